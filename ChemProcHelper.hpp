@@ -3,15 +3,27 @@ ChemProcHelper.hpp
 ----------------------------------------
 복잡한 화학 공정에서의 계산을 물질 흐름을 중심으로 빠르고 편리하게 계산함.
 
-본 헤더 파일은 thread-safe 하지 않음.
+스레드 안전성
+    - 한 객체는 한 스레드에서만 사용하는 것이 기본임. 서로 다른 객체는 각 스레드에서 따로 사용할 수 있음.
+      (StreamBase, ProcObjBase의 하위 클래스, ISATCache, Flowsheet, EOSolver, CubicEOS 등)
+    - SpeedRxnBase의 const 멤버 함수(calcRate, calcRateBatch, calcRateJacobian, calcRateJacobianSparse,
+      getJacobPattern 등)와 CompiledMech의 계산 함수는 같은 객체를 여러 스레드에서 동시에 호출할 수 있음.
+      단, 속도식을 바꾸는 set* 함수(setMassAction, setRateExpr 등)는 이들과 동시에 호출하면 안 됨.
+    - 내부에서 스레드를 사용하는 곳 : Flowsheet(setThreadNum), SSAEngine::simulateEnsemble, MechReducer.
+      Flowsheet는 서로 독립인 블록을 동시에 계산하므로, 블록 사이에 ISATCache처럼 계산 중 상태가 바뀌는 객체를
+      공유하면 스레드 수를 1로 두어야 함.
 
-주요 최상위 클래스 : ChemBase, RxnBase, ProcObjBase
+주요 최상위 클래스 : ChemBase, RxnBase, ProcObjBase, Flowsheet
 ----------------------------------------
 ProcObjBase
-    <= MixerBase, RxtorBase, SpliterBase
+    <= MixerBase, RxtorBase, SplitterBase(<= SeparatorBase), Flash
 RxnBase
     <= SpeedRxnBase, EnergyRxnBase, StateRxnBase
 ChemBase
+CubicEOS
+    : PR, SRK 상태방정식으로 퓨개시티 계수를 계산함
+Flowsheet
+    : ProcObjBase 객체들을 스트림으로 연결함
 */
 
 #ifndef _CHEMPROCHELPER_
@@ -27,7 +39,12 @@ ChemBase
 // 표준 라이브러리
 #include <iostream>
 #include <vector>
+#include <array>
+#include <list>
+#include <deque>
+#include <map>
 #include <set>
+#include <queue>
 #include <unordered_map>
 #include <string>
 #include <regex>
@@ -36,6 +53,31 @@ ChemBase
 #include <set>
 #include <functional>
 #include <cmath>
+#include <memory>
+#include <tuple>
+#include <cctype>
+#include <cstdint>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// 컴파일된 반응 메커니즘(CompiledMech)을 불러오기 위한 동적 라이브러리 헤더
+// (glibc 2.34 미만에서는 -ldl 링크가 필요함.)
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
 
 /*
 이 라이브러리는 Eigen 3 라이브러리를 필수로 요구함.
@@ -43,6 +85,7 @@ https://gitlab.com/libeigen/eigen 참조.
 INTEL(R) MKL 등이 있는 경우 CMake를 이용할 것.
 */
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 
 /*
 이 라이브러리는 boost 라이브러리를 필수로 요구함.
@@ -53,8 +96,10 @@ https://www.boost.org/ 참조.
 // 내부 헤더 파일 연결부
 #include "core/Internal.hpp"
 #include "core/CoreBase.hpp"
+#include "core/ThermoFamily.hpp"
+#include "core/RxnFamily.hpp"
 #include "core/RxtorFamily.hpp"
 #include "core/FlowManagerFamily.hpp"
-#include "core/RxnFamily.hpp"
+#include "core/FlowsheetFamily.hpp"
 
 #endif
\ No newline at end of file
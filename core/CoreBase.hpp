@@ -1,8 +1,9 @@
 /*
 core/CoreBase.hpp
 -----------------
-ChemProcHelper의 핵심 클래스인 ChemBase, RxnBase, StreamBase, ProcObjBase를 include함.
+ChemProcHelper의 핵심 클래스인 ChemBase, RxnBase, StreamBase, ProcObjBase와 자동 미분에 사용하는 Dual을 include함.
 */
+#include "CoreBase/Dual.hpp"
 #include "CoreBase/ChemBase.hpp"
 #include "CoreBase/RxnBase.hpp"
 #include "CoreBase/StreamBase.hpp"
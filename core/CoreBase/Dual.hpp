@@ -0,0 +1,389 @@
+/*
+core/CoreBase/Dual.hpp
+----------------------
+전진 모드 자동 미분에 사용하는 다방향 이원수(dual number) 클래스 Dual과 Jacobian, Hessian 계산 함수를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_DUAL
+#define _CHEMPROCHELPER_DUAL
+
+namespace chemprochelper
+{
+    /*
+    N개 방향의 미분을 값과 함께 계산하는 이원수 클래스.
+    ----------------------------------------------
+    x = a + sum_k b_k e_k (e_k e_l = 0) 형식의 수로, 모든 연산에서 값과 N개 방향의 미분을 함께 계산함.
+    미분 배열은 Eigen::Array<T, N, 1>이므로 N이 고정되면 스택에 놓이고, 연산 한 번이 N개 방향에 대한
+    SIMD 연산으로 전개됨. 입력 N개를 모두 시드하면 Jacobian 전체를 한 번의 계산으로 얻음.
+    T에 다시 Dual을 넣으면(HyperDual) 2계 미분(Hessian)도 같은 방식으로 계산함.
+        ex) Dual<double, 5> : 5방향 1계 미분, HyperDual<double, 5> : 5 x 5 Hessian
+    N = Eigen::Dynamic이면 미분 배열은 동적 크기이며, 크기가 0인 배열은 상수(미분 0)로 취급함.
+    비교 연산은 값만 비교하므로, 분기가 있는 코드도 값이 같은 분기를 따라 미분됨.
+    Dual은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _Val : 값을 저장함.
+        _Grad : 방향별 미분을 저장함.
+    */
+    template <typename T, int N = Eigen::Dynamic>
+    class Dual
+    {
+        public:
+
+            using ValueType = T;
+            using GradType = Eigen::Array<T, N, 1>;
+
+            EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+        private:
+
+            // 값을 저장함.
+            T _Val = T(0);
+
+            // 방향별 미분을 저장함.
+            GradType _Grad;
+
+            // 상수의 미분 배열을 반환함. 동적 크기이면 빈 배열임.
+            static GradType _zeroGrad()
+            {
+                if constexpr (N == Eigen::Dynamic) return GradType();
+                else return GradType::Zero();
+            }
+
+            // ca * ga + cb * gb 를 계산함. 동적 크기에서 빈 배열은 0으로 취급함.
+            static GradType _linGrad(const T& ca, const GradType& ga, const T& cb, const GradType& gb)
+            {
+                if constexpr (N == Eigen::Dynamic)
+                {
+                    if (ga.size() == 0) return (gb.size() == 0) ? GradType() : GradType(cb * gb);
+                    if (gb.size() == 0) return ca * ga;
+                }
+                return ca * ga + cb * gb;
+            }
+
+            // ga + s * gb 를 계산함. (s = 1 혹은 -1)
+            static GradType _addGrad(const GradType& ga, const GradType& gb, const int& s)
+            {
+                if constexpr (N == Eigen::Dynamic)
+                {
+                    if (ga.size() == 0) return (s > 0) ? gb : GradType(-gb);
+                    if (gb.size() == 0) return ga;
+                }
+                return (s > 0) ? GradType(ga + gb) : GradType(ga - gb);
+            }
+
+            // 1변수 함수 f(x)의 값 val과 도함수 deriv로부터 Dual을 만듦.
+            static Dual _chain(const Dual& x, const T& val, const T& deriv)
+            {
+                return Dual(val, GradType(deriv * x._Grad));
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자. 값과 미분이 모두 0임.
+            Dual():
+                _Grad(_zeroGrad()) {}
+
+            // 상수. 미분은 0임.
+            Dual(const T& Val):
+                _Val(Val), _Grad(_zeroGrad()) {}
+
+            // 산술형 상수. T가 Dual인 경우(HyperDual)에도 double로부터 바로 만들 수 있도록 함.
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            Dual(const S& Val):
+                _Val(Val), _Grad(_zeroGrad()) {}
+
+            Dual(const T& Val, const GradType& Grad):
+                _Val(Val), _Grad(Grad) {}
+
+            // 독립 변수. dirNum개 방향 중 dir번째 방향의 미분을 1로 시드함. N이 고정이면 dirNum은 무시함.
+            Dual(const T& Val, const int& dir, const int& dirNum):
+                _Val(Val)
+            {
+                seed(dir, dirNum);
+            }
+
+            // getter 정의부
+
+            const T& getVal() const {return _Val;}
+            const GradType& getGrad() const {return _Grad;}
+
+            // dir번째 방향의 미분을 반환함. 동적 크기에서 빈 배열이면 0을 반환함.
+            T getDeriv(const int& dir) const {return (dir < _Grad.size()) ? _Grad[dir] : T(0);}
+
+            // setter 정의부
+
+            void setVal(const T& Val) {_Val = Val;}
+            void setGrad(const GradType& Grad) {_Grad = Grad;}
+
+            // 인스턴스 정의부
+
+            // dirNum개 방향 중 dir번째 방향의 미분을 1로, 나머지를 0으로 둠. dir이 음수이면 모두 0으로 둠.
+            void seed(const int& dir, const int& dirNum = N)
+            {
+                if constexpr (N == Eigen::Dynamic) _Grad = GradType::Zero(dirNum);
+                else _Grad.setZero();
+
+                if (dir >= 0) _Grad[dir] = T(1);
+            }
+
+            // 연산자 정의부
+
+            Dual operator+() const {return *this;}
+            Dual operator-() const {return Dual(-_Val, GradType(-_Grad));}
+
+            Dual& operator+=(const Dual& b) {return *this = *this + b;}
+            Dual& operator-=(const Dual& b) {return *this = *this - b;}
+            Dual& operator*=(const Dual& b) {return *this = *this * b;}
+            Dual& operator/=(const Dual& b) {return *this = *this / b;}
+
+            friend Dual operator+(const Dual& a, const Dual& b) {return Dual(a._Val + b._Val, _addGrad(a._Grad, b._Grad, 1));}
+            friend Dual operator-(const Dual& a, const Dual& b) {return Dual(a._Val - b._Val, _addGrad(a._Grad, b._Grad, -1));}
+            friend Dual operator*(const Dual& a, const Dual& b) {return Dual(a._Val * b._Val, _linGrad(b._Val, a._Grad, a._Val, b._Grad));}
+            friend Dual operator/(const Dual& a, const Dual& b)
+            {
+                const T inv = T(1) / b._Val;
+                const T val = a._Val * inv;
+                return Dual(val, _linGrad(inv, a._Grad, -val * inv, b._Grad));
+            }
+
+            // 산술형 상수와의 연산은 미분 배열을 만들지 않고 바로 계산함.
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator+(const Dual& a, const S& b) {return Dual(a._Val + b, a._Grad);}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator+(const S& a, const Dual& b) {return Dual(a + b._Val, b._Grad);}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator-(const Dual& a, const S& b) {return Dual(a._Val - b, a._Grad);}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator-(const S& a, const Dual& b) {return Dual(a - b._Val, GradType(-b._Grad));}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator*(const Dual& a, const S& b) {return Dual(a._Val * b, GradType(a._Grad * T(b)));}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator*(const S& a, const Dual& b) {return Dual(a * b._Val, GradType(T(a) * b._Grad));}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator/(const Dual& a, const S& b) {return Dual(a._Val / b, GradType(a._Grad / T(b)));}
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual operator/(const S& a, const Dual& b) {return Dual(T(a)) / b;}
+
+            // 비교 연산은 값만 비교함.
+            friend bool operator<(const Dual& a, const Dual& b) {return a._Val < b._Val;}
+            friend bool operator>(const Dual& a, const Dual& b) {return a._Val > b._Val;}
+            friend bool operator<=(const Dual& a, const Dual& b) {return a._Val <= b._Val;}
+            friend bool operator>=(const Dual& a, const Dual& b) {return a._Val >= b._Val;}
+            friend bool operator==(const Dual& a, const Dual& b) {return a._Val == b._Val;}
+            friend bool operator!=(const Dual& a, const Dual& b) {return a._Val != b._Val;}
+
+            // 수학 함수 정의부. ADL로 찾으므로 일반화된 코드에서는 using std::exp; exp(x); 형식으로 호출함.
+
+            friend Dual exp(const Dual& x)
+            {
+                using std::exp;
+                const T val = exp(x._Val);
+                return _chain(x, val, val);
+            }
+
+            friend Dual log(const Dual& x)
+            {
+                using std::log;
+                return _chain(x, log(x._Val), T(1) / x._Val);
+            }
+
+            friend Dual sqrt(const Dual& x)
+            {
+                using std::sqrt;
+                const T val = sqrt(x._Val);
+                return _chain(x, val, T(0.5) / val);
+            }
+
+            friend Dual abs(const Dual& x) {return (x._Val < T(0)) ? -x : x;}
+            friend Dual fabs(const Dual& x) {return abs(x);}
+
+            // x^p. 정수 차수의 반응 속도식에서 c = 0이어도 미분이 유한하도록 p * x^(p-1)로 계산함.
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual pow(const Dual& x, const S& p)
+            {
+                using std::pow;
+                if (p == 1) return x;
+                return _chain(x, pow(x._Val, T(p)), T(p) * pow(x._Val, T(p - 1)));
+            }
+
+            // x^y. 밑이 0 이하이면 지수에 대한 미분(x^y ln x)은 0으로 둠.
+            friend Dual pow(const Dual& x, const Dual& y)
+            {
+                using std::pow;
+                using std::log;
+                const T val = pow(x._Val, y._Val);
+                const T dx = y._Val * pow(x._Val, y._Val - T(1));
+                const T dy = (x._Val > T(0)) ? T(val * log(x._Val)) : T(0);
+                return Dual(val, _linGrad(dx, x._Grad, dy, y._Grad));
+            }
+
+            template <typename S, typename = std::enable_if_t<std::is_arithmetic<S>::value>>
+            friend Dual pow(const S& x, const Dual& y) {return pow(Dual(T(x)), y);}
+
+            friend std::ostream& operator<<(std::ostream& os, const Dual& x)
+            {
+                os << x._Val << " [" << x._Grad.transpose() << "]";
+                return os;
+            }
+    };
+
+    // 2계 미분(Hessian)을 계산하는 이원수. 바깥 Dual의 미분 배열의 각 원소가 다시 N개 방향의 미분을 가짐.
+    template <typename T, int N = Eigen::Dynamic>
+    using HyperDual = Dual<Dual<T, N>, N>;
+
+    // T의 미분 차수를 나타냄. 산술형은 0, Dual<U, N>은 (U의 차수) + 1
+    template <typename T>
+    struct DualOrder : std::integral_constant<int, 0> {};
+
+    template <typename T, int N>
+    struct DualOrder<Dual<T, N>> : std::integral_constant<int, DualOrder<T>::value + 1> {};
+
+    namespace functions
+    {
+        // 산술형과 Dual의 값을 double로 반환함. Dual이 중첩된 경우 가장 안쪽의 값을 반환함.
+        inline double getDualVal(const double& x) {return x;}
+
+        template <typename T, int N>
+        double getDualVal(const Dual<T, N>& x) {return getDualVal(x.getVal());}
+
+        /*
+        f(const Dual<double, N>* x, Dual<double, N>* y)의 Jacobian(dy / dx, (출력 수 outNum) x (입력 수))을 계산함.
+        N이 고정이면 입력을 N개씩 묶어 (입력 수 / N)번, Eigen::Dynamic이면 모든 방향을 한 번에 시드해 한 번 계산함.
+        f는 Dual을 받는 일반화된 함수(generic lambda 등)이어야 함. yVec이 nullptr이 아니면 f의 값도 저장함.
+        */
+        template <int N = Eigen::Dynamic, typename Func>
+        Eigen::MatrixXd calcJacobAD(const Func& f, const std::vector<double>& xVec, const int& outNum,
+            std::vector<double>* yVec = nullptr)
+        {
+            using DualType = Dual<double, N>;
+
+            const int inNum = xVec.size();
+            const int dirNum = (N == Eigen::Dynamic) ? std::max(inNum, 1) : N;
+
+            std::vector<DualType> x(inNum), y(outNum);
+            Eigen::MatrixXd jacMat(outNum, inNum);
+
+            for (auto base = 0; base < inNum; base += dirNum)
+            {
+                for (auto i = 0; i < inNum; ++i)
+                {
+                    const int dir = (i >= base && i < base + dirNum) ? i - base : -1;
+                    x[i] = DualType(xVec[i], dir, dirNum);
+                }
+
+                f(x.data(), y.data());
+
+                const int colNum = std::min(dirNum, inNum - base);
+                for (auto j = 0; j < outNum; ++j)
+                {
+                    for (auto k = 0; k < colNum; ++k) jacMat(j, base + k) = y[j].getDeriv(k);
+                }
+            }
+
+            if (yVec != nullptr)
+            {
+                yVec->resize(outNum);
+                for (auto j = 0; j < outNum; ++j) (*yVec)[j] = y[j].getVal();
+            }
+
+            return jacMat;
+        }
+
+        /*
+        스칼라 함수 f(const HyperDual<double, N>* x, HyperDual<double, N>* y)의 Hessian(d^2 y / dx^2)을 계산함.
+        N이 고정이면 입력을 N개씩 묶은 블록 쌍마다 한 번씩 계산하고, 대칭이므로 아래 블록은 위 블록을 복사함.
+        gradVec이 nullptr이 아니면 기울기(dy / dx)도 저장함.
+        */
+        template <int N = Eigen::Dynamic, typename Func>
+        Eigen::MatrixXd calcHessAD(const Func& f, const std::vector<double>& xVec, std::vector<double>* gradVec = nullptr)
+        {
+            using InnerType = Dual<double, N>;
+            using DualType = HyperDual<double, N>;
+
+            const int inNum = xVec.size();
+            const int dirNum = (N == Eigen::Dynamic) ? std::max(inNum, 1) : N;
+
+            std::vector<DualType> x(inNum);
+            DualType y;
+            Eigen::MatrixXd hessMat(inNum, inNum);
+            if (gradVec != nullptr) gradVec->assign(inNum, 0);
+
+            for (auto rowBase = 0; rowBase < inNum; rowBase += dirNum)
+            {
+                for (auto colBase = rowBase; colBase < inNum; colBase += dirNum)
+                {
+                    for (auto i = 0; i < inNum; ++i)
+                    {
+                        const int rowDir = (i >= rowBase && i < rowBase + dirNum) ? i - rowBase : -1;
+                        const int colDir = (i >= colBase && i < colBase + dirNum) ? i - colBase : -1;
+
+                        typename DualType::GradType grad = DualType::GradType::Constant(dirNum, InnerType(0.0, -1, dirNum));
+                        if (colDir >= 0) grad[colDir] = InnerType(1.0, -1, dirNum);
+
+                        x[i] = DualType(InnerType(xVec[i], rowDir, dirNum), grad);
+                    }
+
+                    f(x.data(), &y);
+
+                    const int rowNum = std::min(dirNum, inNum - rowBase);
+                    const int colNum = std::min(dirNum, inNum - colBase);
+                    for (auto l = 0; l < colNum; ++l)
+                    {
+                        const InnerType d = y.getDeriv(l);
+                        for (auto k = 0; k < rowNum; ++k)
+                        {
+                            hessMat(rowBase + k, colBase + l) = d.getDeriv(k);
+                            hessMat(colBase + l, rowBase + k) = d.getDeriv(k);
+                        }
+
+                        if (gradVec != nullptr && rowBase == colBase) (*gradVec)[colBase + l] = d.getVal();
+                    }
+                }
+            }
+
+            return hessMat;
+        }
+    }
+} // namespace chemprochelper
+
+/*
+Eigen의 행렬, 배열에 Dual을 원소로 사용할 수 있도록 NumTraits를 지정함.
+double과의 혼합 연산(Dual 행렬 * double 등)도 Dual로 계산함.
+*/
+namespace Eigen
+{
+    template <typename T, int N>
+    struct NumTraits<chemprochelper::Dual<T, N>> : NumTraits<T>
+    {
+        using Real = chemprochelper::Dual<T, N>;
+        using NonInteger = Real;
+        using Nested = Real;
+        using Literal = Real;
+
+        enum
+        {
+            IsComplex = 0,
+            IsInteger = 0,
+            IsSigned = 1,
+            RequireInitialization = 1,
+            ReadCost = 1,
+            AddCost = 3,
+            MulCost = 3
+        };
+    };
+
+    template <typename T, int N, typename BinaryOp>
+    struct ScalarBinaryOpTraits<chemprochelper::Dual<T, N>, double, BinaryOp>
+    {
+        using ReturnType = chemprochelper::Dual<T, N>;
+    };
+
+    template <typename T, int N, typename BinaryOp>
+    struct ScalarBinaryOpTraits<double, chemprochelper::Dual<T, N>, BinaryOp>
+    {
+        using ReturnType = chemprochelper::Dual<T, N>;
+    };
+} // namespace Eigen
+
+#endif
\ No newline at end of file
@@ -49,6 +49,81 @@ namespace chemprochelper
             // 반응기 등에서 중요한 정보들(행렬 등)을 저장함. 자녀 클래스마다 저장하는 값이 다름.
             Eigen::MatrixXf __MainMat;
 
+            /*
+            화학종 chemIdx의 스트림 상 위치 posVec(없으면 -1)이 여전히 유효한지 확인하고, 스트림의 화학종이 바뀐 경우
+            다시 구성함. 유효한 경우 할당 없이 끝나며 true를 반환함.
+            */
+            static bool __syncStreamPos(StreamBase* StreamPtr, const std::vector<ChemBase*>& chemIdx, std::vector<int>& posVec)
+            {
+                bool valid = (posVec.size() == chemIdx.size());
+                const int streamChemNum = StreamPtr->getChemNum();
+
+                for (auto i = 0; valid && i < posVec.size(); ++i)
+                {
+                    if (posVec[i] >= 0)
+                    {
+                        valid = (posVec[i] < streamChemNum) && (StreamPtr->getChemPtrAt(posVec[i]) == chemIdx[i]);
+                    }
+                    else
+                    {
+                        for (auto k = 0; valid && k < streamChemNum; ++k) valid = (StreamPtr->getChemPtrAt(k) != chemIdx[i]);
+                    }
+                }
+                if (valid) return true;
+
+                posVec.assign(chemIdx.size(), -1);
+                for (auto i = 0; i < chemIdx.size(); ++i)
+                {
+                    for (auto k = 0; k < streamChemNum; ++k)
+                    {
+                        if (StreamPtr->getChemPtrAt(k) == chemIdx[i]) posVec[i] = k;
+                    }
+                }
+
+                return false;
+            }
+
+            /*
+            입력 스트림, 출력 스트림 순서로 모든 스트림의 화학종을 합쳐 __ChemIdx를 구성하고, 스트림별 위치를 PosMat에
+            저장함. 스트림의 화학종 구성이 그대로이면 할당 없이 끝나며 true를 반환함.
+            */
+            bool __syncStreamLayout(std::vector<std::vector<int>>& PosMat)
+            {
+                const int inNum = _inStreamIdx.size();
+                const int streamNum = inNum + _outStreamIdx.size();
+
+                bool valid = (PosMat.size() == streamNum);
+                for (auto n = 0; valid && n < streamNum; ++n)
+                {
+                    auto streamPtr = (n < inNum) ? _inStreamIdx[n] : _outStreamIdx[n - inNum];
+                    valid = __syncStreamPos(streamPtr, __ChemIdx, PosMat[n]);
+
+                    // __ChemIdx에 없는 화학종이 추가된 경우
+                    int posNum = 0;
+                    for (auto pos : PosMat[n]) posNum += (pos >= 0);
+                    valid = valid && (posNum == streamPtr->getChemNum());
+                }
+                if (valid) return true;
+
+                __ChemIdx.clear();
+                for (auto n = 0; n < streamNum; ++n)
+                {
+                    auto streamPtr = (n < inNum) ? _inStreamIdx[n] : _outStreamIdx[n - inNum];
+                    for (auto k = 0; k < streamPtr->getChemNum(); ++k)
+                    {
+                        if (!functions::inVector(__ChemIdx, streamPtr->getChemPtrAt(k))) __ChemIdx.push_back(streamPtr->getChemPtrAt(k));
+                    }
+                }
+
+                PosMat.assign(streamNum, std::vector<int>());
+                for (auto n = 0; n < streamNum; ++n)
+                {
+                    __syncStreamPos((n < inNum) ? _inStreamIdx[n] : _outStreamIdx[n - inNum], __ChemIdx, PosMat[n]);
+                }
+
+                return false;
+            }
+
         public:
 
             // 생성자 정의부
@@ -71,6 +146,12 @@ namespace chemprochelper
 
             auto getInStreamIdx() {return _inStreamIdx;}
             auto getOutStreamIdx() {return _outStreamIdx;}
+
+            // pos번째 입/출력 스트림의 포인터를 반환함. std::vector를 복사하지 않음.
+            StreamBase* getInStreamPtr(const int& pos = 0) const {return _inStreamIdx[pos];}
+            StreamBase* getOutStreamPtr(const int& pos = 0) const {return _outStreamIdx[pos];}
+            int getInStreamNum() const {return _inStreamIdx.size();}
+            int getOutStreamNum() const {return _outStreamIdx.size();}
             auto getComment() {return _Comment;}
             auto getChemIdx() {return __ChemIdx;}
             auto getScalarVec() {return __ScalarVec;}
@@ -87,6 +168,37 @@ namespace chemprochelper
             {
 
             }
+
+            /*
+            입력 스트림의 몰 유량(입력 스트림 순서로 이어 붙인 값)에 대한 출력 스트림 몰 유량(출력 스트림 순서로 이어
+            붙인 값)의 야코비안을 Jacob에 계산함. solveSteadyState 직후의 상태에서 호출해야 함.
+            해석적인 야코비안을 제공하지 않는 하위 클래스는 false를 반환하며, 이 경우 EOSolver는 유한 차분을 사용함.
+            */
+            virtual bool calcStreamJacobian(Eigen::MatrixXd& /* Jacob */)
+            {
+                return false;
+            }
+
+            /*
+            단위 공정의 풀이 방향. Flowsheet::analyzeDOF가 스트림의 _ChemMask로부터 정함.
+                Forward : 입력 스트림이 모두 알려진 경우 출력 스트림을 계산함. (solveSteadyState)
+                Backward : 출력 스트림과 입력 스트림 하나를 뺀 나머지가 알려진 경우 그 입력 스트림을 역산함.
+                Estimate : 모든 스트림이 알려진 경우 단위 공정의 사양(전화율 등)을 계산함.
+            */
+            enum DirectionType {Forward, Backward, Estimate};
+
+            // 현재 사양으로 Direction 방향의 풀이를 할 수 있으면 true를 반환함. 기본은 Forward만 지원함.
+            virtual bool supportDirection(const DirectionType& Direction)
+            {
+                return Direction == Forward;
+            }
+
+            // Direction 방향으로 풂. 기본은 Forward만 지원하며 solveSteadyState를 호출함.
+            virtual void solveDirection(const DirectionType& Direction)
+            {
+                if (Direction != Forward) throw std::runtime_error("The unit supports only the forward direction.");
+                solveSteadyState();
+            }
     };
 } // namespace chemprochelper
 
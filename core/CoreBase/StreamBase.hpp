@@ -34,7 +34,7 @@ namespace chemprochelper
             bool _updateChem(ChemBase* ChemIdx, const bool& ChemMask, const float& ChemMol)
             {
                 auto it = std::find(_ChemIdx.begin(), _ChemIdx.end(), ChemIdx);
-                if (it == _ChemIdx.end())
+                if (it != _ChemIdx.end())
                 {
                     auto idx = it - _ChemIdx.begin();
                     _ChemMask[idx] = ChemMask;
@@ -49,7 +49,7 @@ namespace chemprochelper
                     _ChemMol.push_back(ChemMol);
 
                     return true;
-                }                
+                }
             }
 
             // StreamBase 객체에 화학종을 추가함. 기존 화학종의 값을 덮어쓴 경우 false를 반환함.
@@ -202,6 +202,12 @@ namespace chemprochelper
                 else return _ChemMol[functions::getVecPos(_ChemIdx, ChemPtr)];
             }
 
+            // 위치(pos)로 직접 접근함. 복사나 탐색이 없으므로 반복 계산에서 사용함.
+            int getChemNum() const {return _ChemIdx.size();}
+            ChemBase* getChemPtrAt(const int& pos) const {return _ChemIdx[pos];}
+            float getChemMolAt(const int& pos) const {return _ChemMol[pos];}
+            bool getChemMaskAt(const int& pos) const {return _ChemMask[pos];}
+
             // 인스턴스 정의부
 
             // 기존 화학종의 값을 덮어쓴 경우 false를 반환함.
@@ -298,6 +304,13 @@ namespace chemprochelper
                 return _updateChem(ChemIdx, ChemMask, ChemMol);
             }
 
+            // 위치(pos)의 화학종의 몰 유량을 설정하고 알려진 값으로 표시함.
+            void setChemMolAt(const int& pos, const float& ChemMol)
+            {
+                _ChemMol[pos] = ChemMol;
+                _ChemMask[pos] = true;
+            }
+
             // StreamBase 객체에서 화학종을 제거함. 성공한 경우 true를 반환함.
             bool delChem(ChemBase* ChemIdx)
             {
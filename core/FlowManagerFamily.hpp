@@ -1,7 +1,8 @@
 /*
 core/FlowManagerFamily.hpp
 --------------------------
-ProcObjBase로부터 상속받은 Mixer, Splitter를 정의함.
+ProcObjBase로부터 상속받은 Mixer, Splitter, Flash를 정의함.
 */
 #include "FlowManagerFamily/MixerBase.hpp"
-#include "FlowManagerFamily/SplitterBase.hpp"
\ No newline at end of file
+#include "FlowManagerFamily/SplitterBase.hpp"
+#include "FlowManagerFamily/Flash.hpp"
\ No newline at end of file
@@ -0,0 +1,352 @@
+/*
+core/FlowManagerFamily/Flash.hpp
+--------------------------------
+등온 기액 평형 분리기(flash drum) Flash 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_FLASH
+#define _CHEMPROCHELPER_FLASH
+
+namespace chemprochelper
+{
+    /*
+    등온 flash 클래스
+    ---------------
+    온도 _Temp, 압력 _Pres에서 입력 스트림을 기상(0번 출력 스트림)과 액상(1번 출력 스트림)으로 나눔.
+    K 값(K = y / x)은 다음 중 하나로 계산함.
+        - Raoult 법칙 : K = Psat(T) / P, log10(Psat) = A - B / (C + T). (setAntoine, 기본값)
+          T, P의 단위는 Antoine 계수의 단위를 따름.
+        - 사용자 함수 : setKValueFunc로 지정한 함수. (상태방정식 등) 조성에 따라 K가 바뀌므로 K가 수렴할 때까지
+          축차 대입(successive substitution)으로 Rachford-Rice 식과 번갈아 풂.
+    Rachford-Rice 식 f(b) = sum z (K - 1) / (1 + b (K - 1)) = 0은 [0, 1]에서 단조 감소하므로, f(0) <= 0이면
+    액상만(b = 0), f(1) >= 0이면 기상만(b = 1) 있고, 그 외에는 구간 [lo, hi]를 유지하며 Newton 단계가 구간을
+    벗어나면 이분법을 사용해 항상 수렴함. z = 0인 항은 식에서 뺌. K = 0인 화학종(비휘발성)이 있으면 b -> 1에서
+    f -> -inf이므로(f(1) = -inf) 기상만 있는 경우는 없고, 근은 열린 구간 (0, 1) 안에 있음.
+    solveRachfordRiceBatch는 화학종 x 원료 행 우선(row-major) 배열로 여러 원료를 한 번에 풀며, 화학종마다
+    원료 방향으로 연속인 행을 처리하므로 원료 방향으로 벡터화됨. flashBatch는 이를 이용해 여러 원료 조성을
+    한 번에 flash 계산함.
+
+    Flash는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _Temp, _Pres : flash 온도와 압력을 저장함.
+        _AntoineMap : 화학종별 Antoine 계수 (A, B, C)를 저장함.
+        _KValueFunc : 사용자 K 값 함수를 저장함. 비어 있으면 Raoult 법칙을 사용함.
+        _Tol, _MaxIter : Rachford-Rice 식의 허용 오차와 최대 반복 횟수를 저장함.
+        _KTol, _MaxSSIter : K 값 축차 대입의 허용 오차(ln K)와 최대 반복 횟수를 저장함.
+        _PosMat : __ChemIdx의 화학종별 스트림 상 위치(없으면 -1)를 입력 스트림, 출력 스트림 순서로 저장함.
+        _Beta : 마지막 계산의 기화율 V / F를 저장함.
+        _KVec, _LiqFrac, _VapFrac : 마지막 계산의 K 값, 액상/기상 몰분율을 저장함. (__ChemIdx 순서)
+    */
+    class Flash : public ProcObjBase
+    {
+        public:
+
+            // Rachford-Rice 식의 일괄 계산에 사용하는 화학종 x 원료 배열의 형식.
+            using BatchArrayType = Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+            // solveRachfordRiceBatch가 한 번에 반복하는 원료의 수.
+            static constexpr int RRBlockSize = 256;
+
+            // 사용자 K 값 함수의 형식. (화학종, 온도, 압력, 액상 몰분율, 기상 몰분율, K 값) 처음 추정에서는 x = y = z로 호출함.
+            using KValueFuncType = std::function<void(const std::vector<ChemBase*>&, const double&, const double&,
+                const Eigen::VectorXd&, const Eigen::VectorXd&, Eigen::VectorXd&)>;
+
+        private:
+
+            double _Temp = 0.0;
+            double _Pres = 0.0;
+
+            std::unordered_map<ChemBase*, std::array<double, 3>> _AntoineMap;
+            KValueFuncType _KValueFunc;
+
+            double _Tol = 1e-10;
+            int _MaxIter = 100;
+            double _KTol = 1e-8;
+            int _MaxSSIter = 50;
+
+            std::vector<std::vector<int>> _PosMat;
+
+            double _Beta = 0.0;
+            Eigen::VectorXd _KVec;
+            Eigen::VectorXd _LiqFrac;
+            Eigen::VectorXd _VapFrac;
+
+            // Raoult 법칙으로 ChemIdx 순서의 K 값을 K에 계산함.
+            void _calcRaoultK(const std::vector<ChemBase*>& ChemIdx, Eigen::VectorXd& K) const
+            {
+                if (_Pres <= 0) throw std::runtime_error("Flash pressure must be positive.");
+
+                K.resize(ChemIdx.size());
+                for (auto i = 0; i < ChemIdx.size(); ++i)
+                {
+                    auto it = _AntoineMap.find(ChemIdx[i]);
+                    if (it == _AntoineMap.end()) throw std::runtime_error("Antoine coefficients of " + ChemIdx[i]->getAbb() + " aren't specified.");
+
+                    const auto& coef = it->second;
+                    K[i] = std::pow(10.0, coef[0] - coef[1] / (coef[2] + _Temp)) / _Pres;
+                }
+            }
+
+            /*
+            몰분율 z의 원료 하나를 flash 계산해 기화율 beta, 액상/기상 몰분율 x, y, K 값 K를 구함.
+            사용자 K 값 함수가 있으면 K가 수렴할 때까지 축차 대입함.
+            */
+            void _flashOne(const std::vector<ChemBase*>& ChemIdx, const Eigen::VectorXd& z, double& beta,
+                Eigen::VectorXd& x, Eigen::VectorXd& y, Eigen::VectorXd& K) const
+            {
+                const int chemNum = z.size();
+                BatchArrayType zArr(chemNum, 1), kArr(chemNum, 1);
+                Eigen::ArrayXd betaArr(1);
+                zArr.col(0) = z.array();
+
+                if (_KValueFunc) _KValueFunc(ChemIdx, _Temp, _Pres, z, z, K);
+                else _calcRaoultK(ChemIdx, K);
+
+                for (auto iter = 0; iter < _MaxSSIter; ++iter)
+                {
+                    kArr.col(0) = K.array();
+                    solveRachfordRiceBatch(zArr, kArr, betaArr, _Tol, _MaxIter);
+                    beta = betaArr[0];
+
+                    x = (z.array() > 0.0).select(z.array() / (1.0 + beta * (K.array() - 1.0)), 0.0).matrix();
+                    y = (K.array() * x.array()).matrix();
+                    if (!_KValueFunc) return;
+
+                    Eigen::VectorXd kNew;
+                    _KValueFunc(ChemIdx, _Temp, _Pres, x / x.sum(), y / y.sum(), kNew);
+                    // K = 0(비휘발성)인 화학종은 값이 같으면 수렴한 것으로 봄.
+                    const double diff = (kNew.array() == K.array()).select(0.0, (kNew.array().log() - K.array().log()).abs()).maxCoeff();
+                    K = kNew;
+                    if (diff <= _KTol) return;
+                }
+
+                throw std::runtime_error("K values of the flash didn't converge.");
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 임시 객체를 위한 생성자.
+            Flash():
+                ProcObjBase() {}
+
+            // StreamBase* 포인터를 이용함. 입력 스트림, 기상/액상 출력 스트림과 온도, 압력이 정의된 경우
+            Flash(StreamBase* inStreamPtr, StreamBase* vapStreamPtr, StreamBase* liqStreamPtr,
+                const double& Temp, const double& Pres):
+                ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), std::vector<StreamBase*>({vapStreamPtr, liqStreamPtr})),
+                _Temp(Temp), _Pres(Pres) {}
+
+            // StreamBase* 포인터를 이용함. 위의 경우에 코멘트도 입력하는 경우.
+            Flash(StreamBase* inStreamPtr, StreamBase* vapStreamPtr, StreamBase* liqStreamPtr,
+                const double& Temp, const double& Pres, const std::string& Comment):
+                ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), std::vector<StreamBase*>({vapStreamPtr, liqStreamPtr}), Comment),
+                _Temp(Temp), _Pres(Pres) {}
+
+            // getter 정의부
+
+            double getTemp() const {return _Temp;}
+            double getPres() const {return _Pres;}
+            double getBeta() const {return _Beta;}
+            auto getKValue() const {return _KVec;}
+            auto getLiqFrac() const {return _LiqFrac;}
+            auto getVapFrac() const {return _VapFrac;}
+
+            // setter 정의부
+
+            void setTemp(const double& Temp) {_Temp = Temp;}
+            void setPres(const double& Pres) {_Pres = Pres;}
+
+            // 화학종 ChemPtr의 Antoine 계수를 지정함. log10(Psat) = A - B / (C + T)
+            void setAntoine(ChemBase* ChemPtr, const double& A, const double& B, const double& C)
+            {
+                _AntoineMap[ChemPtr] = {A, B, C};
+            }
+
+            // 사용자 K 값 함수를 지정함. 빈 함수를 지정하면 Raoult 법칙으로 돌아감.
+            void setKValueFunc(const KValueFuncType& KValueFunc) {_KValueFunc = KValueFunc;}
+
+            void setTolerance(const double& Tol) {_Tol = Tol;}
+            void setMaxIter(const int& MaxIter) {_MaxIter = MaxIter;}
+            void setKTolerance(const double& KTol) {_KTol = KTol;}
+            void setMaxSSIter(const int& MaxSSIter) {_MaxSSIter = MaxSSIter;}
+
+            // 인스턴스 정의부
+
+            /*
+            원료별 Rachford-Rice 식을 풀어 기화율을 Beta에 저장함. Z, K는 화학종 x 원료 배열이며 Z의 열은 몰분율.
+            원료를 캐시에 들어가는 RRBlockSize개씩 나눠, 블록마다 모든 원료가 수렴할 때까지 반복함.
+            가장 많이 반복한 블록의 반복 횟수를 반환함. MaxIter 안에 수렴하지 않으면 runtime error 발생.
+            */
+            static int solveRachfordRiceBatch(const BatchArrayType& Z, const BatchArrayType& K, Eigen::ArrayXd& Beta,
+                const double& Tol = 1e-10, const int& MaxIter = 100)
+            {
+                const int chemNum = Z.rows();
+                const int feedNum = Z.cols();
+                if (K.rows() != chemNum || K.cols() != feedNum) throw std::runtime_error("The size of K values does not match.");
+
+                // 작업 배열은 스택에 두므로 반복 중에 할당하지 않음.
+                using BlockArrayType = Eigen::Array<double, Eigen::Dynamic, 1, 0, RRBlockSize, 1>;
+                using BlockMaskType = Eigen::Array<bool, Eigen::Dynamic, 1, 0, RRBlockSize, 1>;
+
+                Beta.resize(feedNum);
+                int iterNum = 0;
+
+                for (auto start = 0; start < feedNum; start += RRBlockSize)
+                {
+                    const int len = std::min<int>(RRBlockSize, feedNum - start);
+                    const auto zBlock = Z.middleCols(start, len);
+                    const auto kBlock = K.middleCols(start, len);
+
+                    // f(0), f(1)로 단상인 원료를 먼저 정함. z = 0인 항은 K = 0이어도 NaN이 되지 않도록 뺌.
+                    BlockArrayType f0 = BlockArrayType::Zero(len), f1 = BlockArrayType::Zero(len);
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        const auto zRow = zBlock.row(i).transpose();
+                        f0 += zRow * (kBlock.row(i).transpose() - 1.0);
+                        f1 += (zRow > 0.0).select(zRow * (1.0 - 1.0 / kBlock.row(i).transpose()), 0.0);
+                    }
+
+                    const BlockMaskType twoPhase = (f0 > 0.0) && (f1 < 0.0);
+                    // 두 상인 원료는 f(0), f(1)을 잇는 할선의 근에서 시작함.
+                    BlockArrayType beta = (f0 <= 0.0).select(BlockArrayType::Zero(len),
+                        (f1 >= 0.0).select(BlockArrayType::Ones(len), f0 / (f0 - f1)));
+                    BlockArrayType lo = BlockArrayType::Zero(len), hi = BlockArrayType::Ones(len);
+                    BlockArrayType f(len), df(len), t(len), next(len);
+
+                    bool converged = false;
+                    for (auto iter = 1; iter <= MaxIter && !converged; ++iter)
+                    {
+                        f.setZero();
+                        df.setZero();
+                        // 두 상인 원료의 beta는 열린 구간 (0, 1) 안에 있으므로 K = 0이어도 t는 유한함.
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            t = (kBlock.row(i).transpose() - 1.0) / (1.0 + beta * (kBlock.row(i).transpose() - 1.0));
+                            f += zBlock.row(i).transpose() * t;
+                            df -= zBlock.row(i).transpose() * t.square();
+                        }
+
+                        // f는 단조 감소하므로 f > 0이면 근은 beta보다 큼. Newton 단계가 구간을 벗어나면 이분법을 사용하되,
+                        // 수렴 직전에 반올림으로 구간 끝에 닿은 단계는 그대로 받아들임.
+                        lo = (f > 0.0).select(beta, lo);
+                        hi = (f > 0.0).select(hi, beta);
+
+                        next = beta - f / df;
+                        next = (((next > lo) && (next < hi)) || ((next - beta).abs() <= Tol)).select(next, 0.5 * (lo + hi));
+                        next = (twoPhase && (f != 0.0)).select(next, beta);
+
+                        converged = ((next - beta).abs().maxCoeff() <= Tol);
+                        beta = next;
+                        iterNum = std::max(iterNum, iter);
+                    }
+                    if (!converged) throw std::runtime_error("Rachford-Rice equation didn't converge.");
+
+                    Beta.segment(start, len) = beta;
+                }
+
+                return iterNum;
+            }
+
+            /*
+            ChemIdx 순서의 화학종 x 원료 몰 유량 FeedMat을 모두 flash 계산해 기화율 BetaVec, 기상/액상 몰 유량 VapMat,
+            LiqMat을 구함. Raoult 법칙이면 K 값은 한 번만 계산하고 Rachford-Rice 식을 한 번에 풂.
+            사용자 K 값 함수가 있으면 원료별로 K를 다시 계산하며 모든 원료의 K가 수렴할 때까지 반복함.
+            */
+            void flashBatch(const std::vector<ChemBase*>& ChemIdx, const Eigen::MatrixXd& FeedMat,
+                Eigen::VectorXd& BetaVec, Eigen::MatrixXd& VapMat, Eigen::MatrixXd& LiqMat) const
+            {
+                const int chemNum = ChemIdx.size();
+                const int feedNum = FeedMat.cols();
+                if (FeedMat.rows() != chemNum) throw std::runtime_error("The size of feed matrix does not match.");
+
+                const Eigen::RowVectorXd totalVec = FeedMat.colwise().sum();
+                BatchArrayType zArr = FeedMat.array().rowwise() / totalVec.array().max(1e-300);
+                BatchArrayType kArr(chemNum, feedNum);
+                Eigen::ArrayXd betaArr(feedNum);
+
+                Eigen::VectorXd kVec, xVec, yVec;
+                if (!_KValueFunc)
+                {
+                    _calcRaoultK(ChemIdx, kVec);
+                    kArr = kVec.array().replicate(1, feedNum);
+                }
+                else
+                {
+                    for (auto n = 0; n < feedNum; ++n)
+                    {
+                        const Eigen::VectorXd z = zArr.col(n);
+                        _KValueFunc(ChemIdx, _Temp, _Pres, z, z, kVec);
+                        kArr.col(n) = kVec.array();
+                    }
+                }
+
+                BatchArrayType xArr(chemNum, feedNum);
+                for (auto iter = 0; iter < _MaxSSIter; ++iter)
+                {
+                    solveRachfordRiceBatch(zArr, kArr, betaArr, _Tol, _MaxIter);
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        xArr.row(i) = (zArr.row(i) > 0.0).select(zArr.row(i) / (1.0 + betaArr.transpose() * (kArr.row(i) - 1.0)), 0.0);
+                    }
+                    if (!_KValueFunc) break;
+
+                    double diff = 0.0;
+                    for (auto n = 0; n < feedNum; ++n)
+                    {
+                        xVec = xArr.col(n);
+                        yVec = (kArr.col(n) * xArr.col(n)).matrix();
+                        _KValueFunc(ChemIdx, _Temp, _Pres, xVec / xVec.sum(), yVec / yVec.sum(), kVec);
+                        diff = std::max(diff, (kVec.array() == kArr.col(n)).select(0.0, (kVec.array().log() - kArr.col(n).log()).abs()).maxCoeff());
+                        kArr.col(n) = kVec.array();
+                    }
+                    if (diff <= _KTol) break;
+                    if (iter + 1 == _MaxSSIter) throw std::runtime_error("K values of the flash didn't converge.");
+                }
+
+                BetaVec = betaArr.matrix();
+                LiqMat = (xArr.rowwise() * ((1.0 - betaArr) * totalVec.transpose().array()).transpose()).matrix();
+                VapMat = FeedMat - LiqMat;
+            }
+
+            /*
+            입력 스트림을 _Temp, _Pres에서 flash 계산해 기상/액상 출력 스트림에 씀. 입력 스트림이 모두 알려져야 함.
+            출력 스트림에 없는 화학종은 유량이 0이 아닌 경우에만 출력 스트림에 추가함.
+            */
+            void solveSteadyState() override
+            {
+                auto inStreamPtr = getInStreamPtr();
+                if (!inStreamPtr->chemMolIsAllKnown()) throw std::runtime_error("The inlet stream of the flash must be known.");
+
+                __syncStreamLayout(_PosMat);
+                const int chemNum = __ChemIdx.size();
+
+                Eigen::VectorXd z(chemNum);
+                for (auto i = 0; i < chemNum; ++i) z[i] = (_PosMat[0][i] < 0) ? 0.0 : inStreamPtr->getChemMolAt(_PosMat[0][i]);
+
+                const double total = z.sum();
+                Eigen::VectorXd vapMol = Eigen::VectorXd::Zero(chemNum), liqMol = Eigen::VectorXd::Zero(chemNum);
+                if (total > 0)
+                {
+                    z /= total;
+                    _flashOne(__ChemIdx, z, _Beta, _LiqFrac, _VapFrac, _KVec);
+
+                    liqMol = (1.0 - _Beta) * total * _LiqFrac;
+                    vapMol = (total * z - liqMol).cwiseMax(0.0);
+                }
+
+                for (auto m = 0; m < 2; ++m)
+                {
+                    auto outStreamPtr = getOutStreamPtr(m);
+                    const auto& posVec = _PosMat[1+m];
+                    const auto& molVec = (m == 0) ? vapMol : liqMol;
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (posVec[i] >= 0) outStreamPtr->setChemMolAt(posVec[i], molVec[i]);
+                        else if (molVec[i] != 0) outStreamPtr->updateChem(__ChemIdx[i], molVec[i]);
+                    }
+                }
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
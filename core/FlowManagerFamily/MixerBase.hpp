@@ -9,37 +9,69 @@ core/FlowManagerFamily/MixerBase.hpp
 namespace chemprochelper
 {
     /*
-    분리기를 지정하는 기본 클래스
+    혼합기를 지정하는 기본 클래스
+    ---------------------------
+    여러 입력 스트림을 하나의 출력 스트림으로 합침. solveSteadyState는 스트림의 _ChemMask로 화학종마다 다음을 정함.
+        - 입력 스트림이 모두 알려진 경우 : 출력 = 입력의 합.
+        - 모르는 입력 스트림이 하나이고 출력이 알려진 경우 : 그 입력 = 출력 - 나머지 입력의 합. (역산)
+    입력 스트림의 몰 유량은 화학종 x 스트림의 열 우선(column-major) 행렬 _FlowMat에 모아 한 번에 더하므로,
+    화학종 방향으로 벡터화됨. 스트림에 없는 화학종은 유량이 0으로 알려진 것으로 봄.
+    입/출력 화학종 집합의 비교는 화학종 구성이 바뀐 경우에만 비트 집합으로 다시 계산함.
+
+    MixerBase는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _PosMat : __ChemIdx의 화학종별 스트림 상 위치(없으면 -1)를 입력 스트림, 출력 스트림 순서로 저장함.
+        _InBits, _OutBits : 입/출력 스트림에 포함된 화학종(__ChemIdx 상 위치)의 비트 집합을 저장함.
+        _StreamValid : _InBits와 _OutBits가 같으면 true.
+        _FlowMat, _UnknownMat : 입력 스트림의 몰 유량과 미지수 여부(1 또는 0)를 저장함.
+        _SumVec, _UnknownNum : 알려진 입력 유량의 합과 모르는 입력 스트림의 수를 화학종별로 저장함.
     */
     class MixerBase : public ProcObjBase
     {
         private:
 
-            // 출력 스트림에 포함된 모든 화학종이 입력 스트림의 모든 화학종과 동일한지 확인함.
-            bool _checkStreamValid()
+            std::vector<std::vector<int>> _PosMat;
+            std::vector<std::uint64_t> _InBits;
+            std::vector<std::uint64_t> _OutBits;
+            bool _StreamValid = false;
+
+            Eigen::MatrixXf _FlowMat;
+            Eigen::MatrixXf _UnknownMat;
+            Eigen::VectorXf _SumVec;
+            Eigen::VectorXf _UnknownNum;
+
+            // 스트림의 화학종 구성이 바뀐 경우에만 __ChemIdx, 위치, 비트 집합을 다시 구성함.
+            void _syncLayout()
             {
-                std::set<ChemBase*> inChemSet;
-                std::set<ChemBase*> outChemSet;
+                if (__syncStreamLayout(_PosMat)) return;
 
-                for (auto inStreamPtr : getInStreamIdx())
+                const int inNum = getInStreamNum();
+                const int chemNum = __ChemIdx.size();
+                _InBits.assign((chemNum + 63) / 64, 0);
+                _OutBits.assign((chemNum + 63) / 64, 0);
+                for (auto n = 0; n < _PosMat.size(); ++n)
                 {
-                    for (auto inChemIdx : inStreamPtr->getChemIdx())
+                    auto& bits = (n < inNum) ? _InBits : _OutBits;
+                    for (auto i = 0; i < chemNum; ++i)
                     {
-                        if (!functions::inSet(inChemSet, inChemIdx)) inChemSet.insert(inChemIdx);
+                        if (_PosMat[n][i] >= 0) bits[i / 64] |= (std::uint64_t(1) << (i % 64));
                     }
                 }
+                _StreamValid = (_InBits == _OutBits);
 
-                for (auto outStreamPtr : getOutStreamIdx())
-                {
-                    for (auto outChemIdx : outStreamPtr->getChemIdx())
-                    {
-                        if (!functions::inSet(outChemSet, outChemIdx)) outChemSet.insert(outChemIdx);
-                    }
-                }
+                _FlowMat.resize(chemNum, inNum);
+                _UnknownMat.resize(chemNum, inNum);
+                _SumVec.resize(chemNum);
+                _UnknownNum.resize(chemNum);
+            }
 
-                return (inChemSet == outChemSet);
+            // 출력 스트림에 포함된 모든 화학종이 입력 스트림의 모든 화학종과 동일한지 확인함.
+            bool _checkStreamValid()
+            {
+                _syncLayout();
+                return _StreamValid;
             }
-        
+
         public:
 
             // 생성자 정의부
@@ -47,7 +79,7 @@ namespace chemprochelper
             // 임시 객체를 위한 생성자.
             MixerBase():
                 ProcObjBase() {}
-            
+
             // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의된 경우
             MixerBase(const std::vector<StreamBase*>& inStreamPtr, StreamBase* outStreamPtr):
                 ProcObjBase(inStreamPtr, std::vector<StreamBase*>(1, outStreamPtr)) {}
@@ -56,6 +88,77 @@ namespace chemprochelper
             MixerBase(const std::vector<StreamBase*>& inStreamPtr, StreamBase* outStreamPtr,
                 const std::string& Comment):
                 ProcObjBase(inStreamPtr, std::vector<StreamBase*>(1, outStreamPtr), Comment) {}
+
+            // 인스턴스 정의부
+
+            /*
+            화학종마다 입력 스트림이 모두 알려져 있으면 출력 스트림을, 하나만 모르고 출력 스트림이 알려져 있으면
+            그 입력 스트림을 계산함. 값을 쓰기 전에 모든 화학종을 확인하므로, 풀 수 없으면 스트림을 바꾸지 않고
+            runtime error 발생. 역산한 유량이 음수이면(물질 수지가 맞지 않음) runtime error 발생.
+            */
+            void solveSteadyState() override
+            {
+                if (!_checkStreamValid()) throw std::runtime_error("Species of inlet and outlet streams don't match.");
+
+                const int inNum = getInStreamNum();
+                const int chemNum = __ChemIdx.size();
+                auto outStreamPtr = getOutStreamPtr();
+                // 입/출력 화학종 집합이 같으므로 출력 스트림에는 모든 화학종이 있음.
+                const auto& outPosVec = _PosMat[inNum];
+
+                for (auto n = 0; n < inNum; ++n)
+                {
+                    auto inStreamPtr = getInStreamPtr(n);
+                    const auto& posVec = _PosMat[n];
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        const bool known = (posVec[i] < 0) || inStreamPtr->getChemMaskAt(posVec[i]);
+                        _FlowMat(i, n) = (posVec[i] >= 0 && known) ? inStreamPtr->getChemMolAt(posVec[i]) : 0.0f;
+                        _UnknownMat(i, n) = known ? 0.0f : 1.0f;
+                    }
+                }
+
+                _SumVec.noalias() = _FlowMat.rowwise().sum();
+                _UnknownNum.noalias() = _UnknownMat.rowwise().sum();
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (_UnknownNum[i] == 0) continue;
+
+                    if (_UnknownNum[i] > 1 || !outStreamPtr->getChemMaskAt(outPosVec[i])) throw std::runtime_error("The mixer is under-specified.");
+
+                    const float outMol = outStreamPtr->getChemMolAt(outPosVec[i]);
+                    const float val = outMol - _SumVec[i];
+                    if (val < -1e-5f * std::max(outMol, 1.0f)) throw std::runtime_error("The back-calculated inlet flow is negative.");
+                }
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (_UnknownNum[i] == 0)
+                    {
+                        outStreamPtr->setChemMolAt(outPosVec[i], _SumVec[i]);
+                        continue;
+                    }
+
+                    const float outMol = outStreamPtr->getChemMolAt(outPosVec[i]);
+                    for (auto n = 0; n < inNum; ++n)
+                    {
+                        if (_UnknownMat(i, n) != 0) getInStreamPtr(n)->setChemMolAt(_PosMat[n][i], std::max(outMol - _SumVec[i], 0.0f));
+                    }
+                }
+            }
+
+            // Forward, Backward 모두 solveSteadyState가 _ChemMask로 정함. 모든 스트림이 알려지면 사양이 지나침.
+            bool supportDirection(const DirectionType& Direction) override
+            {
+                return Direction != Estimate;
+            }
+
+            void solveDirection(const DirectionType& Direction) override
+            {
+                if (Direction == Estimate) throw std::runtime_error("The mixer has no specification to estimate.");
+                solveSteadyState();
+            }
     };
 } // namespace chemprochelper
 
@@ -0,0 +1,381 @@
+/*
+core/FlowManagerFamily/SplitterBase.hpp
+---------------------------------------
+분배기의 기초가 되는 SplitterBase 클래스와 성분 분리기 SeparatorBase 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_SPLITTERBASE
+#define _CHEMPROCHELPER_SPLITTERBASE
+
+namespace chemprochelper
+{
+    /*
+    분배기를 지정하는 기본 클래스
+    ---------------------------
+    하나의 입력 스트림을 분배율(__ScalarVec, 출력 스트림 순서)에 따라 여러 출력 스트림으로 나눔. (퍼지, 분기 등)
+    화학종별 분배율은 화학종 x 출력 스트림 행렬 __MainMat에 저장하며, 분배기는 모든 행이 __ScalarVec로 같음.
+    solveSteadyState는 스트림의 _ChemMask로 화학종마다 다음을 정함.
+        - 입력 스트림이 알려진 경우 : 출력 = 분배율 x 입력.
+        - 입력 스트림을 모르는 경우 : 분배율이 가장 큰 알려진 출력 스트림으로 입력 = 출력 / 분배율을 역산한 뒤
+                                     나머지 출력을 계산함. 다른 알려진 출력 스트림이 역산한 결과와 맞지 않으면
+                                     사양이 지나친 것이므로 runtime error 발생.
+    입력 스트림이 알려진 경우의 출력 스트림 값은 이전 계산의 결과로 보고 덮어씀. (_ChemMask로는 사용자가 지정한 값과
+    구분할 수 없으므로, 지나친 사양은 Flowsheet::analyzeDOF로 확인함.)
+    출력은 __MainMat의 열마다 입력 벡터를 곱하는 하나의 Eigen 식으로 미리 할당한 _OutMat에 계산함.
+    작업 공간은 스트림의 화학종 구성이나 분배율이 바뀐 경우에만 다시 만들지만, 출력 스트림에 없는 화학종을
+    추가하는(updateChem) 계산은 스트림 쪽의 할당이 생기고 다음 호출에서 작업 공간도 다시 만듦.
+
+    SplitterBase는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _PosMat : __ChemIdx의 화학종별 스트림 상 위치(없으면 -1)를 입력 스트림, 출력 스트림 순서로 저장함.
+        _InVec : 입력 스트림의 몰 유량(역산한 값 포함)을 저장함.
+        _OutMat : 출력 스트림의 몰 유량을 화학종 x 출력 스트림으로 저장함.
+        _BackVec : 입력 스트림의 몰 유량을 역산한 화학종이면 1을 저장함.
+    protected:
+        __FracValid : __MainMat이 현재 사양과 __ChemIdx에 맞으면 true.
+    */
+    class SplitterBase : public ProcObjBase
+    {
+        private:
+
+            std::vector<std::vector<int>> _PosMat;
+            Eigen::VectorXf _InVec;
+            Eigen::MatrixXf _OutMat;
+            std::vector<char> _BackVec;
+
+            // 스트림의 화학종 구성이 바뀐 경우에만 위치와 작업 공간을 다시 구성함.
+            void _syncLayout()
+            {
+                if (__syncStreamLayout(_PosMat)) return;
+
+                const int chemNum = __ChemIdx.size();
+                _InVec.resize(chemNum);
+                _OutMat.resize(chemNum, getOutStreamNum());
+                _BackVec.assign(chemNum, 0);
+                __FracValid = false;
+            }
+
+        protected:
+
+            bool __FracValid = false;
+
+            // 분배율 Frac이 출력 스트림 수와 맞고, 0 이상이며 합이 1인지 확인함.
+            void __checkFrac(const std::vector<float>& Frac)
+            {
+                if (Frac.size() != getOutStreamNum()) throw std::runtime_error("The number of split fractions doesn't match the number of outlet streams.");
+
+                float sum = 0.0;
+                for (auto f : Frac)
+                {
+                    if (f < 0) throw std::runtime_error("Split fraction must be non-negative.");
+                    sum += f;
+                }
+                if (std::abs(sum - 1.0f) > 1e-5f) throw std::runtime_error("Sum of split fractions must be 1.");
+            }
+
+            // 사양이 지정되었는지의 여부. 하위 클래스에서 다시 정의함.
+            virtual bool __hasSpec()
+            {
+                return __ScalarVec.size() == getOutStreamNum();
+            }
+
+            // __ChemIdx 순서의 화학종별 분배율 __MainMat을 구성함. 하위 클래스에서 다시 정의함.
+            virtual void __buildFrac()
+            {
+                if (!__hasSpec()) throw std::runtime_error("Split fraction isn't specified.");
+
+                const int outNum = getOutStreamNum();
+                __MainMat.resize(__ChemIdx.size(), outNum);
+                for (auto m = 0; m < outNum; ++m) __MainMat.col(m).setConstant(__ScalarVec[m]);
+            }
+
+            /*
+            모든 스트림이 알려진 경우 화학종별 분배율 Frac(__ChemIdx 순서, 화학종 x 출력 스트림)과 전체 분배율
+            TotalFrac을 계산해 하위 클래스에서 사양을 저장함. 입력 유량이 0인 화학종은 Frac의 행을 음수로 둠.
+            */
+            virtual void __setFracResult(const Eigen::MatrixXf& /* Frac */, const std::vector<float>& TotalFrac)
+            {
+                __ScalarVec = TotalFrac;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 임시 객체를 위한 생성자.
+            SplitterBase():
+                ProcObjBase() {}
+
+            // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의된 경우
+            SplitterBase(StreamBase* inStreamPtr, const std::vector<StreamBase*>& outStreamPtr):
+                ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), outStreamPtr) {}
+
+            // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의되고, 코멘트도 입력하는 경우.
+            SplitterBase(StreamBase* inStreamPtr, const std::vector<StreamBase*>& outStreamPtr,
+                const std::string& Comment):
+                ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), outStreamPtr, Comment) {}
+
+            // StreamBase* 포인터를 이용함. 입/출력 스트림과 분배율이 정의된 경우
+            SplitterBase(StreamBase* inStreamPtr, const std::vector<StreamBase*>& outStreamPtr,
+                const std::vector<float>& SplitFrac):
+                ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), outStreamPtr)
+            {
+                setSplitFrac(SplitFrac);
+            }
+
+            // StreamBase* 포인터를 이용함. 입/출력 스트림과 분배율이 정의되고, 코멘트도 입력하는 경우.
+            SplitterBase(StreamBase* inStreamPtr, const std::vector<StreamBase*>& outStreamPtr,
+                const std::vector<float>& SplitFrac, const std::string& Comment):
+                ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), outStreamPtr, Comment)
+            {
+                setSplitFrac(SplitFrac);
+            }
+
+            // getter 정의부
+
+            auto getSplitFrac() {return __ScalarVec;}
+
+            // setter 정의부
+
+            void setSplitFrac(const std::vector<float>& SplitFrac)
+            {
+                __checkFrac(SplitFrac);
+                __ScalarVec = SplitFrac;
+                __FracValid = false;
+            }
+
+            // 인스턴스 정의부
+
+            /*
+            화학종마다 입력 스트림이 알려져 있으면 출력 스트림을 계산하고, 모르면 알려진 출력 스트림으로 역산함.
+            값을 쓰기 전에 모든 화학종을 확인하므로, 풀 수 없으면 스트림을 바꾸지 않고 runtime error 발생.
+            역산한 화학종에서 역산에 쓰지 않은 알려진 출력 스트림은 결과와 같은지 확인하고, 다르면 runtime error 발생.
+            */
+            void solveSteadyState() override
+            {
+                _syncLayout();
+                if (!__FracValid)
+                {
+                    __buildFrac();
+                    __FracValid = true;
+                }
+
+                const int chemNum = __ChemIdx.size();
+                const int outNum = getOutStreamNum();
+                auto inStreamPtr = getInStreamPtr();
+                const auto& inPosVec = _PosMat[0];
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    _BackVec[i] = 0;
+                    if (inPosVec[i] < 0)
+                    {
+                        _InVec[i] = 0.0;
+                        continue;
+                    }
+                    if (inStreamPtr->getChemMaskAt(inPosVec[i]))
+                    {
+                        _InVec[i] = inStreamPtr->getChemMolAt(inPosVec[i]);
+                        continue;
+                    }
+
+                    // 분배율이 가장 큰 알려진 출력 스트림으로 역산함.
+                    int best = -1;
+                    for (auto m = 0; m < outNum; ++m)
+                    {
+                        const int pos = _PosMat[1+m][i];
+                        if (pos < 0 || !getOutStreamPtr(m)->getChemMaskAt(pos) || __MainMat(i, m) <= 0) continue;
+                        if (best < 0 || __MainMat(i, m) > __MainMat(i, best)) best = m;
+                    }
+                    if (best < 0) throw std::runtime_error("The splitter is under-specified.");
+
+                    _InVec[i] = getOutStreamPtr(best)->getChemMolAt(_PosMat[1+best][i]) / __MainMat(i, best);
+                    _BackVec[i] = 1;
+
+                    // 나머지 알려진 출력 스트림은 역산한 입력과 맞아야 함.
+                    for (auto m = 0; m < outNum; ++m)
+                    {
+                        const int pos = _PosMat[1+m][i];
+                        if (m == best || pos < 0 || !getOutStreamPtr(m)->getChemMaskAt(pos)) continue;
+
+                        const float outMol = getOutStreamPtr(m)->getChemMolAt(pos);
+                        const float val = _InVec[i] * __MainMat(i, m);
+                        if (std::abs(outMol - val) > 1e-5f * std::max({std::abs(outMol), std::abs(val), 1.0f}))
+                        {
+                            throw std::runtime_error("The splitter is over-specified.");
+                        }
+                    }
+                }
+
+                _OutMat.noalias() = _InVec.asDiagonal() * __MainMat;
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (_BackVec[i]) inStreamPtr->setChemMolAt(inPosVec[i], _InVec[i]);
+                }
+
+                for (auto m = 0; m < outNum; ++m)
+                {
+                    auto outStreamPtr = getOutStreamPtr(m);
+                    const auto& posVec = _PosMat[1+m];
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (posVec[i] >= 0) outStreamPtr->setChemMolAt(posVec[i], _OutMat(i, m));
+                        else if (_OutMat(i, m) != 0) outStreamPtr->updateChem(__ChemIdx[i], _OutMat(i, m));
+                    }
+                }
+            }
+
+            // 모든 스트림이 알려진 경우 분배율(성분 분리기는 화학종별 회수율)을 계산함.
+            void solveSplitFromStream()
+            {
+                _syncLayout();
+
+                const int chemNum = __ChemIdx.size();
+                const int outNum = getOutStreamNum();
+
+                float inTotal = 0.0;
+                std::vector<float> totalFrac(outNum, 0.0);
+                Eigen::MatrixXf frac = Eigen::MatrixXf::Constant(chemNum, outNum, -1.0f);
+
+                for (auto n = 0; n <= outNum; ++n)
+                {
+                    auto streamPtr = (n == 0) ? getInStreamPtr() : getOutStreamPtr(n - 1);
+                    if (!streamPtr->chemMolIsAllKnown()) throw std::runtime_error("All stream must be known.");
+                }
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    _InVec[i] = (_PosMat[0][i] < 0) ? 0.0f : getInStreamPtr()->getChemMolAt(_PosMat[0][i]);
+                    inTotal += _InVec[i];
+                }
+                if (inTotal <= 0) throw std::runtime_error("The inlet stream is empty.");
+
+                for (auto m = 0; m < outNum; ++m)
+                {
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        const int pos = _PosMat[1+m][i];
+                        const float outMol = (pos < 0) ? 0.0f : getOutStreamPtr(m)->getChemMolAt(pos);
+                        totalFrac[m] += outMol / inTotal;
+                        if (_InVec[i] > 0) frac(i, m) = outMol / _InVec[i];
+                    }
+                }
+
+                __setFracResult(frac, totalFrac);
+                __FracValid = false;
+            }
+
+            // 분배율이 지정되어 있으면 Forward, Backward를, 모든 스트림이 알려진 경우 분배율 계산(Estimate)을 지원함.
+            bool supportDirection(const DirectionType& Direction) override
+            {
+                return (Direction == Estimate) || __hasSpec();
+            }
+
+            void solveDirection(const DirectionType& Direction) override
+            {
+                if (Direction == Estimate) solveSplitFromStream();
+                else solveSteadyState();
+            }
+    };
+
+    /*
+    성분 분리기 클래스
+    ----------------
+    화학종마다 출력 스트림으로의 회수율(recovery, 합이 1)을 지정해 입력 스트림을 나눔. (증류탑, 흡수탑 등의 간이 모델)
+    회수율은 _RecoveryMap에 화학종별로 저장하고, 스트림의 화학종 구성이나 회수율이 바뀐 경우에만 __MainMat으로
+    옮기므로 계산 자체는 SplitterBase와 같음.
+    회수율을 지정하지 않은 화학종이 스트림에 있으면 runtime error 발생.
+
+    SeparatorBase는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _RecoveryMap : 화학종별 출력 스트림 순서의 회수율을 저장함.
+    */
+    class SeparatorBase : public SplitterBase
+    {
+        private:
+
+            std::unordered_map<ChemBase*, std::vector<float>> _RecoveryMap;
+
+        protected:
+
+            bool __hasSpec() override
+            {
+                return !_RecoveryMap.empty();
+            }
+
+            void __buildFrac() override
+            {
+                const int chemNum = __ChemIdx.size();
+                const int outNum = getOutStreamNum();
+
+                __MainMat.resize(chemNum, outNum);
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    auto it = _RecoveryMap.find(__ChemIdx[i]);
+                    if (it == _RecoveryMap.end()) throw std::runtime_error("Recovery of " + __ChemIdx[i]->getAbb() + " isn't specified.");
+                    for (auto m = 0; m < outNum; ++m) __MainMat(i, m) = it->second[m];
+                }
+            }
+
+            // 입력 유량이 0인 화학종은 기존 회수율을 유지함.
+            void __setFracResult(const Eigen::MatrixXf& Frac, const std::vector<float>& /* TotalFrac */) override
+            {
+                const int outNum = getOutStreamNum();
+                for (auto i = 0; i < Frac.rows(); ++i)
+                {
+                    if (Frac(i, 0) < 0) continue;
+
+                    auto& recovery = _RecoveryMap[__ChemIdx[i]];
+                    recovery.resize(outNum);
+                    for (auto m = 0; m < outNum; ++m) recovery[m] = Frac(i, m);
+                }
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 임시 객체를 위한 생성자.
+            SeparatorBase():
+                SplitterBase() {}
+
+            // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의된 경우
+            SeparatorBase(StreamBase* inStreamPtr, const std::vector<StreamBase*>& outStreamPtr):
+                SplitterBase(inStreamPtr, outStreamPtr) {}
+
+            // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의되고, 코멘트도 입력하는 경우.
+            SeparatorBase(StreamBase* inStreamPtr, const std::vector<StreamBase*>& outStreamPtr,
+                const std::string& Comment):
+                SplitterBase(inStreamPtr, outStreamPtr, Comment) {}
+
+            // getter 정의부
+
+            // 화학종 ChemPtr의 회수율을 반환함. 지정하지 않은 경우 runtime error 발생.
+            std::vector<float> getRecovery(ChemBase* ChemPtr)
+            {
+                auto it = _RecoveryMap.find(ChemPtr);
+                if (it == _RecoveryMap.end()) throw std::runtime_error("Recovery of " + ChemPtr->getAbb() + " isn't specified.");
+                return it->second;
+            }
+
+            // setter 정의부
+
+            // 화학종 ChemPtr의 출력 스트림 순서의 회수율을 지정함.
+            void setRecovery(ChemBase* ChemPtr, const std::vector<float>& Recovery)
+            {
+                __checkFrac(Recovery);
+                _RecoveryMap[ChemPtr] = Recovery;
+                __FracValid = false;
+            }
+
+            // 출력 스트림 pos로 모두 보내는 화학종을 지정함.
+            void setRecovery(const std::vector<ChemBase*>& ChemIdx, const int& pos)
+            {
+                std::vector<float> recovery(getOutStreamNum(), 0.0);
+                recovery.at(pos) = 1.0;
+                for (auto chemPtr : ChemIdx) setRecovery(chemPtr, recovery);
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+/*
+core/FlowsheetFamily.hpp
+------------------------
+ProcObjBase 객체들을 스트림으로 연결한 공정도(Flowsheet)를 정의함.
+*/
+#include "FlowsheetFamily/TearConverger.hpp"
+#include "FlowsheetFamily/WorkStealingScheduler.hpp"
+#include "FlowsheetFamily/Flowsheet.hpp"
+#include "FlowsheetFamily/EOSolver.hpp"
\ No newline at end of file
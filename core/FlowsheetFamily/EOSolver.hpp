@@ -0,0 +1,434 @@
+/*
+core/FlowsheetFamily/EOSolver.hpp
+---------------------------------
+공정도 전체를 하나의 희소 연립 방정식으로 푸는 동시 해법(equation-oriented) EOSolver 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_EOSOLVER
+#define _CHEMPROCHELPER_EOSOLVER
+
+namespace chemprochelper
+{
+    #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+    /*
+    EOSolver의 계산 결과를 저장함.
+    ----------------------------
+        IterNum : 뉴턴 반복 수.
+        Converged : 허용 오차 안으로 수렴했는지의 여부.
+        ResidualVec : 반복마다의 상대 잔차 max|x - F(x)| / max(|x|, |F(x)|).
+        FuncNum : 단위 공정의 solveSteadyState를 호출한 횟수.
+        JacobNum : 야코비안을 구성한 횟수.
+    */
+    struct EOResult
+    {
+        int IterNum = 0;
+        bool Converged = false;
+        std::vector<double> ResidualVec;
+        std::int64_t FuncNum = 0;
+        int JacobNum = 0;
+    };
+
+    /*
+    동시 해법 공정도 해석기 클래스.
+    ---------------------------
+    원료가 아닌 모든 스트림의 몰 유량을 미지수 x로 두고, 단위 공정 u마다 출력 스트림의 잔차
+    x_out - F_u(x_in) = 0 을 하나의 연립 방정식으로 모아 뉴턴법으로 한꺼번에 풂.
+    야코비안은 I - dF_u/dx_in 블록들로 이루어진 희소 행렬이며, 단위 공정이 calcStreamJacobian을 제공하면
+    해석적인 블록을, 아니면 입력 스트림 몰 유량의 전진 차분으로 블록을 계산함.
+    희소 구조는 공정도의 연결과 스트림의 화학종 구성으로 정해지므로 한 번만 만들고, SparseLU의 기호 분해(analyzePattern)도
+    한 번만 함. 단위 공정이 스트림에 화학종을 추가하면(updateChem) 구조가 맞지 않으므로, solve를 시작할 때와 매 반복의
+    계산 뒤에 스트림의 화학종 수를 확인하고 바뀐 경우 구조를 다시 만듦. 반복 중에 바뀐 경우 계산된 값에서 다시 시작함.
+    매 반복에서는 블록 값만 valuePtr의 미리 찾아둔 위치에 덮어쓰고 수치 분해(factorize)만 다시 함.
+    뉴턴 방향은 잔차가 줄어들 때까지 반으로 줄이며(최대 _MaxHalving번), 몰 유량은 0 이상으로 자름.
+    순차 모듈 해법(Flowsheet::solve)과 달리 절단 스트림의 중첩 반복이 없어, 순환이 많은 공정도도 몇 번의
+    반복으로 수렴함. 스트림의 현재 값을 처음 추정값으로 사용함.
+
+    EOSolver는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _FlowsheetPtr : 대상 Flowsheet 객체의 포인터를 저장함.
+        _VarStream, _VarPtr : 미지수 스트림과 스트림별 x 상 위치(_VarPtr[s] ~ _VarPtr[s+1])를 저장함.
+        _InVarVec, _OutVarVec : 단위 공정별 입/출력 스트림의 미지수 스트림 인덱스(원료는 -1)를 저장함.
+        _InColVec, _OutRowVec : 단위 공정별 블록의 열(입력 미지수)과 행(출력 미지수)의 x 상 위치를 저장함.
+        _InLocVec : 단위 공정별로 블록의 열이 calcStreamJacobian 결과의 몇 번째 열인지 저장함.
+        _StreamIdx, _ChemNumVec : 구조를 만들 때 공정도의 모든 스트림과 그 화학종 수를 저장함.
+        _JacobMat, _DiagPos, _BlockPos : 희소 야코비안과 대각 원소, 블록 원소(열 우선)의 valuePtr 상 위치를 저장함.
+        _LU, _Analyzed : SparseLU 객체와 기호 분해 여부를 저장함.
+        _Tol, _MaxIter, _MaxHalving, _FDStep : 허용 오차, 최대 반복 수, 최대 반감 수, 유한 차분의 상대 간격을 저장함.
+        _Monitor : 반복마다 (반복 수, 상대 잔차)로 호출하는 함수를 저장함.
+    */
+    class EOSolver
+    {
+        private:
+
+            Flowsheet* _FlowsheetPtr = nullptr;
+
+            // 미지수 스트림과 x 상 위치
+            std::vector<StreamBase*> _VarStream;
+            std::vector<int> _VarPtr;
+
+            // 단위 공정별 연결 정보
+            std::vector<std::vector<int>> _InVarVec, _OutVarVec;
+            std::vector<std::vector<int>> _InColVec, _OutRowVec;
+            std::vector<std::vector<int>> _InLocVec;
+
+            // 구조를 만들 때의 스트림별 화학종 수
+            std::vector<StreamBase*> _StreamIdx;
+            std::vector<int> _ChemNumVec;
+
+            // 희소 야코비안과 값의 위치
+            Eigen::SparseMatrix<double> _JacobMat;
+            std::vector<int> _DiagPos;
+            std::vector<std::vector<int>> _BlockPos;
+
+            Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> _LU;
+            bool _Analyzed = false;
+
+            // 설정
+            double _Tol = 1e-6;
+            int _MaxIter = 50;
+            int _MaxHalving = 8;
+            double _FDStep = 1e-3;
+            std::function<void(const int&, const double&)> _Monitor;
+
+            // 공정도의 연결로부터 미지수와 희소 구조를 만듦.
+            void _buildStructure()
+            {
+                if (!_FlowsheetPtr->isCompiled()) _FlowsheetPtr->compile();
+
+                const auto unitVec = _FlowsheetPtr->getUnitIdx();
+                const auto feedVec = _FlowsheetPtr->getFeedStream();
+                const int unitNum = unitVec.size();
+
+                _VarStream.clear();
+                _VarPtr.assign(1, 0);
+                _StreamIdx = _FlowsheetPtr->getStreamIdx();
+                _ChemNumVec.clear();
+                std::unordered_map<StreamBase*, int> varPos;
+                for (auto ptr : _StreamIdx)
+                {
+                    _ChemNumVec.push_back(ptr->getChemNum());
+                    if (functions::inVector(feedVec, ptr)) continue;
+                    varPos[ptr] = _VarStream.size();
+                    _VarStream.push_back(ptr);
+                    _VarPtr.push_back(_VarPtr.back() + ptr->getChemNum());
+                }
+                const int varNum = _VarPtr.back();
+
+                _InVarVec.assign(unitNum, std::vector<int>());
+                _OutVarVec.assign(unitNum, std::vector<int>());
+                _InColVec.assign(unitNum, std::vector<int>());
+                _OutRowVec.assign(unitNum, std::vector<int>());
+                _InLocVec.assign(unitNum, std::vector<int>());
+
+                std::vector<Eigen::Triplet<double>> tripVec;
+                for (auto i = 0; i < varNum; ++i) tripVec.emplace_back(i, i, 0.0);
+
+                for (auto u = 0; u < unitNum; ++u)
+                {
+                    int loc = 0;
+                    for (auto ptr : unitVec[u]->getInStreamIdx())
+                    {
+                        auto it = varPos.find(ptr);
+                        const int v = (it == varPos.end()) ? -1 : it->second;
+                        _InVarVec[u].push_back(v);
+
+                        for (auto k = 0; k < ptr->getChemNum(); ++k, ++loc)
+                        {
+                            if (v < 0) continue;
+                            _InColVec[u].push_back(_VarPtr[v] + k);
+                            _InLocVec[u].push_back(loc);
+                        }
+                    }
+                    for (auto ptr : unitVec[u]->getOutStreamIdx())
+                    {
+                        const int v = varPos.at(ptr);
+                        _OutVarVec[u].push_back(v);
+                        for (auto k = _VarPtr[v]; k < _VarPtr[v+1]; ++k) _OutRowVec[u].push_back(k);
+                    }
+
+                    for (auto col : _InColVec[u])
+                    {
+                        for (auto row : _OutRowVec[u]) tripVec.emplace_back(row, col, 0.0);
+                    }
+                }
+
+                _JacobMat.resize(varNum, varNum);
+                _JacobMat.setFromTriplets(tripVec.begin(), tripVec.end());
+                _JacobMat.makeCompressed();
+
+                const double* base = _JacobMat.valuePtr();
+                _DiagPos.resize(varNum);
+                for (auto i = 0; i < varNum; ++i) _DiagPos[i] = &_JacobMat.coeffRef(i, i) - base;
+
+                _BlockPos.assign(unitNum, std::vector<int>());
+                for (auto u = 0; u < unitNum; ++u)
+                {
+                    for (auto col : _InColVec[u])
+                    {
+                        for (auto row : _OutRowVec[u]) _BlockPos[u].push_back(&_JacobMat.coeffRef(row, col) - base);
+                    }
+                }
+
+                _Analyzed = false;
+            }
+
+            // 구조를 만든 뒤 스트림의 화학종 수가 바뀌었으면 true를 반환함.
+            bool _layoutChanged() const
+            {
+                for (auto i = 0; i < _StreamIdx.size(); ++i)
+                {
+                    if (_StreamIdx[i]->getChemNum() != _ChemNumVec[i]) return true;
+                }
+                return false;
+            }
+
+            void _readVar(Eigen::VectorXd& x) const
+            {
+                x.resize(_VarPtr.back());
+                for (auto s = 0; s < _VarStream.size(); ++s)
+                {
+                    for (auto k = _VarPtr[s]; k < _VarPtr[s+1]; ++k) x[k] = _VarStream[s]->getChemMolAt(k - _VarPtr[s]);
+                }
+            }
+
+            void _writeVar(const Eigen::VectorXd& x) const
+            {
+                for (auto s = 0; s < _VarStream.size(); ++s)
+                {
+                    for (auto k = _VarPtr[s]; k < _VarPtr[s+1]; ++k) _VarStream[s]->setChemMolAt(k - _VarPtr[s], x[k]);
+                }
+            }
+
+            // 단위 공정 u의 입력 미지수 스트림에 x를 씀.
+            void _writeInlet(const int& u, const Eigen::VectorXd& x) const
+            {
+                for (auto v : _InVarVec[u])
+                {
+                    if (v < 0) continue;
+                    for (auto k = _VarPtr[v]; k < _VarPtr[v+1]; ++k) _VarStream[v]->setChemMolAt(k - _VarPtr[v], x[k]);
+                }
+            }
+
+            // 단위 공정 u의 출력 스트림 값을 F의 해당 위치에 읽음.
+            void _readOutlet(const int& u, Eigen::VectorXd& F) const
+            {
+                for (auto v : _OutVarVec[u])
+                {
+                    for (auto k = _VarPtr[v]; k < _VarPtr[v+1]; ++k) F[k] = _VarStream[v]->getChemMolAt(k - _VarPtr[v]);
+                }
+            }
+
+            /*
+            x에서 모든 단위 공정의 출구 F(x)를 계산함. blockVec이 nullptr이 아니면 단위 공정별 dF/dx_in 블록(열 우선)도
+            계산함. 유한 차분은 입력 스트림 값(float)에 실제로 더해진 간격으로 나눔.
+            */
+            void _evaluate(const Eigen::VectorXd& x, Eigen::VectorXd& F, std::vector<Eigen::MatrixXd>* blockVec, EOResult& res)
+            {
+                const auto unitVec = _FlowsheetPtr->getUnitIdx();
+                F.resize(x.size());
+
+                for (auto u = 0; u < unitVec.size(); ++u)
+                {
+                    auto unitPtr = unitVec[u];
+                    const int rowNum = _OutRowVec[u].size();
+                    const int colNum = _InColVec[u].size();
+                    _writeInlet(u, x);
+
+                    if (blockVec == nullptr)
+                    {
+                        unitPtr->solveSteadyState();
+                        ++res.FuncNum;
+                        _readOutlet(u, F);
+                        continue;
+                    }
+
+                    auto& block = (*blockVec)[u];
+                    block.resize(rowNum, colNum);
+
+                    unitPtr->solveSteadyState();
+                    ++res.FuncNum;
+                    _readOutlet(u, F);
+
+                    // calcStreamJacobian의 행은 출력 스트림의 화학종을 이어 붙인 순서이며 _OutRowVec과 같음.
+                    Eigen::MatrixXd fullJacob;
+                    if (unitPtr->calcStreamJacobian(fullJacob))
+                    {
+                        for (auto j = 0; j < colNum; ++j) block.col(j) = fullJacob.col(_InLocVec[u][j]);
+                    }
+                    else
+                    {
+                        Eigen::VectorXd Fp(x.size());
+                        Eigen::MatrixXd outMat(rowNum, colNum);
+                        Eigen::VectorXd stepVec(colNum);
+
+                        for (auto j = 0; j < colNum; ++j)
+                        {
+                            const int col = _InColVec[u][j];
+                            int v = 0;
+                            while (col >= _VarPtr[v+1]) ++v;
+                            auto ptr = _VarStream[v];
+                            const int pos = col - _VarPtr[v];
+
+                            double scale = 0;
+                            for (auto k = _VarPtr[v]; k < _VarPtr[v+1]; ++k) scale = std::max(scale, std::abs(x[k]));
+
+                            const float base = ptr->getChemMolAt(pos);
+                            const float perturbed = base + _FDStep * std::max({std::abs(x[col]), 1e-2 * scale, 1e-8});
+                            stepVec[j] = double(perturbed) - double(base);
+
+                            ptr->setChemMolAt(pos, perturbed);
+                            unitPtr->solveSteadyState();
+                            ++res.FuncNum;
+                            _readOutlet(u, Fp);
+                            ptr->setChemMolAt(pos, base);
+
+                            for (auto i = 0; i < rowNum; ++i) outMat(i, j) = Fp[_OutRowVec[u][i]];
+                        }
+
+                        // 기준점을 다시 계산해 단위 공정과 출력 스트림의 상태를 x에 맞춤.
+                        unitPtr->solveSteadyState();
+                        ++res.FuncNum;
+                        _readOutlet(u, F);
+
+                        for (auto j = 0; j < colNum; ++j)
+                        {
+                            for (auto i = 0; i < rowNum; ++i) block(i, j) = (outMat(i, j) - F[_OutRowVec[u][i]]) / stepVec[j];
+                        }
+                    }
+                }
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            EOSolver(Flowsheet* FlowsheetPtr):
+                _FlowsheetPtr(FlowsheetPtr)
+            {
+                if (FlowsheetPtr == nullptr) throw std::runtime_error("EOSolver has no Flowsheet object.");
+            }
+
+            // getter 정의부
+
+            int getVarNum() const {return _VarPtr.empty() ? 0 : _VarPtr.back();}
+            int getJacobNnz() const {return _JacobMat.nonZeros();}
+            auto getVarStream() const {return _VarStream;}
+
+            // setter 정의부
+
+            void setTolerance(const double& Tol) {_Tol = Tol;}
+            void setMaxIter(const int& MaxIter) {_MaxIter = MaxIter;}
+            void setMaxHalving(const int& MaxHalving) {_MaxHalving = MaxHalving;}
+            void setFDStep(const double& FDStep) {_FDStep = FDStep;}
+
+            // 반복마다 (반복 수, 상대 잔차)로 호출할 함수를 설정함.
+            void setMonitor(const std::function<void(const int&, const double&)>& Monitor) {_Monitor = Monitor;}
+
+            // 인스턴스 정의부
+
+            // 공정도의 연결이 바뀐 경우 희소 구조와 기호 분해를 다시 만들도록 함.
+            void reset()
+            {
+                _VarPtr.clear();
+                _Analyzed = false;
+            }
+
+            // 뉴턴법으로 공정도 전체를 풀고, 수렴한 값을 미지수 스트림에 반영함.
+            EOResult solve()
+            {
+                const bool stale = !_FlowsheetPtr->isCompiled() || _VarPtr.empty()
+                    || _InVarVec.size() != _FlowsheetPtr->getUnitNum() || _layoutChanged();
+                if (stale) _buildStructure();
+
+                EOResult res;
+                int varNum = getVarNum();
+                const int unitNum = _InVarVec.size();
+
+                Eigen::VectorXd x, F, xTrial, FTrial, dx;
+                std::vector<Eigen::MatrixXd> blockVec(unitNum);
+                _readVar(x);
+
+                for (auto iter = 0; iter < _MaxIter; ++iter)
+                {
+                    _evaluate(x, F, &blockVec, res);
+                    ++res.JacobNum;
+
+                    // 단위 공정이 스트림에 화학종을 추가한 경우 구조를 다시 만들고 계산된 값에서 다시 시작함.
+                    if (_layoutChanged())
+                    {
+                        _buildStructure();
+                        varNum = getVarNum();
+                        _readVar(x);
+
+                        res.ResidualVec.push_back(std::numeric_limits<double>::infinity());
+                        res.IterNum = iter + 1;
+                        if (_Monitor) _Monitor(iter, res.ResidualVec.back());
+                        continue;
+                    }
+
+                    const Eigen::VectorXd r = x - F;
+                    const double scale = (varNum > 0) ? std::max(x.cwiseAbs().maxCoeff(), F.cwiseAbs().maxCoeff()) : 0.0;
+                    const double resid = (varNum > 0) ? r.cwiseAbs().maxCoeff() / std::max(scale, 1e-30) : 0.0;
+
+                    res.ResidualVec.push_back(resid);
+                    res.IterNum = iter;
+                    if (_Monitor) _Monitor(iter, resid);
+
+                    if (resid <= _Tol)
+                    {
+                        res.Converged = true;
+                        break;
+                    }
+
+                    // J = I - dF/dx
+                    double* val = _JacobMat.valuePtr();
+                    std::fill(val, val + _JacobMat.nonZeros(), 0.0);
+                    for (auto pos : _DiagPos) val[pos] = 1.0;
+                    for (auto u = 0; u < unitNum; ++u)
+                    {
+                        const auto& block = blockVec[u];
+                        const int rowNum = block.rows();
+                        for (auto j = 0; j < block.cols(); ++j)
+                        {
+                            for (auto i = 0; i < rowNum; ++i) val[_BlockPos[u][j * rowNum + i]] -= block(i, j);
+                        }
+                    }
+
+                    if (!_Analyzed)
+                    {
+                        _LU.analyzePattern(_JacobMat);
+                        _Analyzed = true;
+                    }
+                    _LU.factorize(_JacobMat);
+                    if (_LU.info() != Eigen::Success) throw std::runtime_error("The Jacobian of the flowsheet is singular.");
+
+                    dx = _LU.solve(-r);
+
+                    // 잔차가 줄어들 때까지 뉴턴 방향을 반으로 줄임.
+                    const double rNorm = r.cwiseAbs().maxCoeff();
+                    double lambda = 1.0;
+                    for (auto h = 0; h <= _MaxHalving; ++h)
+                    {
+                        xTrial = (x + lambda * dx).cwiseMax(0.0);
+                        _evaluate(xTrial, FTrial, nullptr, res);
+                        if ((xTrial - FTrial).cwiseAbs().maxCoeff() < rNorm) break;
+                        lambda *= 0.5;
+                    }
+
+                    // 스트림은 float이므로 실제로 저장된 값을 다음 추정값으로 사용함.
+                    _writeVar(xTrial);
+                    _readVar(x);
+                    res.IterNum = iter + 1;
+                }
+
+                // 미지수 스트림에 x를 반영함. 출력 스트림은 마지막 계산에서 F(x)를 담고 있으므로 x로 덮어씀.
+                _writeVar(x);
+
+                return res;
+            }
+    };
+
+    #endif
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
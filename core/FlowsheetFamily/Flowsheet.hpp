@@ -0,0 +1,1106 @@
+/*
+core/FlowsheetFamily/Flowsheet.hpp
+----------------------------------
+ProcObjBase 객체(단위 공정)들을 스트림으로 연결한 공정도 Flowsheet 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_FLOWSHEET
+#define _CHEMPROCHELPER_FLOWSHEET
+
+namespace chemprochelper
+{
+    /*
+    Flowsheet::analyzeDOF의 풀이 단계 하나를 저장함.
+    ----------------------------------------------
+        UnitPtr : 풀 단위 공정의 포인터. 순환 블록 전체를 푸는 단계이면 nullptr.
+        Direction : 풀이 방향.
+        Block : 순환 블록 전체를 절단 스트림 반복으로 푸는 단계이면 블록의 인덱스, 아니면 -1.
+    */
+    struct DOFStep
+    {
+        ProcObjBase* UnitPtr = nullptr;
+        ProcObjBase::DirectionType Direction = ProcObjBase::Forward;
+        int Block = -1;
+    };
+
+    /*
+    Flowsheet::analyzeDOF의 결과를 저장함.
+    ------------------------------------
+        StepVec : 풀이 순서대로의 단계.
+        OverSpecified : 사양이 지나친 단위 공정. (이미 알려진 출력 스트림을 다시 계산하거나, 모든 스트림이 알려졌는데
+                        Estimate를 지원하지 않음)
+        UnderSpecified : 어느 방향으로도 풀 수 없는 단위 공정.
+        UnknownStream : 끝까지 값을 정할 수 없는 스트림.
+        UnknownNum : UnknownStream의 몰 유량 변수의 수(남은 자유도).
+        Valid : 사양이 지나치거나 모자라지 않으면 true.
+    */
+    struct DOFResult
+    {
+        std::vector<DOFStep> StepVec;
+        std::vector<ProcObjBase*> OverSpecified;
+        std::vector<ProcObjBase*> UnderSpecified;
+        std::vector<StreamBase*> UnknownStream;
+        int UnknownNum = 0;
+        bool Valid = false;
+    };
+
+    /*
+    공정도 클래스.
+    ------------
+    단위 공정의 입/출력 스트림 포인터로부터 단위 공정 그래프(u의 출력 스트림이 v의 입력 스트림이면 u -> v)를 만들고,
+    Tarjan 알고리즘으로 강연결 요소(SCC)를 찾아 위상 순서로 정렬한 순차 모듈(sequential-modular) 계산 순서를 만듦.
+    순환(recycle)이 없는 SCC는 단위 공정 하나이며, 순환이 있는 SCC는 요소 안의 순환을 모두 끊는 가장 작은 절단
+    스트림(tear stream) 집합을 골라 절단한 그래프의 위상 순서로 계산하고, 절단 스트림이 수렴할 때까지 반복함.
+    절단 스트림의 수렴은 TearConverger(축차 대입, Wegstein, Broyden, Anderson)로 가속함.
+
+    계산 순서는 compile에서 한 번만 만들고 단위 공정 포인터의 평탄한 배열(_OrderVec)과 블록 경계(_BlockPtr)로
+    저장하므로, solve는 그래프를 다시 탐색하지 않고 solveSteadyState를 차례로 호출하기만 함.
+    단위 공정을 추가하면 다음 solve에서 다시 compile함.
+
+    스레드 수(setThreadNum)가 1이 아니면 블록 사이의 의존 관계 DAG(_BlockSuccPtr, _BlockSuccIdx, _BlockPredNum)를
+    따라 서로 독립인 블록(병렬 반응기 열, 서로 다른 순환 등)을 WorkStealingScheduler로 동시에 계산함.
+    블록은 자기 단위 공정의 출력 스트림만 쓰고, 입력 스트림은 그 스트림을 쓰는 블록이 끝난 뒤에만 읽음.
+    반응기는 SpeedRxnBase의 const 함수만 호출하므로 여러 단위 공정이 같은 SpeedRxnBase를 공유해도 됨.
+    단, 같은 ISATCache 객체를 공유하면 동시에 계산할 수 없으므로 스레드 수를 1로 두어야 함.
+    스케줄러의 작업 스레드는 Flowsheet가 소멸할 때까지 유지하므로, solve를 반복해도 스레드를 다시 만들지 않음.
+
+    solve가 끝나면 모든 스트림의 값을 저장(_StreamSnap)해 두고, solveIncremental은 바뀐 곳의 하류만 다시 계산함.
+    블록은 밖에서 들어오는 스트림(_BlockInPtr, _BlockInIdx)의 값이 저장한 값과 _ChangeTol(상대 오차) 넘게 다르거나
+    markChanged로 표시한 단위 공정을 포함할 때만 계산함. 다시 계산한 블록의 출력 스트림이 _ChangeTol 안에서
+    그대로이면 그 하류 블록은 계산하지 않으므로, 변화가 사라지는 지점에서 전파가 멈춤.
+    단위 공정의 매개변수(K 값 등)를 바꾼 경우는 스트림으로 알 수 없으므로 markChanged로 알려야 함.
+
+    analyzeDOF는 수치 계산 없이 스트림의 _ChemMask(chemMolIsAllKnown)와 단위 공정이 지원하는 풀이 방향
+    (ProcObjBase::supportDirection)으로 각 단위 공정의 방향과 순서를 정하고, 사양이 지나치거나 모자란 곳을 찾음.
+    solveDOF는 그 결과가 올바를 때만 계산하므로 "All stream are unknown." 같은 예외를 계산 전에 알 수 있음.
+
+    Flowsheet는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _UnitVec : 단위 공정의 포인터를 추가한 순서로 저장함.
+        _StreamVec : 단위 공정들에 연결된 스트림을 처음 나온 순서로 저장함.
+        _Producer : 스트림별로 그 스트림을 출력하는 단위 공정의 인덱스를 저장함. (-1이면 원료 스트림)
+        _ConsumerPtr, _ConsumerIdx : 스트림별로 그 스트림을 입력받는 단위 공정(CSR)을 저장함.
+        _AdjPtr, _AdjIdx : 단위 공정 그래프의 인접 리스트(CSR)를 저장함.
+        _SCCVec : 강연결 요소를 위상 순서로 저장함. 각 요소의 단위 공정은 계산 순서로 정렬됨.
+        _RecycleFlag : 강연결 요소별로 순환이 있는지 저장함.
+        _TearVec : 강연결 요소별 절단 스트림의 인덱스를 저장함. (순환이 없으면 비어 있음)
+        _OrderVec, _BlockPtr : 컴파일된 계산 순서. 블록 b는 _OrderVec의 [_BlockPtr[b], _BlockPtr[b+1]) 구간임.
+        _Compiled : 계산 순서가 최신인지 저장함.
+        _Converger : 순환 블록마다 복사해 사용하는 절단 스트림 수렴 가속기를 저장함.
+        _Tol, _MaxIter : 순환 블록의 수렴 허용 오차(상대 잔차)와 최대 반복 수를 저장함.
+        _MaxTearSearch : 최소 절단 집합을 찾을 때 살펴볼 조합의 최대 수를 저장함.
+        _Monitor : 순환 블록의 반복마다 (블록, 반복 수, 상대 잔차)로 호출하는 함수를 저장함.
+        _BlockSuccPtr, _BlockSuccIdx, _BlockPredNum : 블록의 후속 블록(CSR)과 선행 블록 수를 저장함.
+        _ThreadNum, _Scheduler : 병렬 계산의 스레드 수(0 이하이면 하드웨어 스레드 수)와 스케줄러를 저장함.
+        _BlockInPtr, _BlockInIdx : 블록별로 블록 밖에서 들어오는 스트림의 인덱스(CSR)를 저장함.
+        _StreamSnap, _SnapValid : 마지막 solve 이후 스트림의 몰 유량과 그 값이 유효한지를 저장함.
+        _UnitChanged : markChanged로 표시한 단위 공정을 저장함.
+        _ChangeTol : 스트림이 바뀌었다고 볼 상대 오차를 저장함.
+        _SolvedNum : 마지막 solve, solveIncremental에서 계산한 단위 공정의 수를 저장함.
+    */
+    class Flowsheet
+    {
+        public:
+
+            // (블록, 반복 수, 상대 잔차)
+            using MonitorType = std::function<void(const int&, const int&, const double&)>;
+
+        private:
+
+            // 단위 공정의 포인터를 저장함.
+            std::vector<ProcObjBase*> _UnitVec;
+
+            // 단위 공정들에 연결된 스트림을 저장함.
+            std::vector<StreamBase*> _StreamVec;
+
+            // 스트림별 출력 단위 공정(-1이면 원료 스트림)과 입력 단위 공정(CSR)
+            std::vector<int> _Producer;
+            std::vector<int> _ConsumerPtr, _ConsumerIdx;
+
+            // 단위 공정 그래프의 인접 리스트(CSR)
+            std::vector<int> _AdjPtr, _AdjIdx;
+
+            // 위상 순서의 강연결 요소와 순환 여부
+            std::vector<std::vector<int>> _SCCVec;
+            std::vector<bool> _RecycleFlag;
+            std::vector<std::vector<int>> _TearVec;
+
+            // 컴파일된 계산 순서
+            std::vector<ProcObjBase*> _OrderVec;
+            std::vector<int> _BlockPtr;
+
+            // 계산 순서가 최신인지 저장함.
+            bool _Compiled = false;
+
+            // 순환 블록의 수렴 설정
+            TearConverger _Converger;
+            double _Tol = 1e-5;
+            int _MaxIter = 200;
+            int _MaxTearSearch = 100000;
+            MonitorType _Monitor;
+
+            // 블록의 의존 관계 DAG와 병렬 계산 설정
+            std::vector<int> _BlockSuccPtr, _BlockSuccIdx, _BlockPredNum;
+            int _ThreadNum = 1;
+            WorkStealingScheduler _Scheduler;
+
+            // 증분 계산 상태
+            std::vector<int> _BlockInPtr, _BlockInIdx;
+            std::vector<std::vector<float>> _StreamSnap;
+            bool _SnapValid = false;
+            std::vector<bool> _UnitChanged;
+            double _ChangeTol = 1e-6;
+            int _SolvedNum = 0;
+
+            // 스트림 s의 현재 값이 저장한 값과 다른지 확인함.
+            bool _streamChanged(const int& s) const
+            {
+                const auto ptr = _StreamVec[s];
+                const auto& snap = _StreamSnap[s];
+                if (ptr->getChemNum() != snap.size()) return true;
+
+                for (auto i = 0; i < snap.size(); ++i)
+                {
+                    const double now = ptr->getChemMolAt(i);
+                    if (std::abs(now - snap[i]) > _ChangeTol * std::max(std::abs(now), std::abs<double>(snap[i])) + 1e-30) return true;
+                }
+                return false;
+            }
+
+            // 블록 b를 다시 계산해야 하는지 확인함.
+            bool _blockChanged(const int& b) const
+            {
+                for (auto u : _SCCVec[b])
+                {
+                    if (_UnitChanged[u]) return true;
+                }
+                for (auto p = _BlockInPtr[b]; p < _BlockInPtr[b+1]; ++p)
+                {
+                    if (_streamChanged(_BlockInIdx[p])) return true;
+                }
+                return false;
+            }
+
+            /*
+            스트림의 현재 값을 저장함. all이 false이면 _ChangeTol 넘게 바뀐 스트림만 저장하므로,
+            허용 오차보다 작은 변화가 여러 번 쌓이면 다음 증분 계산에서 바뀐 것으로 봄.
+            */
+            void _takeSnapshot(const bool& all)
+            {
+                _StreamSnap.resize(_StreamVec.size());
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    if (!all && !_streamChanged(s)) continue;
+
+                    const int num = _StreamVec[s]->getChemNum();
+                    _StreamSnap[s].resize(num);
+                    for (auto i = 0; i < num; ++i) _StreamSnap[s][i] = _StreamVec[s]->getChemMolAt(i);
+                }
+                _UnitChanged.assign(_UnitVec.size(), false);
+                _SnapValid = true;
+            }
+
+            /*
+            블록을 계산 순서(혹은 스레드 수가 1이 아니면 의존 관계 DAG)대로 계산함.
+            incremental이면 _blockChanged인 블록만 계산함. 선행 블록이 모두 끝난 뒤에 확인하므로 병렬로 계산해도 같음.
+            */
+            std::vector<RecycleResult> _solveBlocks(const bool& incremental)
+            {
+                if (!_Compiled) compile();
+                if (incremental && !_SnapValid) return _solveBlocks(false);
+
+                const int blockNum = _SCCVec.size();
+                std::vector<RecycleResult> blockRes(blockNum);
+                std::vector<char> solvedFlag(blockNum, 0);
+
+                auto solveBlock = [&](const int& b, const MonitorType& monitor)
+                {
+                    if (incremental && !_blockChanged(b)) return;
+                    solvedFlag[b] = 1;
+
+                    if (_RecycleFlag[b]) blockRes[b] = _solveRecycle(b, monitor);
+                    else
+                    {
+                        for (auto p = _BlockPtr[b]; p < _BlockPtr[b+1]; ++p) _OrderVec[p]->solveSteadyState();
+                    }
+                };
+
+                _SnapValid = _SnapValid && incremental;
+
+                if (_ThreadNum == 1 || blockNum < 2)
+                {
+                    for (auto b = 0; b < blockNum; ++b) solveBlock(b, _Monitor);
+                }
+                else
+                {
+                    std::mutex monitorMutex;
+                    MonitorType monitor;
+                    if (_Monitor)
+                    {
+                        monitor = [&](const int& b, const int& iter, const double& resid)
+                        {
+                            std::lock_guard<std::mutex> lock(monitorMutex);
+                            _Monitor(b, iter, resid);
+                        };
+                    }
+
+                    _Scheduler.setThreadNum(_ThreadNum);
+                    _Scheduler.run(_BlockSuccPtr, _BlockSuccIdx, _BlockPredNum,
+                        [&](const int& b, const int& /* tid */) {solveBlock(b, monitor);});
+                }
+
+                _SolvedNum = 0;
+                std::vector<RecycleResult> res;
+                for (auto b = 0; b < blockNum; ++b)
+                {
+                    if (solvedFlag[b]) _SolvedNum += _BlockPtr[b+1] - _BlockPtr[b];
+                    if (solvedFlag[b] && _RecycleFlag[b]) res.push_back(std::move(blockRes[b]));
+                }
+
+                _takeSnapshot(!incremental);
+
+                return res;
+            }
+
+            // 스트림과 단위 공정 그래프를 만듦.
+            void _buildGraph()
+            {
+                const int unitNum = _UnitVec.size();
+
+                _StreamVec.clear();
+                _Producer.clear();
+
+                std::unordered_map<StreamBase*, int> streamPos;
+                auto getPos = [&](StreamBase* ptr)
+                {
+                    auto it = streamPos.find(ptr);
+                    if (it != streamPos.end()) return it->second;
+
+                    const int pos = _StreamVec.size();
+                    streamPos[ptr] = pos;
+                    _StreamVec.push_back(ptr);
+                    _Producer.push_back(-1);
+                    return pos;
+                };
+
+                std::vector<std::vector<int>> consumerVec;
+                for (auto u = 0; u < unitNum; ++u)
+                {
+                    for (auto ptr : _UnitVec[u]->getInStreamIdx())
+                    {
+                        const int pos = getPos(ptr);
+                        if (consumerVec.size() <= pos) consumerVec.resize(pos + 1);
+                        consumerVec[pos].push_back(u);
+                    }
+                    for (auto ptr : _UnitVec[u]->getOutStreamIdx())
+                    {
+                        const int pos = getPos(ptr);
+                        if (_Producer[pos] >= 0 && _Producer[pos] != u) throw std::runtime_error("A stream is the output of more than one unit in the flowsheet.");
+                        _Producer[pos] = u;
+                    }
+                }
+                consumerVec.resize(_StreamVec.size());
+
+                _ConsumerPtr.assign(1, 0);
+                _ConsumerIdx.clear();
+                for (const auto& consumer : consumerVec)
+                {
+                    _ConsumerIdx.insert(_ConsumerIdx.end(), consumer.begin(), consumer.end());
+                    _ConsumerPtr.push_back(_ConsumerIdx.size());
+                }
+
+                // u -> v (중복 간선 제거)
+                std::vector<std::vector<int>> adjVec(unitNum);
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    if (_Producer[s] < 0) continue;
+                    for (auto p = _ConsumerPtr[s]; p < _ConsumerPtr[s+1]; ++p) adjVec[_Producer[s]].push_back(_ConsumerIdx[p]);
+                }
+
+                _AdjPtr.assign(1, 0);
+                _AdjIdx.clear();
+                for (auto& adj : adjVec)
+                {
+                    std::sort(adj.begin(), adj.end());
+                    adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+                    _AdjIdx.insert(_AdjIdx.end(), adj.begin(), adj.end());
+                    _AdjPtr.push_back(_AdjIdx.size());
+                }
+            }
+
+            /*
+            반복형 Tarjan 알고리즘으로 강연결 요소를 찾음. Tarjan은 요소를 역위상 순서로 내놓으므로 뒤집어 저장함.
+            */
+            void _findSCC()
+            {
+                const int unitNum = _UnitVec.size();
+
+                std::vector<int> index(unitNum, -1), low(unitNum, 0), edgePos(unitNum, 0);
+                std::vector<bool> onStack(unitNum, false);
+                std::vector<int> stack, callStack;
+                int counter = 0;
+
+                _SCCVec.clear();
+
+                for (auto root = 0; root < unitNum; ++root)
+                {
+                    if (index[root] >= 0) continue;
+
+                    callStack.push_back(root);
+                    while (!callStack.empty())
+                    {
+                        const int u = callStack.back();
+
+                        if (index[u] < 0)
+                        {
+                            index[u] = low[u] = counter++;
+                            edgePos[u] = _AdjPtr[u];
+                            stack.push_back(u);
+                            onStack[u] = true;
+                        }
+
+                        // 아직 보지 않은 간선을 따라 내려감.
+                        bool descended = false;
+                        while (edgePos[u] < _AdjPtr[u+1])
+                        {
+                            const int v = _AdjIdx[edgePos[u]++];
+                            if (index[v] < 0)
+                            {
+                                callStack.push_back(v);
+                                descended = true;
+                                break;
+                            }
+                            if (onStack[v]) low[u] = std::min(low[u], index[v]);
+                        }
+                        if (descended) continue;
+
+                        // u의 모든 간선을 본 경우
+                        callStack.pop_back();
+                        if (!callStack.empty()) low[callStack.back()] = std::min(low[callStack.back()], low[u]);
+
+                        if (low[u] == index[u])
+                        {
+                            std::vector<int> comp;
+                            int v;
+                            do
+                            {
+                                v = stack.back();
+                                stack.pop_back();
+                                onStack[v] = false;
+                                comp.push_back(v);
+                            } while (v != u);
+
+                            _SCCVec.push_back(std::move(comp));
+                        }
+                    }
+                }
+
+                std::reverse(_SCCVec.begin(), _SCCVec.end());
+            }
+
+            /*
+            순환이 있는 요소 c의 절단 스트림(tear)을 고르고 요소 안의 계산 순서(comp)를 정함.
+            절단 후보는 출력 단위 공정과 입력 단위 공정이 모두 요소 안에 있는 스트림이며, 후보 조합을 크기 순으로 살펴
+            요소 안의 순환을 모두 끊는 가장 작은 조합(크기가 같으면 화학종 수의 합이 가장 작은 것)을 고름.
+            살펴본 조합이 _MaxTearSearch를 넘으면 입구에서 시작한 깊이 우선 탐색의 역방향 간선을 모두 끊은 뒤,
+            빼도 순환이 생기지 않는 절단 스트림을 하나씩 뺌.
+            계산 순서는 절단 스트림을 뺀 요소 그래프의 위상 순서(같으면 추가한 순서)임.
+            */
+            void _orderComponent(std::vector<int>& comp, std::vector<int>& tear, const std::vector<int>& compOf, const int& c) const
+            {
+                std::sort(comp.begin(), comp.end());
+
+                const int n = comp.size();
+                std::vector<int> local(_UnitVec.size(), -1);
+                for (auto i = 0; i < n; ++i) local[comp[i]] = i;
+
+                // 절단 후보 스트림과 요소 안의 간선(출력 단위 공정 -> 입력 단위 공정)
+                std::vector<int> cand;
+                std::vector<std::vector<std::pair<int, int>>> edgeVec;
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    if (_Producer[s] < 0 || compOf[_Producer[s]] != c) continue;
+
+                    std::vector<std::pair<int, int>> edge;
+                    for (auto p = _ConsumerPtr[s]; p < _ConsumerPtr[s+1]; ++p)
+                    {
+                        if (compOf[_ConsumerIdx[p]] == c) edge.emplace_back(local[_Producer[s]], local[_ConsumerIdx[p]]);
+                    }
+                    if (edge.empty()) continue;
+
+                    cand.push_back(s);
+                    edgeVec.push_back(std::move(edge));
+                }
+                const int candNum = cand.size();
+
+                // 절단한 후보(torn)를 뺀 그래프의 위상 순서. 순환이 남아 있으면 n보다 짧음.
+                auto topoOrder = [&](const std::vector<bool>& torn)
+                {
+                    std::vector<int> inDeg(n, 0);
+                    std::vector<std::vector<int>> adj(n);
+                    for (auto k = 0; k < candNum; ++k)
+                    {
+                        if (torn[k]) continue;
+                        for (const auto& e : edgeVec[k])
+                        {
+                            adj[e.first].push_back(e.second);
+                            ++inDeg[e.second];
+                        }
+                    }
+
+                    std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+                    for (auto i = 0; i < n; ++i)
+                    {
+                        if (inDeg[i] == 0) ready.push(i);
+                    }
+
+                    std::vector<int> order;
+                    while (!ready.empty())
+                    {
+                        const int u = ready.top();
+                        ready.pop();
+                        order.push_back(u);
+                        for (auto v : adj[u])
+                        {
+                            if (--inDeg[v] == 0) ready.push(v);
+                        }
+                    }
+                    return order;
+                };
+
+                /*
+                절단 비용은 스트림의 화학종 수. 비어 있는 스트림(처음 계산에서 화학종이 정해짐)을 가장 싼 절단으로
+                고르지 않도록, 요소에 드나드는 스트림의 화학종 합집합의 크기로 추정함.
+                */
+                std::vector<ChemBase*> compChem;
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    bool touch = (_Producer[s] >= 0 && compOf[_Producer[s]] == c);
+                    for (auto p = _ConsumerPtr[s]; !touch && p < _ConsumerPtr[s+1]; ++p) touch = (compOf[_ConsumerIdx[p]] == c);
+                    if (!touch) continue;
+
+                    for (auto ptr : _StreamVec[s]->getChemIdx())
+                    {
+                        if (!functions::inVector(compChem, ptr)) compChem.push_back(ptr);
+                    }
+                }
+
+                std::vector<int> dim(candNum);
+                for (auto k = 0; k < candNum; ++k)
+                {
+                    dim[k] = _StreamVec[cand[k]]->getChemIdx().size();
+                    if (dim[k] == 0) dim[k] = std::max<int>(compChem.size(), 1);
+                }
+
+                // 크기 순으로 조합을 살펴 최소 절단 집합을 찾음.
+                std::vector<bool> best;
+                int bestDim = std::numeric_limits<int>::max();
+                long long searchNum = 0;
+
+                for (auto size = 1; size <= candNum && best.empty() && searchNum <= _MaxTearSearch; ++size)
+                {
+                    std::vector<int> pick(size);
+                    for (auto i = 0; i < size; ++i) pick[i] = i;
+
+                    while (true)
+                    {
+                        if (++searchNum > _MaxTearSearch) break;
+
+                        std::vector<bool> torn(candNum, false);
+                        int tornDim = 0;
+                        for (auto k : pick)
+                        {
+                            torn[k] = true;
+                            tornDim += dim[k];
+                        }
+                        if (tornDim < bestDim && topoOrder(torn).size() == n)
+                        {
+                            best = torn;
+                            bestDim = tornDim;
+                        }
+
+                        // 다음 조합
+                        int i = size - 1;
+                        while (i >= 0 && pick[i] == candNum - size + i) --i;
+                        if (i < 0) break;
+                        ++pick[i];
+                        for (auto j = i + 1; j < size; ++j) pick[j] = pick[j-1] + 1;
+                    }
+                }
+
+                if (best.empty())
+                {
+                    // 입구(요소 밖이나 원료 스트림에서 입력을 받는 단위 공정)에서 시작하는 깊이 우선 탐색
+                    std::vector<bool> entry(n, false);
+                    for (auto s = 0; s < _StreamVec.size(); ++s)
+                    {
+                        if (_Producer[s] >= 0 && compOf[_Producer[s]] == c) continue;
+                        for (auto p = _ConsumerPtr[s]; p < _ConsumerPtr[s+1]; ++p)
+                        {
+                            if (compOf[_ConsumerIdx[p]] == c) entry[local[_ConsumerIdx[p]]] = true;
+                        }
+                    }
+
+                    std::vector<std::vector<std::pair<int, int>>> adj(n);
+                    for (auto k = 0; k < candNum; ++k)
+                    {
+                        for (const auto& e : edgeVec[k]) adj[e.first].emplace_back(e.second, k);
+                    }
+
+                    best.assign(candNum, false);
+                    std::vector<int> state(n, 0), edgePos(n, 0);
+                    std::vector<int> callStack;
+                    std::vector<int> rootVec;
+                    for (auto i = 0; i < n; ++i)
+                    {
+                        if (entry[i]) rootVec.push_back(i);
+                    }
+                    for (auto i = 0; i < n; ++i) rootVec.push_back(i);
+
+                    for (auto root : rootVec)
+                    {
+                        if (state[root] != 0) continue;
+                        callStack.push_back(root);
+                        state[root] = 1;
+                        while (!callStack.empty())
+                        {
+                            const int u = callStack.back();
+                            if (edgePos[u] == adj[u].size())
+                            {
+                                state[u] = 2;
+                                callStack.pop_back();
+                                continue;
+                            }
+
+                            const auto& e = adj[u][edgePos[u]++];
+                            if (state[e.first] == 1) best[e.second] = true;
+                            else if (state[e.first] == 0)
+                            {
+                                state[e.first] = 1;
+                                callStack.push_back(e.first);
+                            }
+                        }
+                    }
+
+                    // 빼도 순환이 생기지 않는 절단 스트림은 뺌. (화학종 수가 많은 것부터)
+                    std::vector<int> pruneOrder(candNum);
+                    for (auto k = 0; k < candNum; ++k) pruneOrder[k] = k;
+                    std::stable_sort(pruneOrder.begin(), pruneOrder.end(), [&](int a, int b) {return dim[a] > dim[b];});
+                    for (auto k : pruneOrder)
+                    {
+                        if (!best[k]) continue;
+                        best[k] = false;
+                        if (topoOrder(best).size() != n) best[k] = true;
+                    }
+                }
+
+                tear.clear();
+                for (auto k = 0; k < candNum; ++k)
+                {
+                    if (best[k]) tear.push_back(cand[k]);
+                }
+
+                std::vector<int> order = topoOrder(best);
+                for (auto& u : order) u = comp[u];
+                comp = std::move(order);
+            }
+
+            /*
+            순환 블록 b를 절단 스트림이 수렴할 때까지 반복 계산함.
+            단위 공정이 스트림에 화학종을 추가하면(updateChem) 절단 스트림의 크기가 바뀔 수 있으므로, 매 반복마다
+            크기를 확인하고 바뀐 경우 새 구성으로 x, g를 다시 잡고 가속기를 초기화함. 그 반복은 수렴한 것으로 보지 않음.
+            */
+            RecycleResult _solveRecycle(const int& b, const MonitorType& monitor) const
+            {
+                RecycleResult res;
+                res.Block = b;
+
+                for (auto s : _TearVec[b]) res.TearIdx.push_back(_StreamVec[s]);
+
+                auto tearDim = [&]()
+                {
+                    int dim = 0;
+                    for (auto ptr : res.TearIdx) dim += ptr->getChemIdx().size();
+                    return dim;
+                };
+                int dim = tearDim();
+
+                auto readTear = [&](Eigen::VectorXd& x)
+                {
+                    int pos = 0;
+                    for (auto ptr : res.TearIdx)
+                    {
+                        const int num = ptr->getChemIdx().size();
+                        for (auto i = 0; i < num; ++i) x[pos++] = ptr->getChemMolAt(i);
+                    }
+                };
+                auto writeTear = [&](const Eigen::VectorXd& x)
+                {
+                    int pos = 0;
+                    for (auto ptr : res.TearIdx)
+                    {
+                        const int num = ptr->getChemIdx().size();
+                        for (auto i = 0; i < num; ++i) ptr->setChemMolAt(i, x[pos++]);
+                    }
+                };
+
+                // 절단 스트림의 처음 추정값(모르는 값은 0)을 알려진 값으로 표시해, 마스크로 방향을 정하는 단위 공정도 풀 수 있게 함.
+                Eigen::VectorXd x(dim), g(dim), xNew(dim);
+                readTear(x);
+                writeTear(x);
+
+                TearConverger conv = _Converger;
+                conv.reset(dim);
+
+                for (auto iter = 0; iter < _MaxIter; ++iter)
+                {
+                    for (auto p = _BlockPtr[b]; p < _BlockPtr[b+1]; ++p) _OrderVec[p]->solveSteadyState();
+
+                    // 절단 스트림의 화학종 구성이 바뀐 경우 계산된 값에서 다시 시작함.
+                    if (tearDim() != dim)
+                    {
+                        dim = tearDim();
+                        x.resize(dim);
+                        g.resize(dim);
+                        xNew.resize(dim);
+                        readTear(x);
+                        conv.reset(dim);
+
+                        res.ResidualVec.push_back(std::numeric_limits<double>::infinity());
+                        ++res.IterNum;
+                        if (monitor) monitor(b, res.IterNum, res.ResidualVec.back());
+                        continue;
+                    }
+
+                    readTear(g);
+                    const double scale = (dim > 0) ? g.cwiseAbs().maxCoeff() : 0.0;
+                    const double resid = (dim > 0) ? (g - x).cwiseAbs().maxCoeff() / std::max(scale, 1e-30) : 0.0;
+
+                    res.ResidualVec.push_back(resid);
+                    ++res.IterNum;
+                    if (monitor) monitor(b, res.IterNum, resid);
+
+                    if (resid <= _Tol)
+                    {
+                        res.Converged = true;
+                        break;
+                    }
+
+                    conv.update(x, g, xNew);
+                    writeTear(xNew);
+                    readTear(x);
+                }
+
+                return res;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            Flowsheet() = default;
+
+            Flowsheet(const std::vector<ProcObjBase*>& UnitVec):
+                _UnitVec(UnitVec) {}
+
+            // getter 정의부
+
+            int getUnitNum() const {return _UnitVec.size();}
+            int getStreamNum() const {return _StreamVec.size();}
+            int getBlockNum() const {return _SCCVec.size();}
+            auto getUnitIdx() const {return _UnitVec;}
+            auto getStreamIdx() const {return _StreamVec;}
+            bool isCompiled() const {return _Compiled;}
+
+            // 컴파일된 계산 순서를 단위 공정 인덱스의 블록(강연결 요소)으로 반환함.
+            auto getSchedule() const {return _SCCVec;}
+            auto getRecycleFlag() const {return _RecycleFlag;}
+
+            // 블록별 절단 스트림의 포인터를 반환함. (순환이 없는 블록은 비어 있음)
+            std::vector<std::vector<StreamBase*>> getTearStream() const
+            {
+                std::vector<std::vector<StreamBase*>> res(_TearVec.size());
+                for (auto b = 0; b < _TearVec.size(); ++b)
+                {
+                    for (auto s : _TearVec[b]) res[b].push_back(_StreamVec[s]);
+                }
+                return res;
+            }
+
+            auto getTearMethod() const {return _Converger.getMethod();}
+            double getTolerance() const {return _Tol;}
+            int getMaxIter() const {return _MaxIter;}
+            int getThreadNum() const {return _ThreadNum;}
+            double getChangeTol() const {return _ChangeTol;}
+
+            // 마지막 solve, solveIncremental에서 계산한 단위 공정의 수를 반환함.
+            int getSolvedNum() const {return _SolvedNum;}
+
+            // 마지막 병렬 계산에서 다른 스레드가 훔쳐간 블록의 수를 반환함.
+            int getStealNum() const {return _Scheduler.getStealNum();}
+
+            // 단위 공정 u가 추가된 순서 상 인덱스를 반환함.
+            int getUnitPos(ProcObjBase* UnitPtr) const {return functions::getVecPos(_UnitVec, UnitPtr);}
+
+            // 단위 공정의 출력이 아닌 스트림(원료)과 단위 공정의 입력이 아닌 스트림(제품)을 반환함.
+            std::vector<StreamBase*> getFeedStream() const
+            {
+                std::vector<StreamBase*> res;
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    if (_Producer[s] < 0) res.push_back(_StreamVec[s]);
+                }
+                return res;
+            }
+            std::vector<StreamBase*> getProductStream() const
+            {
+                std::vector<StreamBase*> res;
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    if (_ConsumerPtr[s] == _ConsumerPtr[s+1]) res.push_back(_StreamVec[s]);
+                }
+                return res;
+            }
+
+            // setter 정의부
+
+            void addUnit(ProcObjBase* UnitPtr)
+            {
+                if (functions::inVector(_UnitVec, UnitPtr)) throw std::runtime_error("The unit is already in the flowsheet.");
+                _UnitVec.push_back(UnitPtr);
+                _Compiled = false;
+            }
+            void addUnit(const std::vector<ProcObjBase*>& UnitVec)
+            {
+                for (auto ptr : UnitVec) addUnit(ptr);
+            }
+
+            // 순환 블록의 수렴 설정
+            void setTearMethod(const TearConverger::MethodType& Method) {_Converger.setMethod(Method);}
+            void setWegsteinBound(const double& QMin, const double& QMax) {_Converger.setWegsteinBound(QMin, QMax);}
+            void setAndersonDepth(const int& Depth) {_Converger.setAndersonDepth(Depth);}
+            void setMixing(const double& Mixing) {_Converger.setMixing(Mixing);}
+            void setTolerance(const double& Tol) {_Tol = Tol;}
+            void setMaxIter(const int& MaxIter) {_MaxIter = MaxIter;}
+            void setMaxTearSearch(const int& MaxTearSearch) {_MaxTearSearch = MaxTearSearch; _Compiled = false;}
+
+            // 순환 블록의 반복마다 (블록, 반복 수, 상대 잔차)로 호출할 함수를 설정함.
+            void setMonitor(const MonitorType& Monitor) {_Monitor = Monitor;}
+
+            // 병렬 계산의 스레드 수. 1이면 순서대로 계산하고, 0 이하이면 하드웨어 스레드 수를 사용함.
+            void setThreadNum(const int& ThreadNum) {_ThreadNum = ThreadNum;}
+
+            // 증분 계산에서 스트림이 바뀌었다고 볼 상대 오차
+            void setChangeTol(const double& ChangeTol) {_ChangeTol = ChangeTol;}
+
+            // 매개변수를 바꾼 단위 공정을 표시함. 다음 solveIncremental에서 그 단위 공정의 블록부터 다시 계산함.
+            void markChanged(ProcObjBase* UnitPtr)
+            {
+                if (!functions::inVector(_UnitVec, UnitPtr)) throw std::runtime_error("The unit is not in the flowsheet.");
+                const int pos = getUnitPos(UnitPtr);
+                if (_UnitChanged.size() != _UnitVec.size()) _UnitChanged.resize(_UnitVec.size(), false);
+                _UnitChanged[pos] = true;
+            }
+
+            // 인스턴스 정의부
+
+            /*
+            스트림과 단위 공정 그래프를 만들고 강연결 요소를 위상 순서로 정렬한 뒤, 순환 블록의 절단 스트림을 골라
+            계산 순서를 컴파일함.
+            단위 공정의 입/출력 스트림이 바뀐 경우에도 다시 호출해야 함.
+            */
+            void compile()
+            {
+                _buildGraph();
+                _findSCC();
+
+                const int unitNum = _UnitVec.size();
+                std::vector<int> compOf(unitNum);
+                for (auto c = 0; c < _SCCVec.size(); ++c)
+                {
+                    for (auto u : _SCCVec[c]) compOf[u] = c;
+                }
+
+                _RecycleFlag.assign(_SCCVec.size(), false);
+                _TearVec.assign(_SCCVec.size(), std::vector<int>());
+                for (auto c = 0; c < _SCCVec.size(); ++c)
+                {
+                    auto& comp = _SCCVec[c];
+
+                    // 자기 자신으로의 간선도 순환임.
+                    if (comp.size() > 1) _RecycleFlag[c] = true;
+                    else
+                    {
+                        const int u = comp.front();
+                        for (auto p = _AdjPtr[u]; p < _AdjPtr[u+1]; ++p)
+                        {
+                            if (_AdjIdx[p] == u) _RecycleFlag[c] = true;
+                        }
+                    }
+
+                    if (_RecycleFlag[c]) _orderComponent(comp, _TearVec[c], compOf, c);
+                }
+
+                _OrderVec.clear();
+                _BlockPtr.assign(1, 0);
+                for (const auto& comp : _SCCVec)
+                {
+                    for (auto u : comp) _OrderVec.push_back(_UnitVec[u]);
+                    _BlockPtr.push_back(_OrderVec.size());
+                }
+
+                // 블록 사이의 의존 관계 (중복 간선 제거)
+                const int blockNum = _SCCVec.size();
+                std::vector<std::vector<int>> succVec(blockNum);
+                for (auto u = 0; u < unitNum; ++u)
+                {
+                    for (auto p = _AdjPtr[u]; p < _AdjPtr[u+1]; ++p)
+                    {
+                        if (compOf[u] != compOf[_AdjIdx[p]]) succVec[compOf[u]].push_back(compOf[_AdjIdx[p]]);
+                    }
+                }
+
+                _BlockSuccPtr.assign(1, 0);
+                _BlockSuccIdx.clear();
+                _BlockPredNum.assign(blockNum, 0);
+                for (auto& succ : succVec)
+                {
+                    std::sort(succ.begin(), succ.end());
+                    succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+                    for (auto c : succ) ++_BlockPredNum[c];
+                    _BlockSuccIdx.insert(_BlockSuccIdx.end(), succ.begin(), succ.end());
+                    _BlockSuccPtr.push_back(_BlockSuccIdx.size());
+                }
+
+                // 블록 밖에서 들어오는 스트림
+                _BlockInPtr.assign(1, 0);
+                _BlockInIdx.clear();
+                std::vector<std::vector<int>> inVec(blockNum);
+                for (auto s = 0; s < _StreamVec.size(); ++s)
+                {
+                    for (auto p = _ConsumerPtr[s]; p < _ConsumerPtr[s+1]; ++p)
+                    {
+                        const int c = compOf[_ConsumerIdx[p]];
+                        if (_Producer[s] >= 0 && compOf[_Producer[s]] == c) continue;
+                        if (inVec[c].empty() || inVec[c].back() != s) inVec[c].push_back(s);
+                    }
+                }
+                for (const auto& in : inVec)
+                {
+                    _BlockInIdx.insert(_BlockInIdx.end(), in.begin(), in.end());
+                    _BlockInPtr.push_back(_BlockInIdx.size());
+                }
+
+                _SnapValid = false;
+                _UnitChanged.assign(unitNum, false);
+                _Compiled = true;
+            }
+
+            /*
+            컴파일된 계산 순서대로 단위 공정의 solveSteadyState를 호출함. 순환이 없는 블록은 한 번, 순환 블록은 절단
+            스트림이 수렴할 때까지 반복해서 계산함. 절단 스트림의 현재 값을 처음 추정값으로 사용함.
+            스레드 수가 1이 아니면 서로 독립인 블록을 동시에 계산하며, 이때 Monitor는 한 번에 하나씩 호출됨.
+            순환 블록별 수렴 결과를 블록 순서로 반환함.
+            */
+            std::vector<RecycleResult> solve()
+            {
+                return _solveBlocks(false);
+            }
+
+            /*
+            마지막 solve 이후 값이 바뀐 스트림(원료 등)과 markChanged로 표시한 단위 공정의 하류만 다시 계산함.
+            출력이 _ChangeTol 안에서 그대로인 블록에서 전파를 멈춤. 저장한 값이 없으면(처음 호출, 다시 compile한 경우)
+            solve와 같음. 다시 계산한 순환 블록의 수렴 결과를 블록 순서로 반환함.
+            */
+            std::vector<RecycleResult> solveIncremental()
+            {
+                return _solveBlocks(true);
+            }
+
+            /*
+            스트림의 _ChemMask로부터 자유도를 분석해 단위 공정별 풀이 방향과 순서를 정함. 수치 계산은 하지 않음.
+            알려진 스트림에서 시작해, 더 풀 수 있는 단위 공정이 없을 때까지 다음을 반복함.
+                - 입력 스트림이 모두 알려지고 모르는 출력 스트림이 있으면 Forward.
+                - 출력 스트림이 모두 알려지고 모르는 입력 스트림이 하나이면 Backward.
+                - 모든 스트림이 알려지면 Estimate. (지원하지 않으면 사양이 지나침)
+                - 위에 해당하는 단위 공정이 없으면, 밖에서 들어오는 스트림이 모두 알려진 순환 블록 전체를 Forward로
+                  (절단 스트림 반복으로) 풂.
+            순환 블록 안의 스트림 값은 절단 스트림의 처음 추정값으로 보며, 알려진 스트림으로 세지 않음.
+            */
+            DOFResult analyzeDOF()
+            {
+                if (!_Compiled) compile();
+
+                const int unitNum = _UnitVec.size();
+                const int streamNum = _StreamVec.size();
+
+                std::vector<int> compOf(unitNum);
+                for (auto c = 0; c < _SCCVec.size(); ++c)
+                {
+                    for (auto u : _SCCVec[c]) compOf[u] = c;
+                }
+
+                std::unordered_map<StreamBase*, int> streamPos;
+                for (auto s = 0; s < streamNum; ++s) streamPos[_StreamVec[s]] = s;
+
+                std::vector<std::vector<int>> inVec(unitNum), outVec(unitNum);
+                for (auto u = 0; u < unitNum; ++u)
+                {
+                    for (auto ptr : _UnitVec[u]->getInStreamIdx()) inVec[u].push_back(streamPos[ptr]);
+                    for (auto ptr : _UnitVec[u]->getOutStreamIdx()) outVec[u].push_back(streamPos[ptr]);
+                }
+
+                // 순환 블록 안의 스트림은 처음 추정값이므로 모르는 것으로 봄.
+                std::vector<bool> known(streamNum);
+                for (auto s = 0; s < streamNum; ++s)
+                {
+                    bool internal = false;
+                    if (_Producer[s] >= 0 && _RecycleFlag[compOf[_Producer[s]]])
+                    {
+                        for (auto p = _ConsumerPtr[s]; p < _ConsumerPtr[s+1]; ++p)
+                        {
+                            if (compOf[_ConsumerIdx[p]] == compOf[_Producer[s]]) internal = true;
+                        }
+                    }
+                    known[s] = !internal && _StreamVec[s]->chemMolIsAllKnown();
+                }
+
+                DOFResult res;
+                std::vector<bool> done(unitNum, false);
+
+                bool progress = true;
+                while (progress)
+                {
+                    progress = false;
+
+                    for (const auto& comp : _SCCVec)
+                    {
+                        for (auto u : comp)
+                        {
+                            if (done[u]) continue;
+                            auto unitPtr = _UnitVec[u];
+
+                            std::vector<int> inUnknown;
+                            for (auto s : inVec[u])
+                            {
+                                if (!known[s]) inUnknown.push_back(s);
+                            }
+                            int outUnknown = 0;
+                            for (auto s : outVec[u]) outUnknown += !known[s];
+
+                            DOFStep step;
+                            step.UnitPtr = unitPtr;
+
+                            if (inUnknown.empty() && outUnknown > 0 && unitPtr->supportDirection(ProcObjBase::Forward))
+                            {
+                                if (outUnknown < outVec[u].size()) res.OverSpecified.push_back(unitPtr);
+                                step.Direction = ProcObjBase::Forward;
+                                for (auto s : outVec[u]) known[s] = true;
+                            }
+                            else if (outUnknown == 0 && inUnknown.size() == 1 && unitPtr->supportDirection(ProcObjBase::Backward))
+                            {
+                                step.Direction = ProcObjBase::Backward;
+                                known[inUnknown.front()] = true;
+                            }
+                            else if (inUnknown.empty() && outUnknown == 0)
+                            {
+                                if (!unitPtr->supportDirection(ProcObjBase::Estimate))
+                                {
+                                    res.OverSpecified.push_back(unitPtr);
+                                    done[u] = true;
+                                    continue;
+                                }
+                                step.Direction = ProcObjBase::Estimate;
+                            }
+                            else continue;
+
+                            res.StepVec.push_back(step);
+                            done[u] = true;
+                            progress = true;
+                        }
+                    }
+                    if (progress) continue;
+
+                    // 밖에서 들어오는 스트림이 모두 알려진 순환 블록을 통째로 풂.
+                    for (auto b = 0; b < _SCCVec.size() && !progress; ++b)
+                    {
+                        if (!_RecycleFlag[b]) continue;
+
+                        bool ready = true;
+                        for (auto u : _SCCVec[b]) ready = ready && !done[u] && _UnitVec[u]->supportDirection(ProcObjBase::Forward);
+                        for (auto p = _BlockInPtr[b]; ready && p < _BlockInPtr[b+1]; ++p) ready = known[_BlockInIdx[p]];
+                        if (!ready) continue;
+
+                        DOFStep step;
+                        step.Block = b;
+                        res.StepVec.push_back(step);
+
+                        for (auto u : _SCCVec[b])
+                        {
+                            done[u] = true;
+                            for (auto s : outVec[u])
+                            {
+                                if (known[s] && _Producer[s] == u && compOf[u] == b)
+                                {
+                                    // 블록 밖으로 나가는 스트림이 이미 알려져 있으면 사양이 지나침.
+                                    bool external = (_ConsumerPtr[s] == _ConsumerPtr[s+1]);
+                                    for (auto p = _ConsumerPtr[s]; p < _ConsumerPtr[s+1]; ++p) external = external || compOf[_ConsumerIdx[p]] != b;
+                                    if (external && !functions::inVector(res.OverSpecified, _UnitVec[u])) res.OverSpecified.push_back(_UnitVec[u]);
+                                }
+                                known[s] = true;
+                            }
+                        }
+                        progress = true;
+                    }
+                }
+
+                for (auto u = 0; u < unitNum; ++u)
+                {
+                    if (!done[u]) res.UnderSpecified.push_back(_UnitVec[u]);
+                }
+                for (auto s = 0; s < streamNum; ++s)
+                {
+                    if (known[s]) continue;
+                    res.UnknownStream.push_back(_StreamVec[s]);
+                    res.UnknownNum += _StreamVec[s]->getChemNum();
+                }
+
+                res.Valid = res.OverSpecified.empty() && res.UnderSpecified.empty() && res.UnknownStream.empty();
+
+                return res;
+            }
+
+            /*
+            analyzeDOF로 정한 방향과 순서대로 단위 공정을 풂(solveDirection). 순환 블록 단계는 solve와 같이 절단 스트림이
+            수렴할 때까지 반복함. 사양이 지나치거나 모자라면 계산하기 전에 runtime error 발생.
+            */
+            std::vector<RecycleResult> solveDOF()
+            {
+                const auto dof = analyzeDOF();
+                if (!dof.OverSpecified.empty()) throw std::runtime_error("The flowsheet is over-specified.");
+                if (!dof.Valid) throw std::runtime_error("The flowsheet is under-specified.");
+
+                std::vector<RecycleResult> res;
+                _SolvedNum = 0;
+                for (const auto& step : dof.StepVec)
+                {
+                    if (step.Block >= 0)
+                    {
+                        res.push_back(_solveRecycle(step.Block, _Monitor));
+                        _SolvedNum += _BlockPtr[step.Block+1] - _BlockPtr[step.Block];
+                    }
+                    else
+                    {
+                        step.UnitPtr->solveDirection(step.Direction);
+                        ++_SolvedNum;
+                    }
+                }
+
+                _takeSnapshot(true);
+
+                return res;
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -0,0 +1,221 @@
+/*
+core/FlowsheetFamily/TearConverger.hpp
+--------------------------------------
+순환 공정의 절단 스트림(tear stream)을 수렴시키는 가속기 TearConverger 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_TEARCONVERGER
+#define _CHEMPROCHELPER_TEARCONVERGER
+
+namespace chemprochelper
+{
+    /*
+    순환 블록 하나의 수렴 결과를 저장함.
+    --------------------------------
+        Block : 계산 순서 상 블록(강연결 요소)의 인덱스.
+        TearIdx : 절단 스트림의 포인터.
+        IterNum : 블록을 계산한 횟수.
+        Converged : 허용 오차 안으로 수렴했는지의 여부.
+        ResidualVec : 반복마다의 상대 잔차 max|g(x) - x| / max|g(x)|.
+    */
+    struct RecycleResult
+    {
+        int Block = -1;
+        std::vector<StreamBase*> TearIdx;
+        int IterNum = 0;
+        bool Converged = false;
+        std::vector<double> ResidualVec;
+    };
+
+    /*
+    절단 스트림 수렴 가속기 클래스.
+    ---------------------------
+    절단 스트림의 몰 유량을 x, 순환 블록을 한 번 계산해 절단 스트림에 다시 나온 값을 g(x)라 할 때 x = g(x)를 풂.
+    update(x, g, xNew)는 매 반복의 (x, g(x))를 받아 다음 추정값을 계산하며, 다음 방법을 지원함.
+        Direct : 축차 대입(successive substitution). xNew = g
+        Wegstein : 성분별 할선 기울기 s = dg / dx로 q = s / (s - 1)을 구하고 [QMin, QMax]로 제한해
+                   xNew = q x + (1 - q) g. 첫 반복은 축차 대입.
+        Broyden : 잔차 f = g - x의 근을 역 야코비안 근사 H로 찾음. H0 = -I(첫 반복은 축차 대입)에서 시작해
+                  Broyden의 good update H += (dx - H df) dx^T H / (dx^T H df)로 갱신함.
+        Anderson : 최근 Depth개의 (x, f)로 min|f - dF c|를 풀고 xNew = x - dX c + Mixing (f - dF c).
+    몰 유량이 음수가 되지 않도록 xNew는 0 이상으로 자름.
+
+    TearConverger는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _Dim : 절단 변수의 수를 저장함.
+        _Method : 가속 방법을 저장함.
+        _QMin, _QMax : Wegstein q의 범위를 저장함.
+        _Depth, _Mixing : Anderson 가속의 이력 수와 혼합 계수를 저장함.
+        _IterNum : 지금까지 update를 호출한 횟수를 저장함.
+        _PrevX, _PrevG : 이전 반복의 x, g(x)를 저장함.
+        _InvJacob : Broyden의 역 야코비안 근사를 저장함.
+        _XHist, _FHist : Anderson 가속의 x, f 이력을 저장함.
+    */
+    class TearConverger
+    {
+        public:
+
+            // 가속 방법
+            enum MethodType {Direct, Wegstein, Broyden, Anderson};
+
+        private:
+
+            int _Dim = 0;
+            MethodType _Method = Wegstein;
+
+            // Wegstein 설정
+            double _QMin = -5.0;
+            double _QMax = 0.0;
+
+            // Anderson 설정
+            int _Depth = 5;
+            double _Mixing = 1.0;
+
+            // 반복 상태
+            int _IterNum = 0;
+            Eigen::VectorXd _PrevX, _PrevG;
+            Eigen::MatrixXd _InvJacob;
+            std::deque<Eigen::VectorXd> _XHist, _FHist;
+
+            void _updateWegstein(const Eigen::VectorXd& x, const Eigen::VectorXd& g, Eigen::VectorXd& xNew) const
+            {
+                xNew = g;
+                if (_IterNum == 0) return;
+
+                for (auto i = 0; i < _Dim; ++i)
+                {
+                    const double dx = x[i] - _PrevX[i];
+                    if (std::abs(dx) <= 1e-12 * std::max(std::abs(x[i]), 1.0)) continue;
+
+                    const double s = (g[i] - _PrevG[i]) / dx;
+                    double q = (s == 1.0) ? _QMin : s / (s - 1.0);
+                    q = std::clamp(q, _QMin, _QMax);
+                    xNew[i] = q * x[i] + (1.0 - q) * g[i];
+                }
+            }
+
+            void _updateBroyden(const Eigen::VectorXd& x, const Eigen::VectorXd& g, Eigen::VectorXd& xNew)
+            {
+                const Eigen::VectorXd f = g - x;
+
+                if (_IterNum > 0)
+                {
+                    const Eigen::VectorXd dx = x - _PrevX;
+                    const Eigen::VectorXd df = f - (_PrevG - _PrevX);
+                    const Eigen::VectorXd hdf = _InvJacob * df;
+                    const double denom = dx.dot(hdf);
+
+                    // 분모가 너무 작으면 축차 대입으로 다시 시작함.
+                    if (std::abs(denom) <= 1e-14 * dx.squaredNorm()) _InvJacob = -Eigen::MatrixXd::Identity(_Dim, _Dim);
+                    else _InvJacob += ((dx - hdf) / denom) * (dx.transpose() * _InvJacob);
+                }
+
+                xNew = x - _InvJacob * f;
+            }
+
+            void _updateAnderson(const Eigen::VectorXd& x, const Eigen::VectorXd& g, Eigen::VectorXd& xNew)
+            {
+                const Eigen::VectorXd f = g - x;
+
+                _XHist.push_back(x);
+                _FHist.push_back(f);
+                if (_XHist.size() > _Depth + 1)
+                {
+                    _XHist.pop_front();
+                    _FHist.pop_front();
+                }
+
+                const int m = _XHist.size() - 1;
+                if (m == 0)
+                {
+                    xNew = x + _Mixing * f;
+                    return;
+                }
+
+                Eigen::MatrixXd dX(_Dim, m), dF(_Dim, m);
+                for (auto j = 0; j < m; ++j)
+                {
+                    dX.col(j) = _XHist[j+1] - _XHist[j];
+                    dF.col(j) = _FHist[j+1] - _FHist[j];
+                }
+
+                const Eigen::VectorXd c = dF.colPivHouseholderQr().solve(f);
+                xNew = x - dX * c + _Mixing * (f - dF * c);
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            TearConverger() = default;
+
+            TearConverger(const int& Dim, const MethodType& Method = Wegstein):
+                _Method(Method)
+            {
+                reset(Dim);
+            }
+
+            // getter 정의부
+
+            int getDim() const {return _Dim;}
+            auto getMethod() const {return _Method;}
+            int getIterNum() const {return _IterNum;}
+
+            // setter 정의부
+
+            void setMethod(const MethodType& Method) {_Method = Method; reset(_Dim);}
+
+            // Wegstein q의 범위. 보통 -5 <= q <= 0을 사용함.
+            void setWegsteinBound(const double& QMin, const double& QMax)
+            {
+                if (QMin > QMax) throw std::runtime_error("The lower bound of Wegstein q is larger than the upper bound.");
+                _QMin = QMin;
+                _QMax = QMax;
+            }
+
+            void setAndersonDepth(const int& Depth)
+            {
+                if (Depth < 1) throw std::runtime_error("The depth of Anderson acceleration must be positive.");
+                _Depth = Depth;
+            }
+
+            void setMixing(const double& Mixing) {_Mixing = Mixing;}
+
+            // 인스턴스 정의부
+
+            // 반복 상태를 지우고 절단 변수의 수를 Dim으로 바꿈.
+            void reset(const int& Dim)
+            {
+                _Dim = Dim;
+                _IterNum = 0;
+                _PrevX.resize(0);
+                _PrevG.resize(0);
+                _XHist.clear();
+                _FHist.clear();
+                if (_Method == Broyden) _InvJacob = -Eigen::MatrixXd::Identity(Dim, Dim);
+                else _InvJacob.resize(0, 0);
+            }
+
+            // 현재 추정값 x와 블록을 계산한 결과 g(x)로 다음 추정값 xNew를 계산함.
+            void update(const Eigen::VectorXd& x, const Eigen::VectorXd& g, Eigen::VectorXd& xNew)
+            {
+                if (x.size() != _Dim || g.size() != _Dim) throw std::runtime_error("The size of tear variables does not match.");
+
+                switch (_Method)
+                {
+                    case Direct : xNew = g; break;
+                    case Wegstein : _updateWegstein(x, g, xNew); break;
+                    case Broyden : _updateBroyden(x, g, xNew); break;
+                    case Anderson : _updateAnderson(x, g, xNew); break;
+                }
+
+                xNew = xNew.cwiseMax(0.0);
+
+                _PrevX = x;
+                _PrevG = g;
+                ++_IterNum;
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
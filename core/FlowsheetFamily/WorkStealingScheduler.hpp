@@ -0,0 +1,277 @@
+/*
+core/FlowsheetFamily/WorkStealingScheduler.hpp
+----------------------------------------------
+의존 관계 DAG의 작업들을 work-stealing 방식으로 여러 스레드에서 실행하는 WorkStealingScheduler 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_WORKSTEALINGSCHEDULER
+#define _CHEMPROCHELPER_WORKSTEALINGSCHEDULER
+
+namespace chemprochelper
+{
+    /*
+    Work-stealing 작업 스케줄러 클래스.
+    --------------------------------
+    작업 t의 후속 작업(CSR: SuccPtr, SuccIdx)과 선행 작업 수(PredNum)로 주어진 DAG를 실행함.
+    스레드마다 작업 덱(deque)을 두고, 작업을 마치면 선행 작업 수가 0이 된 후속 작업을 자기 덱의 뒤에 넣고 뒤에서
+    꺼내며(LIFO, 방금 쓴 스트림을 바로 읽는 지역성), 자기 덱이 비면 다른 스레드의 덱 앞에서 훔쳐옴(FIFO).
+    선행 작업 수는 원자 변수로 줄이므로, 후속 작업은 선행 작업이 쓴 값(출력 스트림)을 모두 본 뒤에 시작함.
+    훔칠 작업도 없는 스레드는 대기 중인 작업이 생기거나 run이 끝날 때까지 condition_variable에서 기다림.
+    작업에서 예외가 발생하면 남은 작업을 멈추고 run이 끝날 때 다시 던짐.
+
+    작업 스레드는 처음 필요할 때 만들어 객체가 소멸할 때까지 유지하며, run 사이에는 condition_variable에서 잠듦.
+    run을 호출한 스레드가 0번 스레드로 참여하므로 작업 스레드는 (스레드 수 - 1)개임.
+    run은 여러 스레드에서 동시에 호출할 수 없음. 복사하면 스레드 수 설정만 복사함.
+
+    WorkStealingScheduler는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _ThreadNum : 사용할 스레드 수를 저장함. 0 이하이면 std::thread::hardware_concurrency()를 사용함.
+        _StealNum : 마지막 run에서 다른 스레드의 덱에서 훔쳐온 작업 수를 저장함.
+        _ThreadVec : 작업 스레드(1번부터)를 저장함.
+        _PoolMutex, _StartCV, _DoneCV : 작업 스레드를 깨우고 run의 끝을 기다리는 데 사용함.
+        _Work, _Epoch, _BusyNum, _Stop : 현재 run의 작업 함수, run의 번호, 아직 작업 함수를 마치지 않은 작업 스레드 수,
+                                         소멸 여부를 저장함.
+    */
+    class WorkStealingScheduler
+    {
+        private:
+
+            // 스레드별 작업 덱
+            struct _Queue
+            {
+                std::mutex Mutex;
+                std::deque<int> Task;
+            };
+
+            int _ThreadNum = 0;
+            int _StealNum = 0;
+
+            // 작업 스레드
+            std::vector<std::thread> _ThreadVec;
+            std::mutex _PoolMutex;
+            std::condition_variable _StartCV, _DoneCV;
+            std::function<void(const int&)> _Work;
+            std::uint64_t _Epoch = 0;
+            int _BusyNum = 0;
+            bool _Stop = false;
+
+            // 작업 스레드 tid의 본체. run마다 _Work(tid)를 한 번 실행함.
+            void _poolLoop(const int tid, std::uint64_t seen)
+            {
+                while (true)
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(_PoolMutex);
+                        _StartCV.wait(lock, [&]() {return _Stop || _Epoch != seen;});
+                        if (_Stop) return;
+                        seen = _Epoch;
+                    }
+
+                    _Work(tid);
+
+                    std::lock_guard<std::mutex> lock(_PoolMutex);
+                    if (--_BusyNum == 0) _DoneCV.notify_one();
+                }
+            }
+
+            // 작업 스레드가 ThreadNum - 1개 이상이 되도록 만듦.
+            void _growPool(const int& ThreadNum)
+            {
+                while (int(_ThreadVec.size()) + 1 < ThreadNum)
+                {
+                    _ThreadVec.emplace_back(&WorkStealingScheduler::_poolLoop, this, int(_ThreadVec.size()) + 1, _Epoch);
+                }
+            }
+
+            void _stopPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_PoolMutex);
+                    _Stop = true;
+                }
+                _StartCV.notify_all();
+                for (auto& th : _ThreadVec) th.join();
+                _ThreadVec.clear();
+                _Stop = false;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            WorkStealingScheduler() = default;
+
+            WorkStealingScheduler(const int& ThreadNum):
+                _ThreadNum(ThreadNum) {}
+
+            WorkStealingScheduler(const WorkStealingScheduler& Other):
+                _ThreadNum(Other._ThreadNum) {}
+
+            WorkStealingScheduler& operator=(const WorkStealingScheduler& Other)
+            {
+                _ThreadNum = Other._ThreadNum;
+                return *this;
+            }
+
+            ~WorkStealingScheduler()
+            {
+                _stopPool();
+            }
+
+            // getter 정의부
+
+            int getThreadNum() const {return _ThreadNum;}
+            int getStealNum() const {return _StealNum;}
+
+            // 지금 유지하고 있는 작업 스레드의 수를 반환함.
+            int getPoolSize() const {return _ThreadVec.size();}
+
+            // setter 정의부
+
+            void setThreadNum(const int& ThreadNum) {_ThreadNum = ThreadNum;}
+
+            // 인스턴스 정의부
+
+            // DAG의 모든 작업을 Task(작업 인덱스, 스레드 인덱스)로 실행함.
+            void run(const std::vector<int>& SuccPtr, const std::vector<int>& SuccIdx, const std::vector<int>& PredNum,
+                const std::function<void(const int&, const int&)>& Task)
+            {
+                const int taskNum = PredNum.size();
+                _StealNum = 0;
+                if (taskNum == 0) return;
+
+                int threadNum = (_ThreadNum <= 0) ? std::max<int>(1, std::thread::hardware_concurrency()) : _ThreadNum;
+                threadNum = std::max(1, std::min(threadNum, taskNum));
+
+                std::vector<std::atomic<int>> predVec(taskNum);
+                for (auto t = 0; t < taskNum; ++t) predVec[t].store(PredNum[t], std::memory_order_relaxed);
+
+                std::vector<std::unique_ptr<_Queue>> queueVec;
+                for (auto tid = 0; tid < threadNum; ++tid) queueVec.emplace_back(new _Queue());
+
+                // 처음 실행할 수 있는 작업은 스레드에 번갈아 나눔.
+                int readyNum = 0;
+                for (auto t = 0; t < taskNum; ++t)
+                {
+                    if (PredNum[t] == 0) queueVec[readyNum++ % threadNum]->Task.push_back(t);
+                }
+                if (readyNum == 0) throw std::runtime_error("The task graph has no task to start.");
+
+                std::atomic<int> remainNum(taskNum);
+                std::atomic<bool> abort(false);
+                std::atomic<int> stealNum(0);
+                std::vector<std::exception_ptr> errVec(threadNum);
+
+                // 덱에 있는 작업 수. 늘리는 쪽은 idleMutex를 잡고 늘려, 기다리는 스레드가 알림을 놓치지 않게 함.
+                std::atomic<int> queuedNum(readyNum);
+                std::mutex idleMutex;
+                std::condition_variable idleCV;
+
+                auto finish = [&]()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(idleMutex);
+                    }
+                    idleCV.notify_all();
+                };
+
+                auto worker = [&](const int& tid)
+                {
+                    if (tid >= threadNum) return;
+                    auto& own = *queueVec[tid];
+
+                    while (remainNum.load(std::memory_order_acquire) > 0 && !abort.load(std::memory_order_relaxed))
+                    {
+                        int t = -1;
+                        {
+                            std::lock_guard<std::mutex> lock(own.Mutex);
+                            if (!own.Task.empty())
+                            {
+                                t = own.Task.back();
+                                own.Task.pop_back();
+                            }
+                        }
+
+                        for (auto k = 1; t < 0 && k < threadNum; ++k)
+                        {
+                            auto& victim = *queueVec[(tid + k) % threadNum];
+                            std::lock_guard<std::mutex> lock(victim.Mutex);
+                            if (!victim.Task.empty())
+                            {
+                                t = victim.Task.front();
+                                victim.Task.pop_front();
+                                stealNum.fetch_add(1, std::memory_order_relaxed);
+                            }
+                        }
+
+                        if (t < 0)
+                        {
+                            std::unique_lock<std::mutex> lock(idleMutex);
+                            idleCV.wait(lock, [&]()
+                            {
+                                return queuedNum.load() > 0 || remainNum.load() == 0 || abort.load();
+                            });
+                            continue;
+                        }
+                        queuedNum.fetch_sub(1, std::memory_order_relaxed);
+
+                        try
+                        {
+                            Task(t, tid);
+                        }
+                        catch (...)
+                        {
+                            errVec[tid] = std::current_exception();
+                            abort.store(true);
+                            finish();
+                            return;
+                        }
+
+                        for (auto p = SuccPtr[t]; p < SuccPtr[t+1]; ++p)
+                        {
+                            const int succ = SuccIdx[p];
+                            if (predVec[succ].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                            {
+                                {
+                                    std::lock_guard<std::mutex> idleLock(idleMutex);
+                                    std::lock_guard<std::mutex> lock(own.Mutex);
+                                    own.Task.push_back(succ);
+                                    queuedNum.fetch_add(1, std::memory_order_relaxed);
+                                }
+                                idleCV.notify_one();
+                            }
+                        }
+
+                        if (remainNum.fetch_sub(1, std::memory_order_acq_rel) == 1) finish();
+                    }
+                };
+
+                // 작업 스레드를 깨워 worker를 실행하고, 호출한 스레드도 0번 스레드로 참여함.
+                _growPool(threadNum);
+                {
+                    std::lock_guard<std::mutex> lock(_PoolMutex);
+                    _Work = worker;
+                    _BusyNum = _ThreadVec.size();
+                    ++_Epoch;
+                }
+                _StartCV.notify_all();
+
+                worker(0);
+
+                {
+                    std::unique_lock<std::mutex> lock(_PoolMutex);
+                    _DoneCV.wait(lock, [&]() {return _BusyNum == 0;});
+                    _Work = nullptr;
+                }
+
+                _StealNum = stealNum.load();
+
+                for (auto& err : errVec)
+                {
+                    if (err) std::rethrow_exception(err);
+                }
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -127,6 +127,9 @@ namespace chemprochelper
             {"Ts", 292.0},
             {"Og", 295.0}
         };
+        // 기체 상수 (J/mol/K)
+        const double gasConst = 8.314462618;
+
         const std::regex pat_big("([0-9|.]{0,})([A-Za-z0-9\\(\\)]{1,})");
         const std::regex pat_sml("([A-Z][a-z]?)(\\d{0,})");
         const std::regex pat_bra("([A-Z][a-z]?|\\((?:[^()]*(?:\\(.*\\))?[^()]*)+\\))(\\d*)");
@@ -3,4 +3,10 @@ core/RxnFamily.hpp
 ------------------
 변종 화학 반응식들을 정의함.
 */
-#include "RxnFamily/SpeedRxnBase.hpp"
\ No newline at end of file
+#include "RxnFamily/RateExprVM.hpp"
+#include "RxnFamily/CompiledMech.hpp"
+#include "RxnFamily/SpeedRxnBase.hpp"
+#include "RxnFamily/MechCodeGen.hpp"
+#include "RxnFamily/SSAEngine.hpp"
+#include "RxnFamily/SparseBDF.hpp"
+#include "RxnFamily/MechReducer.hpp"
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+core/RxnFamily/CompiledMech.hpp
+-------------------------------
+MechCodeGen이 생성해 컴파일한 반응 메커니즘 공유 라이브러리를 불러오는 CompiledMech 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_COMPILEDMECH
+#define _CHEMPROCHELPER_COMPILEDMECH
+
+namespace chemprochelper
+{
+    /*
+    컴파일된 반응 메커니즘(공유 라이브러리)을 불러와 호출하는 클래스.
+    ------------------------------------------------------------
+    공유 라이브러리는 다음 함수들을 extern "C"로 제공해야 함. (Prefix는 MechCodeGen에서 지정한 접두어)
+        Prefix_info(int* chemNum, int* rxnNum, int* nnz)
+        Prefix_jac_pattern(int* rxnIdx, int* chemIdx)
+        Prefix_rate(const double* c, double T, double* r)
+        Prefix_rate_batch(const double* c, int n, double T, double* r)
+        Prefix_lnq(const double* c, double* lnq)
+        Prefix_wdot(const double* c, double T, double* wdot)
+        Prefix_jac(const double* c, double T, double* val)
+    CompiledMech는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _Handle : 공유 라이브러리의 핸들을 저장함.
+        _ChemNum, _RxnNum, _JacobNnz : 화학종 수, 반응 수, Jacobian의 0이 아닌 원소 수를 저장함.
+        _JacobRxnIdx, _JacobChemIdx : Jacobian의 희소 패턴(반응, 화학종)을 저장함.
+    */
+    class CompiledMech
+    {
+        public:
+
+            using InfoFuncType = void(*)(int*, int*, int*);
+            using PatternFuncType = void(*)(int*, int*);
+            using RateFuncType = void(*)(const double*, double, double*);
+            using BatchFuncType = void(*)(const double*, int, double, double*);
+            using LnQFuncType = void(*)(const double*, double*);
+
+        private:
+
+            // 공유 라이브러리의 핸들을 저장함.
+            void* _Handle = nullptr;
+
+            // 메커니즘의 크기를 저장함.
+            int _ChemNum = 0;
+            int _RxnNum = 0;
+            int _JacobNnz = 0;
+
+            // Jacobian의 희소 패턴을 저장함.
+            std::vector<int> _JacobRxnIdx;
+            std::vector<int> _JacobChemIdx;
+
+            // 공유 라이브러리의 함수 포인터를 저장함.
+            RateFuncType _RateFunc = nullptr;
+            BatchFuncType _RateBatchFunc = nullptr;
+            LnQFuncType _LnQFunc = nullptr;
+            RateFuncType _WdotFunc = nullptr;
+            RateFuncType _JacobFunc = nullptr;
+
+            // 공유 라이브러리에서 심볼을 찾음. 없으면 runtime error 발생.
+            void* _getSym(const std::string& name)
+            {
+                #ifdef _WIN32
+                void* sym = reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(_Handle), name.c_str()));
+                #else
+                void* sym = dlsym(_Handle, name.c_str());
+                #endif
+
+                if (sym == nullptr) throw std::runtime_error("Symbol " + name + " isn't in compiled mechanism.");
+                return sym;
+            }
+
+            void _close()
+            {
+                if (_Handle == nullptr) return;
+
+                #ifdef _WIN32
+                FreeLibrary(static_cast<HMODULE>(_Handle));
+                #else
+                dlclose(_Handle);
+                #endif
+
+                _Handle = nullptr;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            CompiledMech() = default;
+
+            // 공유 라이브러리 LibPath를 열고 Prefix_* 함수들을 불러옴.
+            CompiledMech(const std::string& LibPath, const std::string& Prefix)
+            {
+                #ifdef _WIN32
+                _Handle = static_cast<void*>(LoadLibraryA(LibPath.c_str()));
+                #else
+                _Handle = dlopen(LibPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+                #endif
+
+                if (_Handle == nullptr) throw std::runtime_error("Can't open compiled mechanism " + LibPath);
+
+                auto infoFunc = reinterpret_cast<InfoFuncType>(_getSym(Prefix + "_info"));
+                auto patternFunc = reinterpret_cast<PatternFuncType>(_getSym(Prefix + "_jac_pattern"));
+                _RateFunc = reinterpret_cast<RateFuncType>(_getSym(Prefix + "_rate"));
+                _RateBatchFunc = reinterpret_cast<BatchFuncType>(_getSym(Prefix + "_rate_batch"));
+                _LnQFunc = reinterpret_cast<LnQFuncType>(_getSym(Prefix + "_lnq"));
+                _WdotFunc = reinterpret_cast<RateFuncType>(_getSym(Prefix + "_wdot"));
+                _JacobFunc = reinterpret_cast<RateFuncType>(_getSym(Prefix + "_jac"));
+
+                infoFunc(&_ChemNum, &_RxnNum, &_JacobNnz);
+                _JacobRxnIdx.resize(_JacobNnz);
+                _JacobChemIdx.resize(_JacobNnz);
+                patternFunc(_JacobRxnIdx.data(), _JacobChemIdx.data());
+            }
+
+            // 공유 라이브러리 핸들은 복사할 수 없음.
+            CompiledMech(const CompiledMech&) = delete;
+            CompiledMech& operator=(const CompiledMech&) = delete;
+
+            CompiledMech(CompiledMech&& other)
+            {
+                *this = std::move(other);
+            }
+
+            CompiledMech& operator=(CompiledMech&& other)
+            {
+                if (this == &other) return *this;
+
+                _close();
+                _Handle = other._Handle;
+                _ChemNum = other._ChemNum;
+                _RxnNum = other._RxnNum;
+                _JacobNnz = other._JacobNnz;
+                _JacobRxnIdx = std::move(other._JacobRxnIdx);
+                _JacobChemIdx = std::move(other._JacobChemIdx);
+                _RateFunc = other._RateFunc;
+                _RateBatchFunc = other._RateBatchFunc;
+                _LnQFunc = other._LnQFunc;
+                _WdotFunc = other._WdotFunc;
+                _JacobFunc = other._JacobFunc;
+                other._Handle = nullptr;
+
+                return *this;
+            }
+
+            ~CompiledMech()
+            {
+                _close();
+            }
+
+            // getter 정의부
+
+            int getChemNum() const {return _ChemNum;}
+            int getRxnNum() const {return _RxnNum;}
+            int getJacobNnz() const {return _JacobNnz;}
+            auto getJacobRxnIdx() const {return _JacobRxnIdx;}
+            auto getJacobChemIdx() const {return _JacobChemIdx;}
+            bool isLoaded() const {return _Handle != nullptr;}
+
+            // 인스턴스 정의부
+
+            // 반응 속도를 계산함.
+            void calcRate(const double* conc, const double& Temp, double* rate) const {_RateFunc(conc, Temp, rate);}
+
+            // stateNum개의 상태(상태마다 화학종 수 간격)에 대해 반응 속도를 계산함.
+            void calcRateBatch(const double* concMat, const int& stateNum, const double& Temp, double* rateMat) const
+            {
+                _RateBatchFunc(concMat, stateNum, Temp, rateMat);
+            }
+
+            // 반응별 ln Q를 계산함.
+            void calcLnQ(const double* conc, double* lnQ) const {_LnQFunc(conc, lnQ);}
+
+            // 화학종별 생성 속도(v * r)를 계산함.
+            void calcWdot(const double* conc, const double& Temp, double* wdot) const {_WdotFunc(conc, Temp, wdot);}
+
+            // 희소 Jacobian(d r / d c)의 값을 getJacobRxnIdx(), getJacobChemIdx() 순서로 계산함.
+            void calcJacobSparse(const double* conc, const double& Temp, double* val) const {_JacobFunc(conc, Temp, val);}
+
+            // Jacobian(d r / d c)을 (반응 수) x (화학종 수) 크기의 column-major 배열로 계산함.
+            void calcJacobDense(const double* conc, const double& Temp, double* jac) const
+            {
+                std::vector<double> val(_JacobNnz);
+                _JacobFunc(conc, Temp, val.data());
+
+                std::fill(jac, jac + _ChemNum * _RxnNum, 0.0);
+                for (auto k = 0; k < _JacobNnz; ++k) jac[_JacobChemIdx[k] * _RxnNum + _JacobRxnIdx[k]] = val[k];
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
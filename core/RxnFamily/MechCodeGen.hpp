@@ -0,0 +1,417 @@
+/*
+core/RxnFamily/MechCodeGen.hpp
+------------------------------
+SpeedRxnBase의 반응 메커니즘으로부터 C++ 코드를 생성하고 컴파일하는 MechCodeGen 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_MECHCODEGEN
+#define _CHEMPROCHELPER_MECHCODEGEN
+
+namespace chemprochelper
+{
+    // MechCodeGen::benchmark의 결과. 시간은 상태 하나당 초 단위임.
+    struct MechBenchResult
+    {
+        double GenericTime = 0;
+        double CompiledTime = 0;
+        double MaxDiff = 0;
+    };
+
+    /*
+    반응 메커니즘을 미리(ahead-of-time) C++ 코드로 생성하는 클래스.
+    -----------------------------------------------------------
+    화학종 수, 반응 수, 반응 계수, 반응 차수를 상수로 박아 넣은 직선 코드를 만들어,
+    일반 경로(CSR 순회, std::pow, Eigen 밀집 행렬 곱)의 분기와 0 곱셈을 컴파일 타임에 없앰.
+    생성하는 함수는 CompiledMech에 정리된 Prefix_* 함수들이며, Jacobian은 0이 아닌 원소만 계산함.
+        PowerLaw, Arrhenius, MassAction, LangmuirHinshelwood : 차수가 정수(<= 4)이면 곱셈으로 전개함.
+        Expression : RateExprVM이 컴파일한 명령어를 그대로 직선 코드로 옮김.
+        Custom : std::function은 코드로 옮길 수 없으므로 지원하지 않음.
+    MechCodeGen은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _RxnPtr : 코드를 생성할 SpeedRxnBase 객체의 포인터를 저장함.
+        _Prefix : 생성하는 함수 이름의 접두어를 저장함.
+        _JacobRxnIdx, _JacobChemIdx : 생성한 Jacobian의 희소 패턴(반응, 화학종)을 저장함.
+    */
+    class MechCodeGen
+    {
+        private:
+
+            // 코드를 생성할 화학 반응식의 포인터를 저장함.
+            SpeedRxnBase* _RxnPtr = nullptr;
+
+            // 함수 이름의 접두어를 저장함.
+            std::string _Prefix;
+
+            // Jacobian의 희소 패턴을 저장함. generateSource()에서 채움.
+            std::vector<int> _JacobRxnIdx;
+            std::vector<int> _JacobChemIdx;
+
+            // 실수를 손실 없이 문자열로 바꿈.
+            static std::string _numStr(const double& val)
+            {
+                std::ostringstream ss;
+                ss.precision(17);
+                ss << val;
+                if (ss.str().find_first_not_of("-0123456789") == std::string::npos) ss << ".0";
+
+                return ss.str();
+            }
+
+            // c^ord 를 코드로 만듦. 정수 차수(<= 4)는 곱셈으로 전개함.
+            static std::string _powStr(const std::string& c, const double& ord)
+            {
+                if (ord == 1) return c;
+                if (ord == std::floor(ord) && ord >= 2 && ord <= 4)
+                {
+                    std::string res = "(" + c;
+                    for (auto k = 1; k < ord; ++k) res += " * " + c;
+                    return res + ")";
+                }
+
+                return "std::pow(" + c + ", " + _numStr(ord) + ")";
+            }
+
+            // c_idx[p]^ord[p] 들의 곱을 코드로 만듦. skip 위치는 제외함.
+            static std::string _prodStr(const std::vector<int>& idx, const std::vector<double>& ord, const int& skip = -1)
+            {
+                std::string res;
+                for (auto p = 0; p < idx.size(); ++p)
+                {
+                    if (p == skip) continue;
+                    res += " * " + _powStr("c[" + std::to_string(idx[p]) + "]", ord[p]);
+                }
+
+                return res;
+            }
+
+            // 속도 상수를 코드로 만듦. 활성화 에너지가 0이면 상수로 둠.
+            static std::string _rateConstStr(const double& PreExp, const double& ActEnergy)
+            {
+                if (ActEnergy == 0) return _numStr(PreExp);
+                return _numStr(PreExp) + " * std::exp(" + _numStr(-ActEnergy / const_variables::gasConst) + " / T)";
+            }
+
+            // 차수 행렬의 j번째 반응을 (화학종 인덱스, 차수) 목록으로 바꿈.
+            static void _getOrderRow(const std::vector<std::vector<float>>& OrderMat, const int& j,
+                std::vector<int>& idx, std::vector<double>& ord)
+            {
+                idx.clear();
+                ord.clear();
+                for (auto i = 0; i < OrderMat[j].size(); ++i)
+                {
+                    if (OrderMat[j][i] == 0) continue;
+                    idx.push_back(i);
+                    ord.push_back(OrderMat[j][i]);
+                }
+            }
+
+            /*
+            내장 속도식의 rate, jac 함수 본문을 만듦. Jacobian 패턴은 반응물, 생성물의 화학종과,
+            분모가 있는 반응의 경우 흡착 상수가 0이 아닌 화학종으로 정함.
+            */
+            void _emitBuiltin(std::ostringstream& rateSrc, std::ostringstream& jacSrc)
+            {
+                const int chemNum = _RxnPtr->getChemNum();
+                const int rxnNum = _RxnPtr->getRxnNum();
+
+                const auto fwdOrder = _RxnPtr->getOrderMat(true);
+                const auto revOrder = _RxnPtr->getOrderMat(false);
+                const auto fwdPreExp = _RxnPtr->getFwdPreExp();
+                const auto fwdActEnergy = _RxnPtr->getFwdActEnergy();
+                const auto revPreExp = _RxnPtr->getRevPreExp();
+                const auto revActEnergy = _RxnPtr->getRevActEnergy();
+                const auto adsK = _RxnPtr->getAdsK();
+                const auto inhibExp = _RxnPtr->getInhibExp();
+
+                // 흡착항의 분모 D = 1 + sum_i K_i c_i
+                std::string denomStr = "1.0";
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (adsK[i] != 0) denomStr += " + " + _numStr(adsK[i]) + " * c[" + std::to_string(i) + "]";
+                }
+
+                bool hasDenom = false;
+                for (auto j = 0; j < rxnNum; ++j) hasDenom = hasDenom || (inhibExp[j] != 0);
+
+                if (hasDenom)
+                {
+                    rateSrc << "    const double D = " << denomStr << ";\n";
+                    jacSrc << "    const double D = " << denomStr << ";\n";
+                }
+
+                std::vector<int> fwdIdx, revIdx;
+                std::vector<double> fwdOrd, revOrd;
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    _getOrderRow(fwdOrder, j, fwdIdx, fwdOrd);
+                    _getOrderRow(revOrder, j, revIdx, revOrd);
+
+                    const std::string js = std::to_string(j);
+                    const bool hasRev = (revPreExp[j] != 0);
+                    const std::string inhibStr = (inhibExp[j] == 0) ? "" : " * std::pow(D, " + _numStr(-inhibExp[j]) + ")";
+
+                    // 속도
+                    std::string kDecl = "        const double kf = " + _rateConstStr(fwdPreExp[j], fwdActEnergy[j]) + ";\n";
+                    if (hasRev) kDecl += "        const double kr = " + _rateConstStr(revPreExp[j], revActEnergy[j]) + ";\n";
+
+                    std::string rateStr = "(kf" + _prodStr(fwdIdx, fwdOrd);
+                    if (hasRev) rateStr += " - kr" + _prodStr(revIdx, revOrd);
+                    rateStr += ")" + inhibStr;
+
+                    rateSrc << "    {\n" << kDecl << "        r[" << js << "] = " << rateStr << ";\n    }\n";
+
+                    // Jacobian. 반응 j에 대해 화학종별 도함수를 모아 한 번에 씀.
+                    std::map<int, std::string> derivMap;
+                    for (auto p = 0; p < fwdIdx.size(); ++p)
+                    {
+                        derivMap[fwdIdx[p]] += " + kf * " + ((fwdOrd[p] == 1) ? std::string("1.0") : _numStr(fwdOrd[p]) + " * " +
+                            _powStr("c[" + std::to_string(fwdIdx[p]) + "]", fwdOrd[p] - 1)) + _prodStr(fwdIdx, fwdOrd, p);
+                    }
+                    for (auto p = 0; hasRev && p < revIdx.size(); ++p)
+                    {
+                        derivMap[revIdx[p]] += " - kr * " + ((revOrd[p] == 1) ? std::string("1.0") : _numStr(revOrd[p]) + " * " +
+                            _powStr("c[" + std::to_string(revIdx[p]) + "]", revOrd[p] - 1)) + _prodStr(revIdx, revOrd, p);
+                    }
+                    if (inhibExp[j] != 0)
+                    {
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            if (adsK[i] != 0) derivMap[i];
+                        }
+                    }
+                    if (derivMap.empty()) continue;
+
+                    jacSrc << "    {\n" << kDecl;
+                    if (inhibExp[j] != 0) jacSrc << "        const double rj = " << rateStr << ";\n";
+
+                    for (const auto& deriv : derivMap)
+                    {
+                        const int i = deriv.first;
+                        std::string valStr = deriv.second.empty() ? "0.0" : "(0.0" + deriv.second + ")" + inhibStr;
+                        if (inhibExp[j] != 0 && adsK[i] != 0) valStr += " - rj * " + _numStr(inhibExp[j] * adsK[i]) + " / D";
+
+                        jacSrc << "        val[" << _JacobRxnIdx.size() << "] = " << valStr << ";\n";
+                        _JacobRxnIdx.push_back(j);
+                        _JacobChemIdx.push_back(i);
+                    }
+                    jacSrc << "    }\n";
+                }
+            }
+
+            // Expression 속도식의 rate, jac 함수 본문을 RateExprVM의 명령어로부터 만듦.
+            void _emitExpression(std::ostringstream& rateSrc, std::ostringstream& jacSrc)
+            {
+                const auto& vm = _RxnPtr->getExprVM();
+                const int rxnNum = _RxnPtr->getRxnNum();
+                const auto mask = vm.getJacobMask();
+
+                std::vector<int> jacSlot(mask.size(), -1);
+                for (auto k = 0; k < mask.size(); ++k)
+                {
+                    if (!mask[k]) continue;
+                    jacSlot[k] = _JacobRxnIdx.size();
+                    _JacobRxnIdx.push_back(k % rxnNum);
+                    _JacobChemIdx.push_back(k / rxnNum);
+                }
+
+                rateSrc << "    {\n" << vm.emitCpp(false, "c", {"T"}, "r") << "    }\n";
+                jacSrc << "    {\n    double r[" << rxnNum << "];\n" << vm.emitCpp(true, "c", {"T"}, "r", "val", jacSlot) << "    }\n";
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            MechCodeGen(SpeedRxnBase* RxnPtr, const std::string& Prefix):
+                _RxnPtr(RxnPtr), _Prefix(Prefix)
+            {
+                if (_RxnPtr == nullptr) throw std::runtime_error("MechCodeGen needs a reaction.");
+            }
+
+            // getter 정의부
+
+            auto getPrefix() const {return _Prefix;}
+            int getJacobNnz() const {return _JacobRxnIdx.size();}
+            auto getJacobRxnIdx() const {return _JacobRxnIdx;}
+            auto getJacobChemIdx() const {return _JacobChemIdx;}
+
+            // 인스턴스 정의부
+
+            // 반응 메커니즘의 C++ 소스 코드를 생성해 반환함.
+            std::string generateSource()
+            {
+                const auto rateLaw = _RxnPtr->getSourceRateLaw();
+                if (rateLaw == SpeedRxnBase::Custom) throw std::runtime_error("Custom rate law can't be converted to source code.");
+
+                const int chemNum = _RxnPtr->getChemNum();
+                const int rxnNum = _RxnPtr->getRxnNum();
+                const auto effiMat = _RxnPtr->getEffiMat();
+
+                _JacobRxnIdx.clear();
+                _JacobChemIdx.clear();
+
+                std::ostringstream rateSrc, jacSrc;
+                if (rateLaw == SpeedRxnBase::Expression) _emitExpression(rateSrc, jacSrc);
+                else _emitBuiltin(rateSrc, jacSrc);
+
+                const std::string fn = "static inline void " + _Prefix;
+                const std::string ex = "MECH_EXPORT void " + _Prefix;
+
+                std::ostringstream src;
+                src << "// " << _Prefix << " : generated by chemprochelper::MechCodeGen\n";
+                const auto chemIdx = _RxnPtr->getChemIdx();
+                for (auto i = 0; i < chemNum; ++i) src << "// c[" << i << "] : " << chemIdx[i]->getName() << "\n";
+                src << "#include <cmath>\n\n";
+                src << "#ifdef _WIN32\n#define MECH_EXPORT extern \"C\" __declspec(dllexport)\n#else\n#define MECH_EXPORT extern \"C\"\n#endif\n\n";
+
+                src << fn << "_rate_impl(const double* c, double T, double* r)\n{\n    (void)T;\n" << rateSrc.str() << "}\n\n";
+
+                src << ex << "_info(int* chemNum, int* rxnNum, int* nnz)\n{\n";
+                src << "    *chemNum = " << chemNum << ";\n    *rxnNum = " << rxnNum << ";\n    *nnz = " << _JacobRxnIdx.size() << ";\n}\n\n";
+
+                src << ex << "_jac_pattern(int* rxnIdx, int* chemIdx)\n{\n";
+                for (auto k = 0; k < _JacobRxnIdx.size(); ++k)
+                {
+                    src << "    rxnIdx[" << k << "] = " << _JacobRxnIdx[k] << "; chemIdx[" << k << "] = " << _JacobChemIdx[k] << ";\n";
+                }
+                src << "}\n\n";
+
+                src << ex << "_rate(const double* c, double T, double* r)\n{\n    " << _Prefix << "_rate_impl(c, T, r);\n}\n\n";
+
+                src << ex << "_rate_batch(const double* c, int n, double T, double* r)\n{\n";
+                src << "    for (int s = 0; s < n; ++s) " << _Prefix << "_rate_impl(c + s * " << chemNum << ", T, r + s * " << rxnNum << ");\n}\n\n";
+
+                // ln Q_j = sum_i v_ij ln c_i
+                src << ex << "_lnq(const double* c, double* lnq)\n{\n";
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    src << "    lnq[" << j << "] = 0.0";
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (effiMat(i, j) != 0) src << " + " << _numStr(effiMat(i, j)) << " * std::log(c[" << i << "])";
+                    }
+                    src << ";\n";
+                }
+                src << "}\n\n";
+
+                // wdot_i = sum_j v_ij r_j
+                src << ex << "_wdot(const double* c, double T, double* w)\n{\n";
+                src << "    double r[" << rxnNum << "];\n    " << _Prefix << "_rate_impl(c, T, r);\n";
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    src << "    w[" << i << "] = 0.0";
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        if (effiMat(i, j) != 0) src << " + " << _numStr(effiMat(i, j)) << " * r[" << j << "]";
+                    }
+                    src << ";\n";
+                }
+                src << "}\n\n";
+
+                src << ex << "_jac(const double* c, double T, double* val)\n{\n    (void)T;\n" << jacSrc.str() << "}\n";
+
+                return src.str();
+            }
+
+            // 생성한 소스 코드를 SrcPath에 저장함.
+            void writeSource(const std::string& SrcPath)
+            {
+                std::ofstream file(SrcPath);
+                if (!file) throw std::runtime_error("Can't write " + SrcPath);
+                file << generateSource();
+            }
+
+            /*
+            소스 코드를 SrcPath에 저장하고 Compiler로 LibPath에 공유 라이브러리를 만든 뒤 불러옴.
+            Compiler 뒤에 "SrcPath -o LibPath"를 붙여 실행함.
+            */
+            CompiledMech build(const std::string& SrcPath, const std::string& LibPath,
+                const std::string& Compiler = "g++ -O3 -march=native -shared -fPIC")
+            {
+                writeSource(SrcPath);
+
+                const std::string cmd = Compiler + " \"" + SrcPath + "\" -o \"" + LibPath + "\"";
+                if (std::system(cmd.c_str()) != 0) throw std::runtime_error("Failed to compile mechanism : " + cmd);
+
+                return CompiledMech(LibPath, _Prefix);
+            }
+
+            /*
+            일반 경로와 컴파일된 경로의 속도를 stateNum개의 임의 상태에 대해 repeat번 비교함.
+            일반 경로 : SpeedRxnBase::calcRateJacobian + Eigen 밀집 행렬(v * r, v^T ln c, v * J)
+            컴파일된 경로 : CompiledMech의 wdot, lnq, 희소 Jacobian
+            MaxDiff는 두 경로의 wdot, ln Q의 최대 상대 오차임.
+            */
+            static MechBenchResult benchmark(SpeedRxnBase& Rxn, const CompiledMech& Mech, const int& stateNum = 1000, const int& repeat = 10)
+            {
+                // 일반 경로는 컴파일되기 전의 속도식을 사용함.
+                const auto mechPtr = Rxn.getCompiledMech();
+                const bool wasCompiled = (Rxn.getRateLaw() == SpeedRxnBase::Compiled);
+                if (wasCompiled) Rxn.setCompiledMech(nullptr);
+
+                const int chemNum = Rxn.getChemNum();
+                const int rxnNum = Rxn.getRxnNum();
+                const double Temp = Rxn.getTemp();
+                const auto effiMat = Rxn.getEffiMat();
+                const Eigen::MatrixXd stoiMat = effiMat.block(0, 0, chemNum, rxnNum).cast<double>();
+
+                std::mt19937 gen(0);
+                std::uniform_real_distribution<double> dist(0.1, 2.0);
+                std::vector<double> concMat(chemNum * stateNum);
+                for (auto& c : concMat) c = dist(gen);
+
+                Eigen::MatrixXd genWdot(chemNum, stateNum), genLnQ(rxnNum, stateNum);
+                Eigen::MatrixXd cmpWdot(chemNum, stateNum), cmpLnQ(rxnNum, stateNum);
+                Eigen::VectorXd rate(rxnNum);
+                Eigen::MatrixXd jac(rxnNum, chemNum), wdotJac(chemNum, chemNum);
+                std::vector<double> jacVal(Mech.getJacobNnz());
+                double checkSum = 0;
+
+                MechBenchResult res;
+
+                auto start = std::chrono::steady_clock::now();
+                for (auto rep = 0; rep < repeat; ++rep)
+                {
+                    for (auto s = 0; s < stateNum; ++s)
+                    {
+                        Eigen::Map<const Eigen::VectorXd> conc(concMat.data() + s * chemNum, chemNum);
+                        Rxn.calcRateJacobian(conc.data(), rate.data(), jac.data());
+                        genWdot.col(s).noalias() = stoiMat * rate;
+                        genLnQ.col(s).noalias() = stoiMat.transpose() * conc.array().log().matrix();
+                        wdotJac.noalias() = stoiMat * jac;
+                        checkSum += wdotJac(0, 0);
+                    }
+                }
+                res.GenericTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / (stateNum * repeat);
+
+                start = std::chrono::steady_clock::now();
+                for (auto rep = 0; rep < repeat; ++rep)
+                {
+                    for (auto s = 0; s < stateNum; ++s)
+                    {
+                        const double* conc = concMat.data() + s * chemNum;
+                        Mech.calcWdot(conc, Temp, cmpWdot.col(s).data());
+                        Mech.calcLnQ(conc, cmpLnQ.col(s).data());
+                        Mech.calcJacobSparse(conc, Temp, jacVal.data());
+                        checkSum += jacVal.empty() ? 0 : jacVal[0];
+                    }
+                }
+                res.CompiledTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / (stateNum * repeat);
+
+                auto relDiff = [](const Eigen::MatrixXd& a, const Eigen::MatrixXd& b)
+                {
+                    return ((a - b).array().abs() / (1 + a.array().abs())).maxCoeff();
+                };
+                res.MaxDiff = std::max(relDiff(genWdot, cmpWdot), relDiff(genLnQ, cmpLnQ));
+
+                // 최적화로 계산이 지워지지 않도록 checkSum을 사용함.
+                if (std::isnan(checkSum)) res.MaxDiff = checkSum;
+
+                if (wasCompiled) Rxn.setCompiledMech(mechPtr);
+
+                return res;
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
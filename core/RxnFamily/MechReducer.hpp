@@ -0,0 +1,645 @@
+/*
+core/RxnFamily/MechReducer.hpp
+------------------------------
+DRG/DRGEP(directed relation graph)로 SpeedRxnBase의 반응 메커니즘을 축소하는 MechReducer 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_MECHREDUCER
+#define _CHEMPROCHELPER_MECHREDUCER
+
+namespace chemprochelper
+{
+    /*
+    MechReducer의 축소 결과를 저장함.
+    ------------------------------
+        Rxn : 축소된 반응식과 속도식.
+        ChemIdx : 남은 화학종(Rxn.getChemIdx()와 같음).
+        RxnIdx : 남은 반응의 원래 반응식 상 위치.
+        Threshold : 사용한 중요도 문턱값. 중요도가 Threshold 이상인 화학종만 남음.
+        MaxError : 검증 조건에서 대상 화학종의 최대 상대 오차. 검증하지 않았으면 -1.
+        ValidNum : 축소 중 검증한 후보 메커니즘의 수.
+    */
+    struct ReductionResult
+    {
+        SpeedRxnBase Rxn;
+        std::vector<ChemBase*> ChemIdx;
+        std::vector<int> RxnIdx;
+        double Threshold = 0;
+        double MaxError = -1;
+        int ValidNum = 0;
+    };
+
+    /*
+    DRG/DRGEP 메커니즘 축소 클래스.
+    -----------------------------
+    반응기 상태(농도, 온도)의 표본마다 화학종 사이의 결합 계수를 반응식의 계수와 반응 속도로 계산함.
+        r_AB = |sum_j nu_Aj w_j delta_Bj| / max(P_A, C_A)
+        P_A = sum_j max(nu_Aj w_j, 0), C_A = sum_j max(-nu_Aj w_j, 0)
+    w_j는 반응 j의 (정미) 속도, delta_Bj는 반응 j의 반응식이나 속도식에 B가 있으면 1임.
+    대상 화학종 T로부터 B까지의 경로에 대해 DRG는 경로 상 최소 계수의 최댓값(병목)을, DRGEP는 계수 곱의 최댓값을
+    B의 중요도로 삼고, 모든 표본과 대상 화학종에 대한 최댓값을 최종 중요도로 사용함. 따라서 문턱값 eps의 축소는
+    중요도가 eps 이상인 화학종과 그들만으로 이루어진 반응을 남기는 것과 같고, 문턱값을 바꿔도 다시 계산하지 않음.
+    표본별 계산은 스레드마다 작업 공간을 따로 두고 병렬로 수행함.
+
+    addCase로 추가한 회분식 반응 조건은 전체 메커니즘으로 적분해 표본을 만들고, reduce가 후보 메커니즘을
+    같은 조건으로 다시 적분해 대상 화학종의 오차를 검증함. 오차는 출력 시간에서의 차이의 최댓값을 전체
+    메커니즘에서의 대상 화학종의 최댓값으로 나눈 값이며, reduce는 검증을 통과한 후보만 반환하므로 반환된
+    메커니즘은 모든 검증 조건에서 ErrTol 이하의 오차를 가짐.
+
+    MechReducer는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _RxnPtr : 축소할 SpeedRxnBase 객체의 포인터를 저장함.
+        _TargetPos : 대상 화학종의 위치(RxnBase::getChemIdx() 순서)를 저장함.
+        _Method : DRG 또는 DRGEP를 저장함.
+        _StoiPtr, _StoiChem, _StoiVal : 반응별로 계수가 0이 아닌 화학종과 계수(CSR)를 저장함.
+        _EdgePtr, _EdgeDst : 화학종 A에서 B로 가는 결합 그래프의 간선(A별 CSR)을 저장함.
+        _ContPtr, _ContEdge, _ContVal : 반응 j가 간선의 분자에 더하는 항(간선, nu_Aj)을 저장함.
+        _DepPtr, _DepChem : 반응별로 의존하는 화학종(반응식과 속도식)을 저장함.
+        _SampleConc, _SampleTemp : 상태 표본을 저장함.
+        _CaseVec : 검증 조건과 전체 메커니즘의 대상 화학종 궤적을 저장함.
+        _Importance : 화학종별 중요도를 저장함. 표본이 바뀌면 다시 계산함.
+        _ThreadNum : 표본 계산과 검증에 사용하는 스레드 수를 저장함. 0이면 하드웨어 스레드 수.
+    */
+    class MechReducer
+    {
+        public:
+
+            enum MethodType {DRG, DRGEP};
+
+        private:
+
+            // 검증 조건. 초기 농도, 온도, 출력 시간과 전체 메커니즘의 대상 화학종 궤적((출력 시간) x (대상 화학종))
+            struct _Case
+            {
+                std::vector<double> Conc0;
+                double Temp;
+                std::vector<double> TimeVec;
+                Eigen::MatrixXd TargetMat;
+            };
+
+            // 축소할 반응식의 포인터를 저장함.
+            SpeedRxnBase* _RxnPtr = nullptr;
+
+            // 대상 화학종의 위치를 저장함.
+            std::vector<int> _TargetPos;
+
+            // DRG 또는 DRGEP
+            MethodType _Method = DRGEP;
+
+            // 반응별 계수의 CSR
+            std::vector<int> _StoiPtr, _StoiChem;
+            std::vector<double> _StoiVal;
+
+            // 결합 그래프의 간선(A별 CSR)
+            std::vector<int> _EdgePtr, _EdgeDst;
+
+            // 반응별로 간선 분자에 더하는 항
+            std::vector<int> _ContPtr, _ContEdge;
+            std::vector<double> _ContVal;
+
+            // 반응별로 의존하는 화학종
+            std::vector<int> _DepPtr, _DepChem;
+
+            // 상태 표본
+            std::vector<std::vector<double>> _SampleConc;
+            std::vector<double> _SampleTemp;
+
+            // 검증 조건
+            std::vector<_Case> _CaseVec;
+
+            // 화학종별 중요도와 계산 여부
+            std::vector<double> _Importance;
+            bool _ImportanceValid = false;
+
+            // 스레드 수. 0이면 하드웨어 스레드 수를 사용함.
+            int _ThreadNum = 0;
+
+            // 검증 적분의 허용 오차
+            double _AbsTol = 1e-12;
+            double _RelTol = 1e-6;
+
+            // 결합 그래프를 구성함.
+            void _build()
+            {
+                const int chemNum = _RxnPtr->getChemNum();
+                const int rxnNum = _RxnPtr->getRxnNum();
+                const auto effiMat = _RxnPtr->getEffiMat();
+
+                // 반응별 계수
+                _StoiPtr.assign(1, 0);
+                _StoiChem.clear();
+                _StoiVal.clear();
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (effiMat(i, j) == 0) continue;
+                        _StoiChem.push_back(i);
+                        _StoiVal.push_back(effiMat(i, j));
+                    }
+                    _StoiPtr.push_back(_StoiChem.size());
+                }
+
+                // 반응별 의존 화학종 = 반응식의 화학종과 속도 Jacobian 패턴의 합집합
+                std::vector<std::vector<int>> depVec(rxnNum);
+                for (auto j = 0; j < rxnNum; ++j) depVec[j].assign(_StoiChem.begin() + _StoiPtr[j], _StoiChem.begin() + _StoiPtr[j+1]);
+
+                std::vector<int> rxnIdx, chemIdx;
+                _RxnPtr->getJacobPattern(rxnIdx, chemIdx);
+                for (auto q = 0; q < rxnIdx.size(); ++q) depVec[rxnIdx[q]].push_back(chemIdx[q]);
+
+                _DepPtr.assign(1, 0);
+                _DepChem.clear();
+                for (auto& dep : depVec)
+                {
+                    std::sort(dep.begin(), dep.end());
+                    dep.erase(std::unique(dep.begin(), dep.end()), dep.end());
+                    _DepChem.insert(_DepChem.end(), dep.begin(), dep.end());
+                    _DepPtr.push_back(_DepChem.size());
+                }
+
+                // 간선 (A, B) : A가 반응식에 있는 반응이 B에 의존함. 자기 자신으로의 간선은 두지 않음.
+                std::vector<std::map<int, int>> edgeMap(chemNum);
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    for (auto p = _StoiPtr[j]; p < _StoiPtr[j+1]; ++p)
+                    {
+                        for (auto q = _DepPtr[j]; q < _DepPtr[j+1]; ++q)
+                        {
+                            if (_DepChem[q] != _StoiChem[p]) edgeMap[_StoiChem[p]][_DepChem[q]] = 0;
+                        }
+                    }
+                }
+
+                _EdgePtr.assign(1, 0);
+                _EdgeDst.clear();
+                for (auto a = 0; a < chemNum; ++a)
+                {
+                    for (auto& pair : edgeMap[a])
+                    {
+                        pair.second = _EdgeDst.size();
+                        _EdgeDst.push_back(pair.first);
+                    }
+                    _EdgePtr.push_back(_EdgeDst.size());
+                }
+
+                _ContPtr.assign(1, 0);
+                _ContEdge.clear();
+                _ContVal.clear();
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    for (auto p = _StoiPtr[j]; p < _StoiPtr[j+1]; ++p)
+                    {
+                        for (auto q = _DepPtr[j]; q < _DepPtr[j+1]; ++q)
+                        {
+                            if (_DepChem[q] == _StoiChem[p]) continue;
+                            _ContEdge.push_back(edgeMap[_StoiChem[p]][_DepChem[q]]);
+                            _ContVal.push_back(_StoiVal[p]);
+                        }
+                    }
+                    _ContPtr.push_back(_ContEdge.size());
+                }
+
+                _Importance.assign(chemNum, 0);
+                _ImportanceValid = false;
+            }
+
+            // 스레드 수를 정함.
+            int _getThreadNum(const int& taskNum) const
+            {
+                int threadNum = (_ThreadNum <= 0) ? std::max<int>(1, std::thread::hardware_concurrency()) : _ThreadNum;
+                return std::max(1, std::min(threadNum, taskNum));
+            }
+
+            /*
+            표본 하나의 결합 계수를 계산하고 대상 화학종으로부터의 경로 값의 최댓값을 importance에 반영함.
+            rate, prod, cons, num, weight, best는 호출한 쪽의 작업 공간임.
+            */
+            void _accumSample(const int& s, std::vector<double>& rate, std::vector<double>& prod, std::vector<double>& cons,
+                std::vector<double>& num, std::vector<double>& weight, std::vector<double>& best, std::vector<double>& importance) const
+            {
+                const int chemNum = _RxnPtr->getChemNum();
+                const int rxnNum = _RxnPtr->getRxnNum();
+
+                _RxnPtr->calcRateAD(_SampleConc[s].data(), _SampleTemp[s], rate.data());
+
+                std::fill(prod.begin(), prod.end(), 0.0);
+                std::fill(cons.begin(), cons.end(), 0.0);
+                std::fill(num.begin(), num.end(), 0.0);
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    if (rate[j] == 0 || !std::isfinite(rate[j])) continue;
+
+                    for (auto p = _StoiPtr[j]; p < _StoiPtr[j+1]; ++p)
+                    {
+                        const double v = _StoiVal[p] * rate[j];
+                        if (v > 0) prod[_StoiChem[p]] += v;
+                        else cons[_StoiChem[p]] -= v;
+                    }
+                    for (auto p = _ContPtr[j]; p < _ContPtr[j+1]; ++p) num[_ContEdge[p]] += _ContVal[p] * rate[j];
+                }
+
+                for (auto a = 0; a < chemNum; ++a)
+                {
+                    const double denom = std::max(prod[a], cons[a]);
+                    for (auto e = _EdgePtr[a]; e < _EdgePtr[a+1]; ++e)
+                    {
+                        weight[e] = (denom > 0) ? std::min(1.0, std::abs(num[e]) / denom) : 0;
+                    }
+                }
+
+                // 대상 화학종마다 경로 값이 큰 순서로 확정하는 Dijkstra 탐색
+                std::priority_queue<std::pair<double, int>> queue;
+                for (auto target : _TargetPos)
+                {
+                    std::fill(best.begin(), best.end(), 0.0);
+                    best[target] = 1;
+                    queue.emplace(1.0, target);
+
+                    while (!queue.empty())
+                    {
+                        const auto top = queue.top();
+                        queue.pop();
+                        const int a = top.second;
+                        if (top.first < best[a]) continue;
+
+                        importance[a] = std::max(importance[a], best[a]);
+
+                        for (auto e = _EdgePtr[a]; e < _EdgePtr[a+1]; ++e)
+                        {
+                            const int b = _EdgeDst[e];
+                            const double val = (_Method == DRGEP) ? best[a] * weight[e] : std::min(best[a], weight[e]);
+                            if (val > best[b])
+                            {
+                                best[b] = val;
+                                queue.emplace(val, b);
+                            }
+                        }
+                    }
+                }
+            }
+
+            /*
+            중요도가 Threshold 이상인 화학종으로부터 남길 반응을 정함. 의존하는 화학종이 모두 남고,
+            그 화학종이 남은 반응식에 모두 나오는 반응만 남을 때까지 반복함.
+            */
+            std::vector<int> _selectRxn(const double& Threshold) const
+            {
+                const int chemNum = _RxnPtr->getChemNum();
+                const int rxnNum = _RxnPtr->getRxnNum();
+
+                std::vector<bool> chemKeep(chemNum), rxnKeep(rxnNum, true);
+                for (auto i = 0; i < chemNum; ++i) chemKeep[i] = (_Importance[i] >= Threshold);
+
+                bool changed = true;
+                while (changed)
+                {
+                    changed = false;
+
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        if (!rxnKeep[j]) continue;
+                        for (auto q = _DepPtr[j]; q < _DepPtr[j+1]; ++q)
+                        {
+                            if (!chemKeep[_DepChem[q]])
+                            {
+                                rxnKeep[j] = false;
+                                changed = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    // 남은 반응식에 나오지 않는 화학종은 축소된 반응식에 남을 수 없음.
+                    std::vector<bool> inEqn(chemNum, false);
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        if (!rxnKeep[j]) continue;
+                        for (auto p = _StoiPtr[j]; p < _StoiPtr[j+1]; ++p) inEqn[_StoiChem[p]] = true;
+                    }
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (chemKeep[i] && !inEqn[i])
+                        {
+                            chemKeep[i] = false;
+                            changed = true;
+                        }
+                    }
+                }
+
+                std::vector<int> rxnIdx;
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    if (rxnKeep[j]) rxnIdx.push_back(j);
+                }
+
+                return rxnIdx;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            MechReducer() = default;
+
+            // 대상 화학종 TargetVec은 RxnPtr의 반응식에 있어야 함.
+            MechReducer(SpeedRxnBase* RxnPtr, const std::vector<ChemBase*>& TargetVec, const MethodType& Method = DRGEP):
+                _RxnPtr(RxnPtr), _Method(Method)
+            {
+                if (TargetVec.empty()) throw std::runtime_error("MechReducer needs at least one target chemical.");
+
+                const auto chemIdx = _RxnPtr->getChemIdx();
+                for (auto ptr : TargetVec) _TargetPos.push_back(functions::getVecPos(chemIdx, ptr));
+
+                _build();
+            }
+
+            // getter 정의부
+
+            auto getMethod() const {return _Method;}
+            int getSampleNum() const {return _SampleConc.size();}
+            int getCaseNum() const {return _CaseVec.size();}
+
+            // setter 정의부
+
+            void setMethod(const MethodType& Method)
+            {
+                _Method = Method;
+                _ImportanceValid = false;
+            }
+            void setThreadNum(const int& ThreadNum) {_ThreadNum = ThreadNum;}
+            void setTolerance(const double& AbsTol, const double& RelTol)
+            {
+                _AbsTol = AbsTol;
+                _RelTol = RelTol;
+            }
+
+            // 인스턴스 정의부
+
+            // 농도 conc(RxnBase::getChemIdx() 순서)와 온도 Temp의 상태 표본을 추가함.
+            void addSample(const std::vector<double>& conc, const double& Temp)
+            {
+                if (conc.size() != _RxnPtr->getChemNum()) throw std::runtime_error("Sample doesn't match the number of chemicals.");
+
+                _SampleConc.push_back(conc);
+                _SampleTemp.push_back(Temp);
+                _ImportanceValid = false;
+            }
+
+            /*
+            모든 표본에 대한 화학종별 중요도(0 ~ 1, 대상 화학종은 1)를 반환함. 표본은 스레드별로 나눠 계산하며,
+            스레드마다 결합 계수와 탐색의 작업 공간을 따로 둠.
+            */
+            const std::vector<double>& calcImportance()
+            {
+                if (_ImportanceValid) return _Importance;
+                if (_SampleConc.empty()) throw std::runtime_error("MechReducer has no state samples.");
+
+                const int chemNum = _RxnPtr->getChemNum();
+                const int rxnNum = _RxnPtr->getRxnNum();
+                const int sampleNum = _SampleConc.size();
+                const int threadNum = _getThreadNum(sampleNum);
+
+                std::vector<std::vector<double>> impVec(threadNum, std::vector<double>(chemNum, 0));
+                std::vector<std::exception_ptr> errVec(threadNum);
+
+                auto worker = [&](const int tid)
+                {
+                    std::vector<double> rate(rxnNum), prod(chemNum), cons(chemNum);
+                    std::vector<double> num(_EdgeDst.size()), weight(_EdgeDst.size()), best(chemNum);
+
+                    try
+                    {
+                        for (auto s = tid; s < sampleNum; s += threadNum) _accumSample(s, rate, prod, cons, num, weight, best, impVec[tid]);
+                    }
+                    catch (...)
+                    {
+                        errVec[tid] = std::current_exception();
+                    }
+                };
+
+                std::vector<std::thread> threadVec;
+                for (auto tid = 1; tid < threadNum; ++tid) threadVec.emplace_back(worker, tid);
+                worker(0);
+                for (auto& th : threadVec) th.join();
+
+                for (auto& err : errVec)
+                {
+                    if (err) std::rethrow_exception(err);
+                }
+
+                _Importance.assign(chemNum, 0);
+                for (const auto& imp : impVec)
+                {
+                    for (auto i = 0; i < chemNum; ++i) _Importance[i] = std::max(_Importance[i], imp[i]);
+                }
+                for (auto target : _TargetPos) _Importance[target] = 1;
+
+                _ImportanceValid = true;
+
+                return _Importance;
+            }
+
+            // 문턱값 Threshold로 축소한 메커니즘을 검증 없이 반환함.
+            ReductionResult reduceByThreshold(const double& Threshold)
+            {
+                calcImportance();
+
+                ReductionResult res;
+                res.RxnIdx = _selectRxn(Threshold);
+                res.Rxn = _RxnPtr->extractRxn(res.RxnIdx);
+                res.ChemIdx = res.Rxn.getChemIdx();
+                res.Threshold = Threshold;
+
+                return res;
+            }
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            /*
+            초기 농도 Conc0, 온도 Temp의 회분식 반응을 출력 시간 TimeVec(0 이상, 오름차순)까지 전체 메커니즘으로
+            적분하고, 초기 상태와 출력 시간의 상태를 표본으로, 대상 화학종의 궤적을 검증 조건으로 추가함.
+            */
+            void addCase(const std::vector<double>& Conc0, const double& Temp, const std::vector<double>& TimeVec)
+            {
+                const int chemNum = _RxnPtr->getChemNum();
+                if (Conc0.size() != chemNum) throw std::runtime_error("Initial state doesn't match the number of chemicals.");
+
+                const double prevTemp = _RxnPtr->getTemp();
+                _RxnPtr->setTemp(Temp);
+
+                BDFResult bdfRes;
+                try
+                {
+                    SparseBDF bdf(_RxnPtr);
+                    bdf.setTolerance(_AbsTol, _RelTol);
+                    auto y = Conc0;
+                    bdfRes = bdf.solve(y, 0.0, TimeVec);
+                }
+                catch (...)
+                {
+                    _RxnPtr->setTemp(prevTemp);
+                    throw;
+                }
+                _RxnPtr->setTemp(prevTemp);
+
+                _Case curCase;
+                curCase.Conc0 = Conc0;
+                curCase.Temp = Temp;
+                curCase.TimeVec = TimeVec;
+                curCase.TargetMat.resize(TimeVec.size(), _TargetPos.size());
+
+                addSample(Conc0, Temp);
+                for (auto n = 0; n < TimeVec.size(); ++n)
+                {
+                    for (auto k = 0; k < _TargetPos.size(); ++k) curCase.TargetMat(n, k) = bdfRes.StateVec[n][_TargetPos[k]];
+                    addSample(bdfRes.StateVec[n], Temp);
+                }
+
+                _CaseVec.push_back(std::move(curCase));
+            }
+
+            /*
+            축소된 메커니즘 Rxn을 모든 검증 조건으로 적분해 대상 화학종의 최대 상대 오차를 반환함.
+            조건은 스레드별로 나눠 계산하며, 스레드마다 Rxn의 복사본을 사용함. 적분이 실패하면 무한대를 반환함.
+            */
+            double calcError(SpeedRxnBase& Rxn)
+            {
+                const auto fullChemIdx = _RxnPtr->getChemIdx();
+                const auto subChemIdx = Rxn.getChemIdx();
+                const int subChemNum = subChemIdx.size();
+                const int caseNum = _CaseVec.size();
+                const int threadNum = _getThreadNum(caseNum);
+
+                std::vector<int> posMap(subChemNum);
+                for (auto k = 0; k < subChemNum; ++k) posMap[k] = functions::getVecPos(fullChemIdx, subChemIdx[k]);
+
+                // 대상 화학종의 축소된 반응식 상 위치. 반응이 모두 빠지면 -1(초기값 유지)
+                std::vector<int> targetSub(_TargetPos.size(), -1);
+                for (auto k = 0; k < _TargetPos.size(); ++k)
+                {
+                    if (functions::inVector(subChemIdx, fullChemIdx[_TargetPos[k]])) targetSub[k] = functions::getVecPos(subChemIdx, fullChemIdx[_TargetPos[k]]);
+                }
+
+                std::vector<double> errVec(caseNum, 0);
+
+                auto worker = [&](const int tid)
+                {
+                    SpeedRxnBase rxn = Rxn;
+
+                    for (auto c = tid; c < caseNum; c += threadNum)
+                    {
+                        const auto& curCase = _CaseVec[c];
+                        const int outNum = curCase.TimeVec.size();
+
+                        Eigen::MatrixXd subMat(outNum, _TargetPos.size());
+                        try
+                        {
+                            std::vector<double> y(subChemNum);
+                            for (auto k = 0; k < subChemNum; ++k) y[k] = curCase.Conc0[posMap[k]];
+
+                            BDFResult bdfRes;
+                            if (subChemNum > 0)
+                            {
+                                rxn.setTemp(curCase.Temp);
+                                SparseBDF bdf(&rxn);
+                                bdf.setTolerance(_AbsTol, _RelTol);
+                                bdfRes = bdf.solve(y, 0.0, curCase.TimeVec);
+                            }
+
+                            for (auto n = 0; n < outNum; ++n)
+                            {
+                                for (auto k = 0; k < _TargetPos.size(); ++k)
+                                {
+                                    subMat(n, k) = (targetSub[k] < 0) ? curCase.Conc0[_TargetPos[k]] : bdfRes.StateVec[n][targetSub[k]];
+                                }
+                            }
+                        }
+                        catch (const std::runtime_error&)
+                        {
+                            errVec[c] = std::numeric_limits<double>::infinity();
+                            continue;
+                        }
+
+                        for (auto k = 0; k < _TargetPos.size(); ++k)
+                        {
+                            const double scale = curCase.TargetMat.col(k).cwiseAbs().maxCoeff();
+                            const double diff = (subMat.col(k) - curCase.TargetMat.col(k)).cwiseAbs().maxCoeff();
+                            errVec[c] = std::max(errVec[c], (scale > 0) ? diff / scale : diff);
+                        }
+                    }
+                };
+
+                std::vector<std::thread> threadVec;
+                for (auto tid = 1; tid < threadNum; ++tid) threadVec.emplace_back(worker, tid);
+                worker(0);
+                for (auto& th : threadVec) th.join();
+
+                double maxErr = 0;
+                for (auto err : errVec) maxErr = std::max(maxErr, err);
+
+                return maxErr;
+            }
+
+            /*
+            검증 조건에서 대상 화학종의 오차가 ErrTol 이하인 가장 작은 메커니즘을 찾음.
+            중요도의 서로 다른 값들을 문턱값 후보로 두고 이분 탐색하며, 후보마다 calcError로 검증함.
+            반환된 메커니즘은 검증을 통과한 것이며, 어떤 후보도 통과하지 못하면 전체 메커니즘(문턱값 0)을 반환함.
+            이분 탐색은 오차가 문턱값에 대해 단조 증가한다고 가정하지만 DRG/DRGEP는 이를 보장하지 않음(화학종을 더 빼서
+            오차가 상쇄되면 줄어들 수도 있음). 따라서 결과는 탐색 경로 상에서 통과한 가장 큰 문턱값이며, 통과하는 모든
+            후보 중 가장 작은 메커니즘이라는 보장은 없음.
+            */
+            ReductionResult reduce(const double& ErrTol)
+            {
+                if (_CaseVec.empty()) throw std::runtime_error("MechReducer has no validation cases. Use addCase first.");
+
+                calcImportance();
+
+                std::vector<double> thresholdVec(_Importance.begin(), _Importance.end());
+                thresholdVec.push_back(0);
+                std::sort(thresholdVec.begin(), thresholdVec.end());
+                thresholdVec.erase(std::unique(thresholdVec.begin(), thresholdVec.end()), thresholdVec.end());
+
+                // 대상 화학종만 남기는 문턱값(1)보다 큰 후보는 없음.
+                while (thresholdVec.size() > 1 && thresholdVec.back() > 1) thresholdVec.pop_back();
+
+                ReductionResult best = reduceByThreshold(0);
+                best.MaxError = 0;
+
+                int lo = 0;
+                int hi = thresholdVec.size() - 1;
+                int validNum = 0;
+                std::vector<int> prevRxnIdx = best.RxnIdx;
+
+                while (lo < hi)
+                {
+                    const int mid = (lo + hi + 1) / 2;
+
+                    ReductionResult cand = reduceByThreshold(thresholdVec[mid]);
+                    if (cand.RxnIdx == prevRxnIdx) cand.MaxError = best.MaxError;
+                    else
+                    {
+                        cand.MaxError = calcError(cand.Rxn);
+                        ++validNum;
+                    }
+
+                    if (cand.MaxError <= ErrTol)
+                    {
+                        lo = mid;
+                        prevRxnIdx = cand.RxnIdx;
+                        best = std::move(cand);
+                    }
+                    else hi = mid - 1;
+                }
+
+                best.ValidNum = validNum;
+
+                return best;
+            }
+
+            #endif
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -0,0 +1,755 @@
+/*
+core/RxnFamily/RateExprVM.hpp
+-----------------------------
+문자열로 주어진 반응 속도식을 레지스터 바이트코드로 컴파일하고 실행하는 RateExprVM 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_RATEEXPRVM
+#define _CHEMPROCHELPER_RATEEXPRVM
+
+namespace chemprochelper
+{
+    /*
+    반응 속도식 문자열을 컴파일해 여러 상태에 대해 한 번에 계산하는 가상 머신.
+    -------------------------------------------------------------------
+    지원하는 문법 : 숫자, 변수(화학종), 매개변수(온도 T 등), + - * / ^, 단항 -, 괄호,
+        함수 exp, log(ln), sqrt, pow(a, b). 괄호가 포함된 화학종은 [(CH3)2NH]처럼 대괄호로 감쌈.
+    컴파일 과정 :
+        1. 식을 파싱해 DAG를 만듦. 같은 노드는 한 번만 만들어(hash-consing) 공통 부분식이 제거되고,
+           상수끼리의 연산과 0, 1에 대한 연산은 노드를 만들 때 바로 정리함(constant folding).
+        2. 변수마다 전진 모드로 미분 노드를 만들어 Jacobian을 구함. 미분 노드도 같은 DAG를 공유함.
+        3. 출력에서 도달 가능한 노드를 위상 정렬하고, 생존 구간이 끝난 레지스터를 재사용해 바이트코드를 만듦.
+    실행은 상태 _BlockSize개를 한 블록으로 묶어 명령어마다 블록 전체를 계산하므로,
+    명령어 해석 비용은 상태마다가 아니라 블록마다 한 번만 듦.
+
+    RateExprVM은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _VarName : 변수(상태마다 값이 다름)의 이름을 저장함.
+        _ParamName, _ParamVec : 매개변수(모든 상태에 공통)의 이름과 값을 저장함.
+        _NodeVec, _NodeMap : 식의 DAG와 hash-consing 테이블을 저장함.
+        _RateProg, _JacobProg : 속도만 계산하는 프로그램과, 속도와 Jacobian을 함께 계산하는 프로그램을 저장함.
+    */
+    class RateExprVM
+    {
+        public:
+
+            // 명령어의 종류. Const, Var, Param은 값을 불러오고, Out은 결과를 출력 배열에 씀.
+            enum OpCode : std::uint8_t {Const, Var, Param, Add, Sub, Mul, Div, Pow, Neg, Exp, Log, Sqrt, Out};
+
+            /*
+            레지스터 명령어. Dst <- Op(A, B)
+            Const/Var/Param의 A는 상수/변수/매개변수의 인덱스, Out의 Dst는 출력 위치, A는 레지스터,
+            B는 출력 배열(0 : 속도, 1 : Jacobian)을 뜻함.
+            */
+            struct Inst
+            {
+                OpCode Op;
+                int Dst;
+                int A;
+                int B;
+            };
+
+        private:
+
+            // 식의 DAG를 구성하는 노드.
+            struct _Node
+            {
+                OpCode Op;
+                int A;
+                int B;
+                double Val;
+            };
+
+            // 컴파일된 프로그램.
+            struct _Program
+            {
+                std::vector<Inst> InstVec;
+                std::vector<double> ConstVec;
+                int RegNum = 0;
+            };
+
+            // 한 번에 계산하는 상태의 수.
+            static const int _BlockSize = 64;
+
+            // 변수와 매개변수의 이름, 매개변수의 값을 저장함.
+            std::vector<std::string> _VarName;
+            std::vector<std::string> _ParamName;
+            std::vector<double> _ParamVec;
+
+            // 식의 DAG와 hash-consing 테이블을 저장함.
+            std::vector<_Node> _NodeVec;
+            std::map<std::tuple<int, int, int, double>, int> _NodeMap;
+
+            // 출력(속도)의 노드 인덱스와 Jacobian 노드 인덱스(변수 i, 출력 j -> i * 출력 수 + j)를 저장함.
+            std::vector<int> _OutNode;
+            std::vector<int> _JacobNode;
+
+            // 컴파일된 프로그램을 저장함.
+            _Program _RateProg;
+            _Program _JacobProg;
+
+            // 파서 상태
+            std::string _Src;
+            size_t _Pos = 0;
+
+            // 노드를 만듦. 상수 접기와 항등식 정리를 한 뒤, 이미 있는 노드이면 그 인덱스를 반환함.
+            int _makeNode(const OpCode& Op, int A = -1, int B = -1, const double& Val = 0)
+            {
+                // Var, Param 노드의 A는 노드가 아니라 변수(매개변수) 인덱스이므로 접기 대상에서 뺌.
+                const bool isLeaf = (Op == Const || Op == Var || Op == Param);
+                auto isConst = [&](const int& n, const double& v) {return n >= 0 && _NodeVec[n].Op == Const && _NodeVec[n].Val == v;};
+                const bool bothConst = !isLeaf && (A >= 0 && _NodeVec[A].Op == Const) && (B < 0 || _NodeVec[B].Op == Const);
+
+                if (bothConst)
+                {
+                    const double a = _NodeVec[A].Val;
+                    const double b = (B >= 0) ? _NodeVec[B].Val : 0;
+                    return _makeNode(Const, -1, -1, _calcOp(Op, a, b));
+                }
+
+                switch (Op)
+                {
+                    case Add:
+                        if (isConst(A, 0)) return B;
+                        if (isConst(B, 0)) return A;
+                        if (A > B) std::swap(A, B);
+                        break;
+                    case Sub:
+                        if (isConst(B, 0)) return A;
+                        if (isConst(A, 0)) return _makeNode(Neg, B);
+                        if (A == B) return _makeNode(Const, -1, -1, 0);
+                        break;
+                    case Mul:
+                        if (isConst(A, 0) || isConst(B, 0)) return _makeNode(Const, -1, -1, 0);
+                        if (isConst(A, 1)) return B;
+                        if (isConst(B, 1)) return A;
+                        if (isConst(A, -1)) return _makeNode(Neg, B);
+                        if (isConst(B, -1)) return _makeNode(Neg, A);
+                        if (A > B) std::swap(A, B);
+                        break;
+                    case Div:
+                        if (isConst(A, 0)) return _makeNode(Const, -1, -1, 0);
+                        if (isConst(B, 1)) return A;
+                        break;
+                    case Pow:
+                        if (isConst(B, 0)) return _makeNode(Const, -1, -1, 1);
+                        if (isConst(B, 1)) return A;
+                        break;
+                    case Neg:
+                        if (_NodeVec[A].Op == Neg) return _NodeVec[A].A;
+                        break;
+                    default:
+                        break;
+                }
+
+                auto key = std::make_tuple(static_cast<int>(Op), A, B, Val);
+                auto it = _NodeMap.find(key);
+                if (it != _NodeMap.end()) return it->second;
+
+                _NodeVec.push_back({Op, A, B, Val});
+                _NodeMap[key] = _NodeVec.size() - 1;
+
+                return _NodeVec.size() - 1;
+            }
+
+            static double _calcOp(const OpCode& Op, const double& a, const double& b)
+            {
+                switch (Op)
+                {
+                    case Add: return a + b;
+                    case Sub: return a - b;
+                    case Mul: return a * b;
+                    case Div: return a / b;
+                    case Pow: return std::pow(a, b);
+                    case Neg: return -a;
+                    case Exp: return std::exp(a);
+                    case Log: return std::log(a);
+                    case Sqrt: return std::sqrt(a);
+                    default: throw std::runtime_error("Invalid opcode in RateExprVM.");
+                }
+            }
+
+            // 파서 정의부
+
+            void _skipSpace()
+            {
+                while (_Pos < _Src.size() && std::isspace(static_cast<unsigned char>(_Src[_Pos]))) ++_Pos;
+            }
+
+            bool _accept(const char& ch)
+            {
+                _skipSpace();
+                if (_Pos < _Src.size() && _Src[_Pos] == ch)
+                {
+                    ++_Pos;
+                    return true;
+                }
+                return false;
+            }
+
+            void _expect(const char& ch)
+            {
+                if (!_accept(ch)) throw std::runtime_error("Expected '" + std::string(1, ch) + "' in rate expression : " + _Src);
+            }
+
+            // 이름에 해당하는 변수 혹은 매개변수 노드를 반환함.
+            int _nameNode(const std::string& name)
+            {
+                if (functions::inVector(_VarName, name)) return _makeNode(Var, functions::getVecPos(_VarName, name));
+                if (functions::inVector(_ParamName, name)) return _makeNode(Param, functions::getVecPos(_ParamName, name));
+                throw std::runtime_error("Unknown name " + name + " in rate expression.");
+            }
+
+            // expr := term (('+' | '-') term)*
+            int _parseExpr()
+            {
+                int node = _parseTerm();
+                while (true)
+                {
+                    if (_accept('+')) node = _makeNode(Add, node, _parseTerm());
+                    else if (_accept('-')) node = _makeNode(Sub, node, _parseTerm());
+                    else return node;
+                }
+            }
+
+            // term := unary (('*' | '/') unary)*
+            int _parseTerm()
+            {
+                int node = _parseUnary();
+                while (true)
+                {
+                    if (_accept('*')) node = _makeNode(Mul, node, _parseUnary());
+                    else if (_accept('/')) node = _makeNode(Div, node, _parseUnary());
+                    else return node;
+                }
+            }
+
+            // unary := '-' unary | '+' unary | power
+            int _parseUnary()
+            {
+                if (_accept('-')) return _makeNode(Neg, _parseUnary());
+                if (_accept('+')) return _parseUnary();
+                return _parsePower();
+            }
+
+            // power := primary ('^' unary)?
+            int _parsePower()
+            {
+                int node = _parsePrimary();
+                if (_accept('^')) node = _makeNode(Pow, node, _parseUnary());
+                return node;
+            }
+
+            // primary := number | name | name '(' args ')' | '[' chem ']' | '(' expr ')'
+            int _parsePrimary()
+            {
+                _skipSpace();
+                if (_Pos >= _Src.size()) throw std::runtime_error("Unexpected end of rate expression : " + _Src);
+
+                const char ch = _Src[_Pos];
+
+                if (_accept('('))
+                {
+                    int node = _parseExpr();
+                    _expect(')');
+                    return node;
+                }
+
+                if (_accept('['))
+                {
+                    auto end = _Src.find(']', _Pos);
+                    if (end == std::string::npos) throw std::runtime_error("Expected ']' in rate expression : " + _Src);
+                    auto name = _Src.substr(_Pos, end - _Pos);
+                    _Pos = end + 1;
+                    return _nameNode(name);
+                }
+
+                if (std::isdigit(static_cast<unsigned char>(ch)) || ch == '.')
+                {
+                    size_t len;
+                    double val = std::stod(_Src.substr(_Pos), &len);
+                    _Pos += len;
+                    return _makeNode(Const, -1, -1, val);
+                }
+
+                if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_')
+                {
+                    auto begin = _Pos;
+                    while (_Pos < _Src.size() && (std::isalnum(static_cast<unsigned char>(_Src[_Pos])) || _Src[_Pos] == '_')) ++_Pos;
+                    auto name = _Src.substr(begin, _Pos - begin);
+
+                    if (_accept('('))
+                    {
+                        int arg = _parseExpr();
+                        if (name == "pow")
+                        {
+                            _expect(',');
+                            int arg2 = _parseExpr();
+                            _expect(')');
+                            return _makeNode(Pow, arg, arg2);
+                        }
+                        _expect(')');
+
+                        if (name == "exp") return _makeNode(Exp, arg);
+                        if (name == "log" || name == "ln") return _makeNode(Log, arg);
+                        if (name == "sqrt") return _makeNode(Sqrt, arg);
+                        throw std::runtime_error("Unknown function " + name + " in rate expression.");
+                    }
+
+                    return _nameNode(name);
+                }
+
+                throw std::runtime_error("Invalid character in rate expression : " + _Src);
+            }
+
+            // 미분 노드 생성부
+
+            // 노드 n을 변수 var로 미분한 노드를 반환함. memo에 결과를 저장해 같은 노드를 다시 미분하지 않음.
+            int _diffNode(const int& n, const int& var, std::vector<int>& memo)
+            {
+                if (n < memo.size() && memo[n] >= 0) return memo[n];
+
+                const _Node node = _NodeVec[n];
+                const int zero = _makeNode(Const, -1, -1, 0);
+                int res = zero;
+
+                switch (node.Op)
+                {
+                    case Const:
+                    case Param:
+                        res = zero;
+                        break;
+                    case Var:
+                        res = (node.A == var) ? _makeNode(Const, -1, -1, 1) : zero;
+                        break;
+                    case Add:
+                        res = _makeNode(Add, _diffNode(node.A, var, memo), _diffNode(node.B, var, memo));
+                        break;
+                    case Sub:
+                        res = _makeNode(Sub, _diffNode(node.A, var, memo), _diffNode(node.B, var, memo));
+                        break;
+                    case Mul:
+                        res = _makeNode(Add, _makeNode(Mul, _diffNode(node.A, var, memo), node.B),
+                            _makeNode(Mul, node.A, _diffNode(node.B, var, memo)));
+                        break;
+                    case Div:
+                        // (da - n * db) / b
+                        res = _makeNode(Div, _makeNode(Sub, _diffNode(node.A, var, memo),
+                            _makeNode(Mul, n, _diffNode(node.B, var, memo))), node.B);
+                        break;
+                    case Pow:
+                    {
+                        int da = _diffNode(node.A, var, memo);
+                        int db = _diffNode(node.B, var, memo);
+                        if (_NodeVec[node.B].Op == Const)
+                        {
+                            // b * a^(b-1) * da
+                            const double b = _NodeVec[node.B].Val;
+                            int powNode = _makeNode(Pow, node.A, _makeNode(Const, -1, -1, b - 1));
+                            res = _makeNode(Mul, _makeNode(Mul, _makeNode(Const, -1, -1, b), powNode), da);
+                        }
+                        else
+                        {
+                            // n * (db * log(a) + b * da / a)
+                            res = _makeNode(Mul, n, _makeNode(Add, _makeNode(Mul, db, _makeNode(Log, node.A)),
+                                _makeNode(Div, _makeNode(Mul, node.B, da), node.A)));
+                        }
+                        break;
+                    }
+                    case Neg:
+                        res = _makeNode(Neg, _diffNode(node.A, var, memo));
+                        break;
+                    case Exp:
+                        res = _makeNode(Mul, n, _diffNode(node.A, var, memo));
+                        break;
+                    case Log:
+                        res = _makeNode(Div, _diffNode(node.A, var, memo), node.A);
+                        break;
+                    case Sqrt:
+                        res = _makeNode(Div, _diffNode(node.A, var, memo), _makeNode(Mul, _makeNode(Const, -1, -1, 2), n));
+                        break;
+                    default:
+                        break;
+                }
+
+                if (memo.size() < _NodeVec.size()) memo.resize(_NodeVec.size(), -1);
+                memo[n] = res;
+
+                return res;
+            }
+
+            // 바이트코드 생성부
+
+            // outNode(출력 위치 순서)를 계산하는 프로그램을 만듦. outArr는 각 출력이 쓰일 배열(0 : 속도, 1 : Jacobian)임.
+            _Program _compileProgram(const std::vector<int>& outNode, const std::vector<int>& outArr, const std::vector<int>& outSlot)
+            {
+                _Program prog;
+                const int nodeNum = _NodeVec.size();
+
+                // 출력에서 도달 가능한 노드를 후위 순회로 정렬함.
+                std::vector<int> order;
+                std::vector<char> visited(nodeNum, 0);
+                std::vector<std::pair<int, int>> stack;
+
+                for (auto root : outNode)
+                {
+                    if (visited[root]) continue;
+                    stack.push_back({root, 0});
+
+                    while (!stack.empty())
+                    {
+                        auto& top = stack.back();
+                        const auto& node = _NodeVec[top.first];
+                        const int child = (top.second == 0) ? node.A : ((top.second == 1) ? node.B : -2);
+                        const bool hasChild = (node.Op != Const && node.Op != Var && node.Op != Param);
+
+                        if (hasChild && top.second < 2)
+                        {
+                            ++top.second;
+                            if (child >= 0 && !visited[child])
+                            {
+                                visited[child] = 1;
+                                stack.push_back({child, 0});
+                            }
+                            continue;
+                        }
+
+                        visited[top.first] = 1;
+                        order.push_back(top.first);
+                        stack.pop_back();
+                    }
+                }
+
+                // 각 노드가 마지막으로 사용되는 위치를 구함. 출력 노드는 계산 직후에 출력되므로 그 위치까지 살아있음.
+                std::vector<int> position(nodeNum, -1), lastUse(nodeNum, -1);
+                for (auto p = 0; p < order.size(); ++p)
+                {
+                    const auto& node = _NodeVec[order[p]];
+                    position[order[p]] = p;
+                    lastUse[order[p]] = p;
+                    if (node.Op == Const || node.Op == Var || node.Op == Param) continue;
+                    if (node.A >= 0) lastUse[node.A] = p;
+                    if (node.B >= 0) lastUse[node.B] = p;
+                }
+
+                std::vector<std::vector<int>> outAt(nodeNum);
+                for (auto k = 0; k < outNode.size(); ++k) outAt[outNode[k]].push_back(k);
+
+                // 레지스터를 할당하며 명령어를 만듦. 피연산자를 먼저 해제하므로 같은 레지스터에 덮어쓸 수 있음.
+                std::vector<int> reg(nodeNum, -1), freeReg;
+                std::map<double, int> constIdx;
+
+                for (auto p = 0; p < order.size(); ++p)
+                {
+                    const int n = order[p];
+                    const auto& node = _NodeVec[n];
+                    Inst inst{node.Op, -1, node.A, node.B};
+
+                    if (node.Op == Const)
+                    {
+                        auto it = constIdx.find(node.Val);
+                        if (it == constIdx.end())
+                        {
+                            prog.ConstVec.push_back(node.Val);
+                            it = constIdx.insert({node.Val, (int)prog.ConstVec.size() - 1}).first;
+                        }
+                        inst.A = it->second;
+                        inst.B = -1;
+                    }
+                    else if (node.Op != Var && node.Op != Param)
+                    {
+                        inst.A = reg[node.A];
+                        inst.B = (node.B >= 0) ? reg[node.B] : -1;
+
+                        if (lastUse[node.A] == p) freeReg.push_back(reg[node.A]);
+                        if (node.B >= 0 && node.B != node.A && lastUse[node.B] == p) freeReg.push_back(reg[node.B]);
+                    }
+
+                    if (freeReg.empty()) reg[n] = prog.RegNum++;
+                    else
+                    {
+                        reg[n] = freeReg.back();
+                        freeReg.pop_back();
+                    }
+                    inst.Dst = reg[n];
+                    prog.InstVec.push_back(inst);
+
+                    for (auto k : outAt[n]) prog.InstVec.push_back({Out, outSlot[k], reg[n], outArr[k]});
+
+                    if (lastUse[n] == p) freeReg.push_back(reg[n]);
+                }
+
+                return prog;
+            }
+
+            /*
+            프로그램 prog를 상태 stateNum개에 대해 실행함. 변수는 varMat(상태마다 varStride 간격),
+            출력은 outMat[0](속도, 상태마다 outStride[0] 간격), outMat[1](Jacobian)에 씀.
+            */
+            void _run(const _Program& prog, const double* varMat, const int& varStride, const int& stateNum,
+                double* const* outMat, const int* outStride) const
+            {
+                const int B = _BlockSize;
+
+                // 레지스터 작업 공간((레지스터 수) x _BlockSize)은 스레드마다 따로 두므로 같은 객체를 동시에 실행할 수 있음.
+                thread_local std::vector<double> regWork;
+                if (regWork.size() < prog.RegNum * B) regWork.resize(prog.RegNum * B);
+
+                for (auto base = 0; base < stateNum; base += B)
+                {
+                    const int n = std::min(B, stateNum - base);
+
+                    for (const auto& inst : prog.InstVec)
+                    {
+                        double* d = (inst.Op == Out) ? nullptr : &regWork[inst.Dst * B];
+                        const double* a = (inst.Op >= Add && inst.A >= 0) ? &regWork[inst.A * B] : nullptr;
+                        const double* b = (inst.Op >= Add && inst.B >= 0) ? &regWork[inst.B * B] : nullptr;
+
+                        switch (inst.Op)
+                        {
+                            case Const:
+                                for (auto s = 0; s < n; ++s) d[s] = prog.ConstVec[inst.A];
+                                break;
+                            case Var:
+                                for (auto s = 0; s < n; ++s) d[s] = varMat[(base + s) * varStride + inst.A];
+                                break;
+                            case Param:
+                                for (auto s = 0; s < n; ++s) d[s] = _ParamVec[inst.A];
+                                break;
+                            case Add:
+                                for (auto s = 0; s < n; ++s) d[s] = a[s] + b[s];
+                                break;
+                            case Sub:
+                                for (auto s = 0; s < n; ++s) d[s] = a[s] - b[s];
+                                break;
+                            case Mul:
+                                for (auto s = 0; s < n; ++s) d[s] = a[s] * b[s];
+                                break;
+                            case Div:
+                                for (auto s = 0; s < n; ++s) d[s] = a[s] / b[s];
+                                break;
+                            case Pow:
+                                for (auto s = 0; s < n; ++s) d[s] = std::pow(a[s], b[s]);
+                                break;
+                            case Neg:
+                                for (auto s = 0; s < n; ++s) d[s] = -a[s];
+                                break;
+                            case Exp:
+                                for (auto s = 0; s < n; ++s) d[s] = std::exp(a[s]);
+                                break;
+                            case Log:
+                                for (auto s = 0; s < n; ++s) d[s] = std::log(a[s]);
+                                break;
+                            case Sqrt:
+                                for (auto s = 0; s < n; ++s) d[s] = std::sqrt(a[s]);
+                                break;
+                            case Out:
+                            {
+                                double* out = outMat[inst.B];
+                                const double* src = &regWork[inst.A * B];
+                                const int stride = outStride[inst.B];
+                                for (auto s = 0; s < n; ++s) out[(base + s) * stride + inst.Dst] = src[s];
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            RateExprVM() = default;
+
+            // 식과 변수, 매개변수의 이름을 받아 바로 컴파일함.
+            RateExprVM(const std::vector<std::string>& exprVec, const std::vector<std::string>& VarName,
+                const std::vector<std::string>& ParamName = {})
+            {
+                compile(exprVec, VarName, ParamName);
+            }
+
+            // getter 정의부
+
+            auto getVarName() const {return _VarName;}
+            auto getParamName() const {return _ParamName;}
+            int getOutNum() const {return _OutNode.size();}
+            int getVarNum() const {return _VarName.size();}
+            int getNodeNum() const {return _NodeVec.size();}
+            int getInstNum(const bool& withJacob = false) const {return withJacob ? _JacobProg.InstVec.size() : _RateProg.InstVec.size();}
+            int getRegNum(const bool& withJacob = false) const {return withJacob ? _JacobProg.RegNum : _RateProg.RegNum;}
+            auto getInstVec(const bool& withJacob = false) const {return withJacob ? _JacobProg.InstVec : _RateProg.InstVec;}
+            auto getConstVec(const bool& withJacob = false) const {return withJacob ? _JacobProg.ConstVec : _RateProg.ConstVec;}
+            bool empty() const {return _OutNode.empty();}
+
+            // setter 정의부
+
+            // 매개변수의 값을 설정함. 없는 매개변수이면 false를 반환함.
+            bool setParam(const std::string& name, const double& val)
+            {
+                if (!functions::inVector(_ParamName, name)) return false;
+                _ParamVec[functions::getVecPos(_ParamName, name)] = val;
+                return true;
+            }
+
+            // 인스턴스 정의부
+
+            // 식들을 컴파일함. 이전에 컴파일된 내용은 지움.
+            void compile(const std::vector<std::string>& exprVec, const std::vector<std::string>& VarName,
+                const std::vector<std::string>& ParamName = {})
+            {
+                _VarName = VarName;
+                _ParamName = ParamName;
+                _ParamVec.assign(ParamName.size(), 0);
+                _NodeVec.clear();
+                _NodeMap.clear();
+                _OutNode.clear();
+                _JacobNode.clear();
+
+                for (const auto& expr : exprVec)
+                {
+                    _Src = expr;
+                    _Pos = 0;
+                    _OutNode.push_back(_parseExpr());
+                    _skipSpace();
+                    if (_Pos != _Src.size()) throw std::runtime_error("Unexpected token in rate expression : " + _Src);
+                }
+
+                const int outNum = _OutNode.size();
+                const int varNum = _VarName.size();
+
+                _JacobNode.resize(varNum * outNum);
+                for (auto i = 0; i < varNum; ++i)
+                {
+                    std::vector<int> memo(_NodeVec.size(), -1);
+                    for (auto j = 0; j < outNum; ++j) _JacobNode[i * outNum + j] = _diffNode(_OutNode[j], i, memo);
+                }
+
+                std::vector<int> outArr(outNum, 0), outSlot(outNum);
+                for (auto j = 0; j < outNum; ++j) outSlot[j] = j;
+                _RateProg = _compileProgram(_OutNode, outArr, outSlot);
+
+                std::vector<int> allNode = _OutNode;
+                allNode.insert(allNode.end(), _JacobNode.begin(), _JacobNode.end());
+                outArr.resize(allNode.size(), 1);
+                outSlot.resize(allNode.size());
+                for (auto k = 0; k < _JacobNode.size(); ++k) outSlot[outNum + k] = k;
+                _JacobProg = _compileProgram(allNode, outArr, outSlot);
+            }
+
+            // Jacobian의 각 원소(i * 식의 수 + j)가 항상 0이 아니면 true를 반환함.
+            std::vector<bool> getJacobMask() const
+            {
+                std::vector<bool> mask(_JacobNode.size());
+                for (auto k = 0; k < _JacobNode.size(); ++k)
+                {
+                    const auto& node = _NodeVec[_JacobNode[k]];
+                    mask[k] = !(node.Op == Const && node.Val == 0);
+                }
+
+                return mask;
+            }
+
+            /*
+            컴파일된 프로그램을 직선 C++ 코드로 출력함(레지스터 -> 지역 변수). 변수는 varArr[i], 매개변수는
+            paramExpr[k]로 읽고, 식의 값은 rateArr[j]에 씀. withJacob = true이면 Jacobian 원소 k(i * 식의 수 + j)를
+            jacArr[jacSlot[k]]에 쓰며, jacSlot[k]가 음수인 원소는 건너뜀.
+            */
+            std::string emitCpp(const bool& withJacob, const std::string& varArr, const std::vector<std::string>& paramExpr,
+                const std::string& rateArr, const std::string& jacArr = "", const std::vector<int>& jacSlot = {}) const
+            {
+                const auto& prog = withJacob ? _JacobProg : _RateProg;
+                std::ostringstream ss;
+                ss.precision(17);
+
+                const char* opStr[] = {"", "", "", " + ", " - ", " * ", " / "};
+
+                for (auto r = 0; r < prog.RegNum; ++r) ss << ((r == 0) ? "    double " : ", ") << "x" << r;
+                if (prog.RegNum > 0) ss << ";\n";
+
+                for (const auto& inst : prog.InstVec)
+                {
+                    const std::string dst = "x" + std::to_string(inst.Dst);
+                    const std::string a = "x" + std::to_string(inst.A);
+                    const std::string b = "x" + std::to_string(inst.B);
+
+                    switch (inst.Op)
+                    {
+                        case Const: ss << "    " << dst << " = " << prog.ConstVec[inst.A] << ";\n"; break;
+                        case Var: ss << "    " << dst << " = " << varArr << "[" << inst.A << "];\n"; break;
+                        case Param: ss << "    " << dst << " = " << paramExpr[inst.A] << ";\n"; break;
+                        case Add:
+                        case Sub:
+                        case Mul:
+                        case Div: ss << "    " << dst << " = " << a << opStr[inst.Op] << b << ";\n"; break;
+                        case Pow: ss << "    " << dst << " = std::pow(" << a << ", " << b << ");\n"; break;
+                        case Neg: ss << "    " << dst << " = -" << a << ";\n"; break;
+                        case Exp: ss << "    " << dst << " = std::exp(" << a << ");\n"; break;
+                        case Log: ss << "    " << dst << " = std::log(" << a << ");\n"; break;
+                        case Sqrt: ss << "    " << dst << " = std::sqrt(" << a << ");\n"; break;
+                        case Out:
+                            if (inst.B == 0) ss << "    " << rateArr << "[" << inst.Dst << "] = " << a << ";\n";
+                            else if (jacSlot[inst.Dst] >= 0) ss << "    " << jacArr << "[" << jacSlot[inst.Dst] << "] = " << a << ";\n";
+                            break;
+                    }
+                }
+
+                return ss.str();
+            }
+
+            /*
+            stateNum개의 상태에 대해 식을 계산함. varMat은 (변수 수) x stateNum 크기의 column-major 배열이고,
+            outMat은 (식의 수) x stateNum 크기임. jacMat이 nullptr이 아니면 상태마다 (식의 수) x (변수 수) 크기의
+            Jacobian(jac[i * 식의 수 + j] = d f_j / d x_i)도 함께 계산함.
+            */
+            void evalBatch(const double* varMat, const int& stateNum, double* outMat, double* jacMat = nullptr) const
+            {
+                const int outNum = _OutNode.size();
+                double* outArr[2] = {outMat, jacMat};
+                const int outStride[2] = {outNum, outNum * (int)_VarName.size()};
+
+                if (jacMat == nullptr) _run(_RateProg, varMat, _VarName.size(), stateNum, outArr, outStride);
+                else _run(_JacobProg, varMat, _VarName.size(), stateNum, outArr, outStride);
+            }
+
+            /*
+            한 상태에 대해 속도식을 임의의 스칼라 형식 T(double, Dual, HyperDual 등)로 계산함.
+            var은 변수, param은 매개변수(nullptr이면 setParam으로 지정한 값)이며, out에는 식의 값을 저장함.
+            속도만 계산하는 프로그램(_RateProg)을 T 레지스터로 그대로 실행하므로, Dual로 시드하면
+            바이트코드의 Jacobian(_JacobProg)과 같은 미분을 얻고, 매개변수(온도 등)에 대한 미분과 2계 미분도 얻음.
+            */
+            template <typename T>
+            void evalAD(const T* var, T* out, const T* param = nullptr) const
+            {
+                using std::pow;
+                using std::exp;
+                using std::log;
+                using std::sqrt;
+
+                const auto& prog = _RateProg;
+                std::vector<T> reg(prog.RegNum);
+
+                for (const auto& inst : prog.InstVec)
+                {
+                    switch (inst.Op)
+                    {
+                        case Const: reg[inst.Dst] = T(prog.ConstVec[inst.A]); break;
+                        case Var: reg[inst.Dst] = var[inst.A]; break;
+                        case Param: reg[inst.Dst] = (param == nullptr) ? T(_ParamVec[inst.A]) : param[inst.A]; break;
+                        case Add: reg[inst.Dst] = reg[inst.A] + reg[inst.B]; break;
+                        case Sub: reg[inst.Dst] = reg[inst.A] - reg[inst.B]; break;
+                        case Mul: reg[inst.Dst] = reg[inst.A] * reg[inst.B]; break;
+                        case Div: reg[inst.Dst] = reg[inst.A] / reg[inst.B]; break;
+                        case Pow: reg[inst.Dst] = pow(reg[inst.A], reg[inst.B]); break;
+                        case Neg: reg[inst.Dst] = -reg[inst.A]; break;
+                        case Exp: reg[inst.Dst] = exp(reg[inst.A]); break;
+                        case Log: reg[inst.Dst] = log(reg[inst.A]); break;
+                        case Sqrt: reg[inst.Dst] = sqrt(reg[inst.A]); break;
+                        case Out: if (inst.B == 0) out[inst.Dst] = reg[inst.A]; break;
+                    }
+                }
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -0,0 +1,762 @@
+/*
+core/RxnFamily/SSAEngine.hpp
+----------------------------
+SpeedRxnBase의 반응식과 속도식으로 확률론적 반응 동역학(Gillespie SSA, tau-leaping)을 계산하는 SSAEngine 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_SSAENGINE
+#define _CHEMPROCHELPER_SSAENGINE
+
+namespace chemprochelper
+{
+    /*
+    SSAEngine::simulate의 결과를 저장함. 화학종은 RxnBase::getChemIdx() 순서임.
+    -----------------------------------------------------------------------
+        TimeVec : 출력 시간을 저장함.
+        CountVec : 출력 시간에서의 화학종별 분자 수를 저장함.
+        EventNum : 발생한 반응 사건의 수. (tau-leaping에서는 도약마다 발생한 사건 수의 합)
+        LeapNum : tau-leaping에서 수행한 도약의 수.
+    */
+    struct SSAResult
+    {
+        std::vector<double> TimeVec;
+        std::vector<std::vector<std::int64_t>> CountVec;
+        std::int64_t EventNum = 0;
+        int LeapNum = 0;
+    };
+
+    /*
+    SSAEngine::simulateEnsemble의 결과를 저장함.
+    -----------------------------------------
+        TimeVec : 출력 시간을 저장함.
+        MeanMat, VarMat : 출력 시간에서의 화학종별 분자 수의 평균과 분산. (화학종 수) x (출력 시간 수)
+        TrajNum : 계산한 궤적의 수.
+        EventNum : 모든 궤적에서 발생한 반응 사건의 수.
+    */
+    struct SSAEnsembleResult
+    {
+        std::vector<double> TimeVec;
+        Eigen::MatrixXd MeanMat;
+        Eigen::MatrixXd VarMat;
+        int TrajNum = 0;
+        std::int64_t EventNum = 0;
+    };
+
+    /*
+    확률론적 반응 동역학 엔진.
+    ----------------------
+    SpeedRxnBase의 내장 속도식(PowerLaw, Arrhenius, MassAction, LangmuirHinshelwood)으로부터 반응 채널을 만듦.
+    가역 반응은 정반응과 역반응을 별개의 채널로 둠. 계의 크기 Omega(농도 1에 해당하는 분자 수)에 대해 채널의
+    성향(propensity)은 결정론적 속도식과 같은 극한을 갖도록 다음과 같이 계산함.
+        a_k = Omega * k_k * prod_i [X_i]_a / Omega^a / D^n,  D = 1 + sum_i K_i X_i / Omega
+    ([X]_a는 하강 계승 X (X - 1) ... (X - a + 1). 정수가 아닌 차수는 X^a로 계산함.)
+
+    채널 k가 일어나면 분자 수가 바뀌는 화학종에 의존하는 채널만 성향을 다시 계산함(의존 그래프, CSR 형식).
+    채널 선택은 다음 중 하나를 사용함.
+        Direct : 성향의 이진 합 트리. 선택과 갱신 모두 O(log M)
+        CompositionRejection : 성향을 2의 거듭제곱 구간으로 묶은 그룹을 고르고(그룹 수는 성향의 범위에만
+            의존함), 그룹 안에서는 기각 표본으로 고름. 선택과 갱신이 채널 수 M과 무관함.
+    따라서 사건 하나의 비용은 (의존 채널 수) x (선택 비용)이며, 반응 수가 수천 개로 늘어도 거의 일정함.
+
+    tau-leaping(setTauLeap)은 Cao-Gillespie-Petzold의 tau 선택법으로 도약 크기를 정하고, 채널별 발생 횟수를
+    Poisson 분포로 뽑음. 분자 수가 음수가 되면 tau를 절반으로 줄이고, tau가 10 / a_0보다 작으면 SSA로 100번 진행함.
+    simulateEnsemble은 궤적들을 여러 스레드로 나눠 계산하며, 궤적 n의 난수열은 (_Seed, n)으로 정해지므로
+    결과는 스레드 수와 무관함.
+
+    SSAEngine은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _RxnPtr : 반응식과 속도식을 포함하는 SpeedRxnBase 객체의 포인터를 저장함.
+        _Omega : 계의 크기(농도 1에 해당하는 분자 수)를 저장함.
+        _Method : 채널 선택 방법을 저장함.
+        _TauLeap, _TauEps : tau-leaping의 사용 여부와 허용 오차(epsilon)를 저장함.
+        _Seed : 난수 생성기의 시드를 저장함.
+        _InitCount : 초기 분자 수를 저장함.
+        _ChanConst, _ChanInhib, _ChanDenom : 채널별 상수(Omega^(1-a) k), 분모의 지수, 발생 시 D의 변화량을 저장함.
+        _ReacPtr, _ReacIdx, _ReacOrd : 채널별 반응 차수를 CSR 형식으로 저장함.
+        _DeltaPtr, _DeltaIdx, _DeltaVal : 채널별 분자 수 변화를 CSR 형식으로 저장함.
+        _DepPtr, _DepIdx : 채널별로 성향을 다시 계산해야 하는 채널(의존 그래프)을 CSR 형식으로 저장함.
+        _AdsK : 화학종별 흡착 상수를 Omega로 나눈 값을 저장함.
+        _HighOrd : 화학종별 최고 반응 차수를 저장함. (tau 선택에 사용)
+    */
+    class SSAEngine
+    {
+        public:
+
+            // 채널 선택 방법
+            enum SelectMethod {Direct, CompositionRejection};
+
+        private:
+
+            // CompositionRejection의 그룹. 성향이 [2^(Exp-1), 2^Exp) 구간인 채널을 모음.
+            struct _Group
+            {
+                int Exp = 0;
+                double Sum = 0;
+                std::vector<int> Member;
+            };
+
+            // 궤적 하나의 상태. 스레드마다 하나씩 사용하므로 엔진의 나머지 멤버는 읽기만 함.
+            struct _Traj
+            {
+                std::vector<std::int64_t> Count;
+                std::vector<double> Prop;
+                double Denom = 1;
+
+                // Direct : 이진 합 트리. 잎은 [Leaf, Leaf + 채널 수)
+                std::vector<double> Tree;
+                int Leaf = 1;
+
+                // CompositionRejection : 그룹, 지수별 그룹 인덱스, 채널별 그룹과 그룹 내 위치
+                std::vector<_Group> GroupVec;
+                std::vector<int> GroupMap;
+                std::vector<int> GroupOf;
+                std::vector<int> PosInGroup;
+                int SinceRefresh = 0;
+
+                std::mt19937_64 Rng;
+                std::uniform_real_distribution<double> Unif{0.0, 1.0};
+                std::int64_t EventNum = 0;
+                int LeapNum = 0;
+
+                // (0, 1] 구간의 난수
+                double draw() {return 1.0 - Unif(Rng);}
+            };
+
+            // double의 지수 범위(frexp)를 GroupMap의 인덱스로 바꾸는 오프셋
+            static const int _ExpOffset = 1100;
+
+            // CompositionRejection 그룹 합의 누적 오차를 없애기 위해 다시 계산하는 사건 간격
+            static const int _RefreshNum = 1 << 16;
+
+            // 반응식과 속도식을 포함하는 화학 반응식의 포인터를 저장함.
+            SpeedRxnBase* _RxnPtr = nullptr;
+
+            // 계의 크기를 저장함.
+            double _Omega = 1;
+
+            // 채널 선택 방법을 저장함.
+            SelectMethod _Method = CompositionRejection;
+
+            // tau-leaping의 사용 여부와 허용 오차를 저장함.
+            bool _TauLeap = false;
+            double _TauEps = 0.03;
+
+            // 난수 생성기의 시드를 저장함.
+            std::uint64_t _Seed = 5489;
+
+            // 초기 분자 수를 저장함.
+            std::vector<std::int64_t> _InitCount;
+
+            // 채널 정보
+            int _ChemNum = 0;
+            int _ChanNum = 0;
+            std::vector<double> _ChanConst;
+            std::vector<double> _ChanInhib;
+            std::vector<double> _ChanDenom;
+            std::vector<int> _ReacPtr, _ReacIdx;
+            std::vector<double> _ReacOrd;
+            std::vector<int> _DeltaPtr, _DeltaIdx;
+            std::vector<std::int64_t> _DeltaVal;
+            std::vector<int> _DepPtr, _DepIdx;
+            std::vector<double> _AdsK;
+            std::vector<int> _HighOrd;
+
+            // 반응 차수 행(화학종별)과 분자 수 변화 열(반응식 계수)로 채널 하나를 추가함.
+            void _addChannel(const double& k, const std::vector<float>& OrderRow, const Eigen::VectorXf& DeltaCol,
+                const double& sgn, const double& inhib)
+            {
+                double ordSum = 0;
+                for (auto i = 0; i < _ChemNum; ++i)
+                {
+                    if (OrderRow[i] == 0) continue;
+                    _ReacIdx.push_back(i);
+                    _ReacOrd.push_back(OrderRow[i]);
+                    ordSum += OrderRow[i];
+                    if (OrderRow[i] == std::floor(OrderRow[i])) _HighOrd[i] = std::max<int>(_HighOrd[i], OrderRow[i]);
+                    else _HighOrd[i] = std::max<int>(_HighOrd[i], std::ceil(OrderRow[i]));
+                }
+                _ReacPtr.push_back(_ReacIdx.size());
+
+                double denom = 0;
+                for (auto i = 0; i < _ChemNum; ++i)
+                {
+                    if (DeltaCol[i] == 0) continue;
+                    if (DeltaCol[i] != std::round(DeltaCol[i])) throw std::runtime_error("SSAEngine needs integer stoichiometric coefficients.");
+                    _DeltaIdx.push_back(i);
+                    _DeltaVal.push_back(static_cast<std::int64_t>(std::round(sgn * DeltaCol[i])));
+                    denom += _AdsK[i] * _DeltaVal.back();
+                }
+                _DeltaPtr.push_back(_DeltaIdx.size());
+
+                _ChanConst.push_back(k * std::pow(_Omega, 1 - ordSum));
+                _ChanInhib.push_back(inhib);
+                _ChanDenom.push_back(denom);
+            }
+
+            // SpeedRxnBase로부터 채널과 의존 그래프를 만듦.
+            void _build()
+            {
+                const auto rateLaw = _RxnPtr->getSourceRateLaw();
+                if (rateLaw == SpeedRxnBase::Custom || rateLaw == SpeedRxnBase::Expression) throw std::runtime_error("SSAEngine needs a built-in rate law.");
+
+                const auto effiMat = _RxnPtr->getEffiMat();
+                const auto fwdK = _RxnPtr->getFwdRateConst();
+                const auto revK = _RxnPtr->getRevRateConst();
+                const auto fwdOrd = _RxnPtr->getOrderMat(true);
+                const auto revOrd = _RxnPtr->getOrderMat(false);
+                const auto adsK = _RxnPtr->getAdsK();
+                const auto inhibExp = _RxnPtr->getInhibExp();
+                const int rxnNum = _RxnPtr->getRxnNum();
+
+                _ChemNum = _RxnPtr->getChemNum();
+                _AdsK.resize(_ChemNum);
+                for (auto i = 0; i < _ChemNum; ++i) _AdsK[i] = adsK[i] / _Omega;
+                _HighOrd.assign(_ChemNum, 0);
+
+                _ChanConst.clear();
+                _ChanInhib.clear();
+                _ChanDenom.clear();
+                _ReacPtr.assign(1, 0);
+                _ReacIdx.clear();
+                _ReacOrd.clear();
+                _DeltaPtr.assign(1, 0);
+                _DeltaIdx.clear();
+                _DeltaVal.clear();
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    const Eigen::VectorXf deltaCol = effiMat.col(j);
+                    _addChannel(fwdK[j], fwdOrd[j], deltaCol, 1, inhibExp[j]);
+                    if (revK[j] != 0) _addChannel(revK[j], revOrd[j], deltaCol, -1, inhibExp[j]);
+                }
+                _ChanNum = _ChanConst.size();
+
+                // 화학종 i의 분자 수에 의존하는 채널. 분모가 있는 채널은 흡착 상수가 있는 모든 화학종에 의존함.
+                std::vector<std::vector<int>> chemDep(_ChemNum);
+                for (auto k = 0; k < _ChanNum; ++k)
+                {
+                    for (auto p = _ReacPtr[k]; p < _ReacPtr[k+1]; ++p) chemDep[_ReacIdx[p]].push_back(k);
+                    if (_ChanInhib[k] == 0) continue;
+                    for (auto i = 0; i < _ChemNum; ++i)
+                    {
+                        if (_AdsK[i] != 0 && (chemDep[i].empty() || chemDep[i].back() != k)) chemDep[i].push_back(k);
+                    }
+                }
+
+                // 채널 k가 일어난 뒤 다시 계산할 채널 = k가 바꾸는 화학종에 의존하는 채널의 합집합
+                _DepPtr.assign(1, 0);
+                _DepIdx.clear();
+                std::vector<int> mark(_ChanNum, -1);
+                for (auto k = 0; k < _ChanNum; ++k)
+                {
+                    for (auto p = _DeltaPtr[k]; p < _DeltaPtr[k+1]; ++p)
+                    {
+                        for (auto dep : chemDep[_DeltaIdx[p]])
+                        {
+                            if (mark[dep] == k) continue;
+                            mark[dep] = k;
+                            _DepIdx.push_back(dep);
+                        }
+                    }
+                    _DepPtr.push_back(_DepIdx.size());
+                }
+            }
+
+            // 채널 k의 성향을 계산함.
+            double _calcProp(const _Traj& traj, const int& k) const
+            {
+                double a = _ChanConst[k];
+
+                for (auto p = _ReacPtr[k]; p < _ReacPtr[k+1]; ++p)
+                {
+                    const double x = traj.Count[_ReacIdx[p]];
+                    const double ord = _ReacOrd[p];
+
+                    if (ord == std::floor(ord))
+                    {
+                        for (auto m = 0; m < ord; ++m) a *= x - m;
+                    }
+                    else a *= std::pow(x, ord);
+                }
+
+                if (_ChanInhib[k] != 0) a *= std::pow(traj.Denom, -_ChanInhib[k]);
+
+                return (a > 0) ? a : 0;
+            }
+
+            // 선택 정의부
+
+            // CompositionRejection 그룹에 채널 k를 넣음.
+            void _insertGroup(_Traj& traj, const int& k, const double& a) const
+            {
+                if (a <= 0)
+                {
+                    traj.GroupOf[k] = -1;
+                    return;
+                }
+
+                int e;
+                std::frexp(a, &e);
+
+                int& g = traj.GroupMap[e + _ExpOffset];
+                if (g < 0)
+                {
+                    g = traj.GroupVec.size();
+                    traj.GroupVec.push_back(_Group());
+                    traj.GroupVec.back().Exp = e;
+                }
+
+                auto& group = traj.GroupVec[g];
+                traj.GroupOf[k] = g;
+                traj.PosInGroup[k] = group.Member.size();
+                group.Member.push_back(k);
+                group.Sum += a;
+            }
+
+            // CompositionRejection 그룹에서 채널 k를 뺌. 빈 그룹은 지우지 않고 남겨둠(그룹 수는 지수 범위로 제한됨).
+            void _removeGroup(_Traj& traj, const int& k, const double& a) const
+            {
+                const int g = traj.GroupOf[k];
+                if (g < 0) return;
+
+                auto& group = traj.GroupVec[g];
+                const int pos = traj.PosInGroup[k];
+                const int last = group.Member.back();
+
+                group.Member[pos] = last;
+                traj.PosInGroup[last] = pos;
+                group.Member.pop_back();
+                group.Sum = group.Member.empty() ? 0 : group.Sum - a;
+                traj.GroupOf[k] = -1;
+            }
+
+            // 채널 k의 성향을 a로 바꾸고 선택 구조를 갱신함.
+            void _setProp(_Traj& traj, const int& k, const double& a) const
+            {
+                const double old = traj.Prop[k];
+                traj.Prop[k] = a;
+
+                if (_Method == Direct)
+                {
+                    int i = traj.Leaf + k;
+                    traj.Tree[i] = a;
+                    for (i >>= 1; i > 0; i >>= 1) traj.Tree[i] = traj.Tree[2*i] + traj.Tree[2*i + 1];
+                    return;
+                }
+
+                // 같은 그룹에 남는 경우 합만 고침.
+                const int g = traj.GroupOf[k];
+                if (g >= 0 && a > 0)
+                {
+                    int e;
+                    std::frexp(a, &e);
+                    if (traj.GroupVec[g].Exp == e)
+                    {
+                        traj.GroupVec[g].Sum += a - old;
+                        return;
+                    }
+                }
+
+                _removeGroup(traj, k, old);
+                _insertGroup(traj, k, a);
+            }
+
+            // 모든 채널의 성향을 다시 계산하고 선택 구조를 처음부터 만듦.
+            void _resetProp(_Traj& traj) const
+            {
+                traj.Denom = 1;
+                for (auto i = 0; i < _ChemNum; ++i) traj.Denom += _AdsK[i] * traj.Count[i];
+
+                traj.Prop.resize(_ChanNum);
+                for (auto k = 0; k < _ChanNum; ++k) traj.Prop[k] = _calcProp(traj, k);
+
+                if (_Method == Direct)
+                {
+                    traj.Leaf = 1;
+                    while (traj.Leaf < _ChanNum) traj.Leaf <<= 1;
+                    traj.Tree.assign(2 * traj.Leaf, 0);
+                    for (auto k = 0; k < _ChanNum; ++k) traj.Tree[traj.Leaf + k] = traj.Prop[k];
+                    for (auto i = traj.Leaf - 1; i > 0; --i) traj.Tree[i] = traj.Tree[2*i] + traj.Tree[2*i + 1];
+                    return;
+                }
+
+                traj.GroupVec.clear();
+                traj.GroupMap.assign(2 * _ExpOffset, -1);
+                traj.GroupOf.assign(_ChanNum, -1);
+                traj.PosInGroup.assign(_ChanNum, 0);
+                traj.SinceRefresh = 0;
+                for (auto k = 0; k < _ChanNum; ++k) _insertGroup(traj, k, traj.Prop[k]);
+            }
+
+            // 전체 성향 a_0를 반환함.
+            double _calcTotal(_Traj& traj) const
+            {
+                if (_Method == Direct) return traj.Tree[1];
+
+                // 뺄셈이 누적된 그룹 합을 주기적으로 다시 계산함.
+                if (++traj.SinceRefresh >= _RefreshNum)
+                {
+                    traj.SinceRefresh = 0;
+                    for (auto& group : traj.GroupVec)
+                    {
+                        group.Sum = 0;
+                        for (auto k : group.Member) group.Sum += traj.Prop[k];
+                    }
+                }
+
+                double total = 0;
+                for (const auto& group : traj.GroupVec) total += group.Sum;
+                return total;
+            }
+
+            // 성향에 비례하는 확률로 채널을 고름. 반올림으로 성향이 0인 채널이 골리면 -1을 반환함.
+            int _select(_Traj& traj, const double& total) const
+            {
+                double r = traj.Unif(traj.Rng) * total;
+
+                if (_Method == Direct)
+                {
+                    int i = 1;
+                    while (i < traj.Leaf)
+                    {
+                        if (r < traj.Tree[2*i]) i = 2*i;
+                        else
+                        {
+                            r -= traj.Tree[2*i];
+                            i = 2*i + 1;
+                        }
+                    }
+
+                    const int k = i - traj.Leaf;
+                    return (k < _ChanNum && traj.Prop[k] > 0) ? k : -1;
+                }
+
+                int g = -1;
+                for (auto n = 0; n < traj.GroupVec.size(); ++n)
+                {
+                    if (traj.GroupVec[n].Member.empty()) continue;
+                    g = n;
+                    if (r < traj.GroupVec[n].Sum) break;
+                    r -= traj.GroupVec[n].Sum;
+                }
+                if (g < 0) return -1;
+
+                // 그룹 안에서는 상한 2^Exp에 대한 기각 표본. 기대 시도 횟수는 2 이하임.
+                const auto& group = traj.GroupVec[g];
+                const double upper = std::ldexp(1.0, group.Exp);
+                const int size = group.Member.size();
+                while (true)
+                {
+                    const int k = group.Member[std::min<int>(traj.Unif(traj.Rng) * size, size - 1)];
+                    if (traj.Unif(traj.Rng) * upper < traj.Prop[k]) return k;
+                }
+            }
+
+            // 채널 k를 count번 일으킴. 의존 채널의 성향만 다시 계산함.
+            void _fire(_Traj& traj, const int& k, const std::int64_t& count = 1) const
+            {
+                for (auto p = _DeltaPtr[k]; p < _DeltaPtr[k+1]; ++p) traj.Count[_DeltaIdx[p]] += count * _DeltaVal[p];
+                traj.Denom += count * _ChanDenom[k];
+
+                for (auto p = _DepPtr[k]; p < _DepPtr[k+1]; ++p) _setProp(traj, _DepIdx[p], _calcProp(traj, _DepIdx[p]));
+
+                traj.EventNum += count;
+            }
+
+            // SSA 사건 하나를 진행함. 다음 사건이 tEnd를 넘거나 더 일어날 반응이 없으면 t = tEnd로 두고 false를 반환함.
+            bool _stepSSA(_Traj& traj, double& t, const double& tEnd) const
+            {
+                const double total = _calcTotal(traj);
+                if (total <= 0)
+                {
+                    t = tEnd;
+                    return false;
+                }
+
+                // 대기 시간은 지수 분포(memoryless)이므로 tEnd에서 잘라도 다음 구간의 분포는 같음.
+                const double dt = -std::log(traj.draw()) / total;
+                if (t + dt >= tEnd)
+                {
+                    t = tEnd;
+                    return false;
+                }
+                t += dt;
+
+                const int k = _select(traj, total);
+                if (k >= 0) _fire(traj, k);
+
+                return true;
+            }
+
+            // Cao-Gillespie-Petzold 방법으로 tau를 계산함.
+            double _calcTau(const _Traj& traj) const
+            {
+                std::vector<double> muVec(_ChemNum, 0), sigmaVec(_ChemNum, 0);
+                for (auto k = 0; k < _ChanNum; ++k)
+                {
+                    const double a = traj.Prop[k];
+                    if (a == 0) continue;
+                    for (auto p = _DeltaPtr[k]; p < _DeltaPtr[k+1]; ++p)
+                    {
+                        muVec[_DeltaIdx[p]] += _DeltaVal[p] * a;
+                        sigmaVec[_DeltaIdx[p]] += _DeltaVal[p] * _DeltaVal[p] * a;
+                    }
+                }
+
+                double tau = std::numeric_limits<double>::infinity();
+                for (auto i = 0; i < _ChemNum; ++i)
+                {
+                    if (_HighOrd[i] == 0) continue;
+
+                    // g_i = HOR + sum_m m / (x - m) (같은 화학종이 여러 개 필요한 채널의 보정)
+                    const double x = traj.Count[i];
+                    double g = _HighOrd[i];
+                    for (auto m = 1; m < _HighOrd[i]; ++m) g += (x > m) ? m / (x - m) : 0;
+
+                    const double bound = std::max(_TauEps * x / g, 1.0);
+                    if (muVec[i] != 0) tau = std::min(tau, bound / std::abs(muVec[i]));
+                    if (sigmaVec[i] != 0) tau = std::min(tau, bound * bound / sigmaVec[i]);
+                }
+
+                return tau;
+            }
+
+            // tau-leaping으로 t에서 tEnd까지 진행함.
+            void _advanceTau(_Traj& traj, double& t, const double& tEnd) const
+            {
+                std::vector<std::int64_t> fireVec(_ChanNum), countVec(_ChemNum);
+
+                while (t < tEnd)
+                {
+                    const double total = _calcTotal(traj);
+                    if (total <= 0)
+                    {
+                        t = tEnd;
+                        return;
+                    }
+
+                    double tau = _calcTau(traj);
+
+                    // 도약이 SSA보다 이득이 없으면 SSA로 진행함.
+                    if (tau < 10 / total)
+                    {
+                        for (auto n = 0; n < 100; ++n)
+                        {
+                            if (!_stepSSA(traj, t, tEnd)) return;
+                        }
+                        continue;
+                    }
+
+                    tau = std::min(tau, tEnd - t);
+
+                    while (true)
+                    {
+                        countVec = traj.Count;
+                        bool valid = true;
+
+                        for (auto k = 0; k < _ChanNum && valid; ++k)
+                        {
+                            fireVec[k] = 0;
+                            if (traj.Prop[k] == 0) continue;
+
+                            std::poisson_distribution<std::int64_t> poisson(traj.Prop[k] * tau);
+                            fireVec[k] = poisson(traj.Rng);
+
+                            for (auto p = _DeltaPtr[k]; p < _DeltaPtr[k+1]; ++p) countVec[_DeltaIdx[p]] += fireVec[k] * _DeltaVal[p];
+                        }
+
+                        for (auto i = 0; i < _ChemNum; ++i) valid = valid && countVec[i] >= 0;
+                        if (valid) break;
+
+                        tau /= 2;
+                    }
+
+                    for (auto k = 0; k < _ChanNum; ++k) traj.EventNum += fireVec[k];
+                    traj.Count = countVec;
+                    traj.LeapNum += 1;
+                    t += tau;
+
+                    _resetProp(traj);
+                }
+            }
+
+            // 궤적 trajIdx를 계산함. 출력 시간마다 record(출력 인덱스, 분자 수)를 호출함.
+            template <typename RecordFunc>
+            void _runTraj(_Traj& traj, const int& trajIdx, const std::vector<double>& TimeVec, const RecordFunc& record) const
+            {
+                std::seed_seq seq{static_cast<std::uint32_t>(_Seed), static_cast<std::uint32_t>(_Seed >> 32), static_cast<std::uint32_t>(trajIdx)};
+                traj.Rng.seed(seq);
+                traj.Count = _InitCount;
+                traj.EventNum = 0;
+                traj.LeapNum = 0;
+                _resetProp(traj);
+
+                double t = 0;
+                for (auto n = 0; n < TimeVec.size(); ++n)
+                {
+                    if (_TauLeap) _advanceTau(traj, t, TimeVec[n]);
+                    else while (_stepSSA(traj, t, TimeVec[n]));
+
+                    record(n, traj.Count);
+                }
+            }
+
+            // 출력 시간이 0 이상의 오름차순인지 확인함.
+            static void _checkTimeVec(const std::vector<double>& TimeVec)
+            {
+                for (auto n = 0; n < TimeVec.size(); ++n)
+                {
+                    if (TimeVec[n] < 0 || (n > 0 && TimeVec[n] < TimeVec[n-1])) throw std::runtime_error("SSA output times must be non-negative and increasing.");
+                }
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            SSAEngine() = default;
+
+            // 반응식 RxnPtr와 계의 크기 Omega(농도 1에 해당하는 분자 수)로 채널을 만듦.
+            SSAEngine(SpeedRxnBase* RxnPtr, const double& Omega, const SelectMethod& Method = CompositionRejection):
+                _RxnPtr(RxnPtr), _Omega(Omega), _Method(Method)
+            {
+                if (Omega <= 0) throw std::runtime_error("System size of SSAEngine must be positive.");
+                _build();
+                _InitCount.assign(_ChemNum, 0);
+            }
+
+            // getter 정의부
+
+            auto getRxnPtr() {return _RxnPtr;}
+            auto getOmega() const {return _Omega;}
+            auto getMethod() const {return _Method;}
+            auto getInitCount() const {return _InitCount;}
+            int getChanNum() const {return _ChanNum;}
+
+            // 의존 그래프에서 채널 k가 일어난 뒤 다시 계산하는 채널을 반환함.
+            std::vector<int> getDepChan(const int& k) const {return std::vector<int>(_DepIdx.begin() + _DepPtr[k], _DepIdx.begin() + _DepPtr[k+1]);}
+
+            // setter 정의부
+
+            void setMethod(const SelectMethod& Method) {_Method = Method;}
+            void setSeed(const std::uint64_t& Seed) {_Seed = Seed;}
+
+            // tau-leaping의 사용 여부와 허용 오차(epsilon)를 설정함.
+            void setTauLeap(const bool& TauLeap, const double& TauEps = 0.03)
+            {
+                _TauLeap = TauLeap;
+                _TauEps = TauEps;
+            }
+
+            // 초기 분자 수를 설정함. RxnBase::getChemIdx()의 순서를 따름.
+            void setInitCount(const std::vector<std::int64_t>& InitCount)
+            {
+                if (InitCount.size() != _ChemNum) throw std::runtime_error("Initial counts don't match the number of chemicals.");
+                for (auto x : InitCount)
+                {
+                    if (x < 0) throw std::runtime_error("Initial counts must be non-negative.");
+                }
+                _InitCount = InitCount;
+            }
+
+            // 초기 농도로부터 분자 수(round(c * Omega))를 설정함.
+            void setInitConc(const std::vector<double>& InitConc)
+            {
+                if (InitConc.size() != _ChemNum) throw std::runtime_error("Initial concentrations don't match the number of chemicals.");
+
+                std::vector<std::int64_t> InitCount(_ChemNum);
+                for (auto i = 0; i < _ChemNum; ++i) InitCount[i] = std::llround(InitConc[i] * _Omega);
+                setInitCount(InitCount);
+            }
+
+            // 속도식의 매개변수(온도 등)가 바뀐 경우 채널을 다시 만듦.
+            void rebuild()
+            {
+                _build();
+            }
+
+            // 인스턴스 정의부
+
+            // 궤적 하나를 계산해 출력 시간(TimeVec, 0 이상의 오름차순)에서의 분자 수를 반환함.
+            SSAResult simulate(const std::vector<double>& TimeVec, const int& trajIdx = 0) const
+            {
+                _checkTimeVec(TimeVec);
+
+                SSAResult res;
+                res.TimeVec = TimeVec;
+                res.CountVec.resize(TimeVec.size());
+
+                _Traj traj;
+                _runTraj(traj, trajIdx, TimeVec, [&](const int& n, const std::vector<std::int64_t>& count) {res.CountVec[n] = count;});
+
+                res.EventNum = traj.EventNum;
+                res.LeapNum = traj.LeapNum;
+
+                return res;
+            }
+
+            /*
+            TrajNum개의 궤적을 ThreadNum개의 스레드(0이면 하드웨어 스레드 수)로 나눠 계산하고,
+            출력 시간에서의 분자 수의 평균과 분산을 반환함. 스레드마다 궤적 상태와 누적 버퍼를 따로 둠.
+            */
+            SSAEnsembleResult simulateEnsemble(const std::vector<double>& TimeVec, const int& TrajNum, int ThreadNum = 0) const
+            {
+                _checkTimeVec(TimeVec);
+                if (TrajNum <= 0) throw std::runtime_error("Number of SSA trajectories must be positive.");
+
+                if (ThreadNum <= 0) ThreadNum = std::max<int>(1, std::thread::hardware_concurrency());
+                ThreadNum = std::min(ThreadNum, TrajNum);
+
+                const int outNum = TimeVec.size();
+                std::vector<Eigen::MatrixXd> sumVec(ThreadNum, Eigen::MatrixXd::Zero(_ChemNum, outNum));
+                std::vector<Eigen::MatrixXd> sqVec(ThreadNum, Eigen::MatrixXd::Zero(_ChemNum, outNum));
+                std::vector<std::int64_t> eventVec(ThreadNum, 0);
+
+                auto worker = [&](const int tid)
+                {
+                    _Traj traj;
+                    auto& sumMat = sumVec[tid];
+                    auto& sqMat = sqVec[tid];
+
+                    for (auto n = tid; n < TrajNum; n += ThreadNum)
+                    {
+                        _runTraj(traj, n, TimeVec, [&](const int& m, const std::vector<std::int64_t>& count)
+                        {
+                            for (auto i = 0; i < _ChemNum; ++i)
+                            {
+                                const double x = count[i];
+                                sumMat(i, m) += x;
+                                sqMat(i, m) += x * x;
+                            }
+                        });
+                        eventVec[tid] += traj.EventNum;
+                    }
+                };
+
+                std::vector<std::thread> threadVec;
+                for (auto tid = 1; tid < ThreadNum; ++tid) threadVec.emplace_back(worker, tid);
+                worker(0);
+                for (auto& th : threadVec) th.join();
+
+                SSAEnsembleResult res;
+                res.TimeVec = TimeVec;
+                res.TrajNum = TrajNum;
+                res.MeanMat = Eigen::MatrixXd::Zero(_ChemNum, outNum);
+                res.VarMat = Eigen::MatrixXd::Zero(_ChemNum, outNum);
+
+                for (auto tid = 0; tid < ThreadNum; ++tid)
+                {
+                    res.MeanMat += sumVec[tid];
+                    res.VarMat += sqVec[tid];
+                    res.EventNum += eventVec[tid];
+                }
+                res.MeanMat /= TrajNum;
+                res.VarMat = (res.VarMat / TrajNum - res.MeanMat.cwiseProduct(res.MeanMat)).cwiseMax(0.0);
+                if (TrajNum > 1) res.VarMat *= static_cast<double>(TrajNum) / (TrajNum - 1);
+
+                return res;
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -0,0 +1,570 @@
+/*
+core/RxnFamily/SparseBDF.hpp
+----------------------------
+희소 Jacobian을 사용하는 가변 차수, 가변 간격 BDF 적분기 SparseBDF를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_SPARSEBDF
+#define _CHEMPROCHELPER_SPARSEBDF
+
+namespace chemprochelper
+{
+    #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+    /*
+    SparseBDF::solve의 결과를 저장함.
+    -------------------------------
+        TimeVec : 출력 시간을 저장함.
+        StateVec : 출력 시간에서의 상태를 저장함.
+        StepNum, RejectNum : 받아들인 단계와 기각된 단계의 수.
+        FuncNum, JacobNum, LUNum : 우변, Jacobian 계산과 LU 수치 분해의 횟수.
+    */
+    struct BDFResult
+    {
+        std::vector<double> TimeVec;
+        std::vector<std::vector<double>> StateVec;
+        int StepNum = 0;
+        int RejectNum = 0;
+        int FuncNum = 0;
+        int JacobNum = 0;
+        int LUNum = 0;
+    };
+
+    /*
+    희소 Jacobian을 사용하는 stiff ODE 적분기.
+    ---------------------------------------
+    dy/dt = f(t, y)를 1~5차 BDF(준등간격 역차분 형식, NDF 계수)로 적분하며, 간격과 차수를 국소 오차에 따라 바꿈.
+    각 단계의 Newton 반복은 반복 행렬 M = I - c J (c = h / alpha_k)를 사용하며,
+        - J의 희소 패턴은 생성자에서 한 번 정해지고, Eigen::SparseLU가 COLAMD 순서로 기호 분해(analyzePattern)를
+          한 번만 수행함. 이후에는 값만 바꿔 수치 분해(factorize)함.
+        - LU는 간격이나 차수가 바뀔 때만 다시 분해함.
+        - J는 Newton 반복이 수렴하지 않고 현재 J가 오래된 경우에만 다시 계산함(lazy Jacobian).
+    출력 시간 사이의 값은 역차분으로부터 보간하므로 출력 시간이 단계를 자르지 않음.
+
+    SpeedRxnBase로 만드는 경우 상태는 c = y / Scale를 농도로 하는 dy/dt = v(nu) r(c)이며,
+    J = v (d r / d c) / Scale의 패턴은 반응식의 계수와 SpeedRxnBase::getJacobPattern으로부터 정함.
+        ex) 회분식 반응기 : Scale = 1, PFR : y = F, Scale = v_0 (부피 유량)
+
+    SparseBDF는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _Dim : 상태의 크기를 저장함.
+        _Func, _JacobFunc : 우변과 Jacobian 값(패턴 순서)을 계산하는 함수를 저장함.
+        _JacobMap : Jacobian 패턴의 원소별 희소 행렬 상 위치를 저장함.
+        _DiagPos : 대각 원소의 희소 행렬 상 위치를 저장함.
+        _JacobMat, _IterMat : 같은 패턴의 J와 M = I - c J를 저장함.
+        _LU : COLAMD 순서의 희소 LU 분해를 저장함. 기호 분해는 생성자에서 한 번만 함.
+        _AbsTol, _RelTol, _MaxStep : 허용 오차와 최대 간격을 저장함.
+    */
+    class SparseBDF
+    {
+        public:
+
+            // 우변 (t, y, dydt)
+            using FuncType = std::function<void(const double&, const double*, double*)>;
+
+            // Jacobian 값 (t, y, val). val은 생성자에서 지정한 패턴의 순서를 따름.
+            using JacobFuncType = std::function<void(const double&, const double*, double*)>;
+
+        private:
+
+            using _SpMatType = Eigen::SparseMatrix<double>;
+
+            static const int _MaxOrder = 5;
+            static const int _NewtonMaxIter = 4;
+
+            // 상태의 크기를 저장함.
+            int _Dim = 0;
+
+            // 우변과 Jacobian을 계산하는 함수를 저장함.
+            FuncType _Func;
+            JacobFuncType _JacobFunc;
+
+            // Jacobian 패턴의 원소 수와 원소별 희소 행렬 상 위치를 저장함.
+            int _JacobNnz = 0;
+            std::vector<int> _JacobMap;
+            std::vector<int> _DiagPos;
+
+            // J와 반복 행렬. 같은 패턴(J의 패턴과 대각 원소의 합집합)을 가짐.
+            _SpMatType _JacobMat;
+            _SpMatType _IterMat;
+
+            // 희소 LU 분해. 기호 분해는 생성자에서 한 번만 함.
+            Eigen::SparseLU<_SpMatType, Eigen::COLAMDOrdering<int>> _LU;
+
+            // 허용 오차와 최대 간격을 저장함.
+            double _AbsTol = 1e-8;
+            double _RelTol = 1e-6;
+            double _MaxStep = std::numeric_limits<double>::infinity();
+
+            // Jacobian 값 작업 공간
+            std::vector<double> _JacobWork;
+
+            // BDF 계수. (NDF의 kappa, gamma_k = sum_{j<=k} 1/j, alpha_k = (1 - kappa_k) gamma_k)
+            static double _kappa(const int& k)
+            {
+                static const double kappa[_MaxOrder + 1] = {0, -0.1850, -1.0 / 9, -0.0823, -0.0415, 0};
+                return kappa[k];
+            }
+            static double _gamma(const int& k)
+            {
+                double g = 0;
+                for (auto j = 1; j <= k; ++j) g += 1.0 / j;
+                return g;
+            }
+            static double _alpha(const int& k) {return (1 - _kappa(k)) * _gamma(k);}
+            static double _errConst(const int& k) {return _kappa(k) * _gamma(k) + 1.0 / (k + 1);}
+
+            // 가중 RMS 노름
+            static double _norm(const Eigen::VectorXd& x, const Eigen::VectorXd& scale)
+            {
+                if (x.size() == 0) return 0;
+                return (x.array() / scale.array()).matrix().norm() / std::sqrt(static_cast<double>(x.size()));
+            }
+
+            // 간격을 factor배로 바꿀 때 역차분을 변환하는 행렬 R(order, factor)
+            static Eigen::MatrixXd _calcR(const int& order, const double& factor)
+            {
+                Eigen::MatrixXd M = Eigen::MatrixXd::Zero(order + 1, order + 1);
+                M.row(0).setOnes();
+                for (auto i = 1; i <= order; ++i)
+                {
+                    for (auto j = 1; j <= order; ++j) M(i, j) = (i - 1 - factor * j) / i;
+                }
+
+                // 열 방향 누적 곱
+                for (auto i = 1; i <= order; ++i) M.row(i) = M.row(i).cwiseProduct(M.row(i-1));
+
+                return M;
+            }
+
+            // 역차분 D(열)의 간격을 factor배로 바꿈.
+            static void _changeD(Eigen::MatrixXd& D, const int& order, const double& factor)
+            {
+                const Eigen::MatrixXd RU = _calcR(order, factor) * _calcR(order, 1);
+                D.leftCols(order + 1) = (D.leftCols(order + 1) * RU).eval();
+            }
+
+            // 패턴(rowIdx, colIdx)으로 J와 반복 행렬의 구조를 만들고 기호 분해를 수행함.
+            void _setPattern(const std::vector<int>& rowIdx, const std::vector<int>& colIdx)
+            {
+                if (rowIdx.size() != colIdx.size()) throw std::runtime_error("Jacobian pattern of SparseBDF is invalid.");
+
+                _JacobNnz = rowIdx.size();
+
+                std::vector<Eigen::Triplet<double>> tripVec;
+                tripVec.reserve(_JacobNnz + _Dim);
+                for (auto p = 0; p < _JacobNnz; ++p)
+                {
+                    if (rowIdx[p] < 0 || rowIdx[p] >= _Dim || colIdx[p] < 0 || colIdx[p] >= _Dim) throw std::runtime_error("Jacobian pattern of SparseBDF is out of range.");
+                    tripVec.emplace_back(rowIdx[p], colIdx[p], 0.0);
+                }
+                for (auto i = 0; i < _Dim; ++i) tripVec.emplace_back(i, i, 0.0);
+
+                _JacobMat.resize(_Dim, _Dim);
+                _JacobMat.setFromTriplets(tripVec.begin(), tripVec.end());
+                _JacobMat.makeCompressed();
+
+                // 원소별 위치. 열 안에서 행 인덱스는 정렬되어 있음.
+                auto findPos = [&](const int& i, const int& k)
+                {
+                    const int* begin = _JacobMat.innerIndexPtr() + _JacobMat.outerIndexPtr()[k];
+                    const int* end = _JacobMat.innerIndexPtr() + _JacobMat.outerIndexPtr()[k+1];
+                    return static_cast<int>(std::lower_bound(begin, end, i) - _JacobMat.innerIndexPtr());
+                };
+
+                _JacobMap.resize(_JacobNnz);
+                for (auto p = 0; p < _JacobNnz; ++p) _JacobMap[p] = findPos(rowIdx[p], colIdx[p]);
+
+                _DiagPos.resize(_Dim);
+                for (auto i = 0; i < _Dim; ++i) _DiagPos[i] = findPos(i, i);
+
+                _IterMat = _JacobMat;
+                for (auto i = 0; i < _Dim; ++i) _IterMat.valuePtr()[_DiagPos[i]] = 1;
+
+                _LU.analyzePattern(_IterMat);
+                _JacobWork.assign(_JacobNnz, 0);
+            }
+
+            // J를 계산함.
+            void _updateJacob(const double& t, const Eigen::VectorXd& y)
+            {
+                _JacobFunc(t, y.data(), _JacobWork.data());
+
+                double* val = _JacobMat.valuePtr();
+                std::fill(val, val + _JacobMat.nonZeros(), 0.0);
+                for (auto p = 0; p < _JacobNnz; ++p) val[_JacobMap[p]] += _JacobWork[p];
+            }
+
+            // M = I - c J를 만들고 수치 분해만 수행함(기호 분해는 재사용).
+            void _factorize(const double& c)
+            {
+                const int nnz = _JacobMat.nonZeros();
+                const double* jVal = _JacobMat.valuePtr();
+                double* mVal = _IterMat.valuePtr();
+
+                for (auto p = 0; p < nnz; ++p) mVal[p] = -c * jVal[p];
+                for (auto i = 0; i < _Dim; ++i) mVal[_DiagPos[i]] += 1;
+
+                _LU.factorize(_IterMat);
+                if (_LU.info() != Eigen::Success) throw std::runtime_error("Sparse LU factorization in SparseBDF failed.");
+            }
+
+            // 첫 간격을 추정함. (Hairer, Norsett, Wanner의 방법)
+            double _selectInitStep(const double& t0, const Eigen::VectorXd& y0, const Eigen::VectorXd& f0,
+                const double& interval, int& funcNum)
+            {
+                const Eigen::VectorXd scale = (_AbsTol + _RelTol * y0.array().abs()).matrix();
+                const double d0 = _norm(y0, scale);
+                const double d1 = _norm(f0, scale);
+                const double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+
+                const Eigen::VectorXd y1 = y0 + h0 * f0;
+                Eigen::VectorXd f1(_Dim);
+                _Func(t0 + h0, y1.data(), f1.data());
+                ++funcNum;
+
+                const double d2 = _norm(f1 - f0, scale) / h0;
+                const double h1 = (d1 <= 1e-15 && d2 <= 1e-15) ? std::max(1e-6, h0 * 1e-3) : std::sqrt(0.01 / std::max(d1, d2));
+
+                return std::min({100 * h0, h1, interval});
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            SparseBDF() = default;
+
+            /*
+            크기 Dim인 일반 시스템. Jacobian의 패턴은 (RowIdx[p], ColIdx[p]) 쌍으로 지정하고,
+            JacobFunc는 같은 순서로 값을 채움. 같은 위치가 여러 번 나오면 값을 더함.
+            */
+            SparseBDF(const int& Dim, const FuncType& Func, const JacobFuncType& JacobFunc,
+                const std::vector<int>& RowIdx, const std::vector<int>& ColIdx):
+                _Dim(Dim), _Func(Func), _JacobFunc(JacobFunc)
+            {
+                _setPattern(RowIdx, ColIdx);
+            }
+
+            /*
+            SpeedRxnBase의 반응식으로부터 dy/dt = v(nu) r(y / Scale)를 만듦. y는 RxnBase::getChemIdx()의 순서이며,
+            음수인 y는 농도 0으로 취급함. J = v (d r / d c) / Scale은 희소 속도 Jacobian으로부터 원소별로 모음.
+            */
+            SparseBDF(SpeedRxnBase* RxnPtr, const double& Scale = 1)
+            {
+                const int chemNum = RxnPtr->getChemNum();
+                const int rxnNum = RxnPtr->getRxnNum();
+                const Eigen::MatrixXd stoiMat = RxnPtr->getEffiMat().block(0, 0, chemNum, rxnNum).cast<double>();
+
+                // 반응별로 계수가 0이 아닌 화학종
+                std::vector<std::vector<std::pair<int, double>>> stoiCol(rxnNum);
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (stoiMat(i, j) != 0) stoiCol[j].emplace_back(i, stoiMat(i, j));
+                    }
+                }
+
+                // J_ik = sum_j v_ij R_jk / Scale. 속도 Jacobian 원소 q = (j, k)가 J의 (i, k)들에 기여함.
+                std::vector<int> rxnIdx, chemIdx;
+                RxnPtr->getJacobPattern(rxnIdx, chemIdx);
+
+                std::vector<int> rowIdx, colIdx, srcIdx;
+                std::vector<double> coefVec;
+                for (auto q = 0; q < rxnIdx.size(); ++q)
+                {
+                    for (const auto& pair : stoiCol[rxnIdx[q]])
+                    {
+                        rowIdx.push_back(pair.first);
+                        colIdx.push_back(chemIdx[q]);
+                        srcIdx.push_back(q);
+                        coefVec.push_back(pair.second / Scale);
+                    }
+                }
+
+                auto concVec = std::make_shared<std::vector<double>>(chemNum);
+                auto rateVec = std::make_shared<std::vector<double>>(rxnNum);
+                auto rateJacVec = std::make_shared<std::vector<double>>(rxnIdx.size());
+
+                auto setConc = [=](const double* y)
+                {
+                    for (auto i = 0; i < chemNum; ++i) (*concVec)[i] = std::max(y[i], 0.0) / Scale;
+                };
+
+                _Dim = chemNum;
+                _Func = [=](const double& /* t */, const double* y, double* dydt)
+                {
+                    setConc(y);
+                    RxnPtr->calcRate(concVec->data(), rateVec->data());
+
+                    std::fill(dydt, dydt + chemNum, 0.0);
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        for (const auto& pair : stoiCol[j]) dydt[pair.first] += pair.second * (*rateVec)[j];
+                    }
+                };
+                _JacobFunc = [=](const double& /* t */, const double* y, double* val)
+                {
+                    setConc(y);
+                    RxnPtr->calcRateJacobianSparse(concVec->data(), rateVec->data(), rateJacVec->data());
+                    for (auto p = 0; p < srcIdx.size(); ++p) val[p] = coefVec[p] * (*rateJacVec)[srcIdx[p]];
+                };
+
+                _setPattern(rowIdx, colIdx);
+            }
+
+            // getter 정의부
+
+            int getDim() const {return _Dim;}
+            int getJacobNnz() const {return _JacobMat.nonZeros();}
+
+            // setter 정의부
+
+            void setTolerance(const double& AbsTol, const double& RelTol)
+            {
+                _AbsTol = AbsTol;
+                _RelTol = RelTol;
+            }
+            void setMaxStep(const double& MaxStep) {_MaxStep = MaxStep;}
+
+            // 인스턴스 정의부
+
+            /*
+            t0에서의 상태 y로부터 출력 시간 TimeVec(t0 이상의 오름차순)까지 적분함.
+            y에는 마지막 출력 시간의 상태를 덮어씀.
+            */
+            BDFResult solve(std::vector<double>& y, const double& t0, const std::vector<double>& TimeVec)
+            {
+                if (y.size() != _Dim) throw std::runtime_error("State size doesn't match SparseBDF.");
+                for (auto n = 0; n < TimeVec.size(); ++n)
+                {
+                    if (TimeVec[n] < t0 || (n > 0 && TimeVec[n] < TimeVec[n-1])) throw std::runtime_error("SparseBDF output times must be increasing from t0.");
+                }
+
+                BDFResult res;
+                res.TimeVec = TimeVec;
+                res.StateVec.resize(TimeVec.size());
+                if (TimeVec.empty()) return res;
+
+                const double tEnd = TimeVec.back();
+                const double eps = std::numeric_limits<double>::epsilon();
+                const double newtonTol = std::max(10 * eps / _RelTol, std::min(0.03, std::sqrt(_RelTol)));
+
+                Eigen::VectorXd yVec = Eigen::Map<const Eigen::VectorXd>(y.data(), _Dim);
+                Eigen::VectorXd fVec(_Dim);
+                _Func(t0, yVec.data(), fVec.data());
+                ++res.FuncNum;
+
+                // 역차분 D. 0열은 y, 1열은 h f
+                Eigen::MatrixXd D = Eigen::MatrixXd::Zero(_Dim, _MaxOrder + 3);
+                double t = t0;
+                double hAbs = (tEnd > t0) ? std::min(_MaxStep, _selectInitStep(t0, yVec, fVec, tEnd - t0, res.FuncNum)) : 0;
+                D.col(0) = yVec;
+                D.col(1) = fVec * hAbs;
+
+                int order = 1;
+                int equalStep = 0;
+                bool luValid = false;
+                bool jacobCurrent = false;
+
+                _updateJacob(t, yVec);
+                ++res.JacobNum;
+                jacobCurrent = true;
+
+                Eigen::VectorXd yPredict(_Dim), psi(_Dim), scale(_Dim), yNew(_Dim), d(_Dim), dy(_Dim), rhs(_Dim), f(_Dim);
+                int outIdx = 0;
+
+                // t0와 같은 출력 시간
+                while (outIdx < TimeVec.size() && TimeVec[outIdx] <= t)
+                {
+                    res.StateVec[outIdx] = y;
+                    ++outIdx;
+                }
+
+                while (outIdx < TimeVec.size())
+                {
+                    const double minStep = 10 * eps * std::max(std::abs(t), 1.0);
+                    if (hAbs > _MaxStep)
+                    {
+                        _changeD(D, order, _MaxStep / hAbs);
+                        hAbs = _MaxStep;
+                        equalStep = 0;
+                        luValid = false;
+                    }
+                    else if (hAbs < minStep)
+                    {
+                        _changeD(D, order, minStep / hAbs);
+                        hAbs = minStep;
+                        equalStep = 0;
+                        luValid = false;
+                    }
+
+                    bool accepted = false;
+                    double tNew = t, h = hAbs, errNorm = 0, safety = 0.9;
+
+                    while (!accepted)
+                    {
+                        if (hAbs < minStep) throw std::runtime_error("SparseBDF step size became too small.");
+
+                        h = hAbs;
+                        tNew = t + h;
+                        if (tNew > tEnd)
+                        {
+                            tNew = tEnd;
+                            _changeD(D, order, (tNew - t) / hAbs);
+                            equalStep = 0;
+                            luValid = false;
+                            h = tNew - t;
+                            hAbs = h;
+                        }
+
+                        yPredict = D.leftCols(order + 1).rowwise().sum();
+                        scale = (_AbsTol + _RelTol * yPredict.array().abs()).matrix();
+                        psi.setZero();
+                        for (auto j = 1; j <= order; ++j) psi += _gamma(j) * D.col(j);
+                        psi /= _alpha(order);
+
+                        const double c = h / _alpha(order);
+                        bool converged = false;
+                        int newtonIter = 0;
+
+                        while (!converged)
+                        {
+                            if (!luValid)
+                            {
+                                _factorize(c);
+                                ++res.LUNum;
+                                luValid = true;
+                            }
+
+                            // 단순화된 Newton 반복
+                            d.setZero();
+                            yNew = yPredict;
+                            double dyNormOld = -1;
+                            for (newtonIter = 0; newtonIter < _NewtonMaxIter; ++newtonIter)
+                            {
+                                _Func(tNew, yNew.data(), f.data());
+                                ++res.FuncNum;
+                                if (!f.allFinite()) break;
+
+                                rhs = c * f - psi - d;
+                                dy = _LU.solve(rhs);
+                                const double dyNorm = _norm(dy, scale);
+
+                                double rate = -1;
+                                if (dyNormOld > 0)
+                                {
+                                    rate = dyNorm / dyNormOld;
+                                    if (rate >= 1 || std::pow(rate, _NewtonMaxIter - newtonIter) / (1 - rate) * dyNorm > newtonTol) break;
+                                }
+
+                                yNew += dy;
+                                d += dy;
+
+                                if (dyNorm == 0 || (rate >= 0 && rate / (1 - rate) * dyNorm < newtonTol))
+                                {
+                                    converged = true;
+                                    ++newtonIter;
+                                    break;
+                                }
+                                dyNormOld = dyNorm;
+                            }
+
+                            if (converged) break;
+                            if (jacobCurrent) break;
+
+                            // 오래된 Jacobian으로 수렴하지 않은 경우에만 다시 계산함.
+                            _updateJacob(tNew, yPredict);
+                            ++res.JacobNum;
+                            jacobCurrent = true;
+                            luValid = false;
+                        }
+
+                        if (!converged)
+                        {
+                            hAbs *= 0.5;
+                            _changeD(D, order, 0.5);
+                            equalStep = 0;
+                            luValid = false;
+                            ++res.RejectNum;
+                            continue;
+                        }
+
+                        safety = 0.9 * (2 * _NewtonMaxIter + 1) / (2 * _NewtonMaxIter + newtonIter);
+                        scale = (_AbsTol + _RelTol * yNew.array().abs()).matrix();
+                        errNorm = _norm(_errConst(order) * d, scale);
+
+                        if (errNorm > 1)
+                        {
+                            const double factor = std::max(0.2, safety * std::pow(errNorm, -1.0 / (order + 1)));
+                            hAbs *= factor;
+                            _changeD(D, order, factor);
+                            equalStep = 0;
+                            luValid = false;
+                            ++res.RejectNum;
+                        }
+                        else accepted = true;
+                    }
+
+                    ++res.StepNum;
+                    ++equalStep;
+                    jacobCurrent = false;
+
+                    // 역차분 갱신
+                    D.col(order + 2) = d - D.col(order + 1);
+                    D.col(order + 1) = d;
+                    for (auto i = order; i >= 0; --i) D.col(i) += D.col(i + 1);
+
+                    // (t, tNew] 구간의 출력 시간을 역차분으로 보간함.
+                    while (outIdx < TimeVec.size() && TimeVec[outIdx] <= tNew)
+                    {
+                        Eigen::VectorXd yOut = D.col(0);
+                        double p = 1;
+                        for (auto j = 0; j < order; ++j)
+                        {
+                            p *= (TimeVec[outIdx] - (tNew - h * j)) / (h * (1 + j));
+                            yOut += p * D.col(j + 1);
+                        }
+                        res.StateVec[outIdx].assign(yOut.data(), yOut.data() + _Dim);
+                        ++outIdx;
+                    }
+
+                    t = tNew;
+                    if (equalStep < order + 1) continue;
+
+                    // 차수를 하나 내리거나 올렸을 때의 오차로 다음 차수와 간격을 정함.
+                    const double errM = (order > 1) ? _norm(_errConst(order - 1) * D.col(order), scale) : std::numeric_limits<double>::infinity();
+                    const double errP = (order < _MaxOrder) ? _norm(_errConst(order + 1) * D.col(order + 2), scale) : std::numeric_limits<double>::infinity();
+
+                    const double errVec[3] = {errM, errNorm, errP};
+                    double bestFactor = 0;
+                    int delta = 0;
+                    for (auto m = 0; m < 3; ++m)
+                    {
+                        const double factor = (errVec[m] == 0) ? std::numeric_limits<double>::infinity() : std::pow(errVec[m], -1.0 / (order + m));
+                        if (factor > bestFactor)
+                        {
+                            bestFactor = factor;
+                            delta = m - 1;
+                        }
+                    }
+
+                    order += delta;
+                    const double factor = std::min(10.0, safety * bestFactor);
+                    hAbs *= factor;
+                    _changeD(D, order, factor);
+                    equalStep = 0;
+                    luValid = false;
+                }
+
+                y = res.StateVec.back();
+
+                return res;
+            }
+    };
+
+    #endif
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
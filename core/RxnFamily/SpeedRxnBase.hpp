@@ -14,13 +14,1087 @@ namespace chemprochelper
     SpeedRxnBase는 다음과 같은 멤버변수를 가짐.
     private:
         _SpeedFunc : 화학 반응 속도식(std::functional)을 저장함.
+        _JacobFunc : 화학 반응 속도식의 Jacobian(d r / d c)을 저장함.
+        _RateLaw : 내장 속도식의 종류를 저장함. Custom인 경우 _SpeedFunc를 사용함.
+        _FwdPreExp, _FwdActEnergy, _RevPreExp, _RevActEnergy : 정/역반응의 Arrhenius 상수를 저장함.
+        _FwdPtr, _FwdIdx, _FwdOrd, _RevPtr, _RevIdx, _RevOrd : 정/역반응의 반응 차수를 CSR 형식으로 저장함.
+        _AdsK, _InhibExp : Langmuir-Hinshelwood 식의 흡착 상수와 분모의 지수를 저장함.
+        _Temp : 반응 온도를 저장함.
+        _ExprVM : 문자열로 주어진 속도식(Expression)을 컴파일한 RateExprVM 객체를 저장함.
+        _MechPtr : MechCodeGen으로 생성해 컴파일한 메커니즘(Compiled)의 포인터를 저장함.
+
+    calcRateAD는 같은 속도식을 Dual(자동 미분) 등 임의의 스칼라 형식으로 계산하며, 온도도 독립 변수로 다룰 수 있음.
+
+    내장 속도식은 모두 다음의 통합된 형식으로 계산함. (D = 1 + sum_i K_i c_i)
+        r_j = (kf_j * prod_i c_i^a_ij - kr_j * prod_i c_i^b_ij) / D^n_j
+        kf_j = A_j * exp(-Ea_j / RT), kr_j = A'_j * exp(-Ea'_j / RT)
+    따라서 반응마다 std::function을 호출하지 않고, 모든 반응의 속도와 Jacobian을 한 번의 순회로 계산함.
+    Expression 속도식은 화학종의 축약형과 온도 T를 변수로 사용하는 문자열이며, RateExprVM으로 계산함.
+
+    농도(conc)는 RxnBase::getChemIdx()의 순서를, 반응 속도(rate)는 반응식의 순서를 따름.
+    Jacobian은 (반응 수) x (화학종 수) 크기의 column-major 배열로 저장함.
     */
     class SpeedRxnBase : public RxnBase
     {
         public:
-            
-            
 
+            // 모든 반응의 속도를 한 번에 계산하는 함수의 형식. (conc, rate)
+            using SpeedFuncType = std::function<void(const double*, double*)>;
+
+            // 모든 반응 속도의 Jacobian을 한 번에 계산하는 함수의 형식. (conc, jac)
+            using JacobFuncType = std::function<void(const double*, double*)>;
+
+            // 내장 속도식의 종류
+            enum RateLawType {Custom, PowerLaw, Arrhenius, MassAction, LangmuirHinshelwood, Expression, Compiled};
+
+        private:
+
+            // 화학 반응 속도식을 저장함.
+            SpeedFuncType _SpeedFunc;
+
+            // 화학 반응 속도식의 Jacobian을 저장함. 없는 경우 수치 미분을 사용함.
+            JacobFuncType _JacobFunc;
+
+            // 내장 속도식의 종류를 저장함.
+            RateLawType _RateLaw = Custom;
+
+            // 정/역반응의 Arrhenius 상수를 저장함. 활성화 에너지가 0이면 속도 상수는 온도와 무관함.
+            std::vector<double> _FwdPreExp, _FwdActEnergy;
+            std::vector<double> _RevPreExp, _RevActEnergy;
+
+            // 현재 온도에서의 속도 상수를 저장함.
+            std::vector<double> _FwdK, _RevK;
+
+            // 정/역반응의 반응 차수(CSR 형식). 반응 j의 항은 [Ptr[j], Ptr[j+1]) 구간에 있음.
+            std::vector<int> _FwdPtr, _FwdIdx, _RevPtr, _RevIdx;
+            std::vector<double> _FwdOrd, _RevOrd;
+
+            // Langmuir-Hinshelwood 식의 흡착 상수(화학종별)와 분모의 지수(반응별)를 저장함.
+            std::vector<double> _AdsK;
+            std::vector<double> _InhibExp;
+
+            // 반응 온도(K)를 저장함.
+            double _Temp = 298.15;
+
+            // 문자열 속도식을 컴파일한 가상 머신과 원래의 문자열을 저장함.
+            RateExprVM _ExprVM;
+            std::vector<std::string> _ExprVec;
+
+            // 컴파일된 메커니즘의 포인터를 저장함. 이전 속도식(_CompiledFrom)의 매개변수는 그대로 유지함.
+            const CompiledMech* _MechPtr = nullptr;
+            RateLawType _CompiledFrom = Custom;
+
+            /*
+            화학종 수와 반응 수를 저장함. const 메소드는 멤버를 고치지 않으므로, 같은 객체를 여러 스레드에서
+            동시에 계산에 사용할 수 있음(set* 메소드와는 동시에 호출할 수 없음). 작업 공간은 호출마다 지역 변수로 잡음.
+            */
+            int _ChemNum = 0;
+            int _RxnNum = 0;
+
+            // calcRateBatch가 한 번에 계산하는 상태의 수. 작업 공간이 캐시에 남도록 나눠서 계산함.
+            static const int _BatchBlock = 256;
+
+            // Custom 속도식의 희소 패턴으로 사용하는 반응식 계수의 패턴(반응별 CSR)과 Expression의 Jacobian 패턴을 저장함.
+            std::vector<int> _StoiPtr, _StoiIdx;
+            std::vector<bool> _ExprMask;
+
+            /*
+            속도식을 지정할 때 한 번 만드는 희소 Jacobian 패턴. _PatPtr, _PatIdx는 반응별 화학종(CSR)이며,
+            _FwdPos, _RevPos는 정/역반응 차수의 항별, _AdsPos는 (반응, _AdsIdx의 화학종)별 값 배열의 위치임.
+            calcRateJacobianSparse는 이 위치에 바로 더하므로 작업 공간을 할당하지 않음.
+            */
+            std::vector<int> _PatPtr, _PatIdx;
+            std::vector<int> _FwdPos, _RevPos;
+            std::vector<int> _AdsIdx, _AdsPos;
+
+            // 화학종 수, 반응 수와 반응식 계수의 패턴을 구성함.
+            void _resetWork()
+            {
+                const auto effiMat = getEffiMat();
+                _ChemNum = effiMat.rows();
+                _RxnNum = effiMat.cols() - 1;
+
+                _StoiPtr.assign(1, 0);
+                _StoiIdx.clear();
+                for (auto j = 0; j < _RxnNum; ++j)
+                {
+                    for (auto i = 0; i < _ChemNum; ++i)
+                    {
+                        if (effiMat(i, j) != 0) _StoiIdx.push_back(i);
+                    }
+                    _StoiPtr.push_back(_StoiIdx.size());
+                }
+
+                _setPattern();
+            }
+
+            /*
+            반응 j의 속도가 의존하는 화학종을 chemVec 뒤에 붙임. getJacobPattern과 calcRateJacobianSparse가
+            같은 순서를 사용함. 내장 속도식은 정/역반응 차수와 (분모가 있으면) 흡착 상수가 있는 화학종,
+            Expression은 Jacobian이 0이 아닌 화학종, Custom은 반응식의 계수가 0이 아닌 화학종임.
+            posWork는 (화학종 수) 크기의 -1로 채운 작업 공간이며, 호출한 쪽에서 chemVec의 위치를 다시 -1로 되돌려야 함.
+            */
+            void _gatherPattern(const int& j, std::vector<int>& chemVec, std::vector<int>& posWork) const
+            {
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+                const int begin = chemVec.size();
+                const RateLawType rateLaw = (_RateLaw == Compiled) ? _CompiledFrom : _RateLaw;
+
+                auto push = [&](const int& i)
+                {
+                    if (posWork[i] >= 0) return;
+                    posWork[i] = chemVec.size() - begin;
+                    chemVec.push_back(i);
+                };
+
+                if (rateLaw == Expression)
+                {
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (_ExprMask[i * rxnNum + j]) push(i);
+                    }
+                }
+                else if (rateLaw == Custom)
+                {
+                    for (auto p = _StoiPtr[j]; p < _StoiPtr[j+1]; ++p) push(_StoiIdx[p]);
+                }
+                else
+                {
+                    for (auto p = _FwdPtr[j]; p < _FwdPtr[j+1]; ++p) push(_FwdIdx[p]);
+                    for (auto p = _RevPtr[j]; p < _RevPtr[j+1]; ++p) push(_RevIdx[p]);
+                    if (_InhibExp[j] != 0)
+                    {
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            if (_AdsK[i] != 0) push(i);
+                        }
+                    }
+                }
+            }
+
+            // 현재 속도식의 희소 패턴(_PatPtr, _PatIdx)과 내장 속도식의 값 위치를 만듦. 속도식을 지정할 때마다 호출함.
+            void _setPattern()
+            {
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+                const RateLawType rateLaw = (_RateLaw == Compiled) ? _CompiledFrom : _RateLaw;
+
+                std::vector<int> posWork(chemNum, -1);
+                _PatPtr.assign(1, 0);
+                _PatIdx.clear();
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    _gatherPattern(j, _PatIdx, posWork);
+                    _PatPtr.push_back(_PatIdx.size());
+                    for (auto p = _PatPtr[j]; p < _PatPtr[j+1]; ++p) posWork[_PatIdx[p]] = -1;
+                }
+
+                _FwdPos.clear();
+                _RevPos.clear();
+                _AdsIdx.clear();
+                _AdsPos.clear();
+                if (rateLaw == Custom || rateLaw == Expression) return;
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (_AdsK[i] != 0) _AdsIdx.push_back(i);
+                }
+
+                _FwdPos.resize(_FwdIdx.size());
+                _RevPos.resize(_RevIdx.size());
+                _AdsPos.assign(rxnNum * _AdsIdx.size(), -1);
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    for (auto p = _PatPtr[j]; p < _PatPtr[j+1]; ++p) posWork[_PatIdx[p]] = p;
+
+                    for (auto p = _FwdPtr[j]; p < _FwdPtr[j+1]; ++p) _FwdPos[p] = posWork[_FwdIdx[p]];
+                    for (auto p = _RevPtr[j]; p < _RevPtr[j+1]; ++p) _RevPos[p] = posWork[_RevIdx[p]];
+                    if (_InhibExp[j] != 0)
+                    {
+                        for (auto q = 0; q < _AdsIdx.size(); ++q) _AdsPos[j * _AdsIdx.size() + q] = posWork[_AdsIdx[q]];
+                    }
+
+                    for (auto p = _PatPtr[j]; p < _PatPtr[j+1]; ++p) posWork[_PatIdx[p]] = -1;
+                }
+            }
+
+            // 반응 차수 행렬(반응 x 화학종)을 CSR 형식으로 변환함.
+            void _setOrder(const std::vector<std::vector<float>>& OrderMat,
+                std::vector<int>& ptr, std::vector<int>& idx, std::vector<double>& ord)
+            {
+                const int chemNum = getChemNum();
+
+                if (OrderMat.size() != getRxnNum()) throw std::runtime_error("Order matrix doesn't match the number of reactions.");
+
+                ptr.assign(1, 0);
+                idx.clear();
+                ord.clear();
+
+                for (const auto& row : OrderMat)
+                {
+                    if (row.size() != chemNum) throw std::runtime_error("Order matrix doesn't match the number of chemicals.");
+
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (row[i] == 0) continue;
+                        idx.push_back(i);
+                        ord.push_back(row[i]);
+                    }
+                    ptr.push_back(idx.size());
+                }
+            }
+
+            // 반응식의 계수로부터 반응물(direction = true) 혹은 생성물(direction = false)의 차수 행렬을 만듦.
+            std::vector<std::vector<float>> _getStoiOrder(const bool& direction)
+            {
+                const auto effiMat = getEffiMat();
+                std::vector<std::vector<float>> OrderMat(getRxnNum(), std::vector<float>(getChemNum(), 0));
+
+                for (auto j = 0; j < getRxnNum(); ++j)
+                {
+                    for (auto i = 0; i < getChemNum(); ++i)
+                    {
+                        if (direction && effiMat(i, j) < 0) OrderMat[j][i] = -effiMat(i, j);
+                        if (!direction && effiMat(i, j) > 0) OrderMat[j][i] = effiMat(i, j);
+                    }
+                }
+
+                return OrderMat;
+            }
+
+            // 현재 온도에서의 속도 상수를 계산함.
+            void _updateRateConst()
+            {
+                const double RT = const_variables::gasConst * _Temp;
+
+                _FwdK.resize(_FwdPreExp.size());
+                _RevK.resize(_RevPreExp.size());
+
+                for (auto j = 0; j < _FwdK.size(); ++j) _FwdK[j] = _FwdPreExp[j] * std::exp(-_FwdActEnergy[j] / RT);
+                for (auto j = 0; j < _RevK.size(); ++j) _RevK[j] = _RevPreExp[j] * std::exp(-_RevActEnergy[j] / RT);
+            }
+
+            // 내장 속도식의 매개변수를 초기화함. 역반응과 흡착항은 없는 것으로 둠.
+            void _resetParam(const RateLawType& RateLaw, const std::vector<float>& PreExp,
+                const std::vector<float>& ActEnergy)
+            {
+                const int rxnNum = getRxnNum();
+
+                if (PreExp.size() != rxnNum || ActEnergy.size() != rxnNum) throw std::runtime_error("Rate constants don't match the number of reactions.");
+
+                _RateLaw = RateLaw;
+                _FwdPreExp.assign(PreExp.begin(), PreExp.end());
+                _FwdActEnergy.assign(ActEnergy.begin(), ActEnergy.end());
+                _RevPreExp.assign(rxnNum, 0);
+                _RevActEnergy.assign(rxnNum, 0);
+                _RevPtr.assign(rxnNum + 1, 0);
+                _RevIdx.clear();
+                _RevOrd.clear();
+                _AdsK.assign(getChemNum(), 0);
+                _InhibExp.assign(rxnNum, 0);
+
+                _updateRateConst();
+            }
+
+            // prod_i c_i^a_ij 를 계산함. 차수가 1인 경우 std::pow를 호출하지 않음.
+            static double _calcProd(const double* conc, const int* idx, const double* ord, const int& begin, const int& end)
+            {
+                double prod = 1;
+                for (auto p = begin; p < end; ++p)
+                {
+                    const double c = conc[idx[p]];
+                    prod *= (ord[p] == 1) ? c : std::pow(c, ord[p]);
+                }
+
+                return prod;
+            }
+
+            // _calcProd를 임의의 스칼라 형식 T로 계산함. (calcRateAD에서 사용)
+            template <typename T>
+            static T _calcProdAD(const T* conc, const int* idx, const double* ord, const int& begin, const int& end)
+            {
+                using std::pow;
+
+                T prod = T(1);
+                for (auto p = begin; p < end; ++p)
+                {
+                    if (ord[p] == 1) prod *= conc[idx[p]];
+                    else prod *= pow(conc[idx[p]], ord[p]);
+                }
+
+                return prod;
+            }
+
+            /*
+            d(k * prod_i c_i^a_ij)/dc_i 를 jac에 더함(scale배). 농도가 0이 아니면 prod * a / c로 계산하고,
+            0인 경우에만 해당 화학종을 제외한 곱을 다시 계산함.
+            */
+            static void _addProdDeriv(const double* conc, const int* idx, const double* ord, const int& begin,
+                const int& end, const double& k, const double& prod, const double& scale, double* jac, const int& rxnNum, const int& j)
+            {
+                for (auto p = begin; p < end; ++p) jac[idx[p] * rxnNum + j] += scale * _calcProdDeriv(conc, idx, ord, begin, end, k, prod, p);
+            }
+
+            // _addProdDeriv와 같지만, 항 p의 미분을 희소 값 배열의 위치 pos[p]에 더함.
+            static void _addProdDerivSparse(const double* conc, const int* idx, const double* ord, const int& begin,
+                const int& end, const double& k, const double& prod, const double& scale, double* val, const int* pos)
+            {
+                for (auto p = begin; p < end; ++p) val[pos[p]] += scale * _calcProdDeriv(conc, idx, ord, begin, end, k, prod, p);
+            }
+
+            // k * prod_i c_i^a_ij 의 항 p의 화학종에 대한 미분.
+            static double _calcProdDeriv(const double* conc, const int* idx, const double* ord, const int& begin,
+                const int& end, const double& k, const double& prod, const int& p)
+            {
+                const double c = conc[idx[p]];
+                if (c != 0) return prod * ord[p] / c;
+
+                double deriv = k * ((ord[p] == 1) ? 1 : ((ord[p] > 1) ? 0 : std::pow(c, ord[p] - 1) * ord[p]));
+                for (auto q = begin; q < end; ++q)
+                {
+                    if (q != p) deriv *= std::pow(conc[idx[q]], ord[q]);
+                }
+                return deriv;
+            }
+
+            // 내장 속도식으로 한 상태의 반응 속도(와 Jacobian)를 계산함. jac이 nullptr이면 Jacobian은 계산하지 않음.
+            void _calcBuiltin(const double* conc, double* rate, double* jac) const
+            {
+                const int chemNum = _AdsK.size();
+                const int rxnNum = _FwdK.size();
+
+                double denom = 1;
+                for (auto i = 0; i < chemNum; ++i) denom += _AdsK[i] * conc[i];
+
+                if (jac != nullptr) std::fill(jac, jac + chemNum * rxnNum, 0.0);
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    const double fwd = _FwdK[j] * _calcProd(conc, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1]);
+                    const double rev = (_RevK[j] == 0) ? 0 : _RevK[j] * _calcProd(conc, _RevIdx.data(), _RevOrd.data(), _RevPtr[j], _RevPtr[j+1]);
+                    const double inhib = (_InhibExp[j] == 0) ? 1 : std::pow(denom, -_InhibExp[j]);
+
+                    rate[j] = (fwd - rev) * inhib;
+
+                    if (jac == nullptr) continue;
+
+                    _addProdDeriv(conc, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1], _FwdK[j], fwd, inhib, jac, rxnNum, j);
+                    if (_RevK[j] != 0) _addProdDeriv(conc, _RevIdx.data(), _RevOrd.data(), _RevPtr[j], _RevPtr[j+1], _RevK[j], rev, -inhib, jac, rxnNum, j);
+
+                    // d(D^-n)/dc_i = -n * K_i * D^(-n-1)
+                    if (_InhibExp[j] != 0)
+                    {
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            if (_AdsK[i] != 0) jac[i * rxnNum + j] -= rate[j] * _InhibExp[j] * _AdsK[i] / denom;
+                        }
+                    }
+                }
+            }
+
+            // prod_i c_i^a_ij 를 상태 열마다 prod에 곱함. concT는 (상태 수) x (화학종 수) 크기로 화학종별 열이 연속임.
+            static void _mulProdBatch(const Eigen::ArrayXXd& concT, const int* idx, const double* ord, const int& begin,
+                const int& end, Eigen::ArrayXd& prod)
+            {
+                for (auto p = begin; p < end; ++p)
+                {
+                    if (ord[p] == 1) prod *= concT.col(idx[p]);
+                    else prod *= concT.col(idx[p]).pow(ord[p]);
+                }
+            }
+
+            /*
+            내장 속도식으로 stateNum개 상태의 반응 속도를 계산함. 상태를 _BatchBlock개씩 화학종별 열로 옮긴 뒤
+            반응마다 열 단위의 배열 연산으로 계산하므로, 반복문이 상태 방향으로 벡터화됨. 분모 D는 행렬-벡터 곱으로 구함.
+            */
+            void _calcBuiltinBatch(const double* concMat, const int& stateNum, double* rateMat) const
+            {
+                const int chemNum = _AdsK.size();
+                const int rxnNum = _FwdK.size();
+                const Eigen::Map<const Eigen::VectorXd> adsK(_AdsK.data(), chemNum);
+
+                bool hasInhib = false;
+                for (auto j = 0; j < rxnNum; ++j) hasInhib = hasInhib || (_InhibExp[j] != 0);
+
+                Eigen::ArrayXXd concT;
+                Eigen::ArrayXd denom, fwd, rev;
+
+                for (auto s0 = 0; s0 < stateNum; s0 += _BatchBlock)
+                {
+                    const int blockNum = std::min(_BatchBlock, stateNum - s0);
+                    const Eigen::Map<const Eigen::MatrixXd> concBlock(concMat + s0 * chemNum, chemNum, blockNum);
+                    Eigen::Map<Eigen::MatrixXd> rateBlock(rateMat + s0 * rxnNum, rxnNum, blockNum);
+
+                    concT = concBlock.transpose().array();
+                    if (hasInhib) denom = 1 + (concT.matrix() * adsK).array();
+
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        fwd.setConstant(blockNum, _FwdK[j]);
+                        _mulProdBatch(concT, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1], fwd);
+
+                        if (_RevK[j] != 0)
+                        {
+                            rev.setConstant(blockNum, _RevK[j]);
+                            _mulProdBatch(concT, _RevIdx.data(), _RevOrd.data(), _RevPtr[j], _RevPtr[j+1], rev);
+                            fwd -= rev;
+                        }
+
+                        if (_InhibExp[j] != 0) fwd *= denom.pow(-_InhibExp[j]);
+                        rateBlock.row(j) = fwd.matrix().transpose();
+                    }
+                }
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            SpeedRxnBase() = default;
+
+            // 내장 속도식을 사용하는 경우. set* 메소드로 속도식을 지정함.
+            SpeedRxnBase(const std::vector<std::string>& eqnVec):
+                RxnBase(eqnVec)
+            {
+                _resetWork();
+            }
+
+            SpeedRxnBase(const std::vector<std::string>& eqnVec, const std::string& Comment):
+                RxnBase(eqnVec, Comment)
+            {
+                _resetWork();
+            }
+
+            SpeedRxnBase(const std::string& eqn, const SpeedFuncType& SpeedFunc):
+                RxnBase(eqn), _SpeedFunc(SpeedFunc)
+            {
+                _resetWork();
+            }
+
+            SpeedRxnBase(const std::vector<std::string>& eqnVec, const SpeedFuncType& SpeedFunc):
+                RxnBase(eqnVec), _SpeedFunc(SpeedFunc)
+            {
+                _resetWork();
+            }
+
+            SpeedRxnBase(const std::vector<std::string>& eqnVec, const SpeedFuncType& SpeedFunc,
+                const JacobFuncType& JacobFunc):
+                RxnBase(eqnVec), _SpeedFunc(SpeedFunc), _JacobFunc(JacobFunc)
+            {
+                _resetWork();
+            }
+
+            SpeedRxnBase(const std::vector<std::string>& eqnVec, const SpeedFuncType& SpeedFunc,
+                const JacobFuncType& JacobFunc, const std::string& Comment):
+                RxnBase(eqnVec, Comment), _SpeedFunc(SpeedFunc), _JacobFunc(JacobFunc)
+            {
+                _resetWork();
+            }
+
+            // getter 정의부
+
+            int getRxnNum() const {return _RxnNum;}
+            int getChemNum() const {return _ChemNum;}
+            auto getRateLaw() const {return _RateLaw;}
+            auto getTemp() const {return _Temp;}
+            auto getFwdPreExp() const {return _FwdPreExp;}
+            auto getFwdActEnergy() const {return _FwdActEnergy;}
+            auto getRevPreExp() const {return _RevPreExp;}
+            auto getRevActEnergy() const {return _RevActEnergy;}
+            auto getFwdRateConst() const {return _FwdK;}
+            auto getRevRateConst() const {return _RevK;}
+            auto getAdsK() const {return _AdsK;}
+            auto getInhibExp() const {return _InhibExp;}
+            const RateExprVM& getExprVM() const {return _ExprVM;}
+            auto getRateExpr() const {return _ExprVec;}
+            auto getCompiledMech() const {return _MechPtr;}
+
+            // 컴파일되기 전의 속도식 종류를 반환함. Compiled가 아니면 getRateLaw()와 같음.
+            auto getSourceRateLaw() const {return (_RateLaw == Compiled) ? _CompiledFrom : _RateLaw;}
+
+            // 정/역반응의 반응 차수를 (반응 x 화학종) 행렬로 반환함.
+            std::vector<std::vector<float>> getOrderMat(const bool& direction = true) const
+            {
+                const auto& ptr = direction ? _FwdPtr : _RevPtr;
+                const auto& idx = direction ? _FwdIdx : _RevIdx;
+                const auto& ord = direction ? _FwdOrd : _RevOrd;
+
+                std::vector<std::vector<float>> OrderMat(getRxnNum(), std::vector<float>(getChemNum(), 0));
+                for (auto j = 0; j + 1 < ptr.size(); ++j)
+                {
+                    for (auto p = ptr[j]; p < ptr[j+1]; ++p) OrderMat[j][idx[p]] = ord[p];
+                }
+
+                return OrderMat;
+            }
+
+            // setter 정의부
+
+            void setSpeedFunc(const SpeedFuncType& SpeedFunc)
+            {
+                _SpeedFunc = SpeedFunc;
+                _RateLaw = Custom;
+                _setPattern();
+            }
+            void setJacobFunc(const JacobFuncType& JacobFunc) {_JacobFunc = JacobFunc;}
+
+            // 반응 온도를 설정하고 속도 상수를 다시 계산함.
+            void setTemp(const double& Temp)
+            {
+                _Temp = Temp;
+                _updateRateConst();
+                _ExprVM.setParam("T", _Temp);
+            }
+
+            /*
+            반응마다 속도식 문자열을 지정함. 화학종의 축약형과 온도 T를 사용할 수 있음.
+            예) {"2.5e3 * exp(-4500 / T) * A * B^0.5 / (1 + 0.3 * A)^2"}
+            속도식과 Jacobian은 바이트코드로 컴파일되어 calcRate, calcRateJacobian, calcRateBatch에서 사용됨.
+            */
+            void setRateExpr(const std::vector<std::string>& exprVec)
+            {
+                if (exprVec.size() != getRxnNum()) throw std::runtime_error("Rate expressions don't match the number of reactions.");
+
+                std::vector<std::string> VarName;
+                for (auto ptr : getChemIdx()) VarName.push_back(ptr->getAbb());
+
+                _ExprVM.compile(exprVec, VarName, {"T"});
+                _ExprVM.setParam("T", _Temp);
+                _ExprMask = _ExprVM.getJacobMask();
+                _ExprVec = exprVec;
+                _RateLaw = Expression;
+                _setPattern();
+            }
+
+            /*
+            MechCodeGen으로 생성해 컴파일한 메커니즘을 사용함. MechPtr의 수명은 호출한 쪽에서 관리함.
+            nullptr을 전달하면 컴파일되기 전의 속도식으로 되돌림.
+            */
+            void setCompiledMech(const CompiledMech* MechPtr)
+            {
+                if (MechPtr == nullptr)
+                {
+                    if (_RateLaw == Compiled) _RateLaw = _CompiledFrom;
+                    _MechPtr = nullptr;
+                    return;
+                }
+
+                if (MechPtr->getChemNum() != getChemNum() || MechPtr->getRxnNum() != getRxnNum()) throw std::runtime_error("Compiled mechanism doesn't match the reaction.");
+
+                if (_RateLaw != Compiled) _CompiledFrom = _RateLaw;
+                _MechPtr = MechPtr;
+                _RateLaw = Compiled;
+            }
+
+            // r_j = k_j * prod_i c_i^a_ij. OrderMat은 (반응 수) x (화학종 수)
+            void setPowerLaw(const std::vector<float>& k, const std::vector<std::vector<float>>& OrderMat)
+            {
+                _resetParam(PowerLaw, k, std::vector<float>(k.size(), 0));
+                _setOrder(OrderMat, _FwdPtr, _FwdIdx, _FwdOrd);
+                _setPattern();
+            }
+
+            // r_j = A_j * exp(-Ea_j / RT) * prod_i c_i^a_ij
+            void setArrhenius(const std::vector<float>& PreExp, const std::vector<float>& ActEnergy,
+                const std::vector<std::vector<float>>& OrderMat)
+            {
+                _resetParam(Arrhenius, PreExp, ActEnergy);
+                _setOrder(OrderMat, _FwdPtr, _FwdIdx, _FwdOrd);
+                _setPattern();
+            }
+
+            // 가역 질량 작용 법칙. 차수는 반응식의 계수를 따름. kr이 0이면 비가역 반응임.
+            void setMassAction(const std::vector<float>& kf, const std::vector<float>& kr)
+            {
+                setMassAction(kf, std::vector<float>(kf.size(), 0), kr, std::vector<float>(kr.size(), 0));
+            }
+
+            // 가역 질량 작용 법칙. 정/역반응의 속도 상수가 Arrhenius 식을 따르는 경우.
+            void setMassAction(const std::vector<float>& FwdPreExp, const std::vector<float>& FwdActEnergy,
+                const std::vector<float>& RevPreExp, const std::vector<float>& RevActEnergy)
+            {
+                if (RevPreExp.size() != getRxnNum() || RevActEnergy.size() != getRxnNum()) throw std::runtime_error("Rate constants don't match the number of reactions.");
+
+                _resetParam(MassAction, FwdPreExp, FwdActEnergy);
+                _RevPreExp.assign(RevPreExp.begin(), RevPreExp.end());
+                _RevActEnergy.assign(RevActEnergy.begin(), RevActEnergy.end());
+                _setOrder(_getStoiOrder(true), _FwdPtr, _FwdIdx, _FwdOrd);
+                _setOrder(_getStoiOrder(false), _RevPtr, _RevIdx, _RevOrd);
+                _updateRateConst();
+                _setPattern();
+            }
+
+            // r_j = k_j * prod_i c_i^a_ij / (1 + sum_i K_i c_i)^n_j
+            void setLangmuirHinshelwood(const std::vector<float>& k, const std::vector<std::vector<float>>& OrderMat,
+                const std::vector<float>& AdsK, const std::vector<float>& InhibExp)
+            {
+                setLangmuirHinshelwood(k, std::vector<float>(k.size(), 0), OrderMat, AdsK, InhibExp);
+            }
+
+            // Langmuir-Hinshelwood 식의 속도 상수가 Arrhenius 식을 따르는 경우.
+            void setLangmuirHinshelwood(const std::vector<float>& PreExp, const std::vector<float>& ActEnergy,
+                const std::vector<std::vector<float>>& OrderMat, const std::vector<float>& AdsK, const std::vector<float>& InhibExp)
+            {
+                if (AdsK.size() != getChemNum() || InhibExp.size() != getRxnNum()) throw std::runtime_error("Adsorption constants don't match the reaction.");
+
+                _resetParam(LangmuirHinshelwood, PreExp, ActEnergy);
+                _setOrder(OrderMat, _FwdPtr, _FwdIdx, _FwdOrd);
+                _AdsK.assign(AdsK.begin(), AdsK.end());
+                _InhibExp.assign(InhibExp.begin(), InhibExp.end());
+                _setPattern();
+            }
+
+            // 인스턴스 정의부
+
+            // 농도 conc에서의 모든 반응의 속도를 rate에 저장함.
+            void calcRate(const double* conc, double* rate) const
+            {
+                if (_RateLaw == Compiled)
+                {
+                    _MechPtr->calcRate(conc, _Temp, rate);
+                    return;
+                }
+
+                if (_RateLaw == Expression)
+                {
+                    _ExprVM.evalBatch(conc, 1, rate);
+                    return;
+                }
+
+                if (_RateLaw != Custom)
+                {
+                    _calcBuiltin(conc, rate, nullptr);
+                    return;
+                }
+
+                if (!_SpeedFunc) throw std::runtime_error("SpeedRxnBase has no rate expression.");
+                _SpeedFunc(conc, rate);
+            }
+
+            /*
+            농도 conc에서의 반응 속도를 rate에, Jacobian(d r / d c)을 jac에 저장함.
+            내장 속도식과 Expression 속도식은 해석적으로, _JacobFunc가 없는 Custom 속도식은 전진 차분으로 계산함.
+            */
+            void calcRateJacobian(const double* conc, double* rate, double* jac) const
+            {
+                if (_RateLaw == Compiled)
+                {
+                    _MechPtr->calcRate(conc, _Temp, rate);
+                    _MechPtr->calcJacobDense(conc, _Temp, jac);
+                    return;
+                }
+
+                if (_RateLaw == Expression)
+                {
+                    _ExprVM.evalBatch(conc, 1, rate, jac);
+                    return;
+                }
+
+                if (_RateLaw != Custom)
+                {
+                    _calcBuiltin(conc, rate, jac);
+                    return;
+                }
+
+                calcRate(conc, rate);
+
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+
+                if (_JacobFunc)
+                {
+                    _JacobFunc(conc, jac);
+                    return;
+                }
+
+                std::vector<double> concWork(conc, conc + chemNum), rateWork(rxnNum);
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    double h = 1e-7 * std::max(std::abs(conc[i]), 1e-3);
+                    concWork[i] = conc[i] + h;
+                    _SpeedFunc(concWork.data(), rateWork.data());
+                    concWork[i] = conc[i];
+
+                    for (auto j = 0; j < rxnNum; ++j) jac[i * rxnNum + j] = (rateWork[j] - rate[j]) / h;
+                }
+            }
+
+            /*
+            반응 속도 Jacobian(d r / d c)의 희소 패턴을 (반응, 화학종) 쌍으로 반환함. 순서는 calcRateJacobianSparse의
+            값의 순서와 같음. Compiled는 CompiledMech의 패턴을, 나머지는 반응마다 _gatherPattern의 순서를 따름.
+            */
+            void getJacobPattern(std::vector<int>& rxnIdx, std::vector<int>& chemIdx) const
+            {
+                rxnIdx.clear();
+                chemIdx.clear();
+
+                if (_RateLaw == Compiled)
+                {
+                    rxnIdx = _MechPtr->getJacobRxnIdx();
+                    chemIdx = _MechPtr->getJacobChemIdx();
+                    return;
+                }
+
+                chemIdx = _PatIdx;
+                for (auto j = 0; j < getRxnNum(); ++j) rxnIdx.insert(rxnIdx.end(), _PatPtr[j+1] - _PatPtr[j], j);
+            }
+
+            /*
+            농도 conc에서의 반응 속도를 rate에, Jacobian의 0이 아닌 원소를 getJacobPattern의 순서로 val에 저장함.
+            내장 속도식과 Compiled는 0이 아닌 원소만 계산하므로 비용이 (반응 수) x (화학종 수)가 아니라 원소 수에 비례함.
+            Expression과 Custom은 calcRateJacobian의 밀집 Jacobian에서 모음.
+            */
+            void calcRateJacobianSparse(const double* conc, double* rate, double* val) const
+            {
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+
+                if (_RateLaw == Compiled)
+                {
+                    _MechPtr->calcRate(conc, _Temp, rate);
+                    _MechPtr->calcJacobSparse(conc, _Temp, val);
+                    return;
+                }
+
+                if (_RateLaw == Expression || _RateLaw == Custom)
+                {
+                    std::vector<double> denseJac(chemNum * rxnNum);
+                    calcRateJacobian(conc, rate, denseJac.data());
+
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        for (auto p = _PatPtr[j]; p < _PatPtr[j+1]; ++p) val[p] = denseJac[_PatIdx[p] * rxnNum + j];
+                    }
+                    return;
+                }
+
+                double denom = 1;
+                for (auto i : _AdsIdx) denom += _AdsK[i] * conc[i];
+
+                // 미분을 _setPattern에서 정한 값 배열의 위치에 바로 더함.
+                std::fill(val, val + _PatIdx.size(), 0.0);
+                const int adsNum = _AdsIdx.size();
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    const double fwd = _FwdK[j] * _calcProd(conc, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1]);
+                    const double rev = (_RevK[j] == 0) ? 0 : _RevK[j] * _calcProd(conc, _RevIdx.data(), _RevOrd.data(), _RevPtr[j], _RevPtr[j+1]);
+                    const double inhib = (_InhibExp[j] == 0) ? 1 : std::pow(denom, -_InhibExp[j]);
+
+                    rate[j] = (fwd - rev) * inhib;
+
+                    _addProdDerivSparse(conc, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1], _FwdK[j], fwd, inhib, val, _FwdPos.data());
+                    if (_RevK[j] != 0) _addProdDerivSparse(conc, _RevIdx.data(), _RevOrd.data(), _RevPtr[j], _RevPtr[j+1], _RevK[j], rev, -inhib, val, _RevPos.data());
+
+                    if (_InhibExp[j] != 0)
+                    {
+                        for (auto q = 0; q < adsNum; ++q) val[_AdsPos[j * adsNum + q]] -= rate[j] * _InhibExp[j] * _AdsK[_AdsIdx[q]] / denom;
+                    }
+                }
+            }
+
+            /*
+            농도 conc에서 반응 속도의 매개변수 민감도 d r_j / d ln p_j 를 sens에 저장함.
+            내장 속도식은 p_j = (정반응 속도 상수 kf_j)이므로 정반응 항(역반응 제외)이 되고,
+            Custom, Expression 속도식은 p_j = (반응 속도 전체에 곱해지는 배수)이므로 반응 속도와 같음.
+            활성화 에너지에 대한 민감도는 d r_j / d Ea_j = -sens[j] / RT 로 얻을 수 있음.
+            */
+            void calcRateParamSens(const double* conc, double* sens) const
+            {
+                const auto rateLaw = getSourceRateLaw();
+
+                if (rateLaw == Custom || rateLaw == Expression)
+                {
+                    calcRate(conc, sens);
+                    return;
+                }
+
+                const int chemNum = _AdsK.size();
+                const int rxnNum = _FwdK.size();
+
+                double denom = 1;
+                for (auto i = 0; i < chemNum; ++i) denom += _AdsK[i] * conc[i];
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    const double inhib = (_InhibExp[j] == 0) ? 1 : std::pow(denom, -_InhibExp[j]);
+                    sens[j] = _FwdK[j] * _calcProd(conc, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1]) * inhib;
+                }
+            }
+
+            /*
+            농도 conc와 온도 Temp에서의 반응 속도를 임의의 스칼라 형식 T(double, Dual, HyperDual 등)로 계산함.
+            Dual로 시드하면 농도와 온도에 대한 정확한 Jacobian을, HyperDual로 시드하면 Hessian을 함께 얻음.
+            내장 속도식은 위의 통합된 형식을, Expression 속도식은 RateExprVM::evalAD를 T로 그대로 계산하고,
+            Compiled는 컴파일되기 전의 속도식으로 계산함. Custom 속도식은 double만 받으므로 double은 calcRate로,
+            1계 Dual<double, N>은 calcRateJacobian과 연쇄 법칙으로 계산하며, 온도에 대한 미분은 0임.
+            */
+            template <typename T>
+            void calcRateAD(const T* conc, const T& Temp, T* rate) const
+            {
+                using std::exp;
+                using std::pow;
+
+                const auto rateLaw = getSourceRateLaw();
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+
+                if (rateLaw == Expression)
+                {
+                    _ExprVM.evalAD(conc, rate, &Temp);
+                    return;
+                }
+
+                if (rateLaw == Custom)
+                {
+                    if constexpr (std::is_same<T, double>::value)
+                    {
+                        calcRate(conc, rate);
+                        return;
+                    }
+                    else if constexpr (DualOrder<T>::value == 1 && std::is_same<typename T::ValueType, double>::value)
+                    {
+                        std::vector<double> concVec(chemNum), rateVec(rxnNum), jacVec(chemNum * rxnNum);
+                        for (auto i = 0; i < chemNum; ++i) concVec[i] = conc[i].getVal();
+                        calcRateJacobian(concVec.data(), rateVec.data(), jacVec.data());
+
+                        // 동적 크기에서는 상수인 농도의 미분 배열이 비어 있을 수 있음.
+                        int dirNum = 0;
+                        for (auto i = 0; i < chemNum; ++i) dirNum = std::max<int>(dirNum, conc[i].getGrad().size());
+
+                        for (auto j = 0; j < rxnNum; ++j)
+                        {
+                            typename T::GradType grad = T::GradType::Zero(dirNum);
+                            for (auto i = 0; i < chemNum; ++i)
+                            {
+                                if (conc[i].getGrad().size() != 0) grad += jacVec[i * rxnNum + j] * conc[i].getGrad();
+                            }
+                            rate[j] = T(rateVec[j], grad);
+                        }
+                        return;
+                    }
+                    else throw std::runtime_error("Custom rate law supports only first-order Dual<double, N>.");
+                }
+
+                const T RT = const_variables::gasConst * Temp;
+
+                T denom = T(1);
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (_AdsK[i] != 0) denom += _AdsK[i] * conc[i];
+                }
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    T fwd = _FwdPreExp[j] * _calcProdAD(conc, _FwdIdx.data(), _FwdOrd.data(), _FwdPtr[j], _FwdPtr[j+1]);
+                    if (_FwdActEnergy[j] != 0) fwd *= exp(-_FwdActEnergy[j] / RT);
+
+                    rate[j] = fwd;
+
+                    if (_RevPreExp[j] != 0)
+                    {
+                        T rev = _RevPreExp[j] * _calcProdAD(conc, _RevIdx.data(), _RevOrd.data(), _RevPtr[j], _RevPtr[j+1]);
+                        if (_RevActEnergy[j] != 0) rev *= exp(-_RevActEnergy[j] / RT);
+                        rate[j] -= rev;
+                    }
+
+                    if (_InhibExp[j] != 0) rate[j] *= pow(denom, -_InhibExp[j]);
+                }
+            }
+
+            // 반응 온도(getTemp())에서의 반응 속도를 T 형식으로 계산함. 온도에 대한 미분은 0임.
+            template <typename T>
+            void calcRateAD(const T* conc, T* rate) const
+            {
+                calcRateAD(conc, T(_Temp), rate);
+            }
+
+            /*
+            stateNum개의 상태에 대해 반응 속도를 한 번에 계산함.
+            concMat은 (화학종 수) x stateNum, rateMat은 (반응 수) x stateNum 크기의 column-major 배열임.
+            */
+            void calcRateBatch(const double* concMat, const int& stateNum, double* rateMat) const
+            {
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+
+                // Expression 속도식은 명령어 해석 비용을 블록마다 한 번만 치르도록 한 번에 넘김.
+                if (_RateLaw == Expression)
+                {
+                    _ExprVM.evalBatch(concMat, stateNum, rateMat);
+                    return;
+                }
+
+                if (_RateLaw == Compiled)
+                {
+                    _MechPtr->calcRateBatch(concMat, stateNum, _Temp, rateMat);
+                    return;
+                }
+
+                if (_RateLaw != Custom)
+                {
+                    _calcBuiltinBatch(concMat, stateNum, rateMat);
+                    return;
+                }
+
+                for (auto s = 0; s < stateNum; ++s) calcRate(concMat + s * chemNum, rateMat + s * rxnNum);
+            }
+
+            /*
+            stateNum개의 상태에 대해 반응 속도와 Jacobian을 한 번에 계산함.
+            jacMat은 상태마다 (반응 수) x (화학종 수) 크기의 블록을 이어붙인 배열임.
+            */
+            void calcRateJacobianBatch(const double* concMat, const int& stateNum, double* rateMat, double* jacMat) const
+            {
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+
+                if (_RateLaw == Expression)
+                {
+                    _ExprVM.evalBatch(concMat, stateNum, rateMat, jacMat);
+                    return;
+                }
+
+                for (auto s = 0; s < stateNum; ++s)
+                {
+                    calcRateJacobian(concMat + s * chemNum, rateMat + s * rxnNum, jacMat + s * chemNum * rxnNum);
+                }
+            }
+
+            /*
+            반응 rxnIdx만 남긴 SpeedRxnBase를 만들어 반환함. 화학종은 남은 반응식에 나오는 것만 남으며,
+            속도식의 종류, 매개변수와 반응 온도를 그대로 옮김. Compiled는 컴파일되기 전의 속도식으로 옮기고,
+            Custom은 빠진 화학종의 농도를 0으로 두고 원래의 속도식을 호출하는 함수로 옮김.
+            남은 반응의 속도가 남은 반응식에 없는 화학종에 의존하면 runtime error 발생. (MechReducer에서 사용)
+            */
+            SpeedRxnBase extractRxn(const std::vector<int>& rxnIdx)
+            {
+                const int chemNum = getChemNum();
+                const int rxnNum = getRxnNum();
+                const auto chemIdx = getChemIdx();
+                const auto effiMat = getEffiMat();
+
+                // 남은 반응의 반응식 문자열을 다시 만듦.
+                std::vector<std::string> eqnVec;
+                for (auto j : rxnIdx)
+                {
+                    if (j < 0 || j >= rxnNum) throw std::runtime_error("Reaction index is out of range.");
+
+                    std::string reac, prod;
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        const float nu = effiMat(i, j);
+                        if (nu == 0) continue;
+
+                        std::ostringstream term;
+                        if (std::abs(nu) != 1) term << std::abs(nu);
+                        term << chemIdx[i]->getAbb();
+
+                        auto& side = (nu < 0) ? reac : prod;
+                        if (!side.empty()) side += " + ";
+                        side += term.str();
+                    }
+                    eqnVec.push_back(reac + " = " + prod);
+                }
+
+                SpeedRxnBase sub(eqnVec, getComment());
+                const auto subChemIdx = sub.getChemIdx();
+                const int subChemNum = subChemIdx.size();
+                const int subRxnNum = rxnIdx.size();
+
+                // posMap : 남은 화학종의 원래 위치, newPos : 원래 화학종의 새 위치(-1이면 빠짐)
+                std::vector<int> posMap(subChemNum), newPos(chemNum, -1);
+                for (auto k = 0; k < subChemNum; ++k)
+                {
+                    posMap[k] = functions::getVecPos(chemIdx, subChemIdx[k]);
+                    newPos[posMap[k]] = k;
+                }
+
+                const auto rateLaw = getSourceRateLaw();
+                sub._Temp = _Temp;
+
+                if (rateLaw == Custom)
+                {
+                    if (_SpeedFunc)
+                    {
+                        const auto speedFunc = _SpeedFunc;
+                        sub._SpeedFunc = [speedFunc, posMap, rxnIdx, chemNum, rxnNum](const double* conc, double* rate)
+                        {
+                            std::vector<double> fullConc(chemNum, 0), fullRate(rxnNum, 0);
+                            for (auto k = 0; k < posMap.size(); ++k) fullConc[posMap[k]] = conc[k];
+                            speedFunc(fullConc.data(), fullRate.data());
+                            for (auto m = 0; m < rxnIdx.size(); ++m) rate[m] = fullRate[rxnIdx[m]];
+                        };
+                    }
+                    return sub;
+                }
+
+                if (rateLaw == Expression)
+                {
+                    std::vector<std::string> exprVec;
+                    for (auto j : rxnIdx) exprVec.push_back(_ExprVec[j]);
+
+                    sub.setRateExpr(exprVec);
+                    sub.setTemp(_Temp);
+                    return sub;
+                }
+
+                // 차수의 CSR을 새 화학종 위치로 옮김.
+                auto remap = [&](const std::vector<int>& ptr, const std::vector<int>& idx, const std::vector<double>& ord,
+                    std::vector<int>& subPtr, std::vector<int>& subIdx, std::vector<double>& subOrd)
+                {
+                    subPtr.assign(1, 0);
+                    subIdx.clear();
+                    subOrd.clear();
+                    for (auto j : rxnIdx)
+                    {
+                        for (auto p = ptr[j]; p < ptr[j+1]; ++p)
+                        {
+                            if (newPos[idx[p]] < 0) throw std::runtime_error("Extracted reaction depends on a removed chemical.");
+                            subIdx.push_back(newPos[idx[p]]);
+                            subOrd.push_back(ord[p]);
+                        }
+                        subPtr.push_back(subIdx.size());
+                    }
+                };
+
+                sub._RateLaw = rateLaw;
+                sub._FwdPreExp.resize(subRxnNum);
+                sub._FwdActEnergy.resize(subRxnNum);
+                sub._RevPreExp.resize(subRxnNum);
+                sub._RevActEnergy.resize(subRxnNum);
+                sub._InhibExp.resize(subRxnNum);
+                for (auto m = 0; m < subRxnNum; ++m)
+                {
+                    const int j = rxnIdx[m];
+                    sub._FwdPreExp[m] = _FwdPreExp[j];
+                    sub._FwdActEnergy[m] = _FwdActEnergy[j];
+                    sub._RevPreExp[m] = _RevPreExp[j];
+                    sub._RevActEnergy[m] = _RevActEnergy[j];
+                    sub._InhibExp[m] = _InhibExp[j];
+                }
+                remap(_FwdPtr, _FwdIdx, _FwdOrd, sub._FwdPtr, sub._FwdIdx, sub._FwdOrd);
+                remap(_RevPtr, _RevIdx, _RevOrd, sub._RevPtr, sub._RevIdx, sub._RevOrd);
+
+                // 분모의 흡착항은 남은 반응 중 분모가 있는 반응이 있을 때만 빠진 화학종을 허용하지 않음.
+                bool inhibited = false;
+                for (auto m = 0; m < subRxnNum; ++m) inhibited = inhibited || (sub._InhibExp[m] != 0);
+
+                sub._AdsK.assign(subChemNum, 0);
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    if (_AdsK[i] == 0) continue;
+                    if (newPos[i] >= 0) sub._AdsK[newPos[i]] = _AdsK[i];
+                    else if (inhibited) throw std::runtime_error("Extracted reaction depends on a removed chemical.");
+                }
+
+                sub.setTemp(_Temp);
+                sub._setPattern();
+
+                return sub;
+            }
     };
 } // namespace chemprochelper
 
@@ -5,4 +5,6 @@ ProcObjBase로부터 상속받은 RxtorBase를 정의함.
 또한 CSTRBase, PFRBase 등을 정의함.
 */
 #include "RxtorFamily/RxtorBase.hpp"
-#include "RxtorFamily/CSTR.hpp"
\ No newline at end of file
+#include "RxtorFamily/ISATCache.hpp"
+#include "RxtorFamily/CSTR.hpp"
+#include "RxtorFamily/PFR.hpp"
\ No newline at end of file
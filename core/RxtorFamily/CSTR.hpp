@@ -8,14 +8,101 @@ CSTR에 대한 클래스를 정의함.
 
 namespace chemprochelper
 {
+    class DynamicCSTREngine;
+
+    /*
+    시간에 따라 변하는 입력 스트림을 표현하는 클래스.
+    -----------------------------------------------
+    StreamProfile은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _TimeVec : 각 지점의 시간을 오름차순으로 저장함.
+        _StreamIdx : 각 지점의 StreamBase 객체의 포인터를 저장함.
+    지점 사이의 몰 유량은 선형 보간하며, 범위 밖에서는 양 끝 지점의 값을 사용함.
+    */
+    class StreamProfile
+    {
+        private:
+
+            // 각 지점의 시간을 저장함.
+            std::vector<double> _TimeVec;
+
+            // 각 지점의 스트림 포인터를 저장함.
+            std::vector<StreamBase*> _StreamIdx;
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            StreamProfile() = default;
+
+            StreamProfile(const std::vector<double>& TimeVec, const std::vector<StreamBase*>& StreamIdx):
+                _TimeVec(TimeVec), _StreamIdx(StreamIdx)
+            {
+                assert(TimeVec.size() == StreamIdx.size());
+            }
+
+            // getter 정의부
+
+            auto getTimeVec() {return _TimeVec;}
+            auto getStreamIdx() {return _StreamIdx;}
+
+            // 인스턴스 정의부
+
+            // 지점을 추가함. 시간은 기존 지점보다 커야 함.
+            void addPoint(const double& Time, StreamBase* StreamPtr)
+            {
+                if (!_TimeVec.empty() && Time <= _TimeVec.back()) throw std::runtime_error("StreamProfile time must be increasing.");
+                _TimeVec.push_back(Time);
+                _StreamIdx.push_back(StreamPtr);
+            }
+    };
+
     /*
     CSTR을 지정하는 기본 클래스.
+    --------------------------
+    반응기 내부 화학종의 몰수(holdup)를 __ChemMol에 저장하고, 다음 물질 수지를 적분함.
+        dN/dt = F_in(t) - (v / V) N + V * v(nu) * r(N / V)
+    CSTR은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _SpeedRxnPtr : 반응 속도식을 포함하는 SpeedRxnBase 객체의 포인터를 저장함.
+        _Volume : 반응기의 부피를 저장함.
+        _VolFlow : 부피 유량을 저장함.
+        _ProfileTimeVec, _ProfileMat : 입력 스트림의 시간 변화를 __ChemIdx 순서로 저장함.
+        _RxnPos, _StoiMat, _ConcVec, _RateVec, _RateJacVec : 적분에 사용하는 작업 공간.
+        _ISATPtr : 입구 몰 유량 -> 출구 몰 유량(__ChemIdx 순서)을 저장하는 ISATCache의 포인터를 저장함.
+    calcResidualAD는 같은 물질 수지를 Dual(자동 미분) 등 임의의 스칼라 형식으로 계산함.
     */
     class CSTR : public RxtorBase
     {
+        friend class DynamicCSTREngine;
+
         private:
 
-            // _ChemMol
+            // 반응 속도식을 포함하는 화학 반응식의 포인터를 저장함.
+            SpeedRxnBase* _SpeedRxnPtr = nullptr;
+
+            // 반응기의 부피를 저장함.
+            float _Volume = 1;
+
+            // 부피 유량을 저장함.
+            float _VolFlow = 1;
+
+            // 입력 스트림의 시간 변화를 저장함. _ProfileMat은 (화학종 수) x (지점 수)
+            std::vector<double> _ProfileTimeVec;
+            Eigen::MatrixXd _ProfileMat;
+
+            // 반응에 참여하는 화학종의 __ChemIdx 상 인덱스를 저장함.
+            std::vector<int> _RxnPos;
+
+            // 적분 작업 공간
+            Eigen::MatrixXd _StoiMat;
+            std::vector<double> _ConcVec;
+            std::vector<double> _RateVec;
+            std::vector<double> _RateJacVec;
+
+            // 입구 -> 출구 사상의 ISAT 캐시. nullptr이면 사용하지 않음.
+            ISATCache* _ISATPtr = nullptr;
 
             // __ChemIdx로부터 _ChemMold의 값을 0으로 초기화함.
             void _resetChemMol()
@@ -23,6 +110,115 @@ namespace chemprochelper
                 __ChemMol = std::vector<float>(__ChemIdx.size(), 0);
             }
 
+            // 작업 공간의 크기를 반응식에 맞춤.
+            void _resetWork()
+            {
+                if (_SpeedRxnPtr == nullptr) return;
+
+                const auto effiMat = _SpeedRxnPtr->getEffiMat();
+                const auto rxnChemIdx = _SpeedRxnPtr->getChemIdx();
+                const int chemNum = effiMat.rows();
+                const int rxnNum = effiMat.cols() - 1;
+
+                _StoiMat = effiMat.block(0, 0, chemNum, rxnNum).cast<double>();
+                _ConcVec.assign(chemNum, 0);
+                _RateVec.assign(rxnNum, 0);
+                _RateJacVec.assign(chemNum * rxnNum, 0);
+
+                _RxnPos.resize(chemNum);
+                for (auto i = 0; i < chemNum; ++i) _RxnPos[i] = functions::getVecPos(__ChemIdx, rxnChemIdx[i]);
+            }
+
+            // 시간 t에서의 입력 몰 유량을 Fin(__ChemIdx 순서)에 저장함. 시간에 대한 미분은 dFin에 저장함.
+            void _calcInletFlow(const double& t, double* Fin, double* dFin)
+            {
+                const int chemNum = __ChemIdx.size();
+                const int ptNum = _ProfileTimeVec.size();
+
+                // 입력 스트림이 여러 개인 경우 입구에서 혼합함.
+                if (ptNum == 0)
+                {
+                    __mixInlet();
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        Fin[i] = __MixVec[i];
+                        dFin[i] = 0;
+                    }
+                    return;
+                }
+
+                if (t <= _ProfileTimeVec.front() || t >= _ProfileTimeVec.back())
+                {
+                    const int k = (t <= _ProfileTimeVec.front()) ? 0 : ptNum - 1;
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        Fin[i] = _ProfileMat(i, k);
+                        dFin[i] = 0;
+                    }
+                    return;
+                }
+
+                const int k = std::upper_bound(_ProfileTimeVec.begin(), _ProfileTimeVec.end(), t) - _ProfileTimeVec.begin();
+                const double dt = _ProfileTimeVec[k] - _ProfileTimeVec[k-1];
+                const double w = (t - _ProfileTimeVec[k-1]) / dt;
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    Fin[i] = (1 - w) * _ProfileMat(i, k-1) + w * _ProfileMat(i, k);
+                    dFin[i] = (_ProfileMat(i, k) - _ProfileMat(i, k-1)) / dt;
+                }
+            }
+
+            // 입력 몰 유량 Fin이 주어졌을 때 dN/dt를 계산함. N, Fin, dNdt는 모두 __ChemIdx 순서임.
+            void _calcDeriv(const double* N, const double* Fin, double* dNdt)
+            {
+                const int chemNum = __ChemIdx.size();
+                const double dilution = _VolFlow / _Volume;
+
+                for (auto i = 0; i < chemNum; ++i) dNdt[i] = Fin[i] - dilution * N[i];
+
+                for (auto i = 0; i < _RxnPos.size(); ++i) _ConcVec[i] = std::max(N[_RxnPos[i]], 0.0) / _Volume;
+                _SpeedRxnPtr->calcRate(_ConcVec.data(), _RateVec.data());
+
+                for (auto i = 0; i < _RxnPos.size(); ++i)
+                {
+                    for (auto j = 0; j < _RateVec.size(); ++j) dNdt[_RxnPos[i]] += _Volume * _StoiMat(i, j) * _RateVec[j];
+                }
+            }
+
+            // d(dN/dt)/dN 블록((화학종 수) x (화학종 수))을 J에 저장함.
+            void _calcJacobi(const double* N, Eigen::MatrixXd& J)
+            {
+                const int chemNum = __ChemIdx.size();
+                const int rxnNum = _RateVec.size();
+                const double dilution = _VolFlow / _Volume;
+
+                J = -dilution * Eigen::MatrixXd::Identity(chemNum, chemNum);
+
+                for (auto i = 0; i < _RxnPos.size(); ++i) _ConcVec[i] = std::max(N[_RxnPos[i]], 0.0) / _Volume;
+                _SpeedRxnPtr->calcRateJacobian(_ConcVec.data(), _RateVec.data(), _RateJacVec.data());
+
+                // V * v * (d r / d C) * (1 / V) = v * (d r / d C)
+                for (auto i = 0; i < _RxnPos.size(); ++i)
+                {
+                    for (auto k = 0; k < _RxnPos.size(); ++k)
+                    {
+                        double val = 0;
+                        for (auto j = 0; j < rxnNum; ++j) val += _StoiMat(i, j) * _RateJacVec[k * rxnNum + j];
+                        J(_RxnPos[i], _RxnPos[k]) += val;
+                    }
+                }
+            }
+
+            // 현재 holdup으로부터 출구의 몰 유량(v / V * N)을 구해 출력 스트림들에 나눠 반영함.
+            void _writeOutletFlow()
+            {
+                const double dilution = _VolFlow / _Volume;
+
+                for (auto i = 0; i < __ChemIdx.size(); ++i) __TotalVec[i] = dilution * __ChemMol[i];
+                __splitOutlet();
+            }
+
         public:
 
             // 생성자 정의부
@@ -30,7 +226,7 @@ namespace chemprochelper
             // 임시 객체를 위한 생성자
             CSTR():
                 RxtorBase() {}
-            
+
             // Comment를 사용하지 않는 경우
             CSTR(StreamBase* inStreamPtr, StreamBase* outStreamPtr, RxnBase* RxnPtr):
                 RxtorBase(inStreamPtr, outStreamPtr, RxnPtr)
@@ -46,8 +242,977 @@ namespace chemprochelper
                 _resetChemMol();
             }
 
-            
+            // 반응 속도식을 이용하는 동적 CSTR. Comment를 사용하지 않는 경우
+            CSTR(StreamBase* inStreamPtr, StreamBase* outStreamPtr, SpeedRxnBase* RxnPtr,
+                const float& Volume, const float& VolFlow):
+                RxtorBase(inStreamPtr, outStreamPtr, RxnPtr), _SpeedRxnPtr(RxnPtr), _Volume(Volume), _VolFlow(VolFlow)
+            {
+                _resetChemMol();
+                _resetWork();
+            }
+
+            // 반응 속도식을 이용하는 동적 CSTR. Comment를 사용하는 경우
+            CSTR(StreamBase* inStreamPtr, StreamBase* outStreamPtr, SpeedRxnBase* RxnPtr,
+                const float& Volume, const float& VolFlow, std::string& Comment):
+                RxtorBase(inStreamPtr, outStreamPtr, RxnPtr, Comment), _SpeedRxnPtr(RxnPtr), _Volume(Volume), _VolFlow(VolFlow)
+            {
+                _resetChemMol();
+                _resetWork();
+            }
+
+            /*
+            입/출력 스트림이 여러 개인 동적 CSTR. 입력 스트림은 입구에서 혼합되고, 출구는 SplitFrac에 따라 나뉨.
+            DynamicCSTREngine은 어느 입력 스트림이든 다른 반응기의 어느 출력 스트림과 같으면 두 반응기를 연결함.
+            */
+            CSTR(const std::vector<StreamBase*>& inStreamIdx, const std::vector<StreamBase*>& outStreamIdx,
+                SpeedRxnBase* RxnPtr, const float& Volume, const float& VolFlow, const std::vector<float>& SplitFrac = {}):
+                RxtorBase(inStreamIdx, outStreamIdx, RxnPtr, SplitFrac), _SpeedRxnPtr(RxnPtr), _Volume(Volume), _VolFlow(VolFlow)
+            {
+                _resetChemMol();
+                _resetWork();
+            }
+
+            // getter 정의부
+
+            auto getChemMol() {return __ChemMol;}
+            auto getVolume() {return _Volume;}
+            auto getVolFlow() {return _VolFlow;}
+            auto getISATCache() {return _ISATPtr;}
+
+            // setter 정의부
+
+            void setVolume(const float& Volume) {_Volume = Volume;}
+            void setVolFlow(const float& VolFlow) {_VolFlow = VolFlow;}
+
+            /*
+            입구 몰 유량 -> 출구 몰 유량(__ChemIdx 순서)의 ISAT 캐시를 지정함. nullptr이면 사용하지 않음.
+            정상 상태가 입구로 유일하게 정해진다고 가정하며, 반응기 조건을 바꾸면 ISATCache::clear를 호출할 것.
+            */
+            void setISATCache(ISATCache* ISATPtr)
+            {
+                if (ISATPtr != nullptr && (ISATPtr->getInDim() != __ChemIdx.size() || ISATPtr->getOutDim() != __ChemIdx.size()))
+                {
+                    throw std::runtime_error("ISATCache dimensions don't match the CSTR.");
+                }
+                _ISATPtr = ISATPtr;
+            }
+
+            // 반응기 내부 화학종의 몰수(holdup)를 설정함. __ChemIdx의 순서를 따름.
+            void setChemMol(const std::vector<float>& ChemMol)
+            {
+                assert(ChemMol.size() == __ChemIdx.size());
+                __ChemMol = ChemMol;
+            }
+
+            // 입력 스트림의 시간 변화를 설정함. 설정하지 않은 경우 입력 스트림의 값이 일정하다고 가정함.
+            void setInletProfile(StreamProfile& Profile)
+            {
+                auto StreamIdx = Profile.getStreamIdx();
+
+                _ProfileTimeVec = Profile.getTimeVec();
+                _ProfileMat.resize(__ChemIdx.size(), StreamIdx.size());
+
+                for (auto k = 0; k < StreamIdx.size(); ++k)
+                {
+                    for (auto i = 0; i < __ChemIdx.size(); ++i) _ProfileMat(i, k) = StreamIdx[k]->getChemMol(__ChemIdx[i]);
+                }
+            }
+
+            // 입력 스트림의 시간 변화를 제거함.
+            void clearInletProfile()
+            {
+                _ProfileTimeVec.clear();
+                _ProfileMat.resize(0, 0);
+            }
+
+            /*
+            holdup N, 입력 몰 유량 Fin(__ChemIdx 순서), 온도 Temp에서 물질 수지의 우변
+                G = F_in - (v / V) N + V v(nu) r(N / V)
+            를 임의의 스칼라 형식 T(double, Dual, HyperDual 등)로 res에 계산함. Dual로 시드하면
+            _calcJacobi와 같은 d G / d N 과 온도, 입구 유량에 대한 미분을 손 미분 없이 함께 얻음.
+            */
+            template <typename T>
+            void calcResidualAD(const T* N, const T* Fin, const T& Temp, T* res) const
+            {
+                if (_SpeedRxnPtr == nullptr) throw std::runtime_error("CSTR has no SpeedRxnBase object.");
+
+                const int chemNum = __ChemIdx.size();
+                const int rxnChemNum = _RxnPos.size();
+                const int rxnNum = _RateVec.size();
+                const double dilution = _VolFlow / _Volume;
+
+                for (auto i = 0; i < chemNum; ++i) res[i] = Fin[i] - dilution * N[i];
+
+                std::vector<T> conc(rxnChemNum), rate(rxnNum);
+                for (auto i = 0; i < rxnChemNum; ++i) conc[i] = (N[_RxnPos[i]] < T(0)) ? T(0) : N[_RxnPos[i]] / static_cast<double>(_Volume);
+                _SpeedRxnPtr->calcRateAD(conc.data(), Temp, rate.data());
+
+                for (auto i = 0; i < rxnChemNum; ++i)
+                {
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        if (_StoiMat(i, j) != 0) res[_RxnPos[i]] += (_Volume * _StoiMat(i, j)) * rate[j];
+                    }
+                }
+            }
+
+            // 반응 온도(SpeedRxnBase::getTemp())에서 물질 수지의 우변을 T 형식으로 계산함.
+            template <typename T>
+            void calcResidualAD(const T* N, const T* Fin, T* res) const
+            {
+                calcResidualAD(N, Fin, T(_SpeedRxnPtr->getTemp()), res);
+            }
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            /*
+            정상 상태에 도달할 때까지 holdup 수지를 적분하고 출력 스트림에 값을 반영함.
+            ISATCache가 지정되어 있으면 입구 몰 유량으로 캐시에 질의하고, 캐시가 직접 계산을 요구할 때만 적분하며,
+            민감도는 calcSensitivity로 계산함(반응하지 않는 화학종은 출구 = 입구).
+            */
+            void solveSteadyState() override;
+
+            /*
+            정상 상태(solveSteadyState 이후의 holdup)에서 출구의 민감도를 음함수 정리로 계산함.
+            G(N) = F_in - (v / V) N + V v r(N / V) = 0 에서 dN/dF_in = -G_N^-1, dN/d(ln p) = -G_N^-1 G_p 이므로
+            G_N을 한 번만 분해(LU)해 모든 입구 유량과 매개변수에 대한 민감도를 구함.
+            */
+            RxtorSensitivity calcSensitivity()
+            {
+                const int chemNum = __ChemIdx.size();
+                const int rxnChemNum = _RxnPos.size();
+                const int rxnNum = _RateVec.size();
+                const double dilution = _VolFlow / _Volume;
+
+                if (_SpeedRxnPtr == nullptr) throw std::runtime_error("CSTR has no SpeedRxnBase object.");
+
+                std::vector<double> paramSensVec(rxnNum);
+                for (auto i = 0; i < rxnChemNum; ++i) _ConcVec[i] = std::max<double>(__ChemMol[_RxnPos[i]], 0.0) / _Volume;
+                _SpeedRxnPtr->calcRateJacobian(_ConcVec.data(), _RateVec.data(), _RateJacVec.data());
+                _SpeedRxnPtr->calcRateParamSens(_ConcVec.data(), paramSensVec.data());
+
+                Eigen::Map<const Eigen::MatrixXd> rateJacMat(_RateJacVec.data(), rxnNum, rxnChemNum);
+                const Eigen::MatrixXd rxnJacMat = _StoiMat * rateJacMat;
+
+                // G_N과 우변 [I, G_p]
+                Eigen::MatrixXd jacMat = -dilution * Eigen::MatrixXd::Identity(chemNum, chemNum);
+                Eigen::MatrixXd rhsMat = Eigen::MatrixXd::Zero(chemNum, chemNum + rxnNum);
+                rhsMat.leftCols(chemNum).setIdentity();
+
+                for (auto i = 0; i < rxnChemNum; ++i)
+                {
+                    for (auto k = 0; k < rxnChemNum; ++k) jacMat(_RxnPos[i], _RxnPos[k]) += rxnJacMat(i, k);
+                    for (auto j = 0; j < rxnNum; ++j) rhsMat(_RxnPos[i], chemNum + j) = _Volume * _StoiMat(i, j) * paramSensVec[j];
+                }
+
+                // F_out = (v / V) N
+                const Eigen::MatrixXd solMat = -dilution * jacMat.partialPivLu().solve(rhsMat);
+
+                RxtorSensitivity res;
+                res.dOutdFeed.resize(rxnChemNum, rxnChemNum);
+                res.dOutdParam.resize(rxnChemNum, rxnNum);
+                for (auto i = 0; i < rxnChemNum; ++i)
+                {
+                    for (auto k = 0; k < rxnChemNum; ++k) res.dOutdFeed(i, k) = solMat(_RxnPos[i], _RxnPos[k]);
+                    for (auto j = 0; j < rxnNum; ++j) res.dOutdParam(i, j) = solMat(_RxnPos[i], chemNum + j);
+                }
+
+                return res;
+            }
+
+            // 입력/출력 스트림 몰 유량 사이의 야코비안을 계산함(ProcObjBase::calcStreamJacobian 참조).
+            bool calcStreamJacobian(Eigen::MatrixXd& Jacob) override
+            {
+                __chainStreamJacobian(calcSensitivity().dOutdFeed, Jacob);
+                return true;
+            }
+
+            /*
+            속도식으로 출구를 계산하므로 Forward만 지원함.
+            SpeedRxnBase 없이(RxnBase로) 만든 CSTR은 전화율로 계산하므로 RxtorBase와 같음.
+            */
+            bool supportDirection(const DirectionType& Direction) override
+            {
+                if (_SpeedRxnPtr == nullptr) return RxtorBase::supportDirection(Direction);
+                return Direction == Forward;
+            }
+
+            #endif
+    };
+
+    #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+    /*
+    DynamicCSTREngine의 이벤트를 지정함.
+    ---------------------------------
+        Type : SteadyState(정상 상태 도달) 혹은 Threshold(농도가 Value를 지남)
+        RxtorNum : 대상 반응기의 인덱스. SteadyState에서 -1이면 모든 반응기를 대상으로 함.
+        ChemPtr : Threshold에서 대상 화학종의 포인터.
+        Value : SteadyState에서는 max|dN/dt|의 허용치, Threshold에서는 농도(N / V)의 기준값.
+        Direction : Threshold에서 1이면 증가, -1이면 감소, 0이면 양방향 교차를 감지함.
+        Terminal : true이면 이벤트가 발생한 시점에서 적분을 멈춤.
+    */
+    struct CSTREvent
+    {
+        enum EventType {SteadyState, Threshold};
+
+        EventType Type = SteadyState;
+        int RxtorNum = -1;
+        ChemBase* ChemPtr = nullptr;
+        double Value = 1e-6;
+        int Direction = 0;
+        bool Terminal = true;
+    };
+
+    /*
+    DynamicCSTREngine::simulate의 결과를 저장함.
+    ------------------------------------------
+        TimeVec : 출력 시간을 저장함.
+        StateVec : 출력 시간에서의 모든 반응기의 holdup을 이어붙여 저장함.
+        EventVec : 발생한 이벤트의 (이벤트 인덱스, 시간)을 저장함.
+        StepNum : 적분기가 수행한 단계의 수.
+    */
+    struct CSTRSimResult
+    {
+        std::vector<double> TimeVec;
+        std::vector<std::vector<float>> StateVec;
+        std::vector<std::pair<int, double>> EventVec;
+        int StepNum = 0;
+    };
+
+    /*
+    여러 CSTR의 holdup 수지를 하나의 상태 벡터로 묶어 같은 시간 간격으로(lockstep) 적분하는 클래스.
+    -------------------------------------------------------------------------------------
+    어떤 반응기의 입력 스트림이 다른 반응기(또는 자기 자신)의 출력 스트림과 같은 객체인 경우, 두 반응기를
+    연결된 것으로 보고 그 입력 몰 유량을 상류 반응기의 holdup으로부터 계산함(반응기 열, reactor train).
+    모든 입력 스트림과 출력 스트림을 비교하므로 입/출력 스트림이 여러 개인 반응기도 연결됨.
+
+    적분기는 odeint의 rosenbrock4와 같은 계수의 4차 Rosenbrock 법(_Rosenbrock4)이며, 반복 행렬
+    M = I / (gamma h) - J 만 반응기 열의 구조를 이용해 분해함.
+        - J는 반응기별 대각 블록과 연결 블록으로 이루어지며, 연결에 순환이 없으면 상류 -> 하류 순서(_Order)로
+          정렬했을 때 블록 하삼각(직렬 연결이면 블록 이중대각) 행렬이 됨. 이 경우 대각 블록만 LU 분해하고
+          블록 전진 대입으로 풀므로 반응기 N개, 화학종 n개일 때 분해 비용이 O((N n)^3)이 아닌 O(N n^3)임.
+        - 연결에 순환(재순환)이 있으면 같은 패턴의 희소 행렬을 Eigen::SparseLU로 분해함. 기호 분해는 생성자에서
+          한 번만 함.
+    DynamicCSTREngine은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _RxtorIdx : 적분할 CSTR 객체의 포인터를 저장함.
+        _Offset : 상태 벡터에서 각 반응기의 시작 위치를 저장함.
+        _LinkMat : 각 반응기로 들어오는 연결(상류 반응기, 출력 스트림 번호, 화학종 위치)을 저장함.
+        _SkipMat : 각 반응기의 입력 스트림 중 다른 반응기와 연결된 것을 저장함. (__mixInlet에서 제외함)
+        _Order, _Acyclic : 상류 -> 하류 순서와 연결에 순환이 없는지 여부를 저장함.
+        _JacobBlock, _BlockLU : 반응기별 J의 대각 블록과 M의 대각 블록 LU 분해를 저장함.
+        _IterMat, _SparseLU : 순환이 있는 경우 사용하는 M과 희소 LU 분해를 저장함.
+        _EventVec : 감지할 이벤트를 저장함.
+    */
+    class DynamicCSTREngine
+    {
+        private:
+
+            using _StateType = boost::numeric::ublas::vector<double>;
+
+            /*
+            다른 반응기(Up)의 OutNum번째 출력 스트림이 입력 스트림인 연결.
+            Pos는 하류 반응기 화학종의 상류 반응기 __ChemIdx 상 위치(없으면 -1)임.
+            */
+            struct _Link
+            {
+                int Up = -1;
+                int OutNum = 0;
+                std::vector<int> Pos;
+            };
+
+            /*
+            odeint의 rosenbrock4와 같은 계수(default_rosenbrock_coefficients)의 4차 Rosenbrock 법.
+            rosenbrock4_controller, rosenbrock4_dense_output에 그대로 사용할 수 있으며, 반복 행렬의 분해와 풀이만
+            DynamicCSTREngine::_factorize, _solve에 맡김.
+            */
+            class _Rosenbrock4
+            {
+                public:
+
+                    using value_type = double;
+                    using state_type = _StateType;
+                    using deriv_type = _StateType;
+                    using time_type = double;
+                    using order_type = unsigned short;
+                    using resizer_type = boost::numeric::odeint::initially_resizer;
+                    using stepper_category = boost::numeric::odeint::stepper_tag;
+                    using wrapped_state_type = boost::numeric::odeint::state_wrapper<state_type>;
+                    using wrapped_deriv_type = boost::numeric::odeint::state_wrapper<deriv_type>;
+
+                    static constexpr order_type stepper_order = 4;
+                    static constexpr order_type error_order = 3;
+
+                private:
+
+                    DynamicCSTREngine* _Ptr = nullptr;
+                    boost::numeric::odeint::default_rosenbrock_coefficients<double> _Coef;
+                    _StateType _dxdt, _dfdt, _dxdtNew, _xTmp, _g1, _g2, _g3, _g4, _g5, _cont3, _cont4;
+
+                    void _resize(const size_t& n)
+                    {
+                        if (_g1.size() == n) return;
+                        for (auto vec : {&_dxdt, &_dfdt, &_dxdtNew, &_xTmp, &_g1, &_g2, &_g3, &_g4, &_g5, &_cont3, &_cont4}) vec->resize(n);
+                    }
+
+                public:
+
+                    _Rosenbrock4() = default;
+                    _Rosenbrock4(DynamicCSTREngine* Ptr): _Ptr(Ptr) {}
+
+                    order_type order() const {return stepper_order;}
+
+                    template <typename System>
+                    void do_step(System system, const state_type& x, time_type t, state_type& xout, time_type dt, state_type& xerr)
+                    {
+                        const size_t n = x.size();
+                        const auto& c = _Coef;
+                        _resize(n);
+
+                        system(x, _dxdt, t);
+                        _Ptr->_factorize(x, t, 1.0 / (c.gamma * dt), _dfdt);
+
+                        for (size_t i = 0; i < n; ++i) _g1[i] = _dxdt[i] + dt * c.d1 * _dfdt[i];
+                        _Ptr->_solve(_g1);
+
+                        for (size_t i = 0; i < n; ++i) _xTmp[i] = x[i] + c.a21 * _g1[i];
+                        system(_xTmp, _dxdtNew, t + c.c2 * dt);
+                        for (size_t i = 0; i < n; ++i) _g2[i] = _dxdtNew[i] + dt * c.d2 * _dfdt[i] + c.c21 * _g1[i] / dt;
+                        _Ptr->_solve(_g2);
+
+                        for (size_t i = 0; i < n; ++i) _xTmp[i] = x[i] + c.a31 * _g1[i] + c.a32 * _g2[i];
+                        system(_xTmp, _dxdtNew, t + c.c3 * dt);
+                        for (size_t i = 0; i < n; ++i) _g3[i] = _dxdtNew[i] + dt * c.d3 * _dfdt[i] + (c.c31 * _g1[i] + c.c32 * _g2[i]) / dt;
+                        _Ptr->_solve(_g3);
+
+                        for (size_t i = 0; i < n; ++i) _xTmp[i] = x[i] + c.a41 * _g1[i] + c.a42 * _g2[i] + c.a43 * _g3[i];
+                        system(_xTmp, _dxdtNew, t + c.c4 * dt);
+                        for (size_t i = 0; i < n; ++i) _g4[i] = _dxdtNew[i] + dt * c.d4 * _dfdt[i] + (c.c41 * _g1[i] + c.c42 * _g2[i] + c.c43 * _g3[i]) / dt;
+                        _Ptr->_solve(_g4);
+
+                        for (size_t i = 0; i < n; ++i) _xTmp[i] = x[i] + c.a51 * _g1[i] + c.a52 * _g2[i] + c.a53 * _g3[i] + c.a54 * _g4[i];
+                        system(_xTmp, _dxdtNew, t + dt);
+                        for (size_t i = 0; i < n; ++i) _g5[i] = _dxdtNew[i] + (c.c51 * _g1[i] + c.c52 * _g2[i] + c.c53 * _g3[i] + c.c54 * _g4[i]) / dt;
+                        _Ptr->_solve(_g5);
+
+                        for (size_t i = 0; i < n; ++i) _xTmp[i] += _g5[i];
+                        system(_xTmp, _dxdtNew, t + dt);
+                        for (size_t i = 0; i < n; ++i) xerr[i] = _dxdtNew[i] + (c.c61 * _g1[i] + c.c62 * _g2[i] + c.c63 * _g3[i] + c.c64 * _g4[i] + c.c65 * _g5[i]) / dt;
+                        _Ptr->_solve(xerr);
+
+                        for (size_t i = 0; i < n; ++i) xout[i] = _xTmp[i] + xerr[i];
+                    }
+
+                    void prepare_dense_output()
+                    {
+                        const auto& c = _Coef;
+                        for (size_t i = 0; i < _g1.size(); ++i)
+                        {
+                            _cont3[i] = c.d21 * _g1[i] + c.d22 * _g2[i] + c.d23 * _g3[i] + c.d24 * _g4[i] + c.d25 * _g5[i];
+                            _cont4[i] = c.d31 * _g1[i] + c.d32 * _g2[i] + c.d33 * _g3[i] + c.d34 * _g4[i] + c.d35 * _g5[i];
+                        }
+                    }
+
+                    void calc_state(time_type t, state_type& x, const state_type& xOld, time_type tOld,
+                        const state_type& xNew, time_type tNew)
+                    {
+                        const double s = (t - tOld) / (tNew - tOld);
+                        const double s1 = 1.0 - s;
+                        for (size_t i = 0; i < _g1.size(); ++i) x[i] = xOld[i] * s1 + s * (xNew[i] + s1 * (_cont3[i] + s * _cont4[i]));
+                    }
+            };
+
+            using _StepperType = boost::numeric::odeint::rosenbrock4_dense_output<
+                boost::numeric::odeint::rosenbrock4_controller<_Rosenbrock4>>;
+
+            // 적분할 반응기들의 포인터를 저장함.
+            std::vector<CSTR*> _RxtorIdx;
+
+            // 상태 벡터에서 각 반응기의 시작 위치를 저장함. 마지막 원소는 상태 벡터의 크기임.
+            std::vector<int> _Offset;
+
+            // 반응기 간의 연결 정보를 저장함.
+            std::vector<std::vector<_Link>> _LinkMat;
+            std::vector<std::vector<bool>> _SkipMat;
+
+            // 상류 -> 하류 순서와 연결에 순환이 없는지 여부를 저장함.
+            std::vector<int> _Order;
+            bool _Acyclic = true;
+
+            // 반복 행렬의 분해. 순환이 없으면 대각 블록만, 있으면 전체 희소 행렬을 분해함.
+            std::vector<Eigen::MatrixXd> _JacobBlock;
+            std::vector<Eigen::PartialPivLU<Eigen::MatrixXd>> _BlockLU;
+            Eigen::SparseMatrix<double> _IterMat;
+            Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> _SparseLU;
+            Eigen::VectorXd _SolveWork;
+
+            // 감지할 이벤트를 저장함.
+            std::vector<CSTREvent> _EventVec;
+
+            // 적분기의 허용 오차를 저장함.
+            double _AbsTol = 1e-8;
+            double _RelTol = 1e-6;
+
+            // 적분 작업 공간
+            std::vector<double> _FinVec;
+            std::vector<double> _dFinVec;
+            _StateType _StateVec;
+            _StateType _DerivVec;
+            _StateType _WorkVec;
+
+            // odeint에 전달하는 시스템 함수 객체.
+            struct _System
+            {
+                DynamicCSTREngine* _Ptr;
+                void operator()(const _StateType& N, _StateType& dNdt, const double& t) const
+                {
+                    _Ptr->_calcDeriv(N, dNdt, t);
+                }
+            };
+
+            // 연결 Link의 d(F_in)/d(N_up) 계수. 상류 반응기의 출구 v / V에 출력 스트림의 분배 비율을 곱함.
+            double _linkCoef(const _Link& Link) const
+            {
+                auto upRxtor = _RxtorIdx[Link.Up];
+                return upRxtor->getSplitFracAt(Link.OutNum) * upRxtor->_VolFlow / upRxtor->_Volume;
+            }
+
+            // 반응기 k의 입력 몰 유량을 _FinVec, _dFinVec의 (offset) 위치에 저장함.
+            void _calcInletFlow(const _StateType& N, const double& t, const int& k)
+            {
+                auto rxtor = _RxtorIdx[k];
+                const int offset = _Offset[k];
+
+                if (_LinkMat[k].empty())
+                {
+                    rxtor->_calcInletFlow(t, &_FinVec[offset], &_dFinVec[offset]);
+                    return;
+                }
+
+                // 연결되지 않은 입력 스트림은 그대로 혼합하고, 연결된 입력 스트림은 상류 반응기의 출구로 계산함.
+                rxtor->__mixInlet(_SkipMat[k]);
+                for (auto i = 0; i < _Offset[k+1] - offset; ++i)
+                {
+                    _FinVec[offset + i] = rxtor->__MixVec[i];
+                    _dFinVec[offset + i] = 0;
+                }
+
+                for (const auto& link : _LinkMat[k])
+                {
+                    const double coef = _linkCoef(link);
+                    const int upOffset = _Offset[link.Up];
+                    for (auto i = 0; i < link.Pos.size(); ++i)
+                    {
+                        if (link.Pos[i] >= 0) _FinVec[offset + i] += coef * N[upOffset + link.Pos[i]];
+                    }
+                }
+            }
+
+            void _calcDeriv(const _StateType& N, _StateType& dNdt, const double& t)
+            {
+                for (auto k = 0; k < _RxtorIdx.size(); ++k)
+                {
+                    _calcInletFlow(N, t, k);
+                    _RxtorIdx[k]->_calcDeriv(&N[_Offset[k]], &_FinVec[_Offset[k]], &dNdt[_Offset[k]]);
+                }
+            }
+
+            /*
+            상태 N에서 J와 d f / d t를 계산하고 반복 행렬 M = c I - J 를 분해함. (c = 1 / (gamma h))
+            순환이 없으면 대각 블록 c I - J_kk만 분해하고, 있으면 _IterMat의 값을 채워 희소 LU로 분해함.
+            */
+            void _factorize(const _StateType& N, const double& t, const double& c, _StateType& dfdt)
+            {
+                const int rxtorNum = _RxtorIdx.size();
+
+                for (auto k = 0; k < rxtorNum; ++k)
+                {
+                    const int offset = _Offset[k];
+                    const int chemNum = _Offset[k+1] - offset;
+
+                    _calcInletFlow(N, t, k);
+                    for (auto i = 0; i < chemNum; ++i) dfdt[offset + i] = _dFinVec[offset + i];
+
+                    auto& block = _JacobBlock[k];
+                    _RxtorIdx[k]->_calcJacobi(&N[offset], block);
+
+                    // 자기 자신의 출구가 입구로 돌아오는 연결은 대각 블록에 더함.
+                    for (const auto& link : _LinkMat[k])
+                    {
+                        if (link.Up != k) continue;
+                        const double coef = _linkCoef(link);
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            if (link.Pos[i] >= 0) block(i, link.Pos[i]) += coef;
+                        }
+                    }
+                }
+
+                if (_Acyclic)
+                {
+                    for (auto k = 0; k < rxtorNum; ++k)
+                    {
+                        auto& block = _JacobBlock[k];
+                        block *= -1;
+                        block.diagonal().array() += c;
+                        _BlockLU[k].compute(block);
+                    }
+                    return;
+                }
+
+                std::fill(_IterMat.valuePtr(), _IterMat.valuePtr() + _IterMat.nonZeros(), 0.0);
+                for (auto k = 0; k < rxtorNum; ++k)
+                {
+                    const int offset = _Offset[k];
+                    const auto& block = _JacobBlock[k];
+                    for (auto q = 0; q < block.cols(); ++q)
+                    {
+                        for (auto i = 0; i < block.rows(); ++i) _IterMat.coeffRef(offset + i, offset + q) = -block(i, q);
+                        _IterMat.coeffRef(offset + q, offset + q) += c;
+                    }
+
+                    for (const auto& link : _LinkMat[k])
+                    {
+                        if (link.Up == k) continue;
+                        const double coef = _linkCoef(link);
+                        for (auto i = 0; i < link.Pos.size(); ++i)
+                        {
+                            if (link.Pos[i] >= 0) _IterMat.coeffRef(offset + i, _Offset[link.Up] + link.Pos[i]) -= coef;
+                        }
+                    }
+                }
+
+                _SparseLU.factorize(_IterMat);
+                if (_SparseLU.info() != Eigen::Success) throw std::runtime_error("Sparse LU factorization in DynamicCSTREngine failed.");
+            }
+
+            /*
+            _factorize로 분해한 M으로 M x = b 를 풀어 b에 덮어씀. 순환이 없으면 상류 -> 하류 순서의 블록 전진 대입
+                M_kk x_k = b_k + sum_(m -> k) J_km x_m
+            으로 풂. 상류 반응기의 x_m은 이미 b에 덮어써져 있음.
+            */
+            void _solve(_StateType& b)
+            {
+                Eigen::Map<Eigen::VectorXd> bVec(&b[0], b.size());
+
+                if (!_Acyclic)
+                {
+                    _SolveWork = _SparseLU.solve(bVec);
+                    bVec = _SolveWork;
+                    return;
+                }
+
+                for (auto k : _Order)
+                {
+                    const int offset = _Offset[k];
+                    const int chemNum = _Offset[k+1] - offset;
+
+                    for (const auto& link : _LinkMat[k])
+                    {
+                        if (link.Up == k) continue;
+                        const double coef = _linkCoef(link);
+                        const int upOffset = _Offset[link.Up];
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            if (link.Pos[i] >= 0) bVec[offset + i] += coef * bVec[upOffset + link.Pos[i]];
+                        }
+                    }
+
+                    _SolveWork = _BlockLU[k].solve(bVec.segment(offset, chemNum));
+                    bVec.segment(offset, chemNum) = _SolveWork;
+                }
+            }
+
+            // 이벤트 함수 값을 계산함. Threshold 이벤트에만 사용함.
+            double _calcEventValue(const CSTREvent& event, const _StateType& N)
+            {
+                auto rxtor = _RxtorIdx[event.RxtorNum];
+                const int pos = functions::getVecPos(rxtor->__ChemIdx, event.ChemPtr);
+                return N[_Offset[event.RxtorNum] + pos] / rxtor->_Volume - event.Value;
+            }
+
+            // 정상 상태 여부를 확인함.
+            bool _isSteadyState(const CSTREvent& event, const _StateType& N, const double& t)
+            {
+                _calcDeriv(N, _DerivVec, t);
+
+                int begin = 0, end = _Offset.back();
+                if (event.RxtorNum >= 0)
+                {
+                    begin = _Offset[event.RxtorNum];
+                    end = _Offset[event.RxtorNum + 1];
+                }
+
+                for (auto i = begin; i < end; ++i)
+                {
+                    if (std::abs(_DerivVec[i]) > event.Value) return false;
+                }
+
+                return true;
+            }
+
+            // 상태 벡터의 값을 각 반응기의 __ChemMol과 출력 스트림에 반영함.
+            void _writeState(const _StateType& N)
+            {
+                for (auto k = 0; k < _RxtorIdx.size(); ++k)
+                {
+                    auto rxtor = _RxtorIdx[k];
+                    for (auto i = 0; i < rxtor->__ChemMol.size(); ++i) rxtor->__ChemMol[i] = N[_Offset[k] + i];
+                    rxtor->_writeOutletFlow();
+                }
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            DynamicCSTREngine() = default;
+
+            // 적분할 반응기들을 지정함. 반응기 간의 연결은 스트림 포인터로부터 자동으로 찾음.
+            DynamicCSTREngine(const std::vector<CSTR*>& RxtorIdx):
+                _RxtorIdx(RxtorIdx)
+            {
+                const int rxtorNum = RxtorIdx.size();
+
+                _Offset.assign(rxtorNum + 1, 0);
+                for (auto k = 0; k < rxtorNum; ++k)
+                {
+                    if (RxtorIdx[k]->_SpeedRxnPtr == nullptr) throw std::runtime_error("CSTR has no SpeedRxnBase object.");
+                    _Offset[k+1] = _Offset[k] + RxtorIdx[k]->__ChemIdx.size();
+                }
+
+                // 모든 입력 스트림을 모든 반응기의 모든 출력 스트림과 비교해 연결을 찾음.
+                _LinkMat.assign(rxtorNum, std::vector<_Link>());
+                _SkipMat.resize(rxtorNum);
+                for (auto k = 0; k < rxtorNum; ++k)
+                {
+                    const int inNum = RxtorIdx[k]->getInStreamNum();
+                    const auto& chemIdx = RxtorIdx[k]->__ChemIdx;
+                    _SkipMat[k].assign(inNum, false);
+
+                    for (auto n = 0; n < inNum; ++n)
+                    {
+                        auto inStreamPtr = RxtorIdx[k]->getInStreamPtr(n);
+                        for (auto m = 0; m < rxtorNum; ++m)
+                        {
+                            for (auto j = 0; j < RxtorIdx[m]->getOutStreamNum(); ++j)
+                            {
+                                if (RxtorIdx[m]->getOutStreamPtr(j) != inStreamPtr) continue;
+
+                                const auto& upChemIdx = RxtorIdx[m]->__ChemIdx;
+                                _Link link;
+                                link.Up = m;
+                                link.OutNum = j;
+                                link.Pos.resize(chemIdx.size());
+                                for (auto i = 0; i < chemIdx.size(); ++i)
+                                {
+                                    link.Pos[i] = functions::inVector(upChemIdx, chemIdx[i]) ? functions::getVecPos(upChemIdx, chemIdx[i]) : -1;
+                                }
+
+                                _LinkMat[k].push_back(link);
+                                _SkipMat[k][n] = true;
+                            }
+                        }
+                    }
+                }
+
+                // 상류 -> 하류 순서로 정렬함(Kahn). 자기 자신으로의 연결은 대각 블록에 포함되므로 무시함.
+                std::vector<int> inDegree(rxtorNum, 0);
+                std::vector<std::vector<int>> downMat(rxtorNum);
+                for (auto k = 0; k < rxtorNum; ++k)
+                {
+                    for (const auto& link : _LinkMat[k])
+                    {
+                        if (link.Up == k) continue;
+                        downMat[link.Up].push_back(k);
+                        ++inDegree[k];
+                    }
+                }
+
+                _Order.clear();
+                for (auto k = 0; k < rxtorNum; ++k)
+                {
+                    if (inDegree[k] == 0) _Order.push_back(k);
+                }
+                for (auto q = 0; q < _Order.size(); ++q)
+                {
+                    for (auto k : downMat[_Order[q]])
+                    {
+                        if (--inDegree[k] == 0) _Order.push_back(k);
+                    }
+                }
+                _Acyclic = (_Order.size() == rxtorNum);
+
+                _JacobBlock.resize(rxtorNum);
+                _BlockLU.resize(rxtorNum);
+
+                // 순환이 있으면 대각 블록과 연결 블록의 패턴으로 희소 행렬을 만들고 기호 분해를 한 번만 함.
+                if (!_Acyclic)
+                {
+                    std::vector<Eigen::Triplet<double>> tripVec;
+                    for (auto k = 0; k < rxtorNum; ++k)
+                    {
+                        const int offset = _Offset[k];
+                        const int chemNum = _Offset[k+1] - offset;
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            for (auto q = 0; q < chemNum; ++q) tripVec.emplace_back(offset + i, offset + q, 0.0);
+                        }
+
+                        for (const auto& link : _LinkMat[k])
+                        {
+                            for (auto i = 0; i < chemNum; ++i)
+                            {
+                                if (link.Pos[i] >= 0) tripVec.emplace_back(offset + i, _Offset[link.Up] + link.Pos[i], 0.0);
+                            }
+                        }
+                    }
+
+                    _IterMat.resize(_Offset.back(), _Offset.back());
+                    _IterMat.setFromTriplets(tripVec.begin(), tripVec.end());
+                    _IterMat.makeCompressed();
+                    _SparseLU.analyzePattern(_IterMat);
+                }
+
+                const int stateNum = _Offset.back();
+                _FinVec.assign(stateNum, 0);
+                _dFinVec.assign(stateNum, 0);
+                _StateVec.resize(stateNum);
+                _DerivVec.resize(stateNum);
+                _WorkVec.resize(stateNum);
+            }
+
+            // getter 정의부
+
+            auto getRxtorIdx() {return _RxtorIdx;}
+            auto getEventVec() {return _EventVec;}
+
+            // setter 정의부
+
+            void setTolerance(const double& AbsTol, const double& RelTol)
+            {
+                _AbsTol = AbsTol;
+                _RelTol = RelTol;
+            }
+
+            // 인스턴스 정의부
+
+            // 이벤트를 추가함. 추가된 이벤트의 인덱스를 반환함.
+            int addEvent(const CSTREvent& event)
+            {
+                if (event.Type == CSTREvent::Threshold)
+                {
+                    if (event.RxtorNum < 0 || event.RxtorNum >= _RxtorIdx.size()) throw std::runtime_error("Invalid reactor index in CSTREvent.");
+                    if (!functions::inVector(_RxtorIdx[event.RxtorNum]->__ChemIdx, event.ChemPtr)) throw std::runtime_error("ChemBase object isn't in CSTR.");
+                }
+
+                _EventVec.push_back(event);
+                return _EventVec.size() - 1;
+            }
+
+            // 정상 상태 이벤트를 추가함.
+            int addSteadyStateEvent(const double& Tol = 1e-6, const bool& Terminal = true)
+            {
+                CSTREvent event;
+                event.Type = CSTREvent::SteadyState;
+                event.Value = Tol;
+                event.Terminal = Terminal;
+                return addEvent(event);
+            }
+
+            // 농도 기준값 교차 이벤트를 추가함.
+            int addThresholdEvent(const int& RxtorNum, ChemBase* ChemPtr, const double& Value,
+                const int& Direction = 0, const bool& Terminal = false)
+            {
+                CSTREvent event;
+                event.Type = CSTREvent::Threshold;
+                event.RxtorNum = RxtorNum;
+                event.ChemPtr = ChemPtr;
+                event.Value = Value;
+                event.Direction = Direction;
+                event.Terminal = Terminal;
+                return addEvent(event);
+            }
+
+            void clearEvent() {_EventVec.clear();}
+
+            /*
+            현재 holdup(각 CSTR의 __ChemMol)으로부터 시간 tEnd까지 적분함.
+            outTimeVec(오름차순)에서의 상태를 dense output으로 기록함. 이벤트 발생 시각은 dense output의
+            이분법으로 찾으며, Terminal 이벤트가 발생하면 해당 시각에서 적분을 멈춤.
+            적분이 끝나면 각 CSTR의 __ChemMol과 출력 스트림에 마지막 상태를 반영함.
+            */
+            CSTRSimResult simulate(const double& tEnd, const std::vector<double>& outTimeVec = {},
+                const double& dt0 = 1e-3)
+            {
+                CSTRSimResult res;
+
+                for (auto k = 0; k < _RxtorIdx.size(); ++k)
+                {
+                    auto rxtor = _RxtorIdx[k];
+                    for (auto i = 0; i < rxtor->__ChemMol.size(); ++i) _StateVec[_Offset[k] + i] = rxtor->__ChemMol[i];
+                }
+
+                _StepperType stepper(boost::numeric::odeint::rosenbrock4_controller<_Rosenbrock4>(_AbsTol, _RelTol, _Rosenbrock4(this)));
+                auto sys = _System{this};
+
+                double t = 0;
+                int outIdx = 0;
+                bool stop = false;
+
+                std::vector<double> eventVal(_EventVec.size(), 0);
+                for (auto e = 0; e < _EventVec.size(); ++e)
+                {
+                    if (_EventVec[e].Type == CSTREvent::Threshold) eventVal[e] = _calcEventValue(_EventVec[e], _StateVec);
+                }
+
+                stepper.initialize(_StateVec, t, std::min(dt0, tEnd));
+
+                while (!stop && stepper.current_time() < tEnd)
+                {
+                    auto range = stepper.do_step(sys);
+                    ++res.StepNum;
+
+                    double tStop = std::min(range.second, tEnd);
+
+                    // 이벤트 감지
+                    for (auto e = 0; e < _EventVec.size(); ++e)
+                    {
+                        const auto& event = _EventVec[e];
+
+                        if (event.Type == CSTREvent::SteadyState)
+                        {
+                            if (_isSteadyState(event, stepper.current_state(), range.second))
+                            {
+                                res.EventVec.push_back({e, range.second});
+                                if (event.Terminal) stop = true;
+                            }
+                            continue;
+                        }
+
+                        stepper.calc_state(tStop, _WorkVec);
+                        double newVal = _calcEventValue(event, _WorkVec);
+                        bool crossUp = (eventVal[e] < 0 && newVal >= 0);
+                        bool crossDown = (eventVal[e] > 0 && newVal <= 0);
+
+                        if ((crossUp && event.Direction >= 0) || (crossDown && event.Direction <= 0))
+                        {
+                            double lo = range.first, hi = tStop;
+                            for (auto iter = 0; iter < 50; ++iter)
+                            {
+                                double mid = 0.5 * (lo + hi);
+                                stepper.calc_state(mid, _WorkVec);
+                                double midVal = _calcEventValue(event, _WorkVec);
+                                if ((midVal >= 0) == (eventVal[e] >= 0)) lo = mid;
+                                else hi = mid;
+                            }
+
+                            res.EventVec.push_back({e, hi});
+                            if (event.Terminal)
+                            {
+                                stop = true;
+                                tStop = std::min(tStop, hi);
+                            }
+                        }
+
+                        eventVal[e] = newVal;
+                    }
+
+                    // Terminal 이벤트가 가장 먼저 발생한 시각에서 멈춤.
+                    if (stop)
+                    {
+                        for (const auto& ev : res.EventVec)
+                        {
+                            if (_EventVec[ev.first].Terminal) tStop = std::min(tStop, ev.second);
+                        }
+                    }
+
+                    // 출력 시간 기록
+                    while (outIdx < outTimeVec.size() && outTimeVec[outIdx] <= tStop)
+                    {
+                        stepper.calc_state(outTimeVec[outIdx], _WorkVec);
+                        res.TimeVec.push_back(outTimeVec[outIdx]);
+                        res.StateVec.push_back(std::vector<float>(_WorkVec.begin(), _WorkVec.end()));
+                        ++outIdx;
+                    }
+
+                    if (stop || range.second >= tEnd)
+                    {
+                        stepper.calc_state(tStop, _StateVec);
+                        break;
+                    }
+                }
+
+                _writeState(_StateVec);
+
+                return res;
+            }
     };
+
+    /*
+    정상 상태에 도달할 때까지 holdup 수지를 적분하고 출력 스트림에 값을 반영함.
+    정상 상태의 허용치는 max|dN/dt|에 대한 것이므로 입구 몰 유량으로 스케일하며, 체류 시간의 1000배 안에
+    도달하지 못하면 runtime error 발생. SpeedRxnBase가 없으면 RxtorBase(전화율)로 계산함.
+    */
+    inline void CSTR::solveSteadyState()
+    {
+        if (_SpeedRxnPtr == nullptr)
+        {
+            RxtorBase::solveSteadyState();
+            return;
+        }
+
+        auto solveDynamic = [this]()
+        {
+            __mixInlet();
+
+            DynamicCSTREngine engine({this});
+            const float inFlow = (__MixVec.size() == 0) ? 0.0f : __MixVec.cwiseAbs().maxCoeff();
+            engine.addSteadyStateEvent(1e-6 * std::max(1.0f, inFlow));
+            const auto res = engine.simulate(1e+3 * _Volume / _VolFlow);
+            if (res.EventVec.empty()) throw std::runtime_error("CSTR didn't reach a steady state.");
+        };
+
+        if (_ISATPtr == nullptr)
+        {
+            solveDynamic();
+            return;
+        }
+
+        __mixInlet();
+
+        const int chemNum = __ChemIdx.size();
+        const Eigen::VectorXd x = __MixVec.cast<double>();
+        Eigen::VectorXd f(chemNum);
+
+        // 캐시는 질의 지점(이미 __MixVec에 있는 입구)에서만 계산을 요청함. 같은 질의에서 민감도를 다시 요청하면
+        // 이미 구한 정상 상태를 그대로 사용하고 민감도만 계산함.
+        bool solved = false;
+        _ISATPtr->query(x, f, [&](const Eigen::VectorXd& /* xq */, Eigen::VectorXd& fq, Eigen::MatrixXd* A)
+        {
+            if (!solved) solveDynamic();
+            solved = true;
+            fq = __TotalVec.cast<double>();
+
+            if (A == nullptr) return;
+
+            const auto sens = calcSensitivity();
+            A->setIdentity(chemNum, chemNum);
+            for (auto i = 0; i < _RxnPos.size(); ++i)
+            {
+                for (auto k = 0; k < _RxnPos.size(); ++k) (*A)(_RxnPos[i], _RxnPos[k]) = sens.dOutdFeed(i, k);
+            }
+        });
+
+        // 캐시에서 얻은 출구로부터 holdup을 맞춤. (F_out = (v / V) N)
+        const double holdup = _Volume / _VolFlow;
+        for (auto i = 0; i < chemNum; ++i) __ChemMol[i] = holdup * f[i];
+        _writeOutletFlow();
+    }
+
+    #endif
 } // namespace chemprochelper
 
 
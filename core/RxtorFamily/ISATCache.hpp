@@ -0,0 +1,515 @@
+/*
+core/RxtorFamily/ISATCache.hpp
+------------------------------
+반응기 계산의 입력 상태 -> 출력 상태 사상을 ISAT(in-situ adaptive tabulation)로 저장하는 ISATCache 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_ISATCACHE
+#define _CHEMPROCHELPER_ISATCACHE
+
+namespace chemprochelper
+{
+    /*
+    ISATCache의 통계를 저장함.
+    -----------------------
+        QueryNum : 전체 질의 수.
+        RetrieveNum : 정확도 타원체(EOA) 안에 있어 선형 외삽으로 답한 질의 수.
+        GrowNum : 직접 계산한 값이 허용 오차 안에 있어 기존 기록의 EOA를 키운 질의 수.
+        AddNum : 새 기록을 추가한 질의 수.
+        DirectNum : 메모리 한도 때문에 저장하지 않고 직접 계산만 한 질의 수.
+        EvictNum : 메모리 한도 때문에 지운 기록의 수.
+        RecordNum, MemoryUse : 현재 기록의 수와 사용 중인 메모리(바이트, 추정값).
+        HitRate : RetrieveNum / QueryNum
+    */
+    struct ISATStats
+    {
+        std::int64_t QueryNum = 0;
+        std::int64_t RetrieveNum = 0;
+        std::int64_t GrowNum = 0;
+        std::int64_t AddNum = 0;
+        std::int64_t DirectNum = 0;
+        std::int64_t EvictNum = 0;
+        int RecordNum = 0;
+        std::size_t MemoryUse = 0;
+        double HitRate = 0;
+    };
+
+    /*
+    ISAT 캐시 클래스.
+    ---------------
+    기록마다 입력 x0, 출력 f0 = f(x0), 민감도 A = df/dx(x0)와 정확도 타원체 EOA = {x : (x - x0)^T M (x - x0) <= 1}를 저장함.
+    질의 x는 이진 트리(내부 노드는 두 기록의 수직 이등분 평면)를 따라 내려가 찾은 기록과, 최근에 사용한
+    기록 몇 개(SearchNum)의 EOA 안에 있으면 f0 + A (x - x0)로 답함(Retrieve). 그렇지 않으면 f(x)를 직접 계산해
+        - 가까운 기록의 선형 외삽 오차가 GrowRatio * ErrTol 이하이면 x를 포함하도록 그 기록의 EOA를 키우고(Grow),
+        - 아니면 A를 함께 계산해 새 기록을 추가함(Add). 새 기록은 가까운 기록의 잎을 두 잎으로 나눔.
+    직접 계산이 Add로 끝나면 A가 더 필요하므로, 최근 직접 계산 중 Add의 비율(_AddRate, 지수 이동 평균)이 절반을
+    넘으면 처음부터 A를 함께 요청해 한 번만 계산함. 그렇지 않으면 A 없이 계산해 민감도 비용을 아끼고, Add로 끝나면
+    같은 x로 A를 다시 요청함. 이때 f에는 방금 계산한 출력이 들어 있으므로 Func는 f를 다시 계산하지 않고 A만 계산해도 됨.
+    오차는 출력을 FScale로 나눈 벡터의 2-norm이며, 처음 EOA는 (A' / ErrTol)^T (A' / ErrTol)에서 (A'은 크기 조정한 A)
+    고윳값을 1 / MaxRadius^2 이상으로 잘라 만듦. EOA를 키울 때는 원래 EOA와 x를 포함하는 최소 부피의 타원체로
+    바꾸는 rank-one 갱신(M' = M - (1 - 1/g^2) (M y)(M y)^T / g^2, g^2 = y^T M y)을 사용함.
+    키운 타원체는 오차를 확인하지 않은 지점도 포함하므로, EOA를 키우는 기준을 허용 오차보다 작게(GrowRatio, 기본 0.5) 두어
+    Retrieve의 오차가 허용 오차를 넘지 않도록 여유를 둠.
+    메모리가 MaxMemory를 넘으면 가장 오래 사용하지 않은 기록(LRU)부터 지움.
+
+    f는 항상 질의 지점 x에서만 계산되므로, 반응기는 스트림에 이미 반영된 입구로 계산하는 함수를 그대로 넘길 수 있음.
+
+    ISATCache는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _InDim, _OutDim : 입력과 출력의 크기를 저장함.
+        _Func : 기본 계산 함수. (x, f, A) A가 nullptr이 아니면 민감도도 계산함.
+        _ErrTol, _XScale, _FScale, _MaxRadius : 허용 오차, 입/출력의 크기 조정, EOA의 최대 반지름(크기 조정된 x)을 저장함.
+        _GrowRatio : EOA를 키우는 오차 기준의 허용 오차에 대한 비율을 저장함.
+        _MaxMemory, _RecordBytes : 메모리 한도와 기록 하나의 추정 크기를 저장함.
+        _SearchNum : 트리 탐색에 실패했을 때 추가로 확인하는 최근 기록의 수를 저장함.
+        _RecVec, _FreeRec : 기록과 재사용할 빈 자리를 저장함.
+        _NodeVec, _FreeNode, _Root : 이진 트리의 노드와 재사용할 빈 자리, 뿌리를 저장함.
+        _LRU : 최근에 사용한 순서의 기록(앞쪽이 최근)을 저장함.
+        _AddRate : 직접 계산이 Add로 끝난 비율의 지수 이동 평균을 저장함.
+        _Stats : 통계를 저장함.
+    */
+    class ISATCache
+    {
+        public:
+
+            // (x, f, A) x에서의 출력을 f에, A가 nullptr이 아니면 df/dx를 A에 계산함.
+            using FuncType = std::function<void(const Eigen::VectorXd&, Eigen::VectorXd&, Eigen::MatrixXd*)>;
+
+            // 질의의 처리 결과
+            enum QueryType {Retrieve, Grow, Add, Direct};
+
+        private:
+
+            struct _Record
+            {
+                Eigen::VectorXd X;
+                Eigen::VectorXd F;
+                Eigen::MatrixXd A;
+                Eigen::MatrixXd M;
+                int Node = -1;
+                std::list<int>::iterator LRUIt;
+            };
+
+            // 잎(Rec >= 0)은 기록을, 내부 노드는 V^T x > Cut이면 Right로 가는 평면을 가짐.
+            struct _Node
+            {
+                int Parent = -1;
+                int Left = -1;
+                int Right = -1;
+                int Rec = -1;
+                Eigen::VectorXd V;
+                double Cut = 0;
+            };
+
+            // 입력과 출력의 크기
+            int _InDim = 0;
+            int _OutDim = 0;
+
+            // 기본 계산 함수
+            FuncType _Func;
+
+            // 허용 오차와 크기 조정
+            double _ErrTol = 1e-4;
+            Eigen::VectorXd _XScale;
+            Eigen::VectorXd _FScale;
+            double _MaxRadius = 1;
+            double _GrowRatio = 0.5;
+
+            // 메모리 한도(바이트)와 기록 하나의 추정 크기
+            std::size_t _MaxMemory = std::size_t(256) << 20;
+            std::size_t _RecordBytes = 0;
+
+            // 트리 탐색에 실패했을 때 확인하는 최근 기록의 수
+            int _SearchNum = 8;
+
+            // 직접 계산이 Add로 끝난 비율(지수 이동 평균). 처음에는 기록이 없으므로 Add로 봄.
+            double _AddRate = 1;
+
+            // 기록과 트리
+            std::vector<_Record> _RecVec;
+            std::vector<int> _FreeRec;
+            std::vector<_Node> _NodeVec;
+            std::vector<int> _FreeNode;
+            int _Root = -1;
+            std::list<int> _LRU;
+
+            // 통계
+            ISATStats _Stats;
+
+            // 빈 노드를 하나 가져옴.
+            int _newNode()
+            {
+                if (!_FreeNode.empty())
+                {
+                    const int idx = _FreeNode.back();
+                    _FreeNode.pop_back();
+                    _NodeVec[idx] = _Node();
+                    return idx;
+                }
+
+                _NodeVec.emplace_back();
+                return _NodeVec.size() - 1;
+            }
+
+            // x가 속하는 잎의 기록을 찾음.
+            int _findLeaf(const Eigen::VectorXd& x) const
+            {
+                int node = _Root;
+                while (_NodeVec[node].Rec < 0)
+                {
+                    const auto& cur = _NodeVec[node];
+                    node = (cur.V.dot(x) > cur.Cut) ? cur.Right : cur.Left;
+                }
+
+                return _NodeVec[node].Rec;
+            }
+
+            // x가 기록 rec의 EOA 안에 있는지 확인함.
+            bool _inEOA(const int& rec, const Eigen::VectorXd& x) const
+            {
+                const auto& cur = _RecVec[rec];
+                const Eigen::VectorXd y = x - cur.X;
+                return y.dot(cur.M * y) <= 1;
+            }
+
+            // 기록 rec을 가장 최근에 사용한 것으로 옮김.
+            void _touch(const int& rec)
+            {
+                _LRU.splice(_LRU.begin(), _LRU, _RecVec[rec].LRUIt);
+            }
+
+            // 기록 rec의 선형 외삽 값
+            void _extrapolate(const int& rec, const Eigen::VectorXd& x, Eigen::VectorXd& f) const
+            {
+                const auto& cur = _RecVec[rec];
+                f = cur.F;
+                f.noalias() += cur.A * (x - cur.X);
+            }
+
+            // 처음 EOA를 만듦. 크기 조정된 좌표에서 A'^T A' / ErrTol^2의 고윳값을 1 / MaxRadius^2 이상으로 자름.
+            Eigen::MatrixXd _initEOA(const Eigen::MatrixXd& A) const
+            {
+                const Eigen::MatrixXd scaledA = _FScale.cwiseInverse().asDiagonal() * A * _XScale.asDiagonal() / _ErrTol;
+
+                Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(scaledA.transpose() * scaledA);
+                const Eigen::VectorXd lambda = eig.eigenvalues().cwiseMax(1 / (_MaxRadius * _MaxRadius));
+                const Eigen::MatrixXd scaledM = eig.eigenvectors() * lambda.asDiagonal() * eig.eigenvectors().transpose();
+
+                return _XScale.cwiseInverse().asDiagonal() * scaledM * _XScale.cwiseInverse().asDiagonal();
+            }
+
+            // 기록 rec의 EOA를 x를 포함하는 최소 부피의 타원체로 키움.
+            void _growEOA(const int& rec, const Eigen::VectorXd& x)
+            {
+                auto& cur = _RecVec[rec];
+                const Eigen::VectorXd y = x - cur.X;
+                const Eigen::VectorXd My = cur.M * y;
+                const double g2 = y.dot(My);
+
+                if (g2 <= 1) return;
+                cur.M -= ((1 - 1 / g2) / g2) * My * My.transpose();
+            }
+
+            // 크기 조정된 출력 오차
+            double _calcErr(const Eigen::VectorXd& f, const Eigen::VectorXd& fLin) const
+            {
+                return (f - fLin).cwiseQuotient(_FScale).norm();
+            }
+
+            // 기록 rec을 지우고 트리에서 잎을 뺌. 형제 노드가 부모의 자리를 차지함.
+            void _removeRecord(const int& rec)
+            {
+                const int leaf = _RecVec[rec].Node;
+                const int parent = _NodeVec[leaf].Parent;
+
+                if (parent < 0) _Root = -1;
+                else
+                {
+                    const int sibling = (_NodeVec[parent].Left == leaf) ? _NodeVec[parent].Right : _NodeVec[parent].Left;
+                    const int grand = _NodeVec[parent].Parent;
+
+                    _NodeVec[sibling].Parent = grand;
+                    if (grand < 0) _Root = sibling;
+                    else if (_NodeVec[grand].Left == parent) _NodeVec[grand].Left = sibling;
+                    else _NodeVec[grand].Right = sibling;
+
+                    _NodeVec[parent] = _Node();
+                    _FreeNode.push_back(parent);
+                }
+
+                _NodeVec[leaf] = _Node();
+                _FreeNode.push_back(leaf);
+
+                _LRU.erase(_RecVec[rec].LRUIt);
+                _RecVec[rec] = _Record();
+                _FreeRec.push_back(rec);
+
+                --_Stats.RecordNum;
+                _Stats.MemoryUse -= _RecordBytes;
+            }
+
+            // 새 기록을 추가함. near는 x가 속하는 잎의 기록(-1이면 트리가 비어 있음).
+            void _addRecord(const int& near, const Eigen::VectorXd& x, const Eigen::VectorXd& f, const Eigen::MatrixXd& A)
+            {
+                int rec;
+                if (!_FreeRec.empty())
+                {
+                    rec = _FreeRec.back();
+                    _FreeRec.pop_back();
+                }
+                else
+                {
+                    _RecVec.emplace_back();
+                    rec = _RecVec.size() - 1;
+                }
+
+                auto& cur = _RecVec[rec];
+                cur.X = x;
+                cur.F = f;
+                cur.A = A;
+                cur.M = _initEOA(A);
+
+                _LRU.push_front(rec);
+                cur.LRUIt = _LRU.begin();
+
+                const int leaf = _newNode();
+                _NodeVec[leaf].Rec = rec;
+                cur.Node = leaf;
+
+                if (near < 0) _Root = leaf;
+                else
+                {
+                    // near의 잎을 내부 노드로 바꾸고, 두 기록의 수직 이등분 평면으로 나눔.
+                    const int split = _RecVec[near].Node;
+                    const int oldLeaf = _newNode();
+
+                    _NodeVec[oldLeaf].Rec = near;
+                    _NodeVec[oldLeaf].Parent = split;
+                    _RecVec[near].Node = oldLeaf;
+
+                    auto& node = _NodeVec[split];
+                    node.Rec = -1;
+                    node.V = x - _RecVec[near].X;
+                    node.Cut = node.V.dot(x + _RecVec[near].X) / 2;
+                    node.Left = oldLeaf;
+                    node.Right = leaf;
+                    _NodeVec[leaf].Parent = split;
+                }
+
+                ++_Stats.RecordNum;
+                _Stats.MemoryUse += _RecordBytes;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자
+            ISATCache() = default;
+
+            // 입력 InDim, 출력 OutDim 크기의 캐시. 질의마다 계산 함수를 넘기는 경우.
+            ISATCache(const int& InDim, const int& OutDim, const double& ErrTol = 1e-4):
+                _InDim(InDim), _OutDim(OutDim), _ErrTol(ErrTol)
+            {
+                if (InDim <= 0 || OutDim <= 0) throw std::runtime_error("ISATCache dimensions must be positive.");
+
+                _XScale = Eigen::VectorXd::Ones(InDim);
+                _FScale = Eigen::VectorXd::Ones(OutDim);
+
+                // 기록(x0, f0, A, M)과 잎, 내부 노드 하나의 크기
+                _RecordBytes = sizeof(double) * (InDim + OutDim + OutDim * InDim + InDim * InDim)
+                    + 2 * (sizeof(_Node) + sizeof(double) * InDim) + sizeof(_Record) + 3 * sizeof(void*);
+            }
+
+            // 기본 계산 함수 Func를 사용하는 경우.
+            ISATCache(const int& InDim, const int& OutDim, const FuncType& Func, const double& ErrTol = 1e-4):
+                ISATCache(InDim, OutDim, ErrTol)
+            {
+                _Func = Func;
+            }
+
+            // getter 정의부
+
+            int getInDim() const {return _InDim;}
+            int getOutDim() const {return _OutDim;}
+            auto getTolerance() const {return _ErrTol;}
+            auto getMaxMemory() const {return _MaxMemory;}
+            int getRecordNum() const {return _Stats.RecordNum;}
+
+            // 통계를 반환함.
+            ISATStats getStats() const
+            {
+                ISATStats stats = _Stats;
+                stats.HitRate = (stats.QueryNum > 0) ? static_cast<double>(stats.RetrieveNum) / stats.QueryNum : 0;
+                return stats;
+            }
+
+            // setter 정의부
+
+            void setFunc(const FuncType& Func) {_Func = Func;}
+
+            // 허용 오차를 바꾸면 기존 EOA가 맞지 않으므로 기록을 모두 지움.
+            void setTolerance(const double& ErrTol)
+            {
+                _ErrTol = ErrTol;
+                clear();
+            }
+
+            // 입/출력의 크기 조정. 기존 기록은 모두 지움.
+            void setScale(const Eigen::VectorXd& XScale, const Eigen::VectorXd& FScale)
+            {
+                if (XScale.size() != _InDim || FScale.size() != _OutDim) throw std::runtime_error("ISATCache scale doesn't match the dimensions.");
+                if (XScale.minCoeff() <= 0 || FScale.minCoeff() <= 0) throw std::runtime_error("ISATCache scale must be positive.");
+
+                _XScale = XScale;
+                _FScale = FScale;
+                clear();
+            }
+
+            void setMaxRadius(const double& MaxRadius) {_MaxRadius = MaxRadius;}
+            void setGrowRatio(const double& GrowRatio) {_GrowRatio = GrowRatio;}
+            void setSearchNum(const int& SearchNum) {_SearchNum = std::max(0, SearchNum);}
+
+            // 메모리 한도(바이트)를 정하고, 넘는 기록은 LRU 순서로 지움.
+            void setMaxMemory(const std::size_t& MaxMemory)
+            {
+                _MaxMemory = MaxMemory;
+                while (!_LRU.empty() && _Stats.MemoryUse > _MaxMemory)
+                {
+                    _removeRecord(_LRU.back());
+                    ++_Stats.EvictNum;
+                }
+            }
+
+            // 인스턴스 정의부
+
+            // 모든 기록을 지움. 통계는 유지함.
+            void clear()
+            {
+                _RecVec.clear();
+                _FreeRec.clear();
+                _NodeVec.clear();
+                _FreeNode.clear();
+                _LRU.clear();
+                _Root = -1;
+                _AddRate = 1;
+                _Stats.RecordNum = 0;
+                _Stats.MemoryUse = 0;
+            }
+
+            void resetStats()
+            {
+                const int recordNum = _Stats.RecordNum;
+                const auto memoryUse = _Stats.MemoryUse;
+                _Stats = ISATStats();
+                _Stats.RecordNum = recordNum;
+                _Stats.MemoryUse = memoryUse;
+            }
+
+            // 질의 x의 출력을 f에 계산하고 처리 결과를 반환함. 직접 계산에는 Func를 사용함.
+            QueryType query(const Eigen::VectorXd& x, Eigen::VectorXd& f, const FuncType& Func)
+            {
+                if (x.size() != _InDim) throw std::runtime_error("ISATCache query doesn't match the input dimension.");
+
+                ++_Stats.QueryNum;
+
+                int near = -1;
+                Eigen::MatrixXd A;
+                bool hasSens = false;
+                if (_Root >= 0)
+                {
+                    near = _findLeaf(x);
+                    if (_inEOA(near, x))
+                    {
+                        _extrapolate(near, x, f);
+                        _touch(near);
+                        ++_Stats.RetrieveNum;
+                        return Retrieve;
+                    }
+
+                    // 트리의 잎이 가장 가까운 기록이라는 보장은 없으므로 최근 기록도 확인함.
+                    int count = 0;
+                    for (auto it = _LRU.begin(); it != _LRU.end() && count < _SearchNum; ++it, ++count)
+                    {
+                        if (*it == near || !_inEOA(*it, x)) continue;
+
+                        const int rec = *it;
+                        _extrapolate(rec, x, f);
+                        _touch(rec);
+                        ++_Stats.RetrieveNum;
+                        return Retrieve;
+                    }
+
+                    // 직접 계산해 선형 외삽 오차가 GrowRatio * ErrTol 이하이면 EOA를 키움. Add가 예상되면 민감도도 함께 계산함.
+                    f.resize(_OutDim);
+                    if (_RecordBytes <= _MaxMemory && _AddRate > 0.5)
+                    {
+                        A.resize(_OutDim, _InDim);
+                        Func(x, f, &A);
+                        hasSens = true;
+                    }
+                    else Func(x, f, nullptr);
+
+                    Eigen::VectorXd fLin;
+                    _extrapolate(near, x, fLin);
+                    const bool grow = _calcErr(f, fLin) <= _GrowRatio * _ErrTol;
+                    _AddRate = 0.9 * _AddRate + 0.1 * (grow ? 0 : 1);
+                    if (grow)
+                    {
+                        _growEOA(near, x);
+                        _touch(near);
+                        ++_Stats.GrowNum;
+                        return Grow;
+                    }
+                }
+
+                // 새 기록을 넣을 자리가 없으면 직접 계산만 함.
+                if (_RecordBytes > _MaxMemory)
+                {
+                    if (near < 0)
+                    {
+                        f.resize(_OutDim);
+                        Func(x, f, nullptr);
+                    }
+                    ++_Stats.DirectNum;
+                    return Direct;
+                }
+
+                // 이미 f를 계산했으면(near >= 0) f를 그대로 둔 채 A를 요청함.
+                if (!hasSens)
+                {
+                    A.resize(_OutDim, _InDim);
+                    f.resize(_OutDim);
+                    Func(x, f, &A);
+                }
+
+                // LRU 순서로 지우되, 새 기록의 이웃은 남겨둠.
+                while (_Stats.MemoryUse + _RecordBytes > _MaxMemory && !_LRU.empty())
+                {
+                    int victim = _LRU.back();
+                    if (victim == near)
+                    {
+                        if (_LRU.size() == 1) near = -1;
+                        else victim = *std::prev(_LRU.end(), 2);
+                    }
+
+                    _removeRecord(victim);
+                    ++_Stats.EvictNum;
+                }
+                near = (_Root < 0) ? -1 : _findLeaf(x);
+
+                _addRecord(near, x, f, A);
+                ++_Stats.AddNum;
+
+                return Add;
+            }
+
+            // 기본 계산 함수로 질의함.
+            QueryType query(const Eigen::VectorXd& x, Eigen::VectorXd& f)
+            {
+                if (!_Func) throw std::runtime_error("ISATCache has no function to evaluate.");
+                return query(x, f, _Func);
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -0,0 +1,565 @@
+/*
+core/RxtorFamily/PFR.hpp
+------------------------
+PFR에 대한 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_PFR
+#define _CHEMPROCHELPER_PFR
+
+namespace chemprochelper
+{
+    /*
+    PFR을 지정하는 기본 클래스.
+    --------------------------
+    반응기 부피를 따라 화학종의 몰 유량을 boost::odeint의 rosenbrock4로 적분함.
+    부피 유량은 일정하다고 가정함(C = F / v).
+    PFR은 다음과 같은 멤버 변수를 가짐.
+    private:
+        _SpeedRxnPtr : 반응 속도식을 포함하는 SpeedRxnBase 객체의 포인터를 저장함.
+        _Volume : 반응기의 부피를 저장함.
+        _VolFlow : 부피 유량을 저장함.
+        _StoiMat, _ConcVec, _RateVec, _RateJacVec, _FlowVec : 적분에 사용하는 작업 공간.
+            생성자에서 크기를 잡아두므로 적분 중에는 메모리를 할당하지 않음.
+        _SensAMat, _SensBMat, _SensAWork, _SensBWork, _ParamSensVec : 민감도 방정식에 사용하는 작업 공간.
+        _SparseFlag, _SparseSolver : 희소 BDF 적분기(SparseBDF)의 사용 여부와 적분기를 저장함.
+        _ISATPtr : 입구 몰 유량 -> 출구 몰 유량을 저장하는 ISATCache의 포인터를 저장함. 수명은 호출한 쪽에서 관리함.
+    setSparseSolver(true)이면 solveSteadyState가 rosenbrock4의 조밀 LU 대신 SparseBDF를 사용하므로
+    화학종이 수백 개 이상인 반응 네트워크에서 단계당 비용이 크게 줄어듦.
+    calcDerivAD는 같은 dF/dV를 Dual(자동 미분) 등 임의의 스칼라 형식으로 계산함.
+
+    민감도(solveSensitivity)는 상태 F에 S_F0 = dF/dF_0, S_p = dF/d(ln p)를 덧붙인 확장 시스템을 적분해 구함.
+        dS/dV = A S + B, A = v (d r / d C) / v_0, B = v diag(d r / d ln p) (S_F0의 경우 B = 0)
+    */
+    class PFR : public RxtorBase
+    {
+        private:
+
+            using _StateType = boost::numeric::ublas::vector<double>;
+            using _MatrixType = boost::numeric::ublas::matrix<double>;
+            using _StepperType = boost::numeric::odeint::rosenbrock4_dense_output<
+                boost::numeric::odeint::rosenbrock4_controller<boost::numeric::odeint::rosenbrock4<double>>>;
+
+            // 반응 속도식을 포함하는 화학 반응식의 포인터를 저장함.
+            SpeedRxnBase* _SpeedRxnPtr = nullptr;
+
+            // 반응기의 부피를 저장함.
+            float _Volume = 0;
+
+            // 부피 유량을 저장함.
+            float _VolFlow = 1;
+
+            // 적분기의 허용 오차를 저장함.
+            double _AbsTol = 1e-8;
+            double _RelTol = 1e-6;
+
+            // 반응식의 v(nu) 값을 저장함. (화학종 수) x (반응 수)
+            Eigen::MatrixXd _StoiMat;
+
+            // 적분 작업 공간
+            std::vector<double> _ConcVec;
+            std::vector<double> _RateVec;
+            std::vector<double> _RateJacVec;
+            _StateType _FlowVec;
+
+            // rosenbrock4 dense output 적분기. 내부 작업 공간을 재사용하기 위해 멤버로 저장함.
+            std::unique_ptr<_StepperType> _Stepper;
+
+            // 민감도 방정식의 작업 공간. A : (화학종 수) x (화학종 수), B : (화학종 수) x (반응 수)
+            Eigen::MatrixXd _SensAMat, _SensBMat, _SensAWork, _SensBWork;
+            std::vector<double> _ParamSensVec;
+
+            // 희소 BDF 적분기 사용 여부
+            bool _SparseFlag = false;
+
+            // 입구 -> 출구 사상의 ISAT 캐시. nullptr이면 사용하지 않음.
+            ISATCache* _ISATPtr = nullptr;
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            // 희소 BDF 적분기와 적분기를 만들 때의 부피 유량. 부피 유량이 바뀌면 다시 만듦.
+            std::unique_ptr<SparseBDF> _SparseSolver;
+            float _SparseVolFlow = 0;
+
+            #endif
+
+            // odeint에 전달하는 시스템 함수 객체.
+            struct _System
+            {
+                PFR* _Ptr;
+                void operator()(const _StateType& F, _StateType& dFdV, const double& /* V */) const
+                {
+                    _Ptr->_calcDeriv(F, dFdV);
+                }
+            };
+
+            // odeint에 전달하는 Jacobian 함수 객체.
+            struct _Jacobi
+            {
+                PFR* _Ptr;
+                void operator()(const _StateType& F, _MatrixType& J, const double& /* V */, _StateType& dFdV) const
+                {
+                    _Ptr->_calcJacobi(F, J, dFdV);
+                }
+            };
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            // 민감도 방정식을 포함한 확장 시스템의 함수 객체.
+            struct _SensSystem
+            {
+                PFR* _Ptr;
+                void operator()(const _StateType& X, _StateType& dXdV, const double& /* V */) const
+                {
+                    _Ptr->_calcSensDeriv(X, dXdV);
+                }
+            };
+
+            struct _SensJacobi
+            {
+                PFR* _Ptr;
+                void operator()(const _StateType& X, _MatrixType& J, const double& /* V */, _StateType& dXdV) const
+                {
+                    _Ptr->_calcSensJacobi(X, J, dXdV);
+                }
+            };
+
+            #endif
+
+            // 작업 공간의 크기를 반응식에 맞춤.
+            void _resetWork()
+            {
+                const auto effiMat = _SpeedRxnPtr->getEffiMat();
+                const int chemNum = effiMat.rows();
+                const int rxnNum = effiMat.cols() - 1;
+
+                _StoiMat = effiMat.block(0, 0, chemNum, rxnNum).cast<double>();
+                _ConcVec.assign(chemNum, 0);
+                _RateVec.assign(rxnNum, 0);
+                _RateJacVec.assign(chemNum * rxnNum, 0);
+                _FlowVec.resize(chemNum);
+                _SensAMat.resize(chemNum, chemNum);
+                _SensBMat.resize(chemNum, rxnNum);
+                _SensAWork.resize(chemNum, chemNum);
+                _SensBWork.resize(chemNum, rxnNum);
+                _ParamSensVec.assign(rxnNum, 0);
+                _Stepper.reset(new _StepperType(boost::numeric::odeint::rosenbrock4_controller<
+                    boost::numeric::odeint::rosenbrock4<double>>(_AbsTol, _RelTol)));
+
+                #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+                _SparseSolver.reset();
+                #endif
+            }
+
+            // 몰 유량으로부터 농도를 계산함. 음수인 몰 유량은 0으로 취급함.
+            void _setConc(const _StateType& F)
+            {
+                for (auto i = 0; i < _ConcVec.size(); ++i) _ConcVec[i] = std::max(F[i], 0.0) / _VolFlow;
+            }
+
+            // dF/dV = v * r(C)
+            void _calcDeriv(const _StateType& F, _StateType& dFdV)
+            {
+                _setConc(F);
+                _SpeedRxnPtr->calcRate(_ConcVec.data(), _RateVec.data());
+
+                for (auto i = 0; i < _ConcVec.size(); ++i)
+                {
+                    dFdV[i] = 0;
+                    for (auto j = 0; j < _RateVec.size(); ++j) dFdV[i] += _StoiMat(i, j) * _RateVec[j];
+                }
+            }
+
+            // d(dF/dV)/dF = v * (d r / d C) / v_0
+            void _calcJacobi(const _StateType& F, _MatrixType& J, _StateType& dFdV)
+            {
+                const int rxnNum = _RateVec.size();
+
+                _setConc(F);
+                _SpeedRxnPtr->calcRateJacobian(_ConcVec.data(), _RateVec.data(), _RateJacVec.data());
+
+                for (auto i = 0; i < _ConcVec.size(); ++i)
+                {
+                    for (auto k = 0; k < _ConcVec.size(); ++k)
+                    {
+                        J(i, k) = 0;
+                        for (auto j = 0; j < rxnNum; ++j) J(i, k) += _StoiMat(i, j) * _RateJacVec[k * rxnNum + j];
+                        J(i, k) /= _VolFlow;
+                    }
+
+                    // 반응기 부피에 대한 명시적 의존성은 없음.
+                    dFdV[i] = 0;
+                }
+            }
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            // 몰 유량 F에서 민감도 방정식의 A, B 행렬을 계산함. 반응 속도는 _RateVec에 남음.
+            void _calcSensMat(const double* F, Eigen::MatrixXd& A, Eigen::MatrixXd& B)
+            {
+                const int chemNum = _ConcVec.size();
+                const int rxnNum = _RateVec.size();
+
+                for (auto i = 0; i < chemNum; ++i) _ConcVec[i] = std::max(F[i], 0.0) / _VolFlow;
+                _SpeedRxnPtr->calcRateJacobian(_ConcVec.data(), _RateVec.data(), _RateJacVec.data());
+                _SpeedRxnPtr->calcRateParamSens(_ConcVec.data(), _ParamSensVec.data());
+
+                Eigen::Map<const Eigen::MatrixXd> rateJacMat(_RateJacVec.data(), rxnNum, chemNum);
+                A.noalias() = _StoiMat * rateJacMat / _VolFlow;
+                for (auto j = 0; j < rxnNum; ++j) B.col(j) = _StoiMat.col(j) * _ParamSensVec[j];
+            }
+
+            /*
+            확장 상태 X = [F, S_F0(열 우선), S_p(열 우선)]의 미분을 계산함.
+            */
+            void _calcSensDeriv(const _StateType& X, _StateType& dXdV)
+            {
+                const int chemNum = _ConcVec.size();
+                const int rxnNum = _RateVec.size();
+
+                _calcSensMat(&X[0], _SensAMat, _SensBMat);
+
+                Eigen::Map<const Eigen::MatrixXd> S(&X[chemNum], chemNum, chemNum + rxnNum);
+                Eigen::Map<Eigen::MatrixXd> dS(&dXdV[chemNum], chemNum, chemNum + rxnNum);
+                Eigen::Map<const Eigen::VectorXd> rateVec(_RateVec.data(), rxnNum);
+                Eigen::Map<Eigen::VectorXd> dF(&dXdV[0], chemNum);
+
+                dF.noalias() = _StoiMat * rateVec;
+                dS.noalias() = _SensAMat * S;
+                dS.rightCols(rxnNum) += _SensBMat;
+            }
+
+            /*
+            확장 시스템의 Jacobian. F와 S에 대한 블록은 A이고, S의 F에 대한 블록 d(A S + B)/dF는
+            A, B를 F의 각 성분에 대해 전진 차분해 구함(화학종 수만큼 Jacobian을 더 계산함).
+            */
+            void _calcSensJacobi(const _StateType& X, _MatrixType& J, _StateType& dXdV)
+            {
+                const int chemNum = _ConcVec.size();
+                const int rxnNum = _RateVec.size();
+                const int colNum = chemNum + rxnNum;
+
+                J.clear();
+
+                Eigen::Map<const Eigen::MatrixXd> S(&X[chemNum], chemNum, colNum);
+                std::vector<double> F(X.begin(), X.begin() + chemNum);
+
+                _calcSensMat(F.data(), _SensAMat, _SensBMat);
+
+                // 대각 블록 : dF/dF = A, d(S의 열 c)/d(S의 열 c) = A
+                for (auto c = 0; c <= colNum; ++c)
+                {
+                    const int offset = (c == 0) ? 0 : chemNum * c;
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        for (auto l = 0; l < chemNum; ++l) J(offset + i, offset + l) = _SensAMat(i, l);
+                    }
+                }
+
+                // 결합 블록 : d(A S + B)/dF_k
+                Eigen::MatrixXd baseMat = _SensAMat * S;
+                baseMat.rightCols(rxnNum) += _SensBMat;
+
+                for (auto k = 0; k < chemNum; ++k)
+                {
+                    const double h = 1e-7 * std::max(std::abs(F[k]), 1e-6);
+                    const double orig = F[k];
+                    F[k] = orig + h;
+                    _calcSensMat(F.data(), _SensAWork, _SensBWork);
+                    F[k] = orig;
+
+                    for (auto c = 0; c < colNum; ++c)
+                    {
+                        for (auto i = 0; i < chemNum; ++i)
+                        {
+                            double val = _SensAWork.row(i).dot(S.col(c));
+                            if (c >= chemNum) val += _SensBWork(i, c - chemNum);
+                            J(chemNum + c * chemNum + i, k) = (val - baseMat(i, c)) / h;
+                        }
+                    }
+                }
+
+                // 반응기 부피에 대한 명시적 의존성은 없음.
+                for (auto i = 0; i < X.size(); ++i) dXdV[i] = 0;
+            }
+
+            #endif
+
+            // 입력 스트림들을 합친 몰 유량을 _FlowVec에 불러옴.
+            void _loadInletFlow()
+            {
+                __mixInlet();
+                for (auto i = 0; i < __RxnChemPos.size(); ++i) _FlowVec[i] = __MixVec[__RxnChemPos[i]];
+            }
+
+            /*
+            _FlowVec의 값을 출력 스트림들에 나눠 반영함. 반응에 참여하지 않는 화학종은 입구의 값을 그대로 사용함.
+            __MixVec에는 _loadInletFlow에서 합친 값이 남아 있어야 함.
+            */
+            void _writeOutletFlow()
+            {
+                __TotalVec = __MixVec;
+                for (auto i = 0; i < __RxnChemPos.size(); ++i) __TotalVec[__RxnChemPos[i]] = _FlowVec[i];
+
+                __splitOutlet();
+            }
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            // _FlowVec을 입구로 반응기 출구까지 적분해 _FlowVec에 덮어씀.
+            void _integrateFlow()
+            {
+                if (_SparseFlag)
+                {
+                    if (!_SparseSolver || _SparseVolFlow != _VolFlow)
+                    {
+                        _SparseSolver.reset(new SparseBDF(_SpeedRxnPtr, _VolFlow));
+                        _SparseSolver->setTolerance(_AbsTol, _RelTol);
+                        _SparseVolFlow = _VolFlow;
+                    }
+
+                    std::vector<double> F(_FlowVec.begin(), _FlowVec.end());
+                    _SparseSolver->solve(F, 0.0, {static_cast<double>(_Volume)});
+                    for (auto i = 0; i < F.size(); ++i) _FlowVec[i] = F[i];
+                }
+                else
+                {
+                    boost::numeric::odeint::integrate_adaptive(*_Stepper, std::make_pair(_System{this}, _Jacobi{this}),
+                        _FlowVec, 0.0, static_cast<double>(_Volume), 1e-4 * _Volume);
+                }
+            }
+
+            /*
+            _FlowVec을 입구로 상태와 민감도 방정식을 함께 적분해 출구 몰 유량을 _FlowVec에 덮어쓰고,
+            [S_F0, S_p] ((화학종 수) x (화학종 수 + 반응 수))를 반환함.
+            */
+            Eigen::MatrixXd _integrateSens()
+            {
+                const int chemNum = _ConcVec.size();
+                const int rxnNum = _RateVec.size();
+
+                _StateType X(chemNum * (1 + chemNum + rxnNum));
+                for (auto i = 0; i < X.size(); ++i) X[i] = 0;
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    X[i] = _FlowVec[i];
+                    X[chemNum + i * chemNum + i] = 1;
+                }
+
+                boost::numeric::odeint::integrate_adaptive(
+                    boost::numeric::odeint::make_controlled<boost::numeric::odeint::rosenbrock4<double>>(_AbsTol, _RelTol),
+                    std::make_pair(_SensSystem{this}, _SensJacobi{this}), X, 0.0, static_cast<double>(_Volume), 1e-4 * _Volume);
+
+                for (auto i = 0; i < chemNum; ++i) _FlowVec[i] = X[i];
+
+                return Eigen::Map<const Eigen::MatrixXd>(&X[chemNum], chemNum, chemNum + rxnNum);
+            }
+
+            #endif
+
+        public:
+
+            // 생성자 정의부
+
+            // 임시 객체를 위한 생성자
+            PFR():
+                RxtorBase() {}
+
+            // Comment를 사용하지 않는 경우
+            PFR(StreamBase* inStreamPtr, StreamBase* outStreamPtr, SpeedRxnBase* RxnPtr,
+                const float& Volume, const float& VolFlow):
+                RxtorBase(inStreamPtr, outStreamPtr, RxnPtr), _SpeedRxnPtr(RxnPtr), _Volume(Volume), _VolFlow(VolFlow)
+            {
+                _resetWork();
+            }
+
+            // Comment를 사용하는 경우
+            PFR(StreamBase* inStreamPtr, StreamBase* outStreamPtr, SpeedRxnBase* RxnPtr,
+                const float& Volume, const float& VolFlow, std::string& Comment):
+                RxtorBase(inStreamPtr, outStreamPtr, RxnPtr, Comment), _SpeedRxnPtr(RxnPtr), _Volume(Volume), _VolFlow(VolFlow)
+            {
+                _resetWork();
+            }
+
+            // 입/출력 스트림이 여러 개인 경우. 입력 스트림은 입구에서 혼합되고, 출구는 SplitFrac에 따라 나뉨.
+            PFR(const std::vector<StreamBase*>& inStreamIdx, const std::vector<StreamBase*>& outStreamIdx,
+                SpeedRxnBase* RxnPtr, const float& Volume, const float& VolFlow, const std::vector<float>& SplitFrac = {}):
+                RxtorBase(inStreamIdx, outStreamIdx, RxnPtr, SplitFrac), _SpeedRxnPtr(RxnPtr), _Volume(Volume), _VolFlow(VolFlow)
+            {
+                _resetWork();
+            }
+
+            // getter 정의부
+
+            auto getVolume() {return _Volume;}
+            auto getVolFlow() {return _VolFlow;}
+            auto getSparseSolver() {return _SparseFlag;}
+            auto getISATCache() {return _ISATPtr;}
+
+            // setter 정의부
+
+            void setVolume(const float& Volume) {_Volume = Volume;}
+            void setVolFlow(const float& VolFlow) {_VolFlow = VolFlow;}
+            void setSparseSolver(const bool& SparseFlag) {_SparseFlag = SparseFlag;}
+
+            /*
+            입구 몰 유량(RxnBase::getChemIdx() 순서) -> 출구 몰 유량의 ISAT 캐시를 지정함. nullptr이면 사용하지 않음.
+            캐시는 부피, 부피 유량, 온도 등 반응기 조건이 같은 동안에만 유효하므로 조건을 바꾸면 ISATCache::clear를 호출할 것.
+            */
+            void setISATCache(ISATCache* ISATPtr)
+            {
+                if (ISATPtr != nullptr && (ISATPtr->getInDim() != _ConcVec.size() || ISATPtr->getOutDim() != _ConcVec.size()))
+                {
+                    throw std::runtime_error("ISATCache dimensions don't match the PFR.");
+                }
+                _ISATPtr = ISATPtr;
+            }
+            void setTolerance(const double& AbsTol, const double& RelTol)
+            {
+                _AbsTol = AbsTol;
+                _RelTol = RelTol;
+                _resetWork();
+            }
+
+            // 인스턴스 정의부
+
+            /*
+            몰 유량 F(반응 화학종, RxnBase::getChemIdx() 순서)와 온도 Temp에서 dF/dV = v(nu) r(F / v_0)를
+            임의의 스칼라 형식 T(double, Dual, HyperDual 등)로 dFdV에 계산함. Dual로 시드하면
+            _calcJacobi와 같은 d(dF/dV)/dF 와 온도에 대한 미분을 손 미분 없이 함께 얻음.
+            */
+            template <typename T>
+            void calcDerivAD(const T* F, const T& Temp, T* dFdV) const
+            {
+                const int chemNum = _ConcVec.size();
+                const int rxnNum = _RateVec.size();
+
+                std::vector<T> conc(chemNum), rate(rxnNum);
+                for (auto i = 0; i < chemNum; ++i) conc[i] = (F[i] < T(0)) ? T(0) : F[i] / static_cast<double>(_VolFlow);
+                _SpeedRxnPtr->calcRateAD(conc.data(), Temp, rate.data());
+
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    dFdV[i] = T(0);
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        if (_StoiMat(i, j) != 0) dFdV[i] += _StoiMat(i, j) * rate[j];
+                    }
+                }
+            }
+
+            // 반응 온도(SpeedRxnBase::getTemp())에서 dF/dV를 T 형식으로 계산함.
+            template <typename T>
+            void calcDerivAD(const T* F, T* dFdV) const
+            {
+                calcDerivAD(F, T(_SpeedRxnPtr->getTemp()), dFdV);
+            }
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            /*
+            입력 스트림으로부터 반응기 출구까지 적분하여 출력 스트림에 값을 반영함.
+            ISATCache가 지정되어 있으면 입구 몰 유량으로 캐시에 질의하고, 캐시가 직접 계산을 요구할 때만 적분함.
+            */
+            void solveSteadyState() override
+            {
+                _loadInletFlow();
+
+                if (_ISATPtr == nullptr) _integrateFlow();
+                else
+                {
+                    const int chemNum = _ConcVec.size();
+                    Eigen::VectorXd x(chemNum), f(chemNum);
+                    for (auto i = 0; i < chemNum; ++i) x[i] = _FlowVec[i];
+
+                    _ISATPtr->query(x, f, [this, chemNum](const Eigen::VectorXd& xq, Eigen::VectorXd& fq, Eigen::MatrixXd* A)
+                    {
+                        for (auto i = 0; i < chemNum; ++i) _FlowVec[i] = xq[i];
+                        if (A == nullptr) _integrateFlow();
+                        else *A = _integrateSens().leftCols(chemNum);
+                        for (auto i = 0; i < chemNum; ++i) fq[i] = _FlowVec[i];
+                    });
+
+                    for (auto i = 0; i < chemNum; ++i) _FlowVec[i] = f[i];
+                }
+
+                _writeOutletFlow();
+            }
+
+            /*
+            입력/출력 스트림 몰 유량 사이의 야코비안을 계산함(ProcObjBase::calcStreamJacobian 참조).
+            민감도 방정식을 함께 적분하므로 출력 스트림에도 solveSteadyState와 같은 값이 반영됨.
+            */
+            bool calcStreamJacobian(Eigen::MatrixXd& Jacob) override
+            {
+                _loadInletFlow();
+                const Eigen::MatrixXd S = _integrateSens();
+                _writeOutletFlow();
+
+                __chainStreamJacobian(S.leftCols(_ConcVec.size()), Jacob);
+                return true;
+            }
+
+            // 속도식으로 출구를 계산하므로 Forward만 지원함.
+            bool supportDirection(const DirectionType& Direction) override
+            {
+                return Direction == Forward;
+            }
+
+            /*
+            입력 스트림으로부터 반응기 출구까지 상태와 민감도 방정식을 함께 적분해 출구의 민감도를 반환함.
+            출력 스트림에도 solveSteadyState와 같은 값을 반영함. 유한 차분과 달리 한 번의 적분으로
+            모든 입구 유량과 매개변수에 대한 민감도를 얻음.
+            */
+            RxtorSensitivity solveSensitivity()
+            {
+                const int chemNum = _ConcVec.size();
+                const int rxnNum = _RateVec.size();
+
+                _loadInletFlow();
+                const Eigen::MatrixXd S = _integrateSens();
+                _writeOutletFlow();
+
+                RxtorSensitivity res;
+                res.dOutdFeed = S.leftCols(chemNum);
+                res.dOutdParam = S.rightCols(rxnNum);
+
+                return res;
+            }
+
+            /*
+            반응기 부피 VolVec(오름차순)에서의 몰 유량을 dense output으로 계산해 반환함.
+            반환값의 각 원소는 RxnBase::getChemIdx() 순서의 몰 유량임. 출력 스트림은 변경하지 않음.
+            */
+            std::vector<std::vector<float>> solveProfile(const std::vector<float>& VolVec)
+            {
+                std::vector<std::vector<float>> res;
+                if (VolVec.empty()) return res;
+                res.reserve(VolVec.size());
+
+                std::vector<double> timeVec;
+                timeVec.reserve(VolVec.size() + 1);
+                if (VolVec[0] > 0) timeVec.push_back(0);
+                for (auto V : VolVec) timeVec.push_back(V);
+
+                const bool skipFirst = (VolVec[0] > 0);
+                int obsIdx = 0;
+
+                _loadInletFlow();
+
+                boost::numeric::odeint::integrate_times(*_Stepper, std::make_pair(_System{this}, _Jacobi{this}),
+                    _FlowVec, timeVec.begin(), timeVec.end(), 1e-4 * timeVec.back(),
+                    [&](const _StateType& F, const double& /* V */)
+                    {
+                        if (obsIdx++ == 0 && skipFirst) return;
+                        res.push_back(std::vector<float>(F.begin(), F.end()));
+                    });
+
+                return res;
+            }
+
+            #endif
+    };
+} // namespace chemprochelper
+
+
+#endif
\ No newline at end of file
@@ -8,14 +8,91 @@ core/RxtorFamily/RxtorBase.hpp
 
 namespace chemprochelper
 {
+    #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+    /*
+    RxtorBase::sweepConvRateFromKValue의 결과를 저장함.
+    ------------------------------------------------
+        ConvRateVec : 각 지점에서 수렴한 전화율을 저장함.
+        IterVec : 각 지점에서 사용한 반복 횟수를 저장함.
+        ColdIter : 첫 지점(cold start)에서 사용한 반복 횟수를 저장함.
+        SavedIter : 모든 지점을 cold start로 계산했을 때(ColdIter 기준)에 비해 절약한 반복 횟수의 추정치를 저장함.
+    */
+    struct ConvRateSweepResult
+    {
+        std::vector<std::vector<float>> ConvRateVec;
+        std::vector<int> IterVec;
+        int ColdIter = 0;
+        int SavedIter = 0;
+    };
+
+    /*
+    RxtorBase::calcConvRateSensitivity의 결과를 저장함. 화학종은 RxnBase::getChemIdx() 순서이며,
+    출구는 모든 출력 스트림을 합친 값임(출력 스트림 m의 민감도는 분배 비율을 곱하면 됨).
+    입력 스트림이 여러 개인 경우 Feed는 혼합된 입구이므로, 어느 입력 스트림에 대해서도 같은 값임.
+    ------------------------------------------------------------------------------------------
+        dConvdLnK : d(xi) / d(ln K). (반응 수) x (반응 수)
+        dConvdFeed : d(xi) / d(n_0). (반응 수) x (화학종 수)
+        dOutdLnK, dOutdK : d(n) / d(ln K), d(n) / d(K). (화학종 수) x (반응 수)
+        dOutdFeed : d(n) / d(n_0). (화학종 수) x (화학종 수)
+    */
+    struct ConvRateSensitivity
+    {
+        Eigen::MatrixXf dConvdLnK;
+        Eigen::MatrixXf dConvdFeed;
+        Eigen::MatrixXf dOutdLnK;
+        Eigen::MatrixXf dOutdK;
+        Eigen::MatrixXf dOutdFeed;
+    };
+
+    /*
+    속도식을 이용하는 반응기(PFR, CSTR)의 출구 민감도를 저장함. 화학종은 RxnBase::getChemIdx() 순서이며,
+    출구는 모든 출력 스트림을 합친 값임.
+    ---------------------------------------------------------------------------------------------
+        dOutdFeed : d(F_out) / d(F_in). (화학종 수) x (화학종 수)
+        dOutdParam : d(F_out) / d(ln p). (화학종 수) x (반응 수). p는 SpeedRxnBase::calcRateParamSens 참조.
+    */
+    struct RxtorSensitivity
+    {
+        Eigen::MatrixXd dOutdFeed;
+        Eigen::MatrixXd dOutdParam;
+    };
+
+    #endif
+
     /*
     화학 반응기를 지정하는 기본 클래스
     --------------------------------
-    RxtorBase는 다음과 같은 멤버 변수를 가짐.
+    반응에 참여하는 화학종 수 NChem과 반응 수 NRxn을 컴파일 타임에 지정하면 평형, 전화율 계산의
+    행렬과 벡터가 모두 고정 크기(스택)가 되어 힙 할당 없이 전개된 코드로 계산됨.
+    지정하지 않으면(Eigen::Dynamic) 동적 크기로 동작하며, RxtorBase는 이 경우의 별칭임.
+    NStreamChem은 스트림 쪽 화학종 수(__ChemIdx, 반응하지 않는 화학종 포함)이며 기본값은 NChem임.
+    고정되면 스트림 혼합/분배의 벡터도 고정 크기가 되며, 스트림의 화학종 수가 다르면 runtime error 발생.
+        ex) RxtorBaseT<5, 2> : 화학종 5개, 반응 2개 (main.cpp의 아민화 반응기)
+        ex) RxtorBaseT<5, 2, 6> : 위 반응에 반응하지 않는 화학종 1개가 스트림에 더 있는 경우
+    RxtorBaseT는 다음과 같은 멤버 변수를 가짐.
     private:
         _RxnPtr : 화학 반응식을 나타내는 RxnBase 객체의 포인터를 저장함.
+        _RxnChemIdx : 반응에 참여하는 화학종(RxnBase::getChemIdx())을 저장함.
+        _StoiMat : 반응식의 v(nu) 값((화학종 수) x (반응 수))을 저장함. 생성자에서 한 번만 복사함.
+        _StoiQR, _StoiQtMat, _StoiRMat, _StoiPerm : _StoiMat의 QR 분해(v P = Q R)를 저장함.
+            반응식은 바뀌지 않으므로 생성자에서 한 번만 분해하고, solveConvRateFromStream은
+            Q^T 곱과 R에 대한 삼각 행렬 풀이 한 번으로 전화율을 계산함.
+        _SplitFrac : 출력 스트림별 분배 비율을 저장함. 합은 1임.
+        _InPosMat, _OutPosMat : __ChemIdx의 화학종별 입/출력 스트림 상 위치(없으면 -1)를 스트림마다 저장함.
+        _InChemMask : __ChemIdx의 화학종이 입력 스트림에 포함되는지 저장함.
+        _DeltaWork, _RhsWork, _ConvWork : 전화율 역산에 사용하는 작업 공간.
+    protected:
+        __RxnChemPos : 반응 화학종의 __ChemIdx 상 위치를 저장함.
+        __MixVec, __TotalVec : 입력 스트림을 합친 몰 유량과 출구의 전체 몰 유량(__ChemIdx 순서)을 저장함.
+
+    입/출력 스트림은 여러 개일 수 있음. 입력 스트림은 반응기 입구에서 바로 혼합되고(__mixInlet),
+    출구의 전체 유량은 _SplitFrac에 따라 출력 스트림에 나뉨(__splitOutlet). 혼합과 분배는 캐시된 위치로
+    한 번의 순회에서 이루어지므로, 반응기 앞뒤에 MixerBase와 임시 스트림을 둘 필요가 없음.
+    calcLnQAD, calcConvRateResidualAD는 평형 조건을 Dual(자동 미분) 등 임의의 스칼라 형식으로 계산함.
     */
-    class RxtorBase : public ProcObjBase
+    template <int NChem = Eigen::Dynamic, int NRxn = Eigen::Dynamic, int NStreamChem = NChem>
+    class RxtorBaseT : public ProcObjBase
     {
         /*
         ProcObjBase로부터,
@@ -27,10 +104,121 @@ namespace chemprochelper
         
         세 변수를 상속받음(모두 protected)
         */
+        public:
+
+            // 계산에 사용하는 행렬, 벡터의 형식. NChem, NRxn이 고정되면 모두 고정 크기가 됨.
+            using StoiMatType = Eigen::Matrix<float, NChem, NRxn>;
+            using ChemVecType = Eigen::Matrix<float, NChem, 1>;
+            using RxnVecType = Eigen::Matrix<float, NRxn, 1>;
+            using RxnMatType = Eigen::Matrix<float, NRxn, NRxn>;
+            using StreamVecType = Eigen::Matrix<float, NStreamChem, 1>;
+
+            EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
         private:
 
             // 화학 반응식을 나타내는 RxnBase 객체의 포인터를 저장함.
-            RxnBase* _RxnPtr;
+            RxnBase* _RxnPtr = nullptr;
+
+            // 반응에 참여하는 화학종을 저장함.
+            std::vector<ChemBase*> _RxnChemIdx;
+
+            // 반응식의 v(nu) 값을 저장함.
+            StoiMatType _StoiMat;
+
+            // 반응식의 QR 분해를 저장함. 열이 선형 독립이 아니면(_StoiFullRank = false) _StoiQR.solve를 사용함.
+            Eigen::ColPivHouseholderQR<StoiMatType> _StoiQR;
+            Eigen::Matrix<float, NRxn, NChem> _StoiQtMat;
+            RxnMatType _StoiRMat;
+            Eigen::PermutationMatrix<NRxn, NRxn> _StoiPerm;
+            bool _StoiFullRank = false;
+
+            // 출력 스트림별 분배 비율을 저장함.
+            std::vector<float> _SplitFrac;
+
+            // __ChemIdx의 화학종별 입/출력 스트림 상 위치를 스트림마다 저장함.
+            std::vector<std::vector<int>> _InPosMat;
+            std::vector<std::vector<int>> _OutPosMat;
+
+            // __ChemIdx의 화학종이 입력 스트림에 포함되는지 저장함.
+            Eigen::Matrix<bool, NStreamChem, 1> _InChemMask;
+
+            // 전화율 역산의 작업 공간
+            ChemVecType _DeltaWork;
+            RxnVecType _RhsWork;
+            RxnVecType _ConvWork;
+
+            // RxnBase 객체로부터 _RxnChemIdx, _StoiMat을 구성함. 고정 크기와 맞지 않으면 runtime error 발생.
+            void _setStoiMat()
+            {
+                const auto rxnEffiMat = _RxnPtr->getEffiMat();
+                const int chemNum = rxnEffiMat.rows();
+                const int rxnNum = rxnEffiMat.cols() - 1;
+
+                if ((NChem != Eigen::Dynamic && NChem != chemNum) || (NRxn != Eigen::Dynamic && NRxn != rxnNum))
+                {
+                    throw std::runtime_error("RxnBase object doesn't match the fixed size of RxtorBaseT.");
+                }
+
+                _RxnChemIdx = _RxnPtr->getChemIdx();
+                _StoiMat = rxnEffiMat.block(0, 0, chemNum, rxnNum);
+
+                _setStoiFactor();
+            }
+
+            // _StoiMat의 QR 분해와 작업 공간을 준비함.
+            void _setStoiFactor()
+            {
+                const int chemNum = _StoiMat.rows();
+                const int rxnNum = _StoiMat.cols();
+
+                _StoiQR.compute(_StoiMat);
+                _StoiFullRank = (_StoiQR.rank() == rxnNum);
+
+                // 반응 수가 화학종 수보다 많으면 열이 선형 독립일 수 없으므로 Q^T, R을 만들지 않음.
+                if (_StoiFullRank)
+                {
+                    const Eigen::Matrix<float, NChem, NChem> QMat = _StoiQR.householderQ();
+                    _StoiQtMat = QMat.leftCols(rxnNum).transpose();
+                    _StoiRMat = _StoiQR.matrixQR().topRows(rxnNum).template triangularView<Eigen::Upper>();
+                    _StoiPerm = _StoiQR.colsPermutation();
+                }
+
+                _DeltaWork = ChemVecType::Zero(chemNum);
+                _RhsWork = RxnVecType::Zero(rxnNum);
+                _ConvWork = RxnVecType::Zero(rxnNum);
+            }
+
+            /*
+            스트림 혼합/분배에 사용하는 위치와 작업 공간을 준비함. _setMainMat 이후에 호출해야 함.
+            스트림의 화학종 수가 NStreamChem과 맞지 않으면 runtime error 발생.
+            */
+            void _setStreamWork()
+            {
+                if (NStreamChem != Eigen::Dynamic && NStreamChem != __ChemIdx.size())
+                {
+                    throw std::runtime_error("Streams don't match the fixed size of RxtorBaseT.");
+                }
+
+                __RxnChemPos.resize(_RxnChemIdx.size());
+                for (auto i = 0; i < _RxnChemIdx.size(); ++i) __RxnChemPos[i] = functions::getVecPos(__ChemIdx, _RxnChemIdx[i]);
+
+                _InChemMask.setConstant(__ChemIdx.size(), false);
+                for (auto inStreamPtr : getInStreamIdx())
+                {
+                    for (auto k = 0; k < __ChemIdx.size(); ++k)
+                    {
+                        if (inStreamPtr->inChemList(__ChemIdx[k])) _InChemMask[k] = true;
+                    }
+                }
+
+                _InPosMat.assign(getInStreamIdx().size(), std::vector<int>());
+                _OutPosMat.assign(getOutStreamIdx().size(), std::vector<int>());
+                __MixVec = StreamVecType::Zero(__ChemIdx.size());
+                __TotalVec = StreamVecType::Zero(__ChemIdx.size());
+
+                setSplitFrac(std::vector<float>(_SplitFrac));
+            }
 
             /*
             RxnBase 객체로부터 반응기의 행렬(Murphy의 화학공정계산 p.210 참조)을 __MainMat에 구성함.
@@ -38,19 +226,27 @@ namespace chemprochelper
             */
             void _setMainMat()
             {
-                StreamBase* inStreamPtr = getInStreamIdx()[0];
-                StreamBase* outStreamPtr = getOutStreamIdx()[0];
-                
-                auto RxnEffiMat = _RxnPtr->getEffiMat();
-                auto RxnChemIdx = _RxnPtr->getChemIdx();
-                auto inStrChemIdx = inStreamPtr->getChemIdx();
+                const auto& RxnChemIdx = _RxnChemIdx;
+
+                // 모든 입력 스트림의 화합물들을 모음.
+                std::vector<ChemBase*> inStrChemIdx;
+                for (auto inStreamPtr : getInStreamIdx())
+                {
+                    for (auto idx : inStreamPtr->getChemIdx())
+                    {
+                        if (!functions::inVector(inStrChemIdx, idx)) inStrChemIdx.push_back(idx);
+                    }
+                }
 
                 // _ChemIdx에 입력 스트림과 출력 스트림의 화합물들을 다 저장함.
-                __ChemIdx = inStreamPtr->getChemIdx();
-                for (auto idx : outStreamPtr->getChemIdx())
+                __ChemIdx = inStrChemIdx;
+                for (auto outStreamPtr : getOutStreamIdx())
                 {
-                    if (!functions::inVector(__ChemIdx, idx)) __ChemIdx.push_back(idx);
-                }                
+                    for (auto idx : outStreamPtr->getChemIdx())
+                    {
+                        if (!functions::inVector(__ChemIdx, idx)) __ChemIdx.push_back(idx);
+                    }
+                }
                 for (auto idx : RxnChemIdx)
                 {
                     if (!functions::inVector(__ChemIdx, idx)) throw std::runtime_error("StreamBase object can't cover RxnBase object");
@@ -58,7 +254,7 @@ namespace chemprochelper
 
                 // __MainMat의 크기를 맞춤.
                 int rows = __ChemIdx.size() + inStrChemIdx.size();
-                int cols = __ChemIdx.size() + RxnEffiMat.cols() - 1;
+                int cols = __ChemIdx.size() + _StoiMat.cols();
 
                 __MainMat.resize(rows, cols);
                 __MainMat.setZero();
@@ -73,9 +269,9 @@ namespace chemprochelper
                     // 우측 상단 부분의 값을 결정함.
                     if (functions::inVector(RxnChemIdx, idx))   // 반응에 참여하는 화학종의 경우
                     {
-                        for (auto j = 0; j < RxnEffiMat.cols() - 1; ++j)
+                        for (auto j = 0; j < _StoiMat.cols(); ++j)
                         {
-                            __MainMat(i, __ChemIdx.size() + j) = -1 * RxnEffiMat(functions::getVecPos(RxnChemIdx, idx), j);
+                            __MainMat(i, __ChemIdx.size() + j) = -1 * _StoiMat(functions::getVecPos(RxnChemIdx, idx), j);
                         }
                     }                  
                 }
@@ -87,35 +283,310 @@ namespace chemprochelper
 
                     if (functions::inVector(RxnChemIdx, idx))   // 반응에 참여하는 경우
                     {
-                        for (auto j = 0; j < RxnEffiMat.cols() - 1; ++j)
+                        for (auto j = 0; j < _StoiMat.cols(); ++j)
+                        {
+                            __MainMat(__ChemIdx.size() + i, __ChemIdx.size() + j) = -1 * _StoiMat(functions::getVecPos(RxnChemIdx, idx), j);
+                        }
+                    }
+                }
+            }
+
+            #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
+
+            /*
+            concVec에서 stepVec 방향으로 이동할 때 모든 몰수가 양수로 남도록 하는 최대 비율(최대 1)을 반환함.
+            경계까지의 거리의 99%까지만 이동함.
+            */
+            static float _calcStepRatio(const ChemVecType& concVec, const ChemVecType& stepVec)
+            {
+                float ratio = 1;
+                for (auto i = 0; i < concVec.size(); ++i)
+                {
+                    if (stepVec[i] < 0 && concVec[i] + ratio * stepVec[i] <= 0)
+                    {
+                        ratio = -0.99 * concVec[i] / stepVec[i];
+                    }
+                }
+
+                return ratio;
+            }
+
+            /*
+            ln Q(xi) - ln K = 0을 Newton 반복으로 풂. Jacobian은 J = v^T diag(1/n) v로 해석적으로 계산함.
+            convVec을 초기값으로 사용하고 해를 덮어씀. 수렴 여부를 반환하고, 사용한 반복 횟수는 실패한 경우에도
+            iterNum에 저장함.
+            */
+            static bool _solveConvRateNewton(const RxnVecType& lnKVec, const ChemVecType& initConcVec,
+                const StoiMatType& mat, RxnVecType& convVec, int& iterNum, const float& tol = 1e-4, const int& maxIter = 50)
+            {
+                iterNum = 0;
+
+                ChemVecType concVec = mat * convVec + initConcVec;
+                if ((concVec.array() <= 0).any()) return false;
+
+                RxnVecType resVec, stepVec;
+                RxnMatType jacMat;
+
+                for (; iterNum < maxIter; ++iterNum)
+                {
+                    resVec = mat.transpose() * concVec.array().log().matrix() - lnKVec;
+                    if (resVec.cwiseAbs().maxCoeff() < tol) return true;
+
+                    jacMat = mat.transpose() * concVec.cwiseInverse().asDiagonal() * mat;
+                    stepVec = -jacMat.ldlt().solve(resVec);
+
+                    convVec += _calcStepRatio(concVec, mat * stepVec) * stepVec;
+                    concVec = mat * convVec + initConcVec;
+
+                    if (!concVec.allFinite())
+                    {
+                        ++iterNum;
+                        return false;
+                    }
+                }
+
+                return false;
+            }
+
+            /*
+            계산된 전화율을 __ScalarVec과 출력 스트림에 반영함. __MixVec에는 입력 스트림을 합친 값이 있어야 함.
+            반응하지 않는 화학종은 입구의 값을 그대로 사용함.
+            */
+            void _setConvRateResult(const RxnVecType& convVec)
+            {
+                __ScalarVec.resize(convVec.size());
+                for (auto i = 0; i < __ScalarVec.size(); ++i) __ScalarVec[i] = convVec[i];
+
+                _DeltaWork.noalias() = _StoiMat * convVec;
+                __TotalVec = __MixVec;
+                for (auto i = 0; i < __RxnChemPos.size(); ++i) __TotalVec[__RxnChemPos[i]] += _DeltaWork[i];
+
+                __splitOutlet();
+            }
+
+            #endif
+
+        protected:
+
+            // 반응 화학종의 __ChemIdx 상 위치를 저장함.
+            std::vector<int> __RxnChemPos;
+
+            // 입력 스트림을 합친 몰 유량과 출구의 전체 몰 유량을 저장함. (__ChemIdx 순서)
+            StreamVecType __MixVec;
+            StreamVecType __TotalVec;
+
+            // n번째 입력 스트림을 __MixVec에 더함.
+            void __addInlet(const int& n)
+            {
+                auto inStreamPtr = getInStreamPtr(n);
+                auto& posVec = _InPosMat[n];
+                __syncStreamPos(inStreamPtr, __ChemIdx, posVec);
+
+                for (auto k = 0; k < posVec.size(); ++k)
+                {
+                    if (posVec[k] >= 0) __MixVec[k] += inStreamPtr->getChemMolAt(posVec[k]);
+                }
+            }
+
+            // skip번째를 제외한 모든 입력 스트림을 합쳐 __MixVec에 저장함.
+            void __mixInlet(const int& skip = -1)
+            {
+                __MixVec.setZero();
+                for (auto n = 0; n < _InPosMat.size(); ++n)
+                {
+                    if (n != skip) __addInlet(n);
+                }
+            }
+
+            // SkipVec[n]이 true인 입력 스트림을 제외한 모든 입력 스트림을 합쳐 __MixVec에 저장함.
+            void __mixInlet(const std::vector<bool>& SkipVec)
+            {
+                __MixVec.setZero();
+                for (auto n = 0; n < _InPosMat.size(); ++n)
+                {
+                    if (!SkipVec[n]) __addInlet(n);
+                }
+            }
+
+            // 모든 출력 스트림을 합쳐 __TotalVec에 저장함.
+            void __gatherOutlet()
+            {
+                __TotalVec.setZero();
+                for (auto m = 0; m < _OutPosMat.size(); ++m)
+                {
+                    auto outStreamPtr = getOutStreamPtr(m);
+                    auto& posVec = _OutPosMat[m];
+                    __syncStreamPos(outStreamPtr, __ChemIdx, posVec);
+
+                    for (auto k = 0; k < posVec.size(); ++k)
+                    {
+                        if (posVec[k] >= 0) __TotalVec[k] += outStreamPtr->getChemMolAt(posVec[k]);
+                    }
+                }
+            }
+
+            /*
+            __TotalVec을 _SplitFrac에 따라 출력 스트림에 나눠 씀.
+            출력 스트림에 없는 화학종은 유량이 0이 아닌 경우에만 출력 스트림에 추가함.
+            */
+            void __splitOutlet()
+            {
+                for (auto m = 0; m < _OutPosMat.size(); ++m)
+                {
+                    auto outStreamPtr = getOutStreamPtr(m);
+                    auto& posVec = _OutPosMat[m];
+                    __syncStreamPos(outStreamPtr, __ChemIdx, posVec);
+
+                    for (auto k = 0; k < posVec.size(); ++k)
+                    {
+                        const float val = _SplitFrac[m] * __TotalVec[k];
+                        if (posVec[k] >= 0) outStreamPtr->setChemMolAt(posVec[k], val);
+                        else if (val != 0) outStreamPtr->updateChem(__ChemIdx[k], val);
+                    }
+                }
+            }
+
+            /*
+            반응 화학종의 출구 민감도 dRxnOut(RxnBase::getChemIdx() 순서, d(출구) / d(입구))로부터 입/출력 스트림
+            몰 유량 사이의 야코비안(ProcObjBase::calcStreamJacobian 참조)을 Jacob에 구성함.
+            반응하지 않는 화학종은 출구 = 입구이며, 출구는 _SplitFrac에 따라 출력 스트림에 나뉨.
+            */
+            void __chainStreamJacobian(const Eigen::MatrixXd& dRxnOut, Eigen::MatrixXd& Jacob)
+            {
+                const int chemNum = __ChemIdx.size();
+
+                Eigen::MatrixXd totalMat = Eigen::MatrixXd::Identity(chemNum, chemNum);
+                for (auto i = 0; i < __RxnChemPos.size(); ++i)
+                {
+                    totalMat.row(__RxnChemPos[i]).setZero();
+                    for (auto k = 0; k < __RxnChemPos.size(); ++k) totalMat(__RxnChemPos[i], __RxnChemPos[k]) = dRxnOut(i, k);
+                }
+
+                int rowNum = 0, colNum = 0;
+                for (auto m = 0; m < _OutPosMat.size(); ++m) rowNum += getOutStreamPtr(m)->getChemNum();
+                for (auto n = 0; n < _InPosMat.size(); ++n) colNum += getInStreamPtr(n)->getChemNum();
+                Jacob = Eigen::MatrixXd::Zero(rowNum, colNum);
+
+                int rowOffset = 0;
+                for (auto m = 0; m < _OutPosMat.size(); ++m)
+                {
+                    auto outStreamPtr = getOutStreamPtr(m);
+                    auto& outPosVec = _OutPosMat[m];
+                    __syncStreamPos(outStreamPtr, __ChemIdx, outPosVec);
+
+                    int colOffset = 0;
+                    for (auto n = 0; n < _InPosMat.size(); ++n)
+                    {
+                        auto inStreamPtr = getInStreamPtr(n);
+                        auto& inPosVec = _InPosMat[n];
+                        __syncStreamPos(inStreamPtr, __ChemIdx, inPosVec);
+
+                        for (auto i = 0; i < chemNum; ++i)
                         {
-                            __MainMat(__ChemIdx.size() + i, __ChemIdx.size() + j) = -1 * RxnEffiMat(functions::getVecPos(RxnChemIdx, idx), j);
+                            if (outPosVec[i] < 0) continue;
+                            for (auto k = 0; k < chemNum; ++k)
+                            {
+                                if (inPosVec[k] >= 0) Jacob(rowOffset + outPosVec[i], colOffset + inPosVec[k]) = _SplitFrac[m] * totalMat(i, k);
+                            }
                         }
+
+                        colOffset += inStreamPtr->getChemNum();
                     }
+
+                    rowOffset += outStreamPtr->getChemNum();
                 }
             }
 
+            // 입력 스트림을 합친 반응 화학종의 몰 유량을 initConcVec에 저장함.
+            void __loadFeed(ChemVecType& initConcVec)
+            {
+                __mixInlet();
+                initConcVec = ChemVecType::Zero(_RxnChemIdx.size());
+                for (auto i = 0; i < _RxnChemIdx.size(); ++i) initConcVec[i] = __MixVec[__RxnChemPos[i]];
+            }
+
         public:
 
             // 생성자 정의부
 
             // 임시 객체를 위한 생성자
-            RxtorBase():
+            RxtorBaseT():
                 ProcObjBase() {}
             
             // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의된 경우
-            RxtorBase(StreamBase* inStreamPtr, StreamBase* outStreamPtr, RxnBase* RxnPtr):
+            RxtorBaseT(StreamBase* inStreamPtr, StreamBase* outStreamPtr, RxnBase* RxnPtr):
                 ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), std::vector<StreamBase*>(1, outStreamPtr)),
                 _RxnPtr(RxnPtr)
             {
+                _setStoiMat();
                 _setMainMat();
+                _setStreamWork();
             }
             
             // StreamBase* 포인터를 이용함. 입/출력 스트림이 정의된 경우. 코멘트를 포함함.
-            RxtorBase(StreamBase* inStreamPtr, StreamBase* outStreamPtr, RxnBase* RxnPtr, std::string& Comment):
+            RxtorBaseT(StreamBase* inStreamPtr, StreamBase* outStreamPtr, RxnBase* RxnPtr, std::string& Comment):
                 ProcObjBase(std::vector<StreamBase*>(1, inStreamPtr), std::vector<StreamBase*>(1, outStreamPtr), Comment), _RxnPtr(RxnPtr)
             {
+                _setStoiMat();
+                _setMainMat();
+                _setStreamWork();
+            }
+
+            /*
+            입/출력 스트림이 여러 개인 경우. 입력 스트림은 반응기 입구에서 혼합되고,
+            출구의 유량은 SplitFrac(출력 스트림별 비율)에 따라 나뉨. SplitFrac이 비어 있으면 균등하게 나눔.
+            */
+            RxtorBaseT(const std::vector<StreamBase*>& inStreamIdx, const std::vector<StreamBase*>& outStreamIdx,
+                RxnBase* RxnPtr, const std::vector<float>& SplitFrac = {}):
+                ProcObjBase(inStreamIdx, outStreamIdx), _RxnPtr(RxnPtr), _SplitFrac(SplitFrac)
+            {
+                _setStoiMat();
                 _setMainMat();
+                _setStreamWork();
+            }
+
+            // 입/출력 스트림이 여러 개인 경우. 코멘트를 포함함.
+            RxtorBaseT(const std::vector<StreamBase*>& inStreamIdx, const std::vector<StreamBase*>& outStreamIdx,
+                RxnBase* RxnPtr, const std::vector<float>& SplitFrac, std::string& Comment):
+                ProcObjBase(inStreamIdx, outStreamIdx, Comment), _RxnPtr(RxnPtr), _SplitFrac(SplitFrac)
+            {
+                _setStoiMat();
+                _setMainMat();
+                _setStreamWork();
+            }
+
+            // getter 정의부
+
+            auto getRxnPtr() {return _RxnPtr;}
+            const StoiMatType& getStoiMat() const {return _StoiMat;}
+            auto getSplitFrac() const {return _SplitFrac;}
+            float getSplitFracAt(const int& pos) const {return _SplitFrac[pos];}
+
+            // setter 정의부
+
+            // 출력 스트림별 분배 비율을 설정함. 합이 1이 되도록 정규화하며, 비어 있으면 균등하게 나눔.
+            void setSplitFrac(const std::vector<float>& SplitFrac)
+            {
+                const int outNum = getOutStreamIdx().size();
+
+                if (SplitFrac.empty())
+                {
+                    _SplitFrac.assign(outNum, 1.0f / outNum);
+                    return;
+                }
+
+                if (SplitFrac.size() != outNum) throw std::runtime_error("Split fractions don't match the number of outlet streams.");
+
+                float sum = 0;
+                for (auto frac : SplitFrac)
+                {
+                    if (frac < 0) throw std::runtime_error("Split fraction must be non-negative.");
+                    sum += frac;
+                }
+                if (sum <= 0) throw std::runtime_error("Sum of split fractions must be positive.");
+
+                _SplitFrac.resize(outNum);
+                for (auto m = 0; m < outNum; ++m) _SplitFrac[m] = SplitFrac[m] / sum;
             }
             
             // 인스턴스 정의부
@@ -125,8 +596,8 @@ namespace chemprochelper
             {
                 float ans = 1;
                 int idx;
-                const auto& RxnChemIdx = _RxnPtr->getChemIdx();
-                auto effiVec = _RxnPtr->getEffiMat().col(_RxnPtr->getEffiMat().cols()-1);
+                const auto& RxnChemIdx = _RxnChemIdx;
+                const ChemVecType effiVec = _StoiMat.rowwise().sum();
 
                 for (auto i = 0; i < RxnChemIdx.size(); ++i)
                 {
@@ -141,78 +612,111 @@ namespace chemprochelper
             std::vector<float> calcQ() const
             {
                 int idx;
-                const auto& RxnChemIdx = _RxnPtr->getChemIdx();
-                const auto& EffiMat = _RxnPtr->getEffiMat();
-                std::vector<float> ans(EffiMat.cols()-1, 1);
-                Eigen::VectorXf effiVec;
+                const auto& RxnChemIdx = _RxnChemIdx;
+                std::vector<float> ans(_StoiMat.cols(), 1);
                 
-                for (auto i = 0; i < EffiMat.cols()-1; ++i)
+                for (auto i = 0; i < _StoiMat.cols(); ++i)
                 {
-                    effiVec = EffiMat.col(i);
                     for (auto j = 0; j < RxnChemIdx.size(); ++j)
                     {
                         idx = functions::getVecPos(__ChemIdx, RxnChemIdx[j]);
-                        ans[i] *= std::pow(__ChemMol[idx], effiVec[j]);
+                        ans[i] *= std::pow(__ChemMol[idx], _StoiMat(j, i));
                     }
                 }
 
                 return ans;
             }
 
+            /*
+            반응 화학종의 몰수 mol(RxnBase::getChemIdx() 순서)에서 ln Q_j = sum_i v_ij ln n_i 를 T 형식으로 계산함.
+            Dual로 시드하면 d(ln Q)/dn = v^T diag(1/n)을, HyperDual로 시드하면 2계 미분을 손 미분 없이 얻음.
+            */
+            template <typename T>
+            void calcLnQAD(const T* mol, T* lnQ) const
+            {
+                using std::log;
+
+                const int chemNum = _StoiMat.rows();
+                const int rxnNum = _StoiMat.cols();
+
+                std::vector<T> lnMol(chemNum);
+                for (auto i = 0; i < chemNum; ++i) lnMol[i] = log(mol[i]);
+
+                for (auto j = 0; j < rxnNum; ++j)
+                {
+                    lnQ[j] = T(0);
+                    for (auto i = 0; i < chemNum; ++i)
+                    {
+                        if (_StoiMat(i, j) != 0) lnQ[j] += static_cast<double>(_StoiMat(i, j)) * lnMol[i];
+                    }
+                }
+            }
+
+            /*
+            전화율 conv, 입구 몰수 feed(반응 화학종), ln K에서 평형 조건의 잔차 F = v^T ln(n_0 + v xi) - ln K 를
+            T 형식으로 계산함. solveConvRateFromKValue의 Newton 반복과 calcConvRateSensitivity가 푸는 식과 같음.
+            */
+            template <typename T>
+            void calcConvRateResidualAD(const T* conv, const T* feed, const T* lnK, T* res) const
+            {
+                const int chemNum = _StoiMat.rows();
+                const int rxnNum = _StoiMat.cols();
+
+                std::vector<T> mol(feed, feed + chemNum);
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    for (auto j = 0; j < rxnNum; ++j)
+                    {
+                        if (_StoiMat(i, j) != 0) mol[i] += static_cast<double>(_StoiMat(i, j)) * conv[j];
+                    }
+                }
+
+                calcLnQAD(mol.data(), res);
+                for (auto j = 0; j < rxnNum; ++j) res[j] -= lnK[j];
+            }
+
             #ifdef _INCLUDE_CHEMPROCHELPER_SOLVER
 
             /*
             반응기에 대한 입력 스트림으로부터, 출력 스트림이 평형 상태가 되기 위한 전화율의 값을 각각 계산해,
-            출력 스트림에 값을 반영한다.
+            출력 스트림에 값을 반영한다. 계산에 사용한 반복 횟수를 반환한다.
             단, 반응기가 정상 상태에서 동작한다고 가정한다.
             */
-            void solveConvRateFromKValue(const std::vector<float>& K)
+            int solveConvRateFromKValue(const std::vector<float>& K)
             {
-                auto inStreamPtr = getInStreamIdx()[0];
-                auto outStreamPtr = getOutStreamIdx()[0];
-                const auto rxnChemIdx = _RxnPtr->getChemIdx();
-                const auto rxnEffiMat = _RxnPtr->getEffiMat();
-                const auto inChemIdx = inStreamPtr->getChemIdx();
-                const auto outChemIdx = outStreamPtr->getChemIdx();
+                const auto& mat = _StoiMat;
 
                 // 평형 상수 개수가 맞지 않는 경우 AssertionError 발생
-                assert(rxnEffiMat.cols() - 1 == K.size());
+                assert(mat.cols() == K.size());
 
-                Eigen::VectorXf KVec;
-                KVec.resize(K.size());
+                RxnVecType KVec = RxnVecType::Zero(K.size());
                 for (auto i = 0; i < K.size(); ++i) KVec[i] = K[i];
 
-                Eigen::MatrixXf mat;
-                mat.resize(rxnEffiMat.rows(), rxnEffiMat.cols()-1);
-                mat.block(0, 0, mat.rows(), mat.cols()) = rxnEffiMat.block(0,0,mat.rows(), mat.cols());
-std::cout << "Mat : \n" << mat << std::endl;
+                ChemVecType initConcVec;
+                __loadFeed(initConcVec);
 
-                Eigen::VectorXf concVec;
-                concVec.resize(rxnChemIdx.size());
-                concVec.setZero();
-                for (auto i = 0; i < rxnChemIdx.size(); ++i)
-                {
-                    concVec[i] = inStreamPtr->getChemMol(rxnChemIdx[i]);
-                }
+                ChemVecType concVec = initConcVec;
 
-                Eigen::VectorXf QVec;
-                QVec.resize(KVec.size());
+                RxnVecType QVec = RxnVecType::Zero(KVec.size());
 
-                Eigen::VectorXf convVec;
-                convVec.resize(KVec.size());
-                convVec.setZero();
+                RxnVecType convVec = RxnVecType::Zero(KVec.size());
 
                 // 실제로 값을 대입해보면서 최적의 값을 찾음
                 int iter = 0;
                 float delta;
 
-                std::vector<bool> beforeFlag(K.size(), true);
-                std::vector<bool> currentFlag(K.size(), true);
+                Eigen::Matrix<bool, NRxn, 1> beforeFlag = Eigen::Matrix<bool, NRxn, 1>::Constant(K.size(), true);
+                Eigen::Matrix<bool, NRxn, 1> currentFlag = beforeFlag;
 
-                delta = functions::min(inStreamPtr->getChemMol()) / 100.83;
+                // 입력 스트림에 포함된 화학종 중 최소 몰 유량을 기준으로 함.
+                delta = 1e+30;
+                for (auto k = 0; k < __MixVec.size(); ++k)
+                {
+                    if (_InChemMask[k] && __MixVec[k] < delta) delta = __MixVec[k];
+                }
+                delta /= 100.83;
 
-                Eigen::VectorXf deltaVec;
-                deltaVec.resize(QVec.size());
+                RxnVecType deltaVec = RxnVecType::Zero(QVec.size());
 
                 for (auto i = 0; i < convVec.size(); ++i)
                 {
@@ -222,15 +726,12 @@ std::cout << "Mat : \n" << mat << std::endl;
 
                 while (iter < 100)
                 {
-                    concVec = mat * convVec + concVec;
-std::cout << "ConcVec : \n" << concVec << std::endl;
-std::cout << "ConvVec : \n" << convVec << std::endl;
+                    // 전화율은 누적값이므로 항상 입력 스트림의 몰수로부터 다시 계산함.
+                    concVec = mat * convVec + initConcVec;
                     for (auto j = 0; j < QVec.size(); ++j)
                     {
                         QVec[j] = 1;
                         for (auto i = 0; i < concVec.size(); ++i) QVec[j] *= std::pow(concVec[i], mat(i, j));
-
-std::cout << "Current Q[" << j << "] : " << QVec[j] << std::endl;
                     }
                     QVec -= KVec;
                     beforeFlag = currentFlag;
@@ -269,12 +770,158 @@ std::cout << "Current Q[" << j << "] : " << QVec[j] << std::endl;
                     iter++;
                 }
 
-                for (auto i = 0; i < __ScalarVec.size(); ++i) __ScalarVec[i] = convVec[i];
-                
-                std::unordered_map<ChemBase*, float> ChemMol;
-                for (auto i = 0; i < rxnChemIdx.size(); ++i) ChemMol[rxnChemIdx[i]] = concVec[i];
+                // 탐색으로 얻은 근사해를 Newton 반복으로 다듬음. 실패하면 탐색 결과를 그대로 사용함.
+                RxnVecType lnKVec = KVec.array().log().matrix();
+                RxnVecType newtonVec = convVec;
+                int newtonIter = 0;
+                if (_solveConvRateNewton(lnKVec, initConcVec, mat, newtonVec, newtonIter)) convVec = newtonVec;
+                iter += newtonIter;
+
+                _setConvRateResult(convVec);
+
+                return iter;
+            }
+
+            /*
+            이전에 수렴한 전화율(initConvRate)을 초기값으로 Newton 반복을 수행함(warm start).
+            Newton 반복이 실패하는 경우 위의 탐색법(cold start)으로 다시 계산함. 반복 횟수(실패한 Newton 반복 포함)를 반환한다.
+            */
+            int solveConvRateFromKValue(const std::vector<float>& K, const std::vector<float>& initConvRate)
+            {
+                const auto& mat = _StoiMat;
+
+                assert(mat.cols() == K.size());
+                assert(initConvRate.size() == K.size());
+
+                ChemVecType initConcVec;
+                __loadFeed(initConcVec);
+
+                RxnVecType lnKVec = RxnVecType::Zero(K.size());
+                RxnVecType convVec = RxnVecType::Zero(K.size());
+                for (auto j = 0; j < K.size(); ++j)
+                {
+                    lnKVec[j] = std::log(K[j]);
+                    convVec[j] = initConvRate[j];
+                }
+
+                int iter = 0;
+                if (!_solveConvRateNewton(lnKVec, initConcVec, mat, convVec, iter)) return iter + solveConvRateFromKValue(K);
+
+                _setConvRateResult(convVec);
+
+                return iter;
+            }
+
+            /*
+            solveConvRateFromKValue로 수렴한 전화율(__ScalarVec)에서 출구와 전화율의 민감도를 음함수 정리로 계산함.
+            평형 조건 F(xi) = v^T ln(n_0 + v xi) - ln K = 0 에서 J = v^T diag(1/n) v 이므로,
+                d(xi)/d(ln K) = J^-1, d(xi)/d(n_0) = -J^-1 v^T diag(1/n)
+            J를 한 번만 분해(LDLT)하고 모든 우변을 한 번에 풀므로, 유한 차분과 달리 추가 평형 계산이 필요 없음.
+            */
+            ConvRateSensitivity calcConvRateSensitivity(const std::vector<float>& K)
+            {
+                const auto& mat = _StoiMat;
+                const int chemNum = mat.rows();
+                const int rxnNum = mat.cols();
 
-                outStreamPtr->updateChem(ChemMol);
+                assert(rxnNum == K.size());
+                if (__ScalarVec.size() != rxnNum) throw std::runtime_error("Conversion rate isn't solved.");
+
+                ChemVecType initConcVec;
+                __loadFeed(initConcVec);
+
+                const RxnVecType convVec = Eigen::Map<const RxnVecType>(__ScalarVec.data(), rxnNum);
+                const ChemVecType concVec = mat * convVec + initConcVec;
+                if ((concVec.array() <= 0).any()) throw std::runtime_error("Sensitivity needs positive amounts of all reacting species.");
+
+                // diag(1/n) v
+                const StoiMatType weightMat = concVec.cwiseInverse().asDiagonal() * mat;
+                const RxnMatType jacMat = mat.transpose() * weightMat;
+
+                Eigen::MatrixXf rhsMat(rxnNum, rxnNum + chemNum);
+                rhsMat.leftCols(rxnNum).setIdentity();
+                rhsMat.rightCols(chemNum) = -weightMat.transpose();
+
+                const Eigen::MatrixXf solMat = jacMat.ldlt().solve(rhsMat);
+
+                ConvRateSensitivity res;
+                res.dConvdLnK = solMat.leftCols(rxnNum);
+                res.dConvdFeed = solMat.rightCols(chemNum);
+                res.dOutdLnK = mat * res.dConvdLnK;
+                res.dOutdK = res.dOutdLnK;
+                for (auto j = 0; j < rxnNum; ++j) res.dOutdK.col(j) /= K[j];
+                res.dOutdFeed = mat * res.dConvdFeed;
+                res.dOutdFeed.diagonal().array() += 1;
+
+                return res;
+            }
+
+            /*
+            평형 상수의 경로(KPath)를 따라 solveConvRateFromKValue를 연속적으로 수행함(continuation).
+            첫 지점만 cold start로 계산하고, 이후 지점은 직전 지점의 전화율로 warm start 함.
+            usePredictor = true이면 수렴한 지점의 Jacobian으로 1차 예측(d(xi) = J^-1 d(ln K))을 한 뒤 Newton 반복을 시작함.
+            반복이 끝나면 출력 스트림과 __ScalarVec에는 마지막 지점의 값이 남음.
+            */
+            ConvRateSweepResult sweepConvRateFromKValue(const std::vector<std::vector<float>>& KPath,
+                const bool& usePredictor = true)
+            {
+                ConvRateSweepResult res;
+                if (KPath.empty()) return res;
+
+                const auto& mat = _StoiMat;
+
+                ChemVecType initConcVec;
+                __loadFeed(initConcVec);
+
+                res.ColdIter = solveConvRateFromKValue(KPath[0]);
+                res.IterVec.push_back(res.ColdIter);
+                res.ConvRateVec.push_back(__ScalarVec);
+
+                std::vector<float> initConvRate;
+                RxnVecType deltaLnKVec = RxnVecType::Zero(mat.cols());
+                RxnVecType convVec = RxnVecType::Zero(mat.cols());
+
+                for (auto k = 1; k < KPath.size(); ++k)
+                {
+                    initConvRate = __ScalarVec;
+
+                    if (usePredictor)
+                    {
+                        for (auto j = 0; j < mat.cols(); ++j)
+                        {
+                            convVec[j] = __ScalarVec[j];
+                            deltaLnKVec[j] = std::log(KPath[k][j]) - std::log(KPath[k-1][j]);
+                        }
+
+                        ChemVecType concVec = mat * convVec + initConcVec;
+                        RxnMatType jacMat = mat.transpose() * concVec.cwiseInverse().asDiagonal() * mat;
+                        RxnVecType stepVec = jacMat.ldlt().solve(deltaLnKVec);
+
+                        convVec += _calcStepRatio(concVec, mat * stepVec) * stepVec;
+                        for (auto j = 0; j < mat.cols(); ++j) initConvRate[j] = convVec[j];
+                    }
+
+                    auto iter = solveConvRateFromKValue(KPath[k], initConvRate);
+                    res.IterVec.push_back(iter);
+                    res.ConvRateVec.push_back(__ScalarVec);
+                    res.SavedIter += res.ColdIter - iter;
+                }
+
+                return res;
+            }
+
+            /*
+            매개변수(온도 등) paramVec을 따라 평형 상수를 KFunc로 계산하며 sweepConvRateFromKValue를 수행함.
+            1차 예측은 ln K 공간에서 이루어지므로 매개변수에 대한 1차 예측과 동일함.
+            */
+            ConvRateSweepResult sweepConvRateFromKValue(const std::vector<float>& paramVec,
+                const std::function<std::vector<float>(float)>& KFunc, const bool& usePredictor = true)
+            {
+                std::vector<std::vector<float>> KPath;
+                KPath.reserve(paramVec.size());
+                for (auto param : paramVec) KPath.push_back(KFunc(param));
+
+                return sweepConvRateFromKValue(KPath, usePredictor);
             }
 
             #endif
@@ -283,76 +930,54 @@ std::cout << "Current Q[" << j << "] : " << QVec[j] << std::endl;
 
             /*
             값이 알려진 한쪽 스트림과 전화율을 바탕으로, 반대편 스트림의 값을 재설정함.
+            입력 스트림이 모두 알려진 경우 출력 스트림을 _SplitFrac에 따라 계산하고,
+            출력 스트림이 모두 알려진 경우 값을 모르는 입력 스트림 하나를 역산함.
             단, 반응기가 정상 상태에서 작동한다고 가정한다.
             */
             void solveStreamFromConvRate()
             {
-                bool direction;
-                
-                auto inStreamPtr = getInStreamIdx()[0];
-                auto outStreamPtr = getOutStreamIdx()[0];
-                const auto rxnChemIdx = _RxnPtr->getChemIdx();
-                const auto rxnEffiMat = _RxnPtr->getEffiMat();
-                const auto inChemIdx = inStreamPtr->getChemIdx();
-                const auto outChemIdx = outStreamPtr->getChemIdx();
+                const int inNum = getInStreamIdx().size();
+                const int outNum = getOutStreamIdx().size();
 
-                if (inStreamPtr->chemMolIsAllKnown())
+                // 값을 모르는 입력 스트림의 인덱스. 모든 입력 스트림을 아는 경우 -1.
+                int unknownIn = -1;
+                for (auto n = 0; n < inNum; ++n)
                 {
-                    if (!outStreamPtr->chemMolIsAllKnown()) direction = true;
-                    else throw std::runtime_error("All stream has known.");
-                }
-                else
-                {
-                    if (outStreamPtr->chemMolIsAllKnown()) direction = false;
-                    else throw std::runtime_error("All stream are unknown.");
+                    if (getInStreamPtr(n)->chemMolIsAllKnown()) continue;
+                    if (unknownIn >= 0) throw std::runtime_error("More than one inlet stream is unknown.");
+                    unknownIn = n;
                 }
 
-                Eigen::MatrixXf mat;
-                mat.resize(rxnEffiMat.rows(), rxnEffiMat.cols()-1);
-                mat.block(0,0,mat.rows(), mat.cols()) = rxnEffiMat.block(0,0,mat.rows(), mat.cols());
+                bool outAllKnown = true;
+                for (auto m = 0; m < outNum; ++m) outAllKnown = outAllKnown && getOutStreamPtr(m)->chemMolIsAllKnown();
 
-                Eigen::VectorXf convVec = Eigen::Map<Eigen::VectorXf>(__ScalarVec.data(), __ScalarVec.size());
-                Eigen::VectorXf deltaVec = mat * convVec;
-                std::unordered_map<ChemBase*, float> ChemMol;
+                const RxnVecType convVec = Eigen::Map<const RxnVecType>(__ScalarVec.data(), __ScalarVec.size());
 
-                // 입력 스트림이 알려진 경우
-                if (direction)
+                // 입력 스트림이 알려진 경우 : 혼합 -> 반응 -> 분배
+                if (unknownIn < 0)
                 {
-                    const auto inChemMol = inStreamPtr->getChemMol();                    
+                    if (outAllKnown) throw std::runtime_error("All stream has known.");
 
-                    for (auto chem : outChemIdx)
-                    {
-                        if (functions::inVector(rxnChemIdx, chem))
-                        {
-                            ChemMol[chem] = inStreamPtr->getChemMol(chem) + deltaVec[functions::getVecPos(rxnChemIdx, chem)];
-                        }
-                        else
-                        {
-                            ChemMol[chem] = inStreamPtr->getChemMol(chem);
-                        }
-                    }
-                    
-                    outStreamPtr->updateChem(ChemMol);
+                    __mixInlet();
+                    _setConvRateResult(convVec);
+                    return;
                 }
 
-                // 출력 스트림이 알려진 경우
-                else
-                {
-                    const auto outChemMol = outStreamPtr->getChemMol();
+                // 출력 스트림이 알려진 경우 : 값을 모르는 입력 스트림 = 출구 전체 - 반응 변화량 - 나머지 입력 스트림
+                if (!outAllKnown) throw std::runtime_error("All stream are unknown.");
 
-                    for (auto chem : inChemIdx)
-                    {
-                        if (functions::inVector(rxnChemIdx, chem))
-                        {
-                            ChemMol[chem] = outStreamPtr->getChemMol(chem) - deltaVec[functions::getVecPos(rxnChemIdx, chem)];
-                        }
-                        else
-                        {
-                            ChemMol[chem] = outStreamPtr->getChemMol(chem);
-                        }
-                    }
+                __gatherOutlet();
+                __mixInlet(unknownIn);
+                _DeltaWork.noalias() = _StoiMat * convVec;
+                for (auto i = 0; i < __RxnChemPos.size(); ++i) __TotalVec[__RxnChemPos[i]] -= _DeltaWork[i];
 
-                    inStreamPtr->updateChem(ChemMol);
+                auto inStreamPtr = getInStreamPtr(unknownIn);
+                auto& posVec = _InPosMat[unknownIn];
+                __syncStreamPos(inStreamPtr, __ChemIdx, posVec);
+
+                for (auto k = 0; k < posVec.size(); ++k)
+                {
+                    if (posVec[k] >= 0) inStreamPtr->setChemMolAt(posVec[k], __TotalVec[k] - __MixVec[k]);
                 }
             }
 
@@ -363,57 +988,68 @@ std::cout << "Current Q[" << j << "] : " << QVec[j] << std::endl;
             /*
             입력 스트림과 출력 스트림의 값이 모두 알려진 경우 __ScalarVec의 값을 설정함.
             단, 반응기가 정상 상태에서 작동한다고 가정한다.
+            생성자에서 구한 QR 분해를 재사용하므로, 반복 호출 시 Q^T 곱과 삼각 행렬 풀이 한 번만 수행하며
+            메모리를 할당하지 않음. 반응에 참여하지 않는 화학종(불활성 물질)은 무시함.
             */
             void solveConvRateFromStream()
             {
-                const auto& rxnChemIdx = _RxnPtr->getChemIdx();
-                
-                Eigen::VectorXf deltaVec;
-                deltaVec.resize(rxnChemIdx.size());
-                deltaVec.setZero();                
-                
-                auto inStreamPtr = getInStreamIdx()[0];
-                auto outStreamPtr = getOutStreamIdx()[0];
+                __mixInlet();
+                __gatherOutlet();
 
-                int idx_rci, idx_str;
+                // 반응물의 경우 빼고, 생성물의 경우 더함.
+                for (auto i = 0; i < __RxnChemPos.size(); ++i) _DeltaWork[i] = __TotalVec[__RxnChemPos[i]] - __MixVec[__RxnChemPos[i]];
 
-                for (auto i = 0; i < __ChemIdx.size(); ++i)
+                // v P = Q R 이므로 xi = P R^-1 Q^T delta
+                if (_StoiFullRank)
+                {
+                    _RhsWork.noalias() = _StoiQtMat * _DeltaWork;
+                    _StoiRMat.template triangularView<Eigen::Upper>().solveInPlace(_RhsWork);
+                    _ConvWork.noalias() = _StoiPerm * _RhsWork;
+                }
+                else
                 {
-                    auto ptr = __ChemIdx[i];
-                    idx_rci = functions::getVecPos(rxnChemIdx, ptr);
+                    _ConvWork = _StoiQR.solve(_DeltaWork);
+                }
 
-                    // 반응물의 경우 빼야 함.
-                    if (functions::inVector(inStreamPtr->getChemIdx(), ptr))
-                    {
-                        idx_str = functions::getVecPos(inStreamPtr->getChemIdx(), ptr);
-                        deltaVec[idx_rci] -= inStreamPtr->getChemMol()[idx_str];
-                    }
+                __ScalarVec.resize(_ConvWork.size());
+                for (auto i = 0; i < _ConvWork.size(); ++i) __ScalarVec[i] = _ConvWork[i];
+            }
 
-                    // 생성물의 경우 더해야 함.
-                    if (functions::inVector(outStreamPtr->getChemIdx(), ptr))
-                    {
-                        idx_str = functions::getVecPos(outStreamPtr->getChemIdx(), ptr);
-                        deltaVec[idx_rci] += outStreamPtr->getChemMol()[idx_str];
-                    }
-                }
+            /*
+            전화율(__ScalarVec)이 지정된 반응기의 정상 상태. 입력 스트림을 합쳐 전화율만큼 반응시킨 뒤 출력 스트림에 나눔.
+            출력 스트림이 이미 알려져 있어도 덮어쓰므로, 순환 공정의 반복 계산에서 사용할 수 있음.
+            속도식을 사용하는 하위 클래스(CSTR, PFR)는 이 함수를 다시 정의함.
+            */
+            void solveSteadyState() override
+            {
+                if (__ScalarVec.size() != _StoiMat.cols()) throw std::runtime_error("Conversion rate isn't specified.");
 
-                const auto& rxnEffiMat = _RxnPtr->getEffiMat();
-                Eigen::MatrixXf mat;
-                mat.resize(rxnEffiMat.rows(), rxnEffiMat.cols()-1);
+                __mixInlet();
+                _setConvRateResult(Eigen::Map<const RxnVecType>(__ScalarVec.data(), __ScalarVec.size()));
+            }
 
-                mat.block(0,0,rxnEffiMat.rows(), rxnEffiMat.cols()-1) = rxnEffiMat.block(0,0,rxnEffiMat.rows(), rxnEffiMat.cols()-1);
-                Eigen::VectorXf res = mat.colPivHouseholderQr().solve(deltaVec);
+            /*
+            전화율이 지정되어 있으면 Forward(solveSteadyState), Backward(solveStreamFromConvRate)를 지원하고,
+            모든 스트림이 알려진 경우 solveConvRateFromStream으로 전화율을 계산함(Estimate).
+            속도식을 사용하는 하위 클래스(CSTR, PFR)는 Forward만 지원함.
+            */
+            bool supportDirection(const DirectionType& Direction) override
+            {
+                return (Direction == Estimate) || (__ScalarVec.size() == _StoiMat.cols());
+            }
 
-                __ScalarVec.clear();
-                __ScalarVec.resize(res.size());
-                for (auto i = 0; i < res.size(); ++i)
-                {
-                    __ScalarVec[i] = res[i];
-                }
+            void solveDirection(const DirectionType& Direction) override
+            {
+                if (Direction == Forward) solveSteadyState();
+                else if (Direction == Backward) solveStreamFromConvRate();
+                else solveConvRateFromStream();
             }
 
             #endif
     };
+
+    // 동적 크기의 반응기. 화학종 수와 반응 수를 컴파일 타임에 알 수 없는 경우 사용함.
+    using RxtorBase = RxtorBaseT<>;
 } // namespace chemprochelper
 
 #endif
\ No newline at end of file
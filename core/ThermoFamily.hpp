@@ -0,0 +1,6 @@
+/*
+core/ThermoFamily.hpp
+---------------------
+상태방정식 등 열역학 물성 계산을 정의함.
+*/
+#include "ThermoFamily/CubicEOS.hpp"
\ No newline at end of file
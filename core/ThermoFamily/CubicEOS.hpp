@@ -0,0 +1,339 @@
+/*
+core/ThermoFamily/CubicEOS.hpp
+------------------------------
+Peng-Robinson, Soave-Redlich-Kwong 3차 상태방정식 CubicEOS 클래스를 정의함.
+*/
+#ifndef _CHEMPROCHELPER_CUBICEOS
+#define _CHEMPROCHELPER_CUBICEOS
+
+namespace chemprochelper
+{
+    /*
+    3차 상태방정식 클래스.
+    --------------------
+    P = RT / (V - b) - a(T) / ((V + d1 b)(V + d2 b))로 혼합물의 압축 인자 Z와 퓨개시티 계수 ln phi를 계산함.
+        PR : d1 = 1 + sqrt(2), d2 = 1 - sqrt(2), SRK : d1 = 1, d2 = 0.
+        a_i = Omega_a (R Tc)^2 / Pc alpha(T), alpha = (1 + m (1 - sqrt(T / Tc)))^2, b_i = Omega_b R Tc / Pc.
+        a_m = sum_ij x_i x_j sqrt(a_i a_j) (1 - k_ij), b_m = sum_i x_i b_i. (2차 혼합 규칙)
+    Z는 3차 방정식을 해석적으로(Cardano, 삼각함수 해) 풀고 Newton 한 번으로 다듬음. 단위는 T [K], P [Pa].
+    a_ij = sqrt(a_i a_j) (1 - k_ij) 행렬은 온도가 바뀌거나 k_ij, 임계 상수가 바뀐 경우에만 다시 계산함.
+    calcLnPhiBatch는 같은 온도의 여러 상태(화학종 x 상태, 열 우선)를 한 번에 계산하며, sum_j a_ij x_j를 행렬 곱
+    하나로, ln phi를 화학종 x 상태 배열식으로 계산하므로 벡터화됨. 상태마다 n d(ln phi_i)/d(n_j)도 해석적으로 계산함.
+    calcKValue는 Flash::setKValueFunc에 넘길 수 있는 K = phi_L(x) / phi_V(y)를 계산함.
+
+    CubicEOS는 다음과 같은 멤버 변수를 가짐.
+    private:
+        _Model : 상태방정식의 종류를 저장함.
+        _ChemIdx : 화학종의 포인터를 저장함.
+        _TcVec, _PcVec, _OmegaVec : 화학종별 임계 온도, 임계 압력, 이심 인자를 저장함.
+        _KijMat : 이성분 상호작용 계수 k_ij를 저장함. (대칭)
+        _CacheTemp : _AijMat, _BVec을 계산한 온도를 저장함. 캐시가 무효이면 NaN.
+        _AijMat, _BVec : 온도 _CacheTemp에서의 a_ij와 b_i를 저장함.
+    */
+    class CubicEOS
+    {
+        public:
+
+            // 상태방정식의 종류
+            enum ModelType {PR, SRK};
+
+            // 3차 방정식의 근을 고르는 방법. Stable은 Gibbs 에너지가 작은 근을 고름.
+            enum PhaseType {Liquid, Vapor, Stable};
+
+        private:
+
+            ModelType _Model = PR;
+
+            std::vector<ChemBase*> _ChemIdx;
+            Eigen::VectorXd _TcVec;
+            Eigen::VectorXd _PcVec;
+            Eigen::VectorXd _OmegaVec;
+            Eigen::MatrixXd _KijMat;
+
+            double _CacheTemp = std::numeric_limits<double>::quiet_NaN();
+            Eigen::MatrixXd _AijMat;
+            Eigen::VectorXd _BVec;
+
+            double _delta1() const {return (_Model == PR) ? 1.0 + std::sqrt(2.0) : 1.0;}
+            double _delta2() const {return (_Model == PR) ? 1.0 - std::sqrt(2.0) : 0.0;}
+
+            // 온도 Temp에서의 a_ij, b_i를 계산함. 같은 온도이면 할당 없이 끝남.
+            void _updateCache(const double& Temp)
+            {
+                if (Temp == _CacheTemp) return;
+                if (Temp <= 0) throw std::runtime_error("Temperature must be positive.");
+
+                const double omegaA = (_Model == PR) ? 0.45723553 : 0.42748023;
+                const double omegaB = (_Model == PR) ? 0.07779607 : 0.08664035;
+                const int chemNum = _ChemIdx.size();
+
+                Eigen::VectorXd sqrtA(chemNum);
+                _BVec.resize(chemNum);
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    const double w = _OmegaVec[i];
+                    const double m = (_Model == PR) ? 0.37464 + 1.54226 * w - 0.26992 * w * w : 0.480 + 1.574 * w - 0.176 * w * w;
+                    const double alpha = 1.0 + m * (1.0 - std::sqrt(Temp / _TcVec[i]));
+                    const double rtc = const_variables::gasConst * _TcVec[i];
+
+                    sqrtA[i] = std::sqrt(omegaA * rtc * rtc / _PcVec[i]) * alpha;
+                    _BVec[i] = omegaB * rtc / _PcVec[i];
+                }
+
+                _AijMat = (sqrtA * sqrtA.transpose()).cwiseProduct((1.0 - _KijMat.array()).matrix());
+                _CacheTemp = Temp;
+            }
+
+            // 3차 방정식 Z^3 + c2 Z^2 + c1 Z + c0 = 0의 근 중 Phase에 맞는 근을 반환함.
+            double _solveZ(const double& A, const double& B, const PhaseType& Phase) const
+            {
+                const double u = _delta1() + _delta2(), w = _delta1() * _delta2();
+                const double c2 = -(1.0 + B - u * B);
+                const double c1 = A + w * B * B - u * B - u * B * B;
+                const double c0 = -(A * B + w * B * B + w * B * B * B);
+
+                // Z = t - c2 / 3로 t^3 + p t + q = 0을 풂.
+                const double p = c1 - c2 * c2 / 3.0;
+                const double q = 2.0 * c2 * c2 * c2 / 27.0 - c2 * c1 / 3.0 + c0;
+                const double disc = q * q / 4.0 + p * p * p / 27.0;
+
+                double zMin, zMax;
+                if (disc > 0)
+                {
+                    const double sq = std::sqrt(disc);
+                    zMin = zMax = std::cbrt(-q / 2.0 + sq) + std::cbrt(-q / 2.0 - sq) - c2 / 3.0;
+                }
+                else
+                {
+                    const double r = 2.0 * std::sqrt(-p / 3.0);
+                    const double phi = std::acos(std::clamp(3.0 * q / (p * r), -1.0, 1.0)) / 3.0;
+                    const double pi = std::acos(-1.0);
+                    zMax = r * std::cos(phi) - c2 / 3.0;
+                    zMin = r * std::cos(phi + 2.0 * pi / 3.0) - c2 / 3.0;
+                }
+
+                // 반올림 오차를 Newton 한 번으로 다듬음.
+                auto polish = [&](double z)
+                {
+                    const double dF = (3.0 * z + 2.0 * c2) * z + c1;
+                    if (dF != 0) z -= (((z + c2) * z + c1) * z + c0) / dF;
+                    return z;
+                };
+                zMax = polish(zMax);
+                zMin = polish(zMin);
+                if (zMin <= B) zMin = zMax;
+
+                if (Phase == Liquid) return zMin;
+                if (Phase == Vapor || zMin == zMax) return zMax;
+
+                // 잔류 Gibbs 에너지 G^R / (n R T)가 작은 근을 고름.
+                const double d1 = _delta1(), d2 = _delta2();
+                auto gibbs = [&](const double& z)
+                {
+                    return z - 1.0 - std::log(z - B) - A / (B * (d1 - d2)) * std::log((z + d1 * B) / (z + d2 * B));
+                };
+                return (gibbs(zMin) < gibbs(zMax)) ? zMin : zMax;
+            }
+
+        public:
+
+            // 생성자 정의부
+
+            // 디폴트 생성자. Peng-Robinson 상태방정식을 사용함.
+            CubicEOS() = default;
+
+            CubicEOS(const ModelType& Model):
+                _Model(Model) {}
+
+            // getter 정의부
+
+            auto getModel() const {return _Model;}
+            auto getChemIdx() const {return _ChemIdx;}
+            int getChemNum() const {return _ChemIdx.size();}
+
+            // 화학종 ChemPtr의 위치를 반환함. 없는 경우 runtime error 발생.
+            int getChemPos(ChemBase* ChemPtr) const
+            {
+                if (!functions::inVector(_ChemIdx, ChemPtr)) throw std::runtime_error("Critical constants of " + ChemPtr->getAbb() + " aren't specified.");
+                return functions::getVecPos(_ChemIdx, ChemPtr);
+            }
+
+            double getKij(ChemBase* ChemPtr1, ChemBase* ChemPtr2) const {return _KijMat(getChemPos(ChemPtr1), getChemPos(ChemPtr2));}
+
+            // setter 정의부
+
+            void setModel(const ModelType& Model)
+            {
+                _Model = Model;
+                _CacheTemp = std::numeric_limits<double>::quiet_NaN();
+            }
+
+            // 화학종 ChemPtr의 임계 온도 Tc [K], 임계 압력 Pc [Pa], 이심 인자 Omega를 지정함. 새 화학종이면 추가함.
+            void setCritical(ChemBase* ChemPtr, const double& Tc, const double& Pc, const double& Omega)
+            {
+                if (Tc <= 0 || Pc <= 0) throw std::runtime_error("Critical constants must be positive.");
+
+                int pos = _ChemIdx.size();
+                if (functions::inVector(_ChemIdx, ChemPtr)) pos = functions::getVecPos(_ChemIdx, ChemPtr);
+                else
+                {
+                    _ChemIdx.push_back(ChemPtr);
+                    _TcVec.conservativeResize(pos + 1);
+                    _PcVec.conservativeResize(pos + 1);
+                    _OmegaVec.conservativeResize(pos + 1);
+                    _KijMat.conservativeResize(pos + 1, pos + 1);
+                    _KijMat.row(pos).setZero();
+                    _KijMat.col(pos).setZero();
+                }
+
+                _TcVec[pos] = Tc;
+                _PcVec[pos] = Pc;
+                _OmegaVec[pos] = Omega;
+                _CacheTemp = std::numeric_limits<double>::quiet_NaN();
+            }
+
+            // 이성분 상호작용 계수 k_ij를 대칭으로 지정함.
+            void setKij(ChemBase* ChemPtr1, ChemBase* ChemPtr2, const double& Kij)
+            {
+                const int i = getChemPos(ChemPtr1), j = getChemPos(ChemPtr2);
+                _KijMat(i, j) = Kij;
+                _KijMat(j, i) = Kij;
+                _CacheTemp = std::numeric_limits<double>::quiet_NaN();
+            }
+
+            // 인스턴스 정의부
+
+            /*
+            온도 Temp에서 상태 n(열 n)의 압력 PresVec[n], 몰분율 XMat.col(n)(getChemIdx() 순서)의 ln phi를 LnPhiMat에,
+            압축 인자를 ZVec에 계산함. DLnPhiVec이 nullptr이 아니면 상태마다 n d(ln phi_i)/d(n_j)(대칭, 화학종 x 화학종)를
+            계산함. 몰분율의 합이 1이 아니면 정규화해서 사용함.
+            */
+            void calcLnPhiBatch(const double& Temp, const Eigen::VectorXd& PresVec, const Eigen::MatrixXd& XMat,
+                const PhaseType& Phase, Eigen::MatrixXd& LnPhiMat, Eigen::VectorXd& ZVec,
+                std::vector<Eigen::MatrixXd>* DLnPhiVec = nullptr)
+            {
+                const int chemNum = _ChemIdx.size();
+                const int stateNum = XMat.cols();
+                if (XMat.rows() != chemNum || PresVec.size() != stateNum) throw std::runtime_error("The size of states does not match.");
+
+                _updateCache(Temp);
+
+                const double d1 = _delta1(), d2 = _delta2();
+                const double u = d1 + d2, w = d1 * d2;
+                const double rt = const_variables::gasConst * Temp;
+
+                // 혼합 규칙은 상태 전체에 대한 행렬 연산으로 계산함.
+                const Eigen::MatrixXd x = XMat.array().rowwise() / XMat.colwise().sum().array();
+                const Eigen::MatrixXd sMat = _AijMat * x;
+                const Eigen::ArrayXd amVec = x.cwiseProduct(sMat).colwise().sum().transpose().array();
+                const Eigen::ArrayXd bmVec = (_BVec.transpose() * x).transpose().array();
+                const Eigen::ArrayXd aVec = amVec * PresVec.array() / (rt * rt);
+                const Eigen::ArrayXd bVec = bmVec * PresVec.array() / rt;
+
+                ZVec.resize(stateNum);
+                for (auto n = 0; n < stateNum; ++n) ZVec[n] = _solveZ(aVec[n], bVec[n], Phase);
+                const Eigen::ArrayXd z = ZVec.array();
+
+                const Eigen::ArrayXd lnRatio = ((z + d1 * bVec) / (z + d2 * bVec)).log();
+                const Eigen::ArrayXd coefVec = aVec / (bVec * (d1 - d2)) * lnRatio;
+
+                // ln phi_i = b_i / b_m (Z - 1) - ln(Z - B) - A / (B (d1 - d2)) (2 s_i / a_m - b_i / b_m) ln((Z + d1 B) / (Z + d2 B))
+                LnPhiMat = (_BVec * ((z - 1.0 + coefVec) / bmVec).matrix().transpose()).array().rowwise()
+                    - (z - bVec).log().transpose()
+                    - (sMat.array().rowwise() * (2.0 * coefVec / amVec).transpose());
+
+                if (DLnPhiVec == nullptr) return;
+
+                DLnPhiVec->resize(stateNum);
+                for (auto n = 0; n < stateNum; ++n)
+                {
+                    const double zn = z[n], an = aVec[n], bn = bVec[n], am = amVec[n], bm = bmVec[n];
+                    const auto s = sMat.col(n);
+
+                    // x_j에 대한 A, B, Z의 미분. (x를 독립 변수로 봄)
+                    const Eigen::VectorXd ax = (2.0 * an / am) * s;
+                    const Eigen::VectorXd bx = (bn / bm) * _BVec;
+                    const double fz = (3.0 * zn + 2.0 * (-(1.0 + bn - u * bn))) * zn + (an + w * bn * bn - u * bn - u * bn * bn);
+                    const double fa = zn - bn;
+                    const double fb = (u - 1.0) * zn * zn + (2.0 * w * bn - u - 2.0 * u * bn) * zn - an - 2.0 * w * bn - 3.0 * w * bn * bn;
+                    const Eigen::VectorXd zx = -(fa * ax + fb * bx) / fz;
+
+                    const double q = an / (bn * (d1 - d2));
+                    const Eigen::VectorXd qx = (ax * bn - an * bx) / (bn * bn * (d1 - d2));
+                    const Eigen::VectorXd r = 2.0 * s / am - _BVec / bm;
+                    const Eigen::VectorXd lx = (zx + d1 * bx) / (zn + d1 * bn) - (zx + d2 * bx) / (zn + d2 * bn);
+                    const double l = lnRatio[n];
+
+                    Eigen::MatrixXd jx = (-(zn - 1.0) / (bm * bm)) * _BVec * _BVec.transpose() + (1.0 / bm) * _BVec * zx.transpose();
+                    jx.rowwise() -= (zx - bx).transpose() / (zn - bn);
+                    jx -= (l * r) * qx.transpose() + (q * l) * (2.0 * _AijMat / am - (4.0 / (am * am)) * s * s.transpose()
+                        + _BVec * _BVec.transpose() / (bm * bm)) + q * r * lx.transpose();
+
+                    // n d(ln phi_i)/d(n_j) = d(ln phi_i)/d(x_j) - sum_k x_k d(ln phi_i)/d(x_k)
+                    (*DLnPhiVec)[n] = jx.colwise() - jx * x.col(n);
+                }
+            }
+
+            // 상태 하나의 ln phi를 LnPhi에 계산하고 압축 인자를 반환함. DLnPhi가 nullptr이 아니면 n d(ln phi_i)/d(n_j)도 계산함.
+            double calcLnPhi(const double& Temp, const double& Pres, const Eigen::VectorXd& X, const PhaseType& Phase,
+                Eigen::VectorXd& LnPhi, Eigen::MatrixXd* DLnPhi = nullptr)
+            {
+                Eigen::MatrixXd lnPhiMat;
+                Eigen::VectorXd zVec;
+                std::vector<Eigen::MatrixXd> dLnPhiVec;
+
+                calcLnPhiBatch(Temp, Eigen::VectorXd::Constant(1, Pres), X, Phase, lnPhiMat, zVec,
+                    (DLnPhi == nullptr) ? nullptr : &dLnPhiVec);
+
+                LnPhi = lnPhiMat.col(0);
+                if (DLnPhi != nullptr) *DLnPhi = dLnPhiVec[0];
+                return zVec[0];
+            }
+
+            // Wilson 식으로 ChemIdx 순서의 K 값 초기 추정값을 K에 계산함.
+            void calcWilsonK(const std::vector<ChemBase*>& ChemIdx, const double& Temp, const double& Pres, Eigen::VectorXd& K) const
+            {
+                K.resize(ChemIdx.size());
+                for (auto i = 0; i < ChemIdx.size(); ++i)
+                {
+                    const int pos = getChemPos(ChemIdx[i]);
+                    K[i] = _PcVec[pos] / Pres * std::exp(5.373 * (1.0 + _OmegaVec[pos]) * (1.0 - _TcVec[pos] / Temp));
+                }
+            }
+
+            /*
+            ChemIdx 순서의 액상 몰분율 x, 기상 몰분율 y에서 K = phi_L(x) / phi_V(y)를 K에 계산함.
+            Flash::setKValueFunc에 넘길 수 있으며, 처음 추정(x = y)에서는 Wilson 식을 사용함.
+            */
+            void calcKValue(const std::vector<ChemBase*>& ChemIdx, const double& Temp, const double& Pres,
+                const Eigen::VectorXd& x, const Eigen::VectorXd& y, Eigen::VectorXd& K)
+            {
+                if (x == y)
+                {
+                    calcWilsonK(ChemIdx, Temp, Pres, K);
+                    return;
+                }
+
+                // ChemIdx에 없는 화학종은 몰분율 0으로 계산함.
+                const int chemNum = _ChemIdx.size();
+                std::vector<int> posVec(ChemIdx.size());
+                Eigen::MatrixXd xMat = Eigen::MatrixXd::Zero(chemNum, 2);
+                for (auto i = 0; i < ChemIdx.size(); ++i)
+                {
+                    posVec[i] = getChemPos(ChemIdx[i]);
+                    xMat(posVec[i], 0) = x[i];
+                    xMat(posVec[i], 1) = y[i];
+                }
+
+                Eigen::MatrixXd liqMat, vapMat;
+                Eigen::VectorXd zVec;
+                calcLnPhiBatch(Temp, Eigen::VectorXd::Constant(1, Pres), xMat.col(0), Liquid, liqMat, zVec);
+                calcLnPhiBatch(Temp, Eigen::VectorXd::Constant(1, Pres), xMat.col(1), Vapor, vapMat, zVec);
+
+                K.resize(ChemIdx.size());
+                for (auto i = 0; i < ChemIdx.size(); ++i) K[i] = std::exp(liqMat(posVec[i], 0) - vapMat(posVec[i], 0));
+            }
+    };
+} // namespace chemprochelper
+
+#endif
\ No newline at end of file
@@ -40,9 +40,10 @@ int main()
         )
     );
 
-    std::vector<chemprochelper::RxtorBase> RxtorBaseVec;
+    // 아민화 반응기 : 화학종 5개, 반응 2개이므로 고정 크기 반응기를 사용함.
+    std::vector<chemprochelper::RxtorBaseT<5, 2>> RxtorBaseVec;
     RxtorBaseVec.push_back(
-        chemprochelper::RxtorBase(
+        chemprochelper::RxtorBaseT<5, 2>(
             &StreamBaseVec[0], &StreamBaseVec[1], &RxnBaseVec[0]
         )
     );
@@ -0,0 +1,102 @@
+/*
+tests/CSTRSteadyStateTest.cpp
+-----------------------------
+CSTR::solveSteadyState와 supportDirection을 검사함.
+    - RxnBase로 만든 CSTR(전화율 지정) : 같은 입력의 RxtorBase와 같은 출구, 같은 지원 방향, Backward 계산.
+    - SpeedRxnBase로 만든 CSTR : 정상 상태 A -> B (r = k C_A)의 닫힌 해 N_A = F_A V / (v + k V).
+      입구 몰 유량이 커도 같은 상대 정밀도로 풀림.
+    - 정상 상태가 없는 경우(r = -k C_A, k > v / V이면 holdup이 지수적으로 증가) : runtime error 발생.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// Func가 runtime error를 던지면 true를 반환함.
+template <typename FuncType>
+bool throws(FuncType Func)
+{
+    try
+    {
+        Func();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    ChemBase A("A"), B("B");
+
+    // 전화율이 지정된 CSTR은 RxtorBase와 같음.
+    {
+        RxnBase rxn(std::vector<std::string>{"A = B"});
+
+        StreamBase in(std::vector<ChemBase*>{&A, &B}, std::vector<float>{10, 1});
+        StreamBase out(std::vector<ChemBase*>{&A, &B});
+        CSTR cstr(&in, &out, &rxn);
+        cstr.setScalarVec({2});
+
+        StreamBase refOut(std::vector<ChemBase*>{&A, &B});
+        RxtorBase ref(&in, &refOut, &rxn);
+        ref.setScalarVec({2});
+
+        for (auto dir : {ProcObjBase::Forward, ProcObjBase::Backward, ProcObjBase::Estimate})
+        {
+            check(cstr.supportDirection(dir) == ref.supportDirection(dir), "conversion CSTR supports the same directions as RxtorBase");
+        }
+
+        check(!throws([&]() {cstr.solveSteadyState();}), "conversion CSTR solves without SpeedRxnBase");
+        ref.solveSteadyState();
+        checkNear(out.getChemMol(&A), refOut.getChemMol(&A), 1e-6, 0, "conversion CSTR outlet A matches RxtorBase");
+        checkNear(out.getChemMol(&B), refOut.getChemMol(&B), 1e-6, 0, "conversion CSTR outlet B matches RxtorBase");
+        checkNear(out.getChemMol(&A), 8, 1e-5, 0, "conversion CSTR outlet A");
+
+        // Backward : 출구로부터 입구를 계산함.
+        StreamBase in2(std::vector<ChemBase*>{&A, &B});
+        StreamBase out2(std::vector<ChemBase*>{&A, &B}, std::vector<float>{8, 3});
+        CSTR back(&in2, &out2, &rxn);
+        back.setScalarVec({2});
+        check(!throws([&]() {back.solveDirection(ProcObjBase::Backward);}), "conversion CSTR solves backward");
+        checkNear(in2.getChemMol(&A), 10, 1e-5, 0, "backward inlet A");
+        checkNear(in2.getChemMol(&B), 1, 1e-5, 0, "backward inlet B");
+    }
+
+    // 속도식 CSTR : 입구 몰 유량의 크기와 관계없이 닫힌 해와 맞음.
+    {
+        const double k = 2.0;
+        SpeedRxnBase rxn(std::vector<std::string>{"A = B"}, [k](const double* c, double* r){r[0] = k * c[0];});
+
+        for (auto feed : {10.0f, 1e5f})
+        {
+            StreamBase in(std::vector<ChemBase*>{&A, &B}, std::vector<float>{feed, 0});
+            StreamBase out(std::vector<ChemBase*>{&A, &B});
+            CSTR cstr(&in, &out, &rxn, 1.0f, 1.0f);
+
+            check(cstr.supportDirection(ProcObjBase::Forward) && !cstr.supportDirection(ProcObjBase::Backward), "rate CSTR supports Forward only");
+            check(!throws([&]() {cstr.solveSteadyState();}), "rate CSTR reaches a steady state");
+            checkNear(out.getChemMol(&A), feed / (1.0 + k), 0, 1e-5, "rate CSTR outlet A (feed " + std::to_string(feed) + ")");
+            checkNear(out.getChemMol(&A) + out.getChemMol(&B), feed, 0, 1e-5, "rate CSTR conserves moles");
+        }
+    }
+
+    // 정상 상태가 없는 경우
+    {
+        const double k = 1.001;
+        SpeedRxnBase rxn(std::vector<std::string>{"A = B"}, [k](const double* c, double* r){r[0] = -k * c[0];});
+
+        StreamBase in(std::vector<ChemBase*>{&A, &B}, std::vector<float>{10, 10});
+        StreamBase out(std::vector<ChemBase*>{&A, &B});
+        CSTR cstr(&in, &out, &rxn, 1.0f, 1.0f);
+
+        check(throws([&]() {cstr.solveSteadyState();}), "growing holdup throws instead of returning a transient state");
+    }
+
+    return testhelper::report("CSTRSteadyStateTest");
+}
\ No newline at end of file
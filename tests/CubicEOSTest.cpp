@@ -0,0 +1,137 @@
+/*
+tests/CubicEOSTest.cpp
+----------------------
+CubicEOS(PR, SRK)의 ln phi를 유한 차분과 비교함. 기준값은 CubicEOS를 거치지 않고 임계 상수로부터 다시 계산한
+잔류 Gibbs 에너지 n G^R / (R T) = n [Z - 1 - ln(Z - B) - A / (B (d1 - d2)) ln((Z + d1 B) / (Z + d2 B))]로 구함.
+    - ln phi_i = d(n G^R / (R T)) / d(n_i) (T, P 일정, 중앙 차분)
+    - n d(ln phi_i)/d(n_j) = ln phi의 중앙 차분
+    - Z가 상태방정식 Z / (Z - B) - A Z / ((Z + d1 B)(Z + d2 B)) = Z를 만족하는지
+기상과 액상, 0이 아닌 k_ij를 포함함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// 임계 상수와 k_ij로부터 계산하는 기준 모델
+struct Reference
+{
+    CubicEOS::ModelType Model;
+    Eigen::VectorXd Tc, Pc, Omega;
+    Eigen::MatrixXd Kij;
+
+    double delta1() const {return (Model == CubicEOS::PR) ? 1.0 + std::sqrt(2.0) : 1.0;}
+    double delta2() const {return (Model == CubicEOS::PR) ? 1.0 - std::sqrt(2.0) : 0.0;}
+
+    // 몰수 N에서 무차원 A, B를 계산함.
+    void calcAB(const double& Temp, const double& Pres, const Eigen::VectorXd& N, double& A, double& B) const
+    {
+        const double rt = const_variables::gasConst * Temp;
+        const double omegaA = (Model == CubicEOS::PR) ? 0.45723553 : 0.42748023;
+        const double omegaB = (Model == CubicEOS::PR) ? 0.07779607 : 0.08664035;
+        const Eigen::VectorXd x = N / N.sum();
+
+        const int chemNum = x.size();
+        Eigen::VectorXd a(chemNum), b(chemNum);
+        for (auto i = 0; i < chemNum; ++i)
+        {
+            const double w = Omega[i];
+            const double m = (Model == CubicEOS::PR) ? 0.37464 + 1.54226 * w - 0.26992 * w * w : 0.480 + 1.574 * w - 0.176 * w * w;
+            const double alpha = std::pow(1.0 + m * (1.0 - std::sqrt(Temp / Tc[i])), 2);
+            a[i] = omegaA * std::pow(const_variables::gasConst * Tc[i], 2) / Pc[i] * alpha;
+            b[i] = omegaB * const_variables::gasConst * Tc[i] / Pc[i];
+        }
+
+        double am = 0;
+        for (auto i = 0; i < chemNum; ++i)
+        {
+            for (auto j = 0; j < chemNum; ++j) am += x[i] * x[j] * std::sqrt(a[i] * a[j]) * (1.0 - Kij(i, j));
+        }
+        A = am * Pres / (rt * rt);
+        B = x.dot(b) * Pres / rt;
+    }
+
+    // 몰수 N, 압축 인자 Z에서 n G^R / (R T)를 계산함.
+    double calcGibbs(const double& Temp, const double& Pres, const Eigen::VectorXd& N, const double& Z) const
+    {
+        double A, B;
+        calcAB(Temp, Pres, N, A, B);
+        const double d1 = delta1(), d2 = delta2();
+        return N.sum() * (Z - 1.0 - std::log(Z - B) - A / (B * (d1 - d2)) * std::log((Z + d1 * B) / (Z + d2 * B)));
+    }
+};
+
+void checkModel(const CubicEOS::ModelType& Model, const std::string& Name)
+{
+    ChemBase C1("C1"), C3("C3"), C4("nC4"), CO2("CO2");
+
+    Reference ref;
+    ref.Model = Model;
+    ref.Tc = Eigen::Vector4d(190.56, 369.83, 425.12, 304.13);
+    ref.Pc = Eigen::Vector4d(4.599e6, 4.248e6, 3.796e6, 7.377e6);
+    ref.Omega = Eigen::Vector4d(0.011, 0.152, 0.200, 0.224);
+    ref.Kij = Eigen::Matrix4d::Zero();
+    ref.Kij(0, 3) = ref.Kij(3, 0) = 0.1;
+    ref.Kij(1, 3) = ref.Kij(3, 1) = 0.12;
+
+    CubicEOS eos(Model);
+    const std::vector<ChemBase*> chemVec = {&C1, &C3, &C4, &CO2};
+    for (auto i = 0; i < 4; ++i) eos.setCritical(chemVec[i], ref.Tc[i], ref.Pc[i], ref.Omega[i]);
+    eos.setKij(&C1, &CO2, 0.1);
+    eos.setKij(&C3, &CO2, 0.12);
+
+    const double temp = 320, pres = 6e6;
+    for (auto phase : {CubicEOS::Vapor, CubicEOS::Liquid})
+    {
+        const auto tag = Name + ((phase == CubicEOS::Vapor) ? " vapor" : " liquid");
+        const Eigen::Vector4d n = (phase == CubicEOS::Vapor) ? Eigen::Vector4d(0.4, 0.3, 0.2, 0.1) : Eigen::Vector4d(0.05, 0.3, 0.55, 0.1);
+
+        Eigen::VectorXd lnPhi;
+        Eigen::MatrixXd dLnPhi;
+        const double z = eos.calcLnPhi(temp, pres, n, phase, lnPhi, &dLnPhi);
+
+        // 상태방정식 잔차
+        double A, B;
+        ref.calcAB(temp, pres, n, A, B);
+        const double resid = z / (z - B) - A * z / ((z + ref.delta1() * B) * (z + ref.delta2() * B)) - z;
+        checkNear(resid, 0, 1e-10, 0, tag + " Z satisfies the equation of state");
+
+        Eigen::VectorXd otherLnPhi;
+        const double otherZ = eos.calcLnPhi(temp, pres, n, (phase == CubicEOS::Vapor) ? CubicEOS::Liquid : CubicEOS::Vapor, otherLnPhi);
+        check((phase == CubicEOS::Vapor) ? (z >= otherZ) : (z <= otherZ), tag + " picks the requested root");
+
+        // ln phi_i = d(n G^R / (R T)) / d(n_i)
+        const double h = 1e-5;
+        Eigen::VectorXd fdLnPhi(4);
+        Eigen::MatrixXd fdDLnPhi(4, 4);
+        for (auto i = 0; i < 4; ++i)
+        {
+            Eigen::VectorXd np = n, nm = n, lp, lm;
+            np[i] += h;
+            nm[i] -= h;
+            const double zp = eos.calcLnPhi(temp, pres, np, phase, lp);
+            const double zm = eos.calcLnPhi(temp, pres, nm, phase, lm);
+
+            fdLnPhi[i] = (ref.calcGibbs(temp, pres, np, zp) - ref.calcGibbs(temp, pres, nm, zm)) / (2 * h);
+            fdDLnPhi.col(i) = n.sum() * (lp - lm) / (2 * h);
+        }
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            checkNear(lnPhi[i], fdLnPhi[i], 1e-7, 1e-6, tag + " ln phi of " + chemVec[i]->getAbb() + " matches the finite difference");
+        }
+        checkNear((dLnPhi - fdDLnPhi).cwiseAbs().maxCoeff(), 0, 1e-6, 0, tag + " n d(ln phi)/dn matches the finite difference");
+        checkNear((n.transpose() * dLnPhi).cwiseAbs().maxCoeff(), 0, 1e-10, 0, tag + " n d(ln phi)/dn satisfies Gibbs-Duhem");
+    }
+}
+
+int main()
+{
+    checkModel(CubicEOS::PR, "PR");
+    checkModel(CubicEOS::SRK, "SRK");
+
+    return testhelper::report("CubicEOSTest");
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+/*
+tests/DOFTest.cpp
+-----------------
+Flowsheet::analyzeDOF와 solveDOF를 검사함.
+    - 올바른 사양 : CSTR(전화율, Backward) -> Mixer(입구 역산, Backward) -> RxtorBase(Forward) -> Splitter(Estimate)
+    - 사양이 지나친 경우 : 모든 스트림이 알려진 Mixer
+    - 사양이 모자란 경우 : 입/출력을 모두 모르는 반응기, 속도식 CSTR의 Backward
+    - 순환 블록 : 블록 단계 뒤에 하류 단위 공정이 옴
+StepVec의 순서와 방향, Valid, 그리고 solveDOF가 스트림을 쓰기 전에 runtime error를 던지는지 확인함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// Func가 runtime error를 던지면 true를 반환함.
+template <typename FuncType>
+bool throws(FuncType Func)
+{
+    try
+    {
+        Func();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+// StepVec이 (단위 공정, 방향) 순서와 같은지 확인함.
+bool sameSteps(const DOFResult& Res, const std::vector<std::pair<ProcObjBase*, ProcObjBase::DirectionType>>& Ref)
+{
+    if (Res.StepVec.size() != Ref.size()) return false;
+    for (auto k = 0; k < Ref.size(); ++k)
+    {
+        if (Res.StepVec[k].Block >= 0 || Res.StepVec[k].UnitPtr != Ref[k].first || Res.StepVec[k].Direction != Ref[k].second) return false;
+    }
+    return true;
+}
+
+int main()
+{
+    ChemBase A("A"), B("B");
+    const std::vector<ChemBase*> chemVec = {&A, &B};
+    RxnBase rxn(std::vector<std::string>{"A = B"});
+
+    auto unknown = [&]()
+    {
+        StreamBase stream(chemVec, std::vector<float>{0, 0});
+        stream.setAllUnknown();
+        return stream;
+    };
+
+    // 올바른 사양
+    {
+        StreamBase q = unknown(), x = unknown(), y = unknown();
+        StreamBase f(chemVec, std::vector<float>{10, 3});
+        StreamBase m(chemVec, std::vector<float>{15, 3});
+        StreamBase p1(chemVec, std::vector<float>{1.2f, 0.8f});
+        StreamBase p2(chemVec, std::vector<float>{1.8f, 1.2f});
+
+        CSTR cstr(&q, &f, &rxn);
+        cstr.setScalarVec({2});
+        MixerBase mixer({&f, &x}, &m);
+        RxtorBase rxtor(&x, &y, &rxn);
+        rxtor.setScalarVec({2});
+        SplitterBase splitter(&y, {&p1, &p2});
+
+        Flowsheet flowsheet({&splitter, &rxtor, &mixer, &cstr});
+        const auto dof = flowsheet.analyzeDOF();
+
+        check(dof.Valid, "consistent specification is valid");
+        check(dof.UnknownNum == 0 && dof.OverSpecified.empty() && dof.UnderSpecified.empty(), "consistent specification has no leftover");
+        check(sameSteps(dof, {{&cstr, ProcObjBase::Backward}, {&mixer, ProcObjBase::Backward},
+            {&rxtor, ProcObjBase::Forward}, {&splitter, ProcObjBase::Estimate}}), "steps are CSTR backward, mixer backward, reactor forward, splitter estimate");
+
+        check(!throws([&]() {flowsheet.solveDOF();}), "solveDOF runs the valid specification");
+        checkNear(q.getChemMol(&A), 12, 1e-5, 1e-5, "CSTR back-calculates inlet A");
+        checkNear(q.getChemMol(&B), 1, 1e-5, 1e-5, "CSTR back-calculates inlet B");
+        checkNear(x.getChemMol(&A), 5, 1e-5, 1e-5, "mixer back-calculates the unknown inlet");
+        checkNear(y.getChemMol(&B), 2, 1e-5, 1e-5, "reactor computes its outlet");
+        const auto frac = splitter.getSplitFrac();
+        check(frac.size() == 2, "splitter estimates one fraction per outlet");
+        if (frac.size() == 2) checkNear(frac[0], 0.4, 1e-5, 1e-5, "splitter estimates the split fraction");
+    }
+
+    // 사양이 지나친 경우. 앞의 반응기를 풀기 전에 오류가 나야 함.
+    {
+        StreamBase f(chemVec, std::vector<float>{10, 0});
+        StreamBase out = unknown();
+        StreamBase g(chemVec, std::vector<float>{1, 1});
+        StreamBase m(chemVec, std::vector<float>{5, 5});
+
+        RxtorBase rxtor(&f, &out, &rxn);
+        rxtor.setScalarVec({1});
+        MixerBase mixer({&f, &g}, &m);
+
+        Flowsheet flowsheet({&rxtor, &mixer});
+        const auto dof = flowsheet.analyzeDOF();
+        check(!dof.Valid, "over-specification is invalid");
+        check(dof.OverSpecified.size() == 1 && dof.OverSpecified[0] == &mixer, "the fully known mixer is over-specified");
+
+        check(throws([&]() {flowsheet.solveDOF();}), "solveDOF throws on over-specification");
+        check(!out.chemMolIsAllKnown(), "no stream is written before the over-specification error");
+        checkNear(m.getChemMol(&A), 5, 0, 0, "specified mixer outlet is kept");
+    }
+
+    // 사양이 모자란 경우. 속도식 CSTR은 Backward를 지원하지 않음.
+    {
+        SpeedRxnBase speedRxn(std::vector<std::string>{"A = B"}, [](const double* c, double* r){r[0] = c[0];});
+
+        StreamBase f(chemVec, std::vector<float>{10, 0});
+        StreamBase out = unknown(), q = unknown(), r = unknown();
+        StreamBase cstrOut(chemVec, std::vector<float>{4, 6});
+
+        RxtorBase rxtor(&f, &out, &rxn);
+        rxtor.setScalarVec({1});
+        RxtorBase idle(&q, &r, &rxn);
+        CSTR cstr(&q, &cstrOut, &speedRxn, 1.0f, 1.0f);
+
+        Flowsheet flowsheet({&rxtor, &idle, &cstr});
+        const auto dof = flowsheet.analyzeDOF();
+        check(!dof.Valid && dof.OverSpecified.empty(), "under-specification is invalid but not over-specified");
+        check(dof.UnderSpecified.size() == 2 && functions::inVector(dof.UnderSpecified, static_cast<ProcObjBase*>(&idle))
+            && functions::inVector(dof.UnderSpecified, static_cast<ProcObjBase*>(&cstr)), "reactor without streams and rate CSTR are under-specified");
+        check(dof.UnknownNum == 4, "two unknown streams are left");
+        check(sameSteps(dof, {{&rxtor, ProcObjBase::Forward}}), "the solvable reactor is still scheduled");
+
+        check(throws([&]() {flowsheet.solveDOF();}), "solveDOF throws on under-specification");
+        check(!out.chemMolIsAllKnown(), "no stream is written before the under-specification error");
+    }
+
+    // 순환 블록
+    {
+        StreamBase f(chemVec, std::vector<float>{10, 0});
+        StreamBase rec = unknown(), m = unknown(), o = unknown(), prod = unknown(), fin = unknown();
+
+        MixerBase mixer({&f, &rec}, &m);
+        RxtorBase rxtor(&m, &o, &rxn);
+        rxtor.setScalarVec({3});
+        SplitterBase splitter(&o, {&rec, &prod}, std::vector<float>{0.5f, 0.5f});
+        RxtorBase after(&prod, &fin, &rxn);
+        after.setScalarVec({1});
+
+        Flowsheet flowsheet({&after, &splitter, &rxtor, &mixer});
+        const auto dof = flowsheet.analyzeDOF();
+        check(dof.Valid, "recycle specification is valid");
+        check(dof.StepVec.size() == 2 && dof.StepVec[0].Block >= 0, "recycle block is solved as one step");
+        check(dof.StepVec.size() == 2 && dof.StepVec[1].UnitPtr == &after && dof.StepVec[1].Direction == ProcObjBase::Forward,
+            "downstream reactor follows the recycle block");
+
+        auto res = flowsheet.solveDOF();
+        check(res.size() == 1 && res[0].Converged, "recycle block converges");
+        // 정상 상태 : m = f + 0.5 (m - 3), prod = 0.5 (m - 3) 이므로 m_A = 17, prod_A = 7
+        checkNear(prod.getChemMol(&A), 7, 1e-3, 1e-4, "recycle product A");
+        checkNear(fin.getChemMol(&B), 4, 1e-3, 1e-4, "downstream reactor outlet B");
+    }
+
+    return testhelper::report("DOFTest");
+}
\ No newline at end of file
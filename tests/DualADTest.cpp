@@ -0,0 +1,140 @@
+/*
+tests/DualADTest.cpp
+--------------------
+Dual, HyperDual을 사용한 자동 미분(calcJacobAD, calcHessAD, SpeedRxnBase::calcRateAD)을 해석해와 비교함.
+    - 4 x 3 함수(exp, log, sqrt, 실수 지수, x^y)의 Jacobian과 값
+    - 3변수 스칼라 함수의 Hessian과 기울기
+    - 방향 수 N이 입력 수보다 작거나(나누어떨어지지 않는 경우 포함) 같은 경우, Eigen::Dynamic인 경우가 모두 같은지.
+    - 정수 차수의 x^p는 x = 0에서도 미분이 유한함.
+    - 질량 작용 속도식의 calcRateAD가 calcRateJacobian과 같고, 온도에 대한 미분이 중앙 차분과 같은지.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// f(x, y, z) = [x y e^z, ln x + sqrt(y) / z, x^2.5 y - x / y, x^y]
+auto vecFunc = [](const auto* x, auto* y)
+{
+    y[0] = x[0] * x[1] * exp(x[2]);
+    y[1] = log(x[0]) + sqrt(x[1]) / x[2];
+    y[2] = pow(x[0], 2.5) * x[1] - x[0] / x[1];
+    y[3] = pow(x[0], x[1]);
+};
+
+// g(x, y, z) = x^2 y + e^(xz) + z ln y + sqrt(xy)
+auto scalarFunc = [](const auto* x, auto* y)
+{
+    *y = x[0] * x[0] * x[1] + exp(x[0] * x[2]) + x[2] * log(x[1]) + sqrt(x[0] * x[1]);
+};
+
+double maxDiff(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B)
+{
+    return (A - B).cwiseAbs().maxCoeff();
+}
+
+int main()
+{
+    const double x = 1.3, y = 0.7, z = 0.4;
+    const std::vector<double> point = {x, y, z};
+
+    // Jacobian
+    {
+        Eigen::MatrixXd ref(4, 3);
+        ref << y * std::exp(z), x * std::exp(z), x * y * std::exp(z),
+               1.0 / x, 0.5 / (std::sqrt(y) * z), -std::sqrt(y) / (z * z),
+               2.5 * std::pow(x, 1.5) * y - 1.0 / y, std::pow(x, 2.5) + x / (y * y), 0,
+               y * std::pow(x, y - 1), std::pow(x, y) * std::log(x), 0;
+        const std::vector<double> refVal = {x * y * std::exp(z), std::log(x) + std::sqrt(y) / z,
+            std::pow(x, 2.5) * y - x / y, std::pow(x, y)};
+
+        std::vector<double> val;
+        const auto jac = functions::calcJacobAD<>(vecFunc, point, 4, &val);
+        checkNear(maxDiff(jac, ref), 0, 1e-13, 0, "dynamic Jacobian matches the closed form");
+        for (auto j = 0; j < 4; ++j) checkNear(val[j], refVal[j], 1e-14, 1e-14, "function value " + std::to_string(j));
+
+        checkNear(maxDiff(functions::calcJacobAD<1>(vecFunc, point, 4), ref), 0, 1e-13, 0, "N = 1 Jacobian matches the closed form");
+        checkNear(maxDiff(functions::calcJacobAD<2>(vecFunc, point, 4), ref), 0, 1e-13, 0, "N = 2 Jacobian matches the closed form");
+        checkNear(maxDiff(functions::calcJacobAD<3>(vecFunc, point, 4), ref), 0, 1e-13, 0, "N = 3 Jacobian matches the closed form");
+        checkNear(maxDiff(functions::calcJacobAD<8>(vecFunc, point, 4), ref), 0, 1e-13, 0, "N = 8 Jacobian matches the closed form");
+    }
+
+    // Hessian
+    {
+        const double e = std::exp(x * z), s = std::sqrt(x * y), s3 = s * s * s;
+        Eigen::MatrixXd ref(3, 3);
+        ref << 2 * y + z * z * e - 0.25 * y * y / s3, 2 * x + 0.25 / s, e * (1 + x * z),
+               2 * x + 0.25 / s, -z / (y * y) - 0.25 * x * x / s3, 1.0 / y,
+               e * (1 + x * z), 1.0 / y, x * x * e;
+        const std::vector<double> refGrad = {2 * x * y + z * e + 0.5 * y / s, x * x + z / y + 0.5 * x / s, x * e + std::log(y)};
+
+        std::vector<double> grad;
+        const auto hess = functions::calcHessAD<>(scalarFunc, point, &grad);
+        checkNear(maxDiff(hess, ref), 0, 1e-13, 0, "dynamic Hessian matches the closed form");
+        for (auto i = 0; i < 3; ++i) checkNear(grad[i], refGrad[i], 1e-13, 1e-13, "gradient " + std::to_string(i));
+
+        std::vector<double> grad2;
+        checkNear(maxDiff(functions::calcHessAD<2>(scalarFunc, point, &grad2), ref), 0, 1e-13, 0, "N = 2 Hessian matches the closed form");
+        for (auto i = 0; i < 3; ++i) checkNear(grad2[i], refGrad[i], 1e-13, 1e-13, "N = 2 gradient " + std::to_string(i));
+        checkNear(maxDiff(functions::calcHessAD<1>(scalarFunc, point), ref), 0, 1e-13, 0, "N = 1 Hessian matches the closed form");
+        checkNear(maxDiff(functions::calcHessAD<3>(scalarFunc, point), ref), 0, 1e-13, 0, "N = 3 Hessian matches the closed form");
+    }
+
+    // x = 0에서 정수 차수
+    {
+        auto powFunc = [](const auto* c, auto* r)
+        {
+            r[0] = pow(c[0], 1);
+            r[1] = pow(c[0], 2);
+            r[2] = pow(c[0], 3) * c[1];
+        };
+        const auto jac = functions::calcJacobAD<2>(powFunc, {0.0, 2.0}, 3);
+        check(jac.allFinite(), "integer powers have finite derivatives at zero");
+        checkNear(jac(0, 0), 1, 0, 0, "d(c^1)/dc at zero");
+        checkNear(jac(1, 0), 0, 0, 0, "d(c^2)/dc at zero");
+        checkNear(jac(2, 0), 0, 0, 0, "d(c^3 d)/dc at zero");
+    }
+
+    // 반응 속도
+    {
+        ChemBase A("A"), B("B"), P("P"), Q("Q");
+        SpeedRxnBase rxn(std::vector<std::string>{"A + B = P", "P = Q", "2A = Q"});
+        rxn.setMassAction({2e3f, 5e2f, 1e2f}, {2e4f, 1.5e4f, 1e4f}, {1e1f, 0.0f, 5.0f}, {5e3f, 0.0f, 8e3f});
+
+        const double temp = 350;
+        rxn.setTemp(temp);
+
+        const int chemNum = rxn.getChemNum(), rxnNum = rxn.getRxnNum();
+        std::vector<double> conc = {0.7, 0.4, 0.2, 0.1}, rate(rxnNum), jac(rxnNum * chemNum);
+        conc.resize(chemNum, 0.3);
+        rxn.calcRateJacobian(conc.data(), rate.data(), jac.data());
+
+        std::vector<double> rateAD;
+        const auto jacAD = functions::calcJacobAD<4>([&](const auto* c, auto* r) {rxn.calcRateAD(c, r);}, conc, rxnNum, &rateAD);
+        const Eigen::Map<Eigen::MatrixXd> jacMat(jac.data(), rxnNum, chemNum);
+        checkNear(maxDiff(jacAD, jacMat), 0, 1e-12 * jacMat.cwiseAbs().maxCoeff(), 0, "calcRateAD Jacobian matches calcRateJacobian");
+        for (auto j = 0; j < rxnNum; ++j) checkNear(rateAD[j], rate[j], 1e-14, 1e-12, "calcRateAD rate " + std::to_string(j));
+
+        // 온도를 마지막 입력으로 둔 Jacobian의 마지막 열 = d r / d T
+        std::vector<double> state = conc;
+        state.push_back(temp);
+        const auto jacT = functions::calcJacobAD<>([&](const auto* c, auto* r) {rxn.calcRateAD(c, c[chemNum], r);}, state, rxnNum);
+
+        const double h = 1e-3;
+        std::vector<double> rp(rxnNum), rm(rxnNum);
+        rxn.setTemp(temp + h);
+        rxn.calcRate(conc.data(), rp.data());
+        rxn.setTemp(temp - h);
+        rxn.calcRate(conc.data(), rm.data());
+        rxn.setTemp(temp);
+        for (auto j = 0; j < rxnNum; ++j)
+        {
+            checkNear(jacT(j, chemNum), (rp[j] - rm[j]) / (2 * h), 1e-10, 1e-6, "temperature derivative of rate " + std::to_string(j));
+        }
+    }
+
+    return testhelper::report("DualADTest");
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/*
+tests/DynamicCSTRTest.cpp
+-------------------------
+DynamicCSTREngine의 반응기 연결과 반복 행렬 분해를 검사함. 반응 A -> B (r = k C_A, k = 2), V = v = 1 에서
+정상 상태의 holdup은 닫힌 형태로 구할 수 있음.
+    - 직렬 연결(블록 전진 대입) : N_A,k = N_A,k-1 / (1 + k)
+    - 재순환 연결(희소 LU) : 두 번째 출력 스트림이 첫 반응기의 두 번째 입력 스트림으로 돌아감
+    - 적분 경로가 단일 반응기의 해석해 N_A(t)와 일치하는지
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+int main()
+{
+    ChemBase A("A"), B("B");
+    const double k = 2.0;
+    SpeedRxnBase rxn(std::vector<std::string>{"A = B"}, [k](const double* c, double* r){r[0] = k * c[0];});
+
+    // 직렬 연결된 반응기 5개. 연결에 순환이 없으므로 블록 전진 대입으로 풂.
+    {
+        const int rxtorNum = 5;
+        std::deque<StreamBase> streamVec;
+        streamVec.emplace_back(std::vector<ChemBase*>{&A, &B}, std::vector<float>{10, 0});
+        for (auto n = 0; n < rxtorNum; ++n) streamVec.emplace_back(std::vector<ChemBase*>{&A, &B}, std::vector<float>{0, 0});
+
+        std::deque<CSTR> rxtorVec;
+        std::vector<CSTR*> rxtorIdx;
+        for (auto n = 0; n < rxtorNum; ++n)
+        {
+            rxtorVec.emplace_back(&streamVec[n], &streamVec[n+1], &rxn, 1.0f, 1.0f);
+            rxtorIdx.push_back(&rxtorVec.back());
+        }
+
+        DynamicCSTREngine engine(rxtorIdx);
+        engine.setTolerance(1e-10, 1e-8);
+        engine.addSteadyStateEvent(1e-8);
+        auto res = engine.simulate(200.0);
+
+        check(!res.EventVec.empty(), "train reaches steady state");
+        double ref = 10;
+        for (auto n = 0; n < rxtorNum; ++n)
+        {
+            ref /= 1 + k;
+            checkNear(streamVec[n+1].getChemMol(&A), ref, 1e-5, 1e-4, "train outlet A of reactor " + std::to_string(n));
+            checkNear(streamVec[n+1].getChemMol(&A) + streamVec[n+1].getChemMol(&B), 10, 1e-4, 1e-5, "train conserves moles in reactor " + std::to_string(n));
+        }
+    }
+
+    // 재순환 : feed + rec -> R1 -> mid -> R2 -> [prod, rec] (분배 비율 0.5, 0.5). 연결에 순환이 있으므로 희소 LU로 풂.
+    {
+        StreamBase feed(std::vector<ChemBase*>{&A, &B}, std::vector<float>{10, 0});
+        StreamBase rec(std::vector<ChemBase*>{&A, &B}, std::vector<float>{0, 0});
+        StreamBase mid(std::vector<ChemBase*>{&A, &B}, std::vector<float>{0, 0});
+        StreamBase prod(std::vector<ChemBase*>{&A, &B}, std::vector<float>{0, 0});
+
+        CSTR r1(std::vector<StreamBase*>{&feed, &rec}, std::vector<StreamBase*>{&mid}, &rxn, 1.0f, 1.0f);
+        CSTR r2(std::vector<StreamBase*>{&mid}, std::vector<StreamBase*>{&prod, &rec}, &rxn, 1.0f, 1.0f, {0.5f, 0.5f});
+
+        DynamicCSTREngine engine({&r1, &r2});
+        engine.setTolerance(1e-10, 1e-8);
+        engine.addSteadyStateEvent(1e-8);
+        engine.simulate(200.0);
+
+        // N2 = N1 / (1 + k), N1 = (10 + 0.5 N2) / (1 + k)
+        const double n1 = 10 / ((1 + k) - 0.5 / (1 + k));
+        const double n2 = n1 / (1 + k);
+        checkNear(r1.getChemMol()[0], n1, 1e-5, 1e-4, "recycle holdup of the first reactor");
+        checkNear(r2.getChemMol()[0], n2, 1e-5, 1e-4, "recycle holdup of the second reactor");
+        checkNear(prod.getChemMol(&A) + prod.getChemMol(&B), 10, 1e-4, 1e-5, "recycle loop conserves moles at the product");
+        checkNear(rec.getChemMol(&A), 0.5 * n2, 1e-5, 1e-4, "recycle stream carries half of the second outlet");
+    }
+
+    // 단일 반응기의 적분 경로 : N_A(t) = N_ss (1 - exp(-(1 + k) t)), N_ss = 10 / (1 + k)
+    {
+        StreamBase feed(std::vector<ChemBase*>{&A, &B}, std::vector<float>{10, 0});
+        StreamBase out(std::vector<ChemBase*>{&A, &B}, std::vector<float>{0, 0});
+        CSTR r1(&feed, &out, &rxn, 1.0f, 1.0f);
+        r1.setChemMol({0, 0});
+
+        DynamicCSTREngine engine({&r1});
+        engine.setTolerance(1e-10, 1e-8);
+        std::vector<double> timeVec = {0.1, 0.5, 1.0, 2.0};
+        auto res = engine.simulate(2.0, timeVec);
+
+        check(res.TimeVec.size() == timeVec.size(), "dense output records every output time");
+        for (auto n = 0; n < res.TimeVec.size(); ++n)
+        {
+            const double ref = 10 / (1 + k) * (1 - std::exp(-(1 + k) * res.TimeVec[n]));
+            checkNear(res.StateVec[n][0], ref, 1e-5, 1e-4, "transient A at t = " + std::to_string(res.TimeVec[n]));
+        }
+    }
+
+    return testhelper::report("DynamicCSTRTest");
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+tests/FixedSizeRxtorTest.cpp
+----------------------------
+고정 크기 RxtorBaseT의 평형 계산(solveConvRateFromKValue)을 닫힌 형태의 해와 비교함. (입구 A = 1, B = 0)
+    - A = B : xi = K / (1 + K)
+    - 2A = B : K (1 - 2 xi)^2 = xi 이므로 xi = ((4K + 1) - sqrt(8K + 1)) / (8K)
+스트림에 반응하지 않는 화학종이 있는 경우(NStreamChem)와 동적 크기 RxtorBase의 결과도 같아야 함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// 반응기의 입구를 A = 1로 두고 K에 대해 평형 전화율을 계산함.
+template <typename RxtorType>
+float solveExtent(RxtorType& Rxtor, const float& K)
+{
+    Rxtor.solveConvRateFromKValue(std::vector<float>{K});
+    return Rxtor.getScalarVec()[0];
+}
+
+int main()
+{
+    ChemBase A("A"), B("B"), N2("N2");
+    RxnBase isoRxn(std::vector<std::string>{"A = B"});
+    RxnBase dimRxn(std::vector<std::string>{"2A = B"});
+
+    StreamBase inStream(std::vector<ChemBase*>{&A}, std::vector<float>{1});
+    StreamBase outStream(std::vector<ChemBase*>{&A, &B}, std::vector<float>{0, 0});
+    StreamBase inertIn(std::vector<ChemBase*>{&A, &N2}, std::vector<float>{1, 3});
+    StreamBase inertOut(std::vector<ChemBase*>{&A, &B, &N2}, std::vector<float>{0, 0, 0});
+
+    RxtorBaseT<2, 1> isoFixed(&inStream, &outStream, &isoRxn);
+    RxtorBaseT<2, 1> dimFixed(&inStream, &outStream, &dimRxn);
+    RxtorBaseT<2, 1, 3> isoInert(&inertIn, &inertOut, &isoRxn);
+    RxtorBase isoDynamic(&inStream, &outStream, &isoRxn);
+
+    for (auto K : {0.2f, 1.0f, 4.0f, 25.0f})
+    {
+        const auto tag = " at K = " + std::to_string(K);
+
+        const double isoRef = K / (1 + K);
+        checkNear(solveExtent(isoFixed, K), isoRef, 1e-4, 1e-3, "fixed-size A = B extent" + tag);
+        checkNear(outStream.getChemMol(&B), isoRef, 1e-4, 1e-3, "fixed-size A = B outlet" + tag);
+        checkNear(solveExtent(isoInert, K), isoRef, 1e-4, 1e-3, "fixed-size A = B extent with an inert" + tag);
+        checkNear(inertOut.getChemMol(&N2), 3, 1e-6, 0, "inert passes through" + tag);
+        checkNear(solveExtent(isoDynamic, K), isoRef, 1e-4, 1e-3, "dynamic-size A = B extent" + tag);
+
+        const double dimRef = ((4 * K + 1) - std::sqrt(8 * K + 1)) / (8 * K);
+        checkNear(solveExtent(dimFixed, K), dimRef, 1e-4, 1e-3, "fixed-size 2A = B extent" + tag);
+    }
+
+    // 스트림의 화학종 수가 NStreamChem과 다르면 생성할 수 없음.
+    bool thrown = false;
+    try
+    {
+        RxtorBaseT<2, 1> mismatch(&inertIn, &inertOut, &isoRxn);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    check(thrown, "stream size mismatch with the fixed size throws");
+
+    return testhelper::report("FixedSizeRxtorTest");
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*
+tests/FlowsheetParallelTest.cpp
+-------------------------------
+200개 단위 공정으로 된 합성 공정도에서 Flowsheet의 병렬 계산(WorkStealingScheduler)을 검사하고 시간을 출력함.
+    - 순환 열 20개(Mixer + PFR 8개 + Splitter) : 스레드 수와 관계없이 결과가 같은지. 모든 PFR은 SpeedRxnBase 하나를 공유함.
+    - 20층 x 10열의 격자 DAG(Mixer) : 같은 Flowsheet로 여러 번 풀 때 작업 스레드를 다시 만들지 않고 결과가 같은지.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+double elapsed(const std::chrono::steady_clock::time_point& Start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+int main()
+{
+    ChemBase A("A"), B("B"), C("C");
+    const std::vector<ChemBase*> chemVec = {&A, &B, &C};
+    const std::vector<int> threadVec = {1, 2, 4};
+
+    std::vector<std::unique_ptr<StreamBase>> streamVec;
+    auto makeStream = [&](const std::vector<float>& Mol)
+    {
+        streamVec.emplace_back(new StreamBase(chemVec, Mol));
+        return streamVec.back().get();
+    };
+
+    // 순환 열 20개
+    {
+        const int trainNum = 20, pfrNum = 8;
+        SpeedRxnBase rxn(std::vector<std::string>{"A = B", "B = C"});
+        rxn.setMassAction({0.5f, 0.2f}, {0.05f, 0.0f});
+
+        std::vector<std::unique_ptr<ProcObjBase>> unitVec;
+        std::vector<StreamBase*> prodVec, innerVec;
+        for (auto t = 0; t < trainNum; ++t)
+        {
+            auto feed = makeStream({10.0f + t, 0, 0});
+            auto rec = makeStream({0, 0, 0});
+            auto cur = makeStream({0, 0, 0});
+            unitVec.emplace_back(new MixerBase({feed, rec}, cur));
+            innerVec.push_back(rec);
+            innerVec.push_back(cur);
+
+            for (auto p = 0; p < pfrNum; ++p)
+            {
+                auto out = makeStream({0, 0, 0});
+                unitVec.emplace_back(new PFR(cur, out, &rxn, 1.0f, 1.0f));
+                innerVec.push_back(out);
+                cur = out;
+            }
+
+            auto prod = makeStream({0, 0, 0});
+            unitVec.emplace_back(new SplitterBase(cur, {rec, prod}, std::vector<float>{0.6f, 0.4f}));
+            prodVec.push_back(prod);
+            innerVec.push_back(prod);
+        }
+
+        std::vector<ProcObjBase*> unitPtr;
+        for (auto& unit : unitVec) unitPtr.push_back(unit.get());
+        check(unitPtr.size() == 200, "train flowsheet has 200 units");
+
+        std::vector<float> ref;
+        for (auto threadNum : threadVec)
+        {
+            for (auto ptr : innerVec)
+            {
+                for (auto i = 0; i < 3; ++i) ptr->setChemMolAt(i, 0);
+            }
+
+            Flowsheet flowsheet(unitPtr);
+            flowsheet.setThreadNum(threadNum);
+            flowsheet.setTolerance(1e-6);
+
+            const auto start = std::chrono::steady_clock::now();
+            auto resVec = flowsheet.solve();
+            const double time = elapsed(start);
+
+            bool converged = (resVec.size() == trainNum);
+            for (auto& res : resVec) converged = converged && res.Converged;
+            check(converged, "every recycle converges with " + std::to_string(threadNum) + " threads");
+
+            std::vector<float> out;
+            for (auto ptr : prodVec)
+            {
+                for (auto i = 0; i < 3; ++i) out.push_back(ptr->getChemMolAt(i));
+            }
+            if (ref.empty()) ref = out;
+            check(out == ref, "train results don't depend on the thread count (" + std::to_string(threadNum) + " threads)");
+
+            std::cout << "trains, " << threadNum << " threads : " << time * 1e3 << " ms, steals " << flowsheet.getStealNum() << std::endl;
+        }
+
+        // 제품의 총 몰수는 원료와 같음.
+        for (auto t = 0; t < trainNum; ++t)
+        {
+            checkNear(prodVec[t]->getChemMol(&A) + prodVec[t]->getChemMol(&B) + prodVec[t]->getChemMol(&C), 10.0 + t,
+                1e-3, 1e-4, "train " + std::to_string(t) + " conserves moles");
+        }
+    }
+
+    // 격자 DAG : 각 Mixer는 이전 층의 이웃한 두 스트림을 섞음.
+    {
+        const int layerNum = 20, width = 10, repeatNum = 200;
+
+        std::vector<std::unique_ptr<ProcObjBase>> unitVec;
+        std::vector<StreamBase*> prev;
+        for (auto i = 0; i < width; ++i) prev.push_back(makeStream({float(i + 1), 0, 0}));
+        for (auto l = 0; l < layerNum; ++l)
+        {
+            std::vector<StreamBase*> cur;
+            for (auto i = 0; i < width; ++i)
+            {
+                cur.push_back(makeStream({0, 0, 0}));
+                unitVec.emplace_back(new MixerBase({prev[i], prev[(i + 1) % width]}, cur.back()));
+            }
+            prev = cur;
+        }
+
+        std::vector<ProcObjBase*> unitPtr;
+        for (auto& unit : unitVec) unitPtr.push_back(unit.get());
+
+        // 층 l의 스트림 합은 2^l * (원료 합)
+        const double total = std::pow(2.0, layerNum) * width * (width + 1) / 2;
+
+        for (auto threadNum : threadVec)
+        {
+            Flowsheet flowsheet(unitPtr);
+            flowsheet.setThreadNum(threadNum);
+
+            bool same = true;
+            const auto start = std::chrono::steady_clock::now();
+            for (auto r = 0; r < repeatNum; ++r)
+            {
+                flowsheet.solve();
+                double sum = 0;
+                for (auto ptr : prev) sum += ptr->getChemMol(&A);
+                same = same && (std::abs(sum - total) <= 1e-5 * total);
+            }
+            const double time = elapsed(start);
+
+            check(same, "lattice outlet is exact for every repeat with " + std::to_string(threadNum) + " threads");
+            std::cout << "lattice, " << threadNum << " threads : " << time / repeatNum * 1e6 << " us per solve" << std::endl;
+        }
+    }
+
+    return testhelper::report("FlowsheetParallelTest");
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+tests/FlowsheetScheduleTest.cpp
+-------------------------------
+순환 블록 두 개를 가진 공정도에서 Flowsheet::compile이 만든 계산 순서(getSchedule)와 절단 스트림(getTearStream)을 검사함.
+    feed1 -> M1([feed1, r1]) -> a1 -> S1 -> [r1, b1]
+    X([b1, feed2]) -> c
+    c -> M2([c, r2]) -> a2 -> S2 -> [r2, d]
+    d -> F -> [p1, p2]
+단위 공정은 순서를 섞어 전달함. 블록은 {M1, S1}, {X}, {M2, S2}, {F} 순서이고, 순환 블록마다 절단 스트림이 하나씩 있어야 함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+int main()
+{
+    ChemBase A("A"), B("B");
+    const std::vector<ChemBase*> chemVec = {&A, &B};
+
+    StreamBase feed1(chemVec, std::vector<float>{10, 2}), feed2(chemVec, std::vector<float>{3, 4});
+    StreamBase a1(chemVec), r1(chemVec), b1(chemVec), c(chemVec), a2(chemVec), r2(chemVec), d(chemVec), p1(chemVec), p2(chemVec);
+
+    MixerBase M1({&feed1, &r1}, &a1);
+    SplitterBase S1(&a1, {&r1, &b1}, std::vector<float>{0.3f, 0.7f});
+    MixerBase X({&b1, &feed2}, &c);
+    MixerBase M2({&c, &r2}, &a2);
+    SplitterBase S2(&a2, {&r2, &d}, std::vector<float>{0.5f, 0.5f});
+    SplitterBase F(&d, {&p1, &p2}, std::vector<float>{0.25f, 0.75f});
+
+    // 전달 순서 : F, S2, X, M2, S1, M1
+    const std::vector<ProcObjBase*> unitVec = {&F, &S2, &X, &M2, &S1, &M1};
+    const int iF = 0, iS2 = 1, iX = 2, iM2 = 3, iS1 = 4, iM1 = 5;
+
+    Flowsheet flowsheet(unitVec);
+    flowsheet.compile();
+
+    const auto schedule = flowsheet.getSchedule();
+    const auto tearVec = flowsheet.getTearStream();
+    const auto recycleFlag = flowsheet.getRecycleFlag();
+
+    check(schedule.size() == 4, "flowsheet has four blocks");
+    check(flowsheet.getBlockNum() == 4, "getBlockNum matches the schedule");
+    check(tearVec.size() == schedule.size() && recycleFlag.size() == schedule.size(), "tears and recycle flags are per block");
+
+    if (schedule.size() == 4 && tearVec.size() == 4 && recycleFlag.size() == 4)
+    {
+        auto sorted = [](std::vector<int> v) {std::sort(v.begin(), v.end()); return v;};
+
+        // 블록 구성과 위상 순서
+        check(sorted(schedule[0]) == sorted({iM1, iS1}), "first block is the upstream loop");
+        check(schedule[1] == std::vector<int>{iX}, "second block is the connecting mixer");
+        check(sorted(schedule[2]) == sorted({iM2, iS2}), "third block is the downstream loop");
+        check(schedule[3] == std::vector<int>{iF}, "last block is the product splitter");
+
+        // 순환 여부와 절단 스트림
+        check(recycleFlag[0] && !recycleFlag[1] && recycleFlag[2] && !recycleFlag[3], "only the loops are recycle blocks");
+        check(tearVec[0].size() == 1 && tearVec[2].size() == 1, "each loop tears a single stream");
+        check(tearVec[1].empty() && tearVec[3].empty(), "acyclic blocks have no tear stream");
+
+        if (tearVec[0].size() == 1 && tearVec[2].size() == 1)
+        {
+            check(tearVec[0][0] == &a1 || tearVec[0][0] == &r1, "upstream tear lies on the upstream loop");
+            check(tearVec[2][0] == &a2 || tearVec[2][0] == &r2, "downstream tear lies on the downstream loop");
+
+            // 블록의 첫 단위 공정은 절단 스트림을 입력으로 받음.
+            for (auto b : {0, 2})
+            {
+                const auto inVec = unitVec[schedule[b].front()]->getInStreamIdx();
+                check(std::find(inVec.begin(), inVec.end(), tearVec[b][0]) != inVec.end(),
+                    "block " + std::to_string(b) + " starts at the unit reading the tear");
+            }
+        }
+    }
+
+    // 컴파일된 순서로 풀면 정상 상태 해를 얻음. (각 순환 블록의 제품은 그 블록의 입력과 같음)
+    flowsheet.setTolerance(1e-7);
+    const auto resVec = flowsheet.solve();
+
+    bool converged = (resVec.size() == 2);
+    for (const auto& res : resVec) converged = converged && res.Converged;
+    check(converged, "both recycle blocks converge");
+
+    checkNear(b1.getChemMol(&A), 10, 1e-4, 1e-4, "upstream loop passes feed1 A");
+    checkNear(d.getChemMol(&A), 13, 1e-4, 1e-4, "downstream loop passes feed1 + feed2 A");
+    checkNear(d.getChemMol(&B), 6, 1e-4, 1e-4, "downstream loop passes feed1 + feed2 B");
+    checkNear(p2.getChemMol(&B), 4.5, 1e-4, 1e-4, "product splitter runs after the downstream loop");
+
+    return testhelper::report("FlowsheetScheduleTest");
+}
\ No newline at end of file
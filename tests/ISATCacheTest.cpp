@@ -0,0 +1,157 @@
+/*
+tests/ISATCacheTest.cpp
+-----------------------
+ISATCache를 매끄러운 해석적 사상 f(x) = (exp(-x0) x1, sin(x0) + x1^2)로 검사함.
+    - Retrieve로 답한 값의 오차가 허용 오차 이하인지
+    - 같은 분포의 질의를 반복하면 hit rate가 올라가는지
+    - setMaxMemory가 가장 오래 사용하지 않은 기록부터 지우고, RecordNum과 MemoryUse가 맞는지
+PFR, CSTR에 setISATCache로 캐시를 지정한 경우 캐시 없이 계산한 출구와 비교함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+void analyticMap(const Eigen::VectorXd& x, Eigen::VectorXd& f, Eigen::MatrixXd* A)
+{
+    f.resize(2);
+    f[0] = std::exp(-x[0]) * x[1];
+    f[1] = std::sin(x[0]) + x[1] * x[1];
+
+    if (A == nullptr) return;
+    A->resize(2, 2);
+    (*A) << -std::exp(-x[0]) * x[1], std::exp(-x[0]), std::cos(x[0]), 2 * x[1];
+}
+
+int main()
+{
+    std::mt19937 gen(1);
+    std::normal_distribution<double> noise(0, 0.05);
+
+    // 오차와 hit rate
+    {
+        const double errTol = 1e-3;
+        ISATCache cache(2, 2, analyticMap, errTol);
+
+        const int roundNum = 4, queryNum = 5000;
+        std::vector<double> hitVec;
+        double maxErr = 0;
+        Eigen::VectorXd f, fExact;
+        for (auto r = 0; r < roundNum; ++r)
+        {
+            cache.resetStats();
+            for (auto q = 0; q < queryNum; ++q)
+            {
+                Eigen::VectorXd x(2);
+                x << 1 + noise(gen), 2 + noise(gen);
+                if (cache.query(x, f) != ISATCache::Retrieve) continue;
+
+                analyticMap(x, fExact, nullptr);
+                maxErr = std::max(maxErr, (f - fExact).norm());
+            }
+            hitVec.push_back(cache.getStats().HitRate);
+            std::cout << "round " << r << " : hit rate " << hitVec.back() << ", records " << cache.getRecordNum() << std::endl;
+        }
+
+        check(maxErr <= errTol, "retrieved values are within the tolerance (max error " + std::to_string(maxErr) + ")");
+        check(hitVec.front() < hitVec.back(), "hit rate rises with repeated queries");
+        check(hitVec.back() > 0.95, "hit rate is high once the region is tabulated");
+
+        const auto stats = cache.getStats();
+        check(stats.QueryNum == queryNum, "resetStats keeps counting from zero");
+        check(stats.RetrieveNum + stats.GrowNum + stats.AddNum + stats.DirectNum == stats.QueryNum, "every query has one outcome");
+    }
+
+    // LRU 순서의 삭제. 서로 먼 점 5개는 각각 새 기록이 됨.
+    {
+        ISATCache cache(2, 2, analyticMap, 1e-4);
+        std::vector<Eigen::VectorXd> pointVec;
+        for (auto k = 0; k < 5; ++k) pointVec.push_back(Eigen::Vector2d(3.0 * k, 1.0 + k));
+
+        Eigen::VectorXd f;
+        for (const auto& x : pointVec) check(cache.query(x, f) == ISATCache::Add, "distant point adds a record");
+        check(cache.getRecordNum() == 5, "five records are stored");
+
+        const std::size_t recordBytes = cache.getStats().MemoryUse / 5;
+        check(cache.getStats().MemoryUse == 5 * recordBytes, "memory use is proportional to the record count");
+
+        // 0번 기록을 다시 사용하면 가장 오래 사용하지 않은 기록은 1번, 2번이 됨.
+        check(cache.query(pointVec[0], f) == ISATCache::Retrieve, "stored point is retrieved");
+        cache.setMaxMemory(3 * recordBytes);
+
+        auto stats = cache.getStats();
+        check(stats.RecordNum == 3 && stats.EvictNum == 2, "setMaxMemory evicts down to the limit");
+        check(stats.MemoryUse == 3 * recordBytes, "memory use follows the record count after eviction");
+        for (auto k : {0, 3, 4}) check(cache.query(pointVec[k], f) == ISATCache::Retrieve, "recently used record " + std::to_string(k) + " survives");
+
+        // 남은 기록의 사용 순서는 4, 3, 0이므로 새 기록은 0번을 밀어냄.
+        check(cache.query(pointVec[1], f) == ISATCache::Add, "evicted record has to be recomputed");
+        stats = cache.getStats();
+        check(stats.RecordNum == 3 && stats.EvictNum == 3, "adding at the limit evicts one record");
+        check(stats.MemoryUse == 3 * recordBytes, "memory use stays at the limit");
+        check(cache.query(pointVec[4], f) == ISATCache::Retrieve, "recent record survives the add");
+        check(cache.query(pointVec[0], f) != ISATCache::Retrieve, "least recently used record was evicted");
+    }
+
+    // PFR, CSTR 연동
+    {
+        ChemBase A("A"), B("B"), C("C");
+        const std::vector<ChemBase*> chemVec = {&A, &B, &C};
+        SpeedRxnBase rxn(std::vector<std::string>{"A = B", "B = C"});
+        rxn.setMassAction({2.0f, 1.0f}, {0.1f, 0.0f});
+
+        StreamBase in(chemVec, std::vector<float>{10, 1, 0});
+        StreamBase out(chemVec), refOut(chemVec), cstrOut(chemVec), cstrRefOut(chemVec);
+
+        PFR pfr(&in, &out, &rxn, 1.0f, 2.0f), pfrRef(&in, &refOut, &rxn, 1.0f, 2.0f);
+        CSTR cstr(&in, &cstrOut, &rxn, 1.0f, 2.0f), cstrRef(&in, &cstrRefOut, &rxn, 1.0f, 2.0f);
+
+        const double errTol = 1e-3;
+        ISATCache pfrCache(3, 3, errTol), cstrCache(3, 3, errTol);
+        pfr.setISATCache(&pfrCache);
+        cstr.setISATCache(&cstrCache);
+
+        ISATCache wrong(2, 3);
+        bool thrown = false;
+        try
+        {
+            pfr.setISATCache(&wrong);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        check(thrown, "PFR rejects a cache with the wrong dimensions");
+
+        double pfrErr = 0, cstrErr = 0;
+        for (auto q = 0; q < 400; ++q)
+        {
+            in.setChemMolAt(0, 10 + 5 * noise(gen));
+            in.setChemMolAt(1, 1 + noise(gen));
+
+            pfr.solveSteadyState();
+            pfrRef.solveSteadyState();
+            cstr.solveSteadyState();
+            cstrRef.solveSteadyState();
+
+            for (auto chem : chemVec)
+            {
+                pfrErr = std::max(pfrErr, double(std::abs(out.getChemMol(chem) - refOut.getChemMol(chem))));
+                cstrErr = std::max(cstrErr, double(std::abs(cstrOut.getChemMol(chem) - cstrRefOut.getChemMol(chem))));
+            }
+        }
+
+        std::cout << "PFR : hit rate " << pfrCache.getStats().HitRate << ", max error " << pfrErr << std::endl;
+        std::cout << "CSTR : hit rate " << cstrCache.getStats().HitRate << ", max error " << cstrErr << std::endl;
+
+        check(pfrCache.getStats().HitRate > 0.5, "PFR answers most feeds from the cache");
+        check(cstrCache.getStats().HitRate > 0.5, "CSTR answers most feeds from the cache");
+        check(pfrErr <= errTol, "cached PFR outlet matches the direct integration");
+        check(cstrErr <= errTol, "cached CSTR outlet matches the direct steady state");
+    }
+
+    return testhelper::report("ISATCacheTest");
+}
\ No newline at end of file
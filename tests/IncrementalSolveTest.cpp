@@ -0,0 +1,122 @@
+/*
+tests/IncrementalSolveTest.cpp
+------------------------------
+Flowsheet::solveIncremental이 바뀐 곳의 하류만 다시 계산하는지 검사함.
+    feedA + feedC -> Mixer -> Separator(C는 모두 waste로) -> Splitter -> [PFR, PFR] -> Mixer -> PFR
+    feedB -> PFR -> PFR (독립된 열)
+    - feedA를 바꾸면 첫 Mixer부터 끝까지 7개 단위 공정만 계산하고, 결과는 solve와 같음.
+    - feedC를 바꾸면 Separator의 주 출력이 그대로이므로 Mixer, Separator에서 전파를 멈춤.
+    - ChangeTol보다 작은 변화는 무시하고, markChanged로 표시한 단위 공정은 스트림이 그대로여도 다시 계산함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+int main()
+{
+    ChemBase A("A"), B("B"), C("C");
+    const std::vector<ChemBase*> chemVec = {&A, &B, &C};
+
+    SpeedRxnBase rxn(std::vector<std::string>{"A = B"});
+    rxn.setMassAction({0.8f}, {0.1f});
+
+    StreamBase feedA(chemVec, std::vector<float>{10, 0, 0});
+    StreamBase feedC(chemVec, std::vector<float>{0, 0, 2});
+    StreamBase feedB(chemVec, std::vector<float>{5, 1, 0});
+
+    std::deque<StreamBase> streamVec;
+    for (auto i = 0; i < 11; ++i) streamVec.emplace_back(chemVec, std::vector<float>{0, 0, 0});
+    auto& mixOut = streamVec[0];
+    auto& mainOut = streamVec[1];
+    auto& waste = streamVec[2];
+    auto& branch1 = streamVec[3];
+    auto& branch2 = streamVec[4];
+    auto& pfr1Out = streamVec[5];
+    auto& pfr2Out = streamVec[6];
+    auto& mix2Out = streamVec[7];
+    auto& prod = streamVec[8];
+    auto& side1 = streamVec[9];
+    auto& side2 = streamVec[10];
+
+    MixerBase mixer({&feedA, &feedC}, &mixOut);
+    SeparatorBase separator(&mixOut, {&mainOut, &waste});
+    separator.setRecovery(&A, {1.0f, 0.0f});
+    separator.setRecovery(&B, {1.0f, 0.0f});
+    separator.setRecovery(&C, {0.0f, 1.0f});
+    SplitterBase splitter(&mainOut, {&branch1, &branch2}, std::vector<float>{0.3f, 0.7f});
+    PFR pfr1(&branch1, &pfr1Out, &rxn, 1.0f, 1.0f);
+    PFR pfr2(&branch2, &pfr2Out, &rxn, 2.0f, 1.0f);
+    MixerBase mixer2({&pfr1Out, &pfr2Out}, &mix2Out);
+    PFR pfr3(&mix2Out, &prod, &rxn, 1.0f, 1.0f);
+    PFR side(&feedB, &side1, &rxn, 1.0f, 1.0f);
+    PFR side2Rxtor(&side1, &side2, &rxn, 1.0f, 1.0f);
+
+    Flowsheet flowsheet({&pfr3, &mixer2, &pfr2, &pfr1, &splitter, &separator, &mixer, &side2Rxtor, &side});
+    flowsheet.setChangeTol(1e-3);
+
+    // 현재 모든 스트림 값
+    auto takeValue = [&]()
+    {
+        std::vector<float> value;
+        for (auto& stream : streamVec)
+        {
+            for (auto chem : chemVec) value.push_back(stream.getChemMol(chem));
+        }
+        return value;
+    };
+    auto maxDiff = [](const std::vector<float>& X, const std::vector<float>& Y)
+    {
+        double diff = 0;
+        for (auto i = 0; i < X.size(); ++i) diff = std::max(diff, double(std::abs(X[i] - Y[i])));
+        return diff;
+    };
+
+    flowsheet.solve();
+    check(flowsheet.getSolvedNum() == 9, "full solve computes every unit");
+
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 0, "nothing is recomputed without a change");
+
+    // feedA : 하류 7개
+    feedA.setChemMolAt(0, 12);
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 7, "feed change recomputes the 7 downstream units");
+    const auto incValue = takeValue();
+    flowsheet.solve();
+    checkNear(maxDiff(incValue, takeValue()), 0, 1e-6, 0, "incremental result matches a full solve");
+    checkNear(prod.getChemMol(&A) + prod.getChemMol(&B), 12, 1e-4, 1e-4, "product follows the new feed");
+
+    // feedC : Separator의 주 출력이 그대로이므로 전파를 멈춤.
+    feedC.setChemMolAt(2, 3);
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 2, "propagation stops at an unchanged separator outlet");
+    checkNear(waste.getChemMol(&C), 3, 1e-5, 1e-5, "waste follows the new feed");
+
+    // ChangeTol보다 작은 변화는 무시함. 작은 변화가 쌓여 ChangeTol을 넘으면 다시 계산함.
+    feedB.setChemMolAt(0, 5.002f);
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 0, "change below ChangeTol is ignored");
+    feedB.setChemMolAt(0, 5.01f);
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 2, "accumulated change above ChangeTol is propagated");
+
+    // 매개변수 변경은 markChanged로 알려야 함.
+    const float before = side2.getChemMol(&B);
+    side.setVolume(2.0f);
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 0, "parameter change isn't visible without markChanged");
+    flowsheet.markChanged(&side);
+    flowsheet.solveIncremental();
+    check(flowsheet.getSolvedNum() == 2, "markChanged forces the unit and its downstream to be recomputed");
+    check(side2.getChemMol(&B) > before, "larger reactor converts more A");
+
+    const auto markValue = takeValue();
+    flowsheet.solve();
+    checkNear(maxDiff(markValue, takeValue()), 0, 1e-6, 0, "marked result matches a full solve");
+
+    return testhelper::report("IncrementalSolveTest");
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*
+tests/MechCodeGenTest.cpp
+-------------------------
+MechCodeGen으로 생성, 컴파일한 메커니즘(CompiledMech)을 SpeedRxnBase의 일반 경로와 비교함.
+    - MassAction(정/역반응, 활성화 에너지)과 Expression 속도식
+    - calcRate, calcWdot(v r), calcJacobSparse(getJacobPattern 밖의 원소는 일반 경로에서도 0)
+benchmark의 상태 하나당 시간을 출력함. 생성한 코드는 g++로 컴파일하고 dlopen으로 불러오므로 -ldl로 링크할 것.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+void checkMech(SpeedRxnBase& Rxn, const std::string& Name)
+{
+    const int chemNum = Rxn.getChemNum();
+    const int rxnNum = Rxn.getRxnNum();
+    const Eigen::MatrixXd stoiMat = Rxn.getEffiMat().block(0, 0, chemNum, rxnNum).cast<double>();
+
+    MechCodeGen gen(&Rxn, "test_" + Name);
+    const std::string srcPath = "./MechCodeGenTest_" + Name + ".cpp";
+    const std::string libPath = "./MechCodeGenTest_" + Name + ".so";
+    auto mech = gen.build(srcPath, libPath);
+
+    check(mech.isLoaded(), Name + " library is loaded");
+    check(mech.getChemNum() == chemNum && mech.getRxnNum() == rxnNum, Name + " sizes match the mechanism");
+    check(mech.getJacobNnz() == gen.getJacobNnz() && mech.getJacobNnz() < chemNum * rxnNum, Name + " Jacobian is sparse");
+
+    const auto rxnIdx = mech.getJacobRxnIdx();
+    const auto chemIdx = mech.getJacobChemIdx();
+    Eigen::MatrixXi inPattern = Eigen::MatrixXi::Zero(rxnNum, chemNum);
+    for (auto k = 0; k < rxnIdx.size(); ++k) inPattern(rxnIdx[k], chemIdx[k]) = 1;
+
+    std::mt19937 gen32(7);
+    std::uniform_real_distribution<double> dist(0.1, 2.0);
+
+    double rateErr = 0, wdotErr = 0, jacErr = 0, outside = 0;
+    for (auto s = 0; s < 100; ++s)
+    {
+        Eigen::VectorXd conc(chemNum);
+        for (auto i = 0; i < chemNum; ++i) conc[i] = dist(gen32);
+
+        Eigen::VectorXd rate(rxnNum), cmpRate(rxnNum), cmpWdot(chemNum);
+        Eigen::MatrixXd jac(rxnNum, chemNum);
+        std::vector<double> val(mech.getJacobNnz());
+
+        Rxn.calcRateJacobian(conc.data(), rate.data(), jac.data());
+        mech.calcRate(conc.data(), Rxn.getTemp(), cmpRate.data());
+        mech.calcWdot(conc.data(), Rxn.getTemp(), cmpWdot.data());
+        mech.calcJacobSparse(conc.data(), Rxn.getTemp(), val.data());
+
+        const double scale = std::max(1.0, rate.cwiseAbs().maxCoeff());
+        rateErr = std::max(rateErr, (cmpRate - rate).cwiseAbs().maxCoeff() / scale);
+        wdotErr = std::max(wdotErr, (cmpWdot - stoiMat * rate).cwiseAbs().maxCoeff() / scale);
+        for (auto k = 0; k < val.size(); ++k)
+        {
+            jacErr = std::max(jacErr, std::abs(val[k] - jac(rxnIdx[k], chemIdx[k])) / std::max(1.0, std::abs(jac(rxnIdx[k], chemIdx[k]))));
+        }
+        for (auto j = 0; j < rxnNum; ++j)
+        {
+            for (auto i = 0; i < chemNum; ++i)
+            {
+                if (!inPattern(j, i)) outside = std::max(outside, std::abs(jac(j, i)));
+            }
+        }
+    }
+
+    checkNear(rateErr, 0, 1e-12, 0, Name + " calcRate matches the generic path");
+    checkNear(wdotErr, 0, 1e-12, 0, Name + " calcWdot matches v r");
+    checkNear(jacErr, 0, 1e-12, 0, Name + " calcJacobSparse matches the generic Jacobian");
+    check(outside == 0, Name + " generic Jacobian is zero outside the generated pattern");
+
+    // SpeedRxnBase가 컴파일된 메커니즘을 사용해도 같은 값을 냄.
+    Eigen::VectorXd conc = Eigen::VectorXd::Constant(chemNum, 0.7), rate(rxnNum), cmpRate(rxnNum);
+    Rxn.calcRate(conc.data(), rate.data());
+    Rxn.setCompiledMech(&mech);
+    Rxn.calcRate(conc.data(), cmpRate.data());
+    Rxn.setCompiledMech(nullptr);
+    checkNear((cmpRate - rate).cwiseAbs().maxCoeff(), 0, 1e-12, 0, Name + " SpeedRxnBase uses the compiled mechanism");
+
+    const auto bench = MechCodeGen::benchmark(Rxn, mech, 2000, 20);
+    checkNear(bench.MaxDiff, 0, 1e-12, 0, Name + " benchmark paths agree");
+    std::cout << Name << " : generic " << bench.GenericTime << " s, compiled " << bench.CompiledTime
+        << " s per state, max diff " << bench.MaxDiff << std::endl;
+
+    std::remove(srcPath.c_str());
+    std::remove(libPath.c_str());
+}
+
+int main()
+{
+    ChemBase A("A"), B("B"), C("C"), D("D"), E("E");
+    const std::vector<std::string> eqnVec = {"A + B = C", "2C = A + D", "C + E = 2D"};
+
+    SpeedRxnBase massAction(eqnVec);
+    massAction.setMassAction({2.0f, 1.5f, 0.3f}, {1000.0f, 0.0f, 500.0f}, {0.1f, 0.0f, 0.05f}, {0.0f, 0.0f, 0.0f});
+    massAction.setTemp(400);
+    checkMech(massAction, "massaction");
+
+    SpeedRxnBase expr(eqnVec);
+    expr.setRateExpr({"2.5e3*exp(-4500/T)*A*B^0.5/(1+0.3*A)^2", "0.1*C^2 - 0.05*A*D", "E*C"});
+    expr.setTemp(400);
+    checkMech(expr, "expression");
+
+    return testhelper::report("MechCodeGenTest");
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+/*
+tests/MechReducerTest.cpp
+-------------------------
+MechReducer::reduce를 대상 화학종과 결합하지 않은 곁가지가 있는 작은 메커니즘으로 검사함.
+    주 경로 : A = B, B = P (대상 A, P)
+    곁가지 : X = Y, Y = Z (X만 초기에 있으며 A, B, P와 반응하지 않음)
+곁가지 화학종의 중요도는 0이므로 reduce는 곁가지를 빼야 하고, 반환된 MaxError는 허용치 이하이며
+calcError로 다시 계산한 값과 같아야 함. DRG, DRGEP 모두 검사함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+int main()
+{
+    ChemBase A("A"), B("B"), P("P"), X("X"), Y("Y"), Z("Z");
+
+    SpeedRxnBase rxn(std::vector<std::string>{"A = B", "B = P", "X = Y", "Y = Z"});
+    rxn.setMassAction({2.0f, 0.5f, 1.0f, 0.3f}, {0.1f, 0.0f, 0.0f, 0.0f});
+    rxn.setTemp(300);
+
+    const auto chemIdx = rxn.getChemIdx();
+    std::vector<double> conc0(chemIdx.size(), 0);
+    conc0[functions::getVecPos(chemIdx, &A)] = 1.0;
+    conc0[functions::getVecPos(chemIdx, &X)] = 2.0;
+
+    for (auto method : {MechReducer::DRG, MechReducer::DRGEP})
+    {
+        const std::string name = (method == MechReducer::DRG) ? "DRG" : "DRGEP";
+
+        MechReducer reducer(&rxn, {&A, &P}, method);
+        reducer.addCase(conc0, 300, {0.1, 0.5, 1, 2, 5});
+
+        const auto& imp = reducer.calcImportance();
+        for (auto ptr : {&X, &Y, &Z})
+        {
+            check(imp[functions::getVecPos(chemIdx, ptr)] == 0, name + " side-chain species " + ptr->getAbb() + " has zero importance");
+        }
+
+        for (auto tol : {1e-3, 1e-1})
+        {
+            const auto tag = name + " (tol " + std::to_string(tol) + ")";
+            auto res = reducer.reduce(tol);
+
+            for (auto ptr : {&X, &Y, &Z}) check(!functions::inVector(res.ChemIdx, ptr), tag + " drops " + ptr->getAbb());
+            for (auto ptr : {&A, &P}) check(functions::inVector(res.ChemIdx, ptr), tag + " keeps target " + ptr->getAbb());
+            check(res.RxnIdx.size() >= 2 && res.RxnIdx.size() < 4, tag + " keeps the main path only");
+            check(res.MaxError >= 0 && res.MaxError <= tol, tag + " MaxError is within the tolerance");
+            checkNear(reducer.calcError(res.Rxn), res.MaxError, 1e-12, 1e-9, tag + " calcError reproduces MaxError");
+        }
+    }
+
+    return testhelper::report("MechReducerTest");
+}
\ No newline at end of file
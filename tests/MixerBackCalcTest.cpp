@@ -0,0 +1,104 @@
+/*
+tests/MixerBackCalcTest.cpp
+---------------------------
+MixerBase의 역산(출력 스트림이 알려지고 화학종마다 입력 스트림 하나를 모르는 경우)을 검사함.
+    - 입력 하나를 모르는 경우 : 출력 - (알려진 입력의 합)
+    - 화학종마다 모르는 입력이 다른 경우
+    - 역산한 값이 0인 경우
+    - 역산한 값이 음수이거나, 모르는 입력이 둘 이상인 경우 : runtime error가 발생하고 스트림은 바뀌지 않음.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// Func가 runtime error를 던지면 true를 반환함.
+template <typename FuncType>
+bool throws(FuncType Func)
+{
+    try
+    {
+        Func();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    ChemBase A("A"), B("B");
+    const std::vector<ChemBase*> chemVec = {&A, &B};
+
+    // 입력 하나를 모르는 경우
+    {
+        StreamBase in1(chemVec, std::vector<float>{3, 1});
+        StreamBase in2(chemVec);
+        StreamBase out(chemVec, std::vector<float>{10, 4});
+        MixerBase mixer({&in1, &in2}, &out);
+
+        check(!throws([&]() {mixer.solveSteadyState();}), "mixer with one unknown inlet solves");
+        check(in2.chemMolIsAllKnown(), "unknown inlet becomes known");
+        checkNear(in2.getChemMol(&A), 7, 1e-5, 1e-5, "mixer back-calculates inlet A");
+        checkNear(in2.getChemMol(&B), 3, 1e-5, 1e-5, "mixer back-calculates inlet B");
+        checkNear(out.getChemMol(&A), 10, 0, 0, "specified outlet is kept");
+    }
+
+    // 화학종마다 모르는 입력이 다른 경우
+    {
+        StreamBase in1(chemVec, std::vector<bool>{true, false}, std::vector<float>{2, 0});
+        StreamBase in2(chemVec, std::vector<bool>{false, true}, std::vector<float>{0, 5});
+        StreamBase in3(chemVec, std::vector<float>{1, 1});
+        StreamBase out(chemVec, std::vector<float>{10, 10});
+        MixerBase mixer({&in1, &in2, &in3}, &out);
+
+        mixer.solveSteadyState();
+        checkNear(in2.getChemMol(&A), 7, 1e-5, 1e-5, "A is back-calculated into the second inlet");
+        checkNear(in1.getChemMol(&B), 4, 1e-5, 1e-5, "B is back-calculated into the first inlet");
+        checkNear(in1.getChemMol(&A), 2, 0, 0, "known A of the first inlet is kept");
+        checkNear(in2.getChemMol(&B), 5, 0, 0, "known B of the second inlet is kept");
+    }
+
+    // 역산한 값이 0인 경우
+    {
+        StreamBase in1(chemVec, std::vector<float>{10, 4});
+        StreamBase in2(chemVec);
+        StreamBase out(chemVec, std::vector<float>{10, 4});
+        MixerBase mixer({&in1, &in2}, &out);
+
+        check(!throws([&]() {mixer.solveSteadyState();}), "zero back-calculated flow is accepted");
+        checkNear(in2.getChemMol(&A), 0, 0, 0, "zero back-calculated A");
+        checkNear(in2.getChemMol(&B), 0, 0, 0, "zero back-calculated B");
+    }
+
+    // 역산한 값이 음수인 경우
+    {
+        StreamBase in1(chemVec, std::vector<float>{12, 1});
+        StreamBase in2(chemVec);
+        StreamBase out(chemVec, std::vector<float>{10, 4});
+        MixerBase mixer({&in1, &in2}, &out);
+
+        check(throws([&]() {mixer.solveSteadyState();}), "negative back-calculated flow throws");
+        check(!in2.getChemMaskAt(0) && !in2.getChemMaskAt(1), "inlet stays unknown after the error");
+        checkNear(out.getChemMol(&A), 10, 0, 0, "outlet A isn't overwritten after the error");
+        checkNear(out.getChemMol(&B), 4, 0, 0, "outlet B isn't overwritten after the error");
+    }
+
+    // 모르는 입력이 둘인 경우
+    {
+        StreamBase in1(chemVec), in2(chemVec);
+        StreamBase in3(chemVec, std::vector<float>{1, 1});
+        StreamBase out(chemVec, std::vector<float>{10, 4});
+        MixerBase mixer({&in1, &in2, &in3}, &out);
+
+        check(throws([&]() {mixer.solveSteadyState();}), "two unknown inlets throw");
+        check(!in1.chemMolIsAllKnown() && !in2.chemMolIsAllKnown(), "unknown inlets stay unknown");
+    }
+
+    return testhelper::report("MixerBackCalcTest");
+}
\ No newline at end of file
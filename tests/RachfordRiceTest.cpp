@@ -0,0 +1,135 @@
+/*
+tests/RachfordRiceTest.cpp
+--------------------------
+Flash::solveRachfordRiceBatch의 경계 경우를 검사함.
+    - z = 0이고 K = 0인 화학종 : 식에서 빠지므로 나머지 화학종만의 해와 같음.
+    - z > 0이고 K = 0인 화학종(비휘발성) : b = 1 쪽 끝이 열려 있으며(f -> -inf) 근은 (0, 1) 안에 있음.
+    - 단상 : 모든 K < 1이면 b = 0, 모든 K > 1이면 b = 1.
+여러 경우를 한 번에(같은 블록에서) 풀어도 원료마다 따로 푼 결과와 같아야 함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+using BatchArrayType = Flash::BatchArrayType;
+
+// Z, K의 열 하나를 원료로 하는 Rachford-Rice 식의 값을 계산함. z = 0인 항은 뺌.
+double rachfordRice(const std::vector<double>& Z, const std::vector<double>& K, const double& Beta)
+{
+    double f = 0.0;
+    for (auto i = 0; i < Z.size(); ++i)
+    {
+        if (Z[i] > 0) f += Z[i] * (K[i] - 1.0) / (1.0 + Beta * (K[i] - 1.0));
+    }
+    return f;
+}
+
+double solveOne(const std::vector<double>& Z, const std::vector<double>& K)
+{
+    const int chemNum = Z.size();
+    BatchArrayType zArr(chemNum, 1), kArr(chemNum, 1);
+    for (auto i = 0; i < chemNum; ++i)
+    {
+        zArr(i, 0) = Z[i];
+        kArr(i, 0) = K[i];
+    }
+
+    Eigen::ArrayXd beta;
+    Flash::solveRachfordRiceBatch(zArr, kArr, beta);
+    return beta[0];
+}
+
+int main()
+{
+    // (이름, z, K, 기대값) 기대값이 음수이면 식의 근을 검사함.
+    struct Case
+    {
+        std::string Name;
+        std::vector<double> Z, K;
+        double Ref;
+    };
+
+    const std::vector<Case> caseVec = {
+        // 0.5 * 2 / (1 + 2b) = 0.5 * 0.8 / (1 - 0.8b) 이므로 b = 0.375
+        {"z = 0 with K = 0", {0.5, 0.5, 0.0}, {3.0, 0.2, 0.0}, 0.375},
+        {"z = 0 with K = 0 first", {0.0, 0.5, 0.5}, {0.0, 3.0, 0.2}, 0.375},
+        {"non-volatile species", {0.5, 0.3, 0.2}, {4.0, 2.0, 0.0}, -1.0},
+        {"mostly non-volatile", {0.05, 0.95}, {50.0, 0.0}, -1.0},
+        {"non-volatile only", {0.0, 1.0}, {3.0, 0.0}, 0.0},
+        {"vapor with absent non-volatile", {1.0, 0.0}, {5.0, 0.0}, 1.0},
+        {"liquid only", {0.3, 0.7}, {0.9, 0.5}, 0.0},
+        {"vapor only", {0.3, 0.7}, {1.5, 4.0}, 1.0},
+        {"liquid with non-volatile", {0.4, 0.6}, {1.2, 0.0}, 0.0},
+    };
+
+    std::vector<double> betaVec;
+    for (const auto& c : caseVec)
+    {
+        double beta = std::numeric_limits<double>::quiet_NaN();
+        bool thrown = false;
+        try
+        {
+            beta = solveOne(c.Z, c.K);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        betaVec.push_back(beta);
+
+        check(!thrown, c.Name + " converges");
+        check(std::isfinite(beta) && beta >= 0 && beta <= 1, c.Name + " gives a vapor fraction in [0, 1]");
+        if (c.Ref >= 0) checkNear(beta, c.Ref, 1e-9, 0, c.Name + " vapor fraction");
+        else
+        {
+            check(beta > 0 && beta < 1, c.Name + " has a two-phase root");
+            checkNear(rachfordRice(c.Z, c.K, beta), 0, 1e-9, 0, c.Name + " satisfies the Rachford-Rice equation");
+        }
+    }
+
+    // 모든 경우를 한 블록에서 풂. (화학종 수는 가장 많은 경우에 맞추고 나머지는 z = 0으로 채움)
+    {
+        const int chemNum = 3;
+        const int feedNum = caseVec.size();
+        BatchArrayType zArr = BatchArrayType::Zero(chemNum, feedNum), kArr = BatchArrayType::Zero(chemNum, feedNum);
+        for (auto n = 0; n < feedNum; ++n)
+        {
+            for (auto i = 0; i < caseVec[n].Z.size(); ++i)
+            {
+                zArr(i, n) = caseVec[n].Z[i];
+                kArr(i, n) = caseVec[n].K[i];
+            }
+        }
+
+        Eigen::ArrayXd beta;
+        Flash::solveRachfordRiceBatch(zArr, kArr, beta);
+        for (auto n = 0; n < feedNum; ++n) checkNear(beta[n], betaVec[n], 1e-12, 0, caseVec[n].Name + " batch matches single feed");
+    }
+
+    // K = 0인 화학종은 액상에만 있고, 원료에 없는 화학종은 출력 스트림에 추가되지 않음.
+    {
+        ChemBase A("A"), B("B"), S("S"), C("C");
+        StreamBase feed(std::vector<ChemBase*>{&A, &B, &S, &C}, std::vector<float>{5, 3, 2, 0});
+        StreamBase vap, liq;
+        Flash flash(&feed, &vap, &liq, 300, 1);
+        flash.setKValueFunc([&](const std::vector<ChemBase*>& ChemIdx, const double&, const double&,
+            const Eigen::VectorXd&, const Eigen::VectorXd&, Eigen::VectorXd& K)
+        {
+            K.resize(ChemIdx.size());
+            for (auto i = 0; i < ChemIdx.size(); ++i) K[i] = (ChemIdx[i] == &A) ? 4.0 : ((ChemIdx[i] == &B) ? 2.0 : 0.0);
+        });
+        flash.solveSteadyState();
+
+        checkNear(flash.getBeta(), solveOne({0.5, 0.3, 0.2, 0.0}, {4.0, 2.0, 0.0, 0.0}), 1e-6, 0, "flash unit vapor fraction");
+        check(!vap.inChemList(&S) || vap.getChemMol(&S) == 0, "non-volatile species stays in the liquid");
+        checkNear(liq.getChemMol(&S), 2, 1e-5, 1e-5, "liquid carries all of the non-volatile species");
+        check(!vap.inChemList(&C) && !liq.inChemList(&C), "absent species isn't added to the outlets");
+        checkNear(vap.getChemMol(&A) + liq.getChemMol(&A), 5, 1e-5, 1e-5, "flash conserves A");
+    }
+
+    return testhelper::report("RachfordRiceTest");
+}
\ No newline at end of file
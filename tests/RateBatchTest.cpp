@@ -0,0 +1,122 @@
+/*
+tests/RateBatchTest.cpp
+-----------------------
+SpeedRxnBase의 내장 속도식에 대해 다음을 검사함.
+    - calcRateBatch(열 단위 계산)가 상태마다 calcRate를 호출한 결과와 같은지
+    - 같은 객체를 여러 스레드에서 동시에 calcRateJacobian, calcRateJacobianSparse에 사용해도 결과가 같은지
+      (Expression, Custom 속도식 포함)
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// 양수 농도(0을 포함)를 가진 stateNum개의 상태를 만듦.
+std::vector<double> makeStates(const int& chemNum, const int& stateNum)
+{
+    std::vector<double> concMat(chemNum * stateNum);
+    for (auto s = 0; s < stateNum; ++s)
+    {
+        for (auto i = 0; i < chemNum; ++i) concMat[s * chemNum + i] = ((s + i) % 7 == 0) ? 0 : 0.1 + 0.37 * ((s * 3 + i * 5) % 11);
+    }
+    return concMat;
+}
+
+void checkBatch(const SpeedRxnBase& Rxn, const std::string& Name)
+{
+    const int chemNum = Rxn.getChemNum();
+    const int rxnNum = Rxn.getRxnNum();
+    const int stateNum = 600;
+    const auto concMat = makeStates(chemNum, stateNum);
+
+    std::vector<double> batchMat(rxnNum * stateNum), rate(rxnNum);
+    Rxn.calcRateBatch(concMat.data(), stateNum, batchMat.data());
+
+    double err = 0;
+    for (auto s = 0; s < stateNum; ++s)
+    {
+        Rxn.calcRate(concMat.data() + s * chemNum, rate.data());
+        for (auto j = 0; j < rxnNum; ++j) err = std::max(err, std::abs(batchMat[s * rxnNum + j] - rate[j]) / (1 + std::abs(rate[j])));
+    }
+    checkNear(err, 0, 1e-12, 0, Name + " batch rate matches single-state rate");
+}
+
+void checkConcurrent(const SpeedRxnBase& Rxn, const std::string& Name)
+{
+    const int chemNum = Rxn.getChemNum();
+    const int rxnNum = Rxn.getRxnNum();
+    const int stateNum = 200;
+    const auto concMat = makeStates(chemNum, stateNum);
+
+    std::vector<int> rxnIdx, chemIdx;
+    Rxn.getJacobPattern(rxnIdx, chemIdx);
+
+    // 한 스레드에서 계산한 기준값
+    std::vector<double> refJac(stateNum * chemNum * rxnNum), refVal(stateNum * rxnIdx.size()), rate(rxnNum);
+    for (auto s = 0; s < stateNum; ++s)
+    {
+        Rxn.calcRateJacobian(concMat.data() + s * chemNum, rate.data(), refJac.data() + s * chemNum * rxnNum);
+        Rxn.calcRateJacobianSparse(concMat.data() + s * chemNum, rate.data(), refVal.data() + s * rxnIdx.size());
+    }
+
+    std::atomic<int> mismatch(0);
+    std::vector<std::thread> threadVec;
+    for (auto t = 0; t < 4; ++t)
+    {
+        threadVec.emplace_back([&]()
+        {
+            std::vector<double> jac(chemNum * rxnNum), val(rxnIdx.size()), rateWork(rxnNum);
+            for (auto rep = 0; rep < 20; ++rep)
+            {
+                for (auto s = 0; s < stateNum; ++s)
+                {
+                    Rxn.calcRateJacobian(concMat.data() + s * chemNum, rateWork.data(), jac.data());
+                    Rxn.calcRateJacobianSparse(concMat.data() + s * chemNum, rateWork.data(), val.data());
+                    if (!std::equal(jac.begin(), jac.end(), refJac.begin() + s * chemNum * rxnNum)) ++mismatch;
+                    if (!std::equal(val.begin(), val.end(), refVal.begin() + s * rxnIdx.size())) ++mismatch;
+                }
+            }
+        });
+    }
+    for (auto& thread : threadVec) thread.join();
+
+    check(mismatch == 0, Name + " concurrent Jacobians match the serial result");
+}
+
+int main()
+{
+    ChemBase A("A"), B("B"), C("C"), D("D");
+    SpeedRxnBase rxn(std::vector<std::string>{"A + B = C", "2C = A + D", "B + D = C"});
+
+    rxn.setPowerLaw({2, 0.5, 1.5}, {{1, 0.5, 0, 0}, {0, 0, 2, 0}, {0, 1, 0, 1.5}});
+    checkBatch(rxn, "PowerLaw");
+    checkConcurrent(rxn, "PowerLaw");
+
+    rxn.setMassAction({2, 1, 0.3}, {0.5, 0.1, 0});
+    checkBatch(rxn, "MassAction");
+    checkConcurrent(rxn, "MassAction");
+
+    rxn.setLangmuirHinshelwood({2, 1, 0.7}, {{1, 1, 0, 0}, {0, 0, 1, 0}, {0, 1, 0, 1}}, {0.3, 0.2, 0.1, 0}, {2, 1, 0});
+    checkBatch(rxn, "LangmuirHinshelwood");
+    checkConcurrent(rxn, "LangmuirHinshelwood");
+
+    // Expression 속도식은 RateExprVM의 레지스터를 스레드마다 따로 사용해야 함.
+    rxn.setRateExpr({"2 * A * B^0.5 / (1 + 0.3 * A)^2", "0.5 * C^2 - 0.1 * A * D", "B * D^1.5"});
+    checkBatch(rxn, "Expression");
+    checkConcurrent(rxn, "Expression");
+
+    // 수치 미분을 사용하는 Custom 속도식도 작업 공간을 공유하지 않아야 함.
+    SpeedRxnBase custom(std::vector<std::string>{"A + B = C", "2C = A + D", "B + D = C"}, [](const double* c, double* r)
+    {
+        r[0] = 2 * c[0] * c[1];
+        r[1] = 0.5 * c[2] * c[2];
+        r[2] = c[1] * c[3];
+    });
+    checkBatch(custom, "Custom");
+    checkConcurrent(custom, "Custom");
+
+    return testhelper::report("RateBatchTest");
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+tests/RateExprTest.cpp
+----------------------
+SpeedRxnBase::setRateExpr로 지정한 속도식(RateExprVM)을 직접 작성한 속도식과 비교함.
+    - 속도 : Arrhenius 항, 실수 지수, 괄호로 감싼 화학종 이름, 상수식을 포함한 식이 손으로 쓴 식과 같은지.
+    - Jacobian : calcRateJacobian이 중앙 차분과 같은지.
+    - 온도 : setTemp로 바꾼 온도가 식의 T에 반영되는지.
+    - 여러 상태를 한 번에 계산한 결과가 상태마다 계산한 결과와 같은지.
+    - 알 수 없는 이름, 식의 수가 반응 수와 다른 경우에는 runtime error 발생.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// Func가 runtime error를 던지면 true를 반환함.
+template <typename FuncType>
+bool throws(FuncType Func)
+{
+    try
+    {
+        Func();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+// 손으로 쓴 속도식. 농도는 A, B, C, (CH3)2NH 순서임.
+void handRate(const double* Conc, const double& Temp, double* Rate)
+{
+    const double k = 2.5e3 * std::exp(-4500.0 / Temp);
+    Rate[0] = k * Conc[0] * std::sqrt(Conc[1]) / std::pow(1.0 + 0.3 * Conc[0], 2);
+    Rate[1] = 0.1 * Conc[2] * Conc[2] - 0.05 * Conc[0] * Conc[3] + 6.0;
+}
+
+int main()
+{
+    ChemBase A("A"), B("B"), C("C"), D("(CH3)2NH");
+
+    SpeedRxnBase rxn(std::vector<std::string>{"A + B = C", "2C = A + (CH3)2NH"});
+    rxn.setRateExpr({"2.5e3 * exp(-4500 / T) * A * B^0.5 / (1 + 0.3 * A)^2", "0.1 * C^2 - 0.05 * A * [(CH3)2NH] + 2 * 3"});
+
+    // 식의 변수 순서(getChemIdx)를 A, B, C, (CH3)2NH 순서로 맞춤.
+    const std::vector<ChemBase*> order = {&A, &B, &C, &D};
+    const auto chemIdx = rxn.getChemIdx();
+    const int chemNum = chemIdx.size();
+    check(chemNum == 4, "expression reaction has four chemicals");
+
+    std::vector<int> pos(chemNum);
+    for (auto i = 0; i < chemNum; ++i) pos[i] = std::find(chemIdx.begin(), chemIdx.end(), order[i]) - chemIdx.begin();
+
+    const std::vector<double> base = {1.0, 2.0, 3.0, 0.5};
+    for (auto temp : {350.0, 420.0})
+    {
+        const auto tag = "T = " + std::to_string(int(temp));
+        rxn.setTemp(temp);
+
+        std::vector<double> conc(chemNum), rate(2), jac(2 * chemNum), ref(2);
+        for (auto i = 0; i < chemNum; ++i) conc[pos[i]] = base[i];
+        rxn.calcRateJacobian(conc.data(), rate.data(), jac.data());
+        handRate(base.data(), temp, ref.data());
+
+        checkNear(rate[0], ref[0], 1e-14, 1e-12, tag + " expression rate 0 matches the hand-coded rate");
+        checkNear(rate[1], ref[1], 1e-14, 1e-12, tag + " expression rate 1 matches the hand-coded rate");
+
+        std::vector<double> onlyRate(2);
+        rxn.calcRate(conc.data(), onlyRate.data());
+        check(onlyRate == rate, tag + " calcRate matches calcRateJacobian");
+
+        // 중앙 차분 Jacobian (jac[i * 반응 수 + j] = d r_j / d c_i)
+        double err = 0, scale = 0;
+        const double h = 1e-6;
+        for (auto i = 0; i < chemNum; ++i)
+        {
+            std::vector<double> cp = base, cm = base, rp(2), rm(2);
+            cp[i] += h;
+            cm[i] -= h;
+            handRate(cp.data(), temp, rp.data());
+            handRate(cm.data(), temp, rm.data());
+
+            for (auto j = 0; j < 2; ++j)
+            {
+                const double fd = (rp[j] - rm[j]) / (2 * h);
+                err = std::max(err, std::abs(jac[pos[i] * 2 + j] - fd));
+                scale = std::max(scale, std::abs(fd));
+            }
+        }
+        checkNear(err, 0, 1e-7 * std::max(1.0, scale), 0, tag + " expression Jacobian matches the finite difference");
+    }
+
+    // 여러 상태를 한 번에 계산함.
+    {
+        rxn.setTemp(380);
+        const int stateNum = 64;
+        std::vector<double> concMat(chemNum * stateNum), rateMat(2 * stateNum), jacMat(2 * chemNum * stateNum);
+        for (auto s = 0; s < stateNum; ++s)
+        {
+            for (auto i = 0; i < chemNum; ++i) concMat[s * chemNum + pos[i]] = base[i] + 0.01 * s * (i + 1);
+        }
+        rxn.calcRateJacobianBatch(concMat.data(), stateNum, rateMat.data(), jacMat.data());
+
+        bool same = true;
+        for (auto s = 0; s < stateNum; ++s)
+        {
+            std::vector<double> rate(2), jac(2 * chemNum);
+            rxn.calcRateJacobian(concMat.data() + s * chemNum, rate.data(), jac.data());
+            for (auto j = 0; j < 2; ++j) same = same && (std::abs(rate[j] - rateMat[s * 2 + j]) <= 1e-14 * std::max(1.0, std::abs(rate[j])));
+            for (auto k = 0; k < 2 * chemNum; ++k) same = same && (std::abs(jac[k] - jacMat[s * 2 * chemNum + k]) <= 1e-14 * std::max(1.0, std::abs(jac[k])));
+        }
+        check(same, "batch evaluation matches single-state evaluation");
+    }
+
+    // 잘못된 식
+    {
+        SpeedRxnBase bad(std::vector<std::string>{"A + B = C"});
+        check(throws([&]() {bad.setRateExpr({"A * Z"});}), "unknown name throws");
+        check(throws([&]() {bad.setRateExpr({"A * (B + 1"});}), "unbalanced parenthesis throws");
+        check(throws([&]() {bad.setRateExpr({"A", "B"});}), "expression count must match the reaction count");
+    }
+
+    return testhelper::report("RateExprTest");
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+tests/RecycleTearTest.cpp
+-------------------------
+Flowsheet의 순환 블록이 처음에 비어 있는(혹은 화학종이 모자란) 절단 스트림으로도 수렴하는지 검사함.
+    feed -> Mixer([feed, rec]) -> mid -> Splitter(0.6, 0.4) -> [prod, rec]
+정상 상태에서 prod = feed, mid = feed / 0.6, rec = 0.4 mid 임.
+분배기는 출력 스트림에 없는 화학종을 추가하므로(updateChem), 첫 반복에서 절단 스트림의 크기가 바뀜.
+EOSolver도 같은 공정도에서 반복 중에 바뀐 스트림 구성으로 희소 구조를 다시 만들어 수렴해야 함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+void checkRecycle(ChemBase* A, ChemBase* B, StreamBase& Rec, const std::string& Name)
+{
+    StreamBase feed(std::vector<ChemBase*>{A, B}, std::vector<float>{10, 5});
+    StreamBase mid(std::vector<ChemBase*>{A, B});
+    StreamBase prod(std::vector<ChemBase*>{A, B});
+
+    MixerBase mixer({&feed, &Rec}, &mid);
+    SplitterBase splitter(&mid, {&prod, &Rec}, std::vector<float>{0.6f, 0.4f});
+
+    Flowsheet flowsheet({&mixer, &splitter});
+    flowsheet.setTolerance(1e-6);
+    auto resVec = flowsheet.solve();
+
+    check(resVec.size() == 1 && resVec[0].Converged, Name + " recycle converges");
+    check(flowsheet.getTearStream().size() == 1 && flowsheet.getTearStream()[0].size() == 1, Name + " tears a single stream");
+
+    checkNear(prod.getChemMol(A), 10, 1e-4, 1e-4, Name + " product A equals feed");
+    checkNear(prod.getChemMol(B), 5, 1e-4, 1e-4, Name + " product B equals feed");
+    checkNear(Rec.getChemMol(A), 10 * 0.4 / 0.6, 1e-4, 1e-4, Name + " recycle A");
+    checkNear(Rec.getChemMol(B), 5 * 0.4 / 0.6, 1e-4, 1e-4, Name + " recycle B");
+}
+
+void checkRecycleEO(ChemBase* A, ChemBase* B, StreamBase& Rec, const std::string& Name)
+{
+    StreamBase feed(std::vector<ChemBase*>{A, B}, std::vector<float>{10, 5});
+    StreamBase mid(std::vector<ChemBase*>{A, B});
+    StreamBase prod(std::vector<ChemBase*>{A, B});
+
+    MixerBase mixer({&feed, &Rec}, &mid);
+    SplitterBase splitter(&mid, {&prod, &Rec}, std::vector<float>{0.6f, 0.4f});
+
+    Flowsheet flowsheet({&mixer, &splitter});
+    EOSolver solver(&flowsheet);
+    auto res = solver.solve();
+
+    check(res.Converged, Name + " EO solve converges");
+    check(solver.getVarNum() == 6, Name + " EO structure covers the added species");
+    checkNear(prod.getChemMol(A), 10, 1e-4, 1e-4, Name + " EO product A equals feed");
+    checkNear(prod.getChemMol(B), 5, 1e-4, 1e-4, Name + " EO product B equals feed");
+    checkNear(Rec.getChemMol(B), 5 * 0.4 / 0.6, 1e-4, 1e-4, Name + " EO recycle B");
+
+    // 스트림 구성이 바뀐 뒤 다시 풀어도 구조를 맞게 유지함.
+    feed.setChemMolAt(1, 8);
+    res = solver.solve();
+    check(res.Converged, Name + " EO re-solve converges");
+    checkNear(prod.getChemMol(B), 8, 1e-4, 1e-4, Name + " EO re-solve follows the new feed");
+}
+
+int main()
+{
+    ChemBase A("A"), B("B");
+
+    // 화학종이 없는 절단 스트림
+    StreamBase emptyRec;
+    checkRecycle(&A, &B, emptyRec, "default-constructed tear");
+
+    // 화학종 일부만 있는 절단 스트림
+    StreamBase partialRec(std::vector<ChemBase*>{&A}, std::vector<float>{1});
+    checkRecycle(&A, &B, partialRec, "partial tear");
+
+    StreamBase partialEORec(std::vector<ChemBase*>{&A}, std::vector<float>{1});
+    checkRecycleEO(&A, &B, partialEORec, "partial tear");
+
+    return testhelper::report("RecycleTearTest");
+}
\ No newline at end of file
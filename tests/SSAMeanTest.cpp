@@ -0,0 +1,82 @@
+/*
+tests/SSAMeanTest.cpp
+---------------------
+SSAEngine의 앙상블 평균을 반응 속도식(ODE)의 해와 비교함. 1차 반응만 있는 계는 평균이 ODE를 정확히 따름.
+    - A = B 비가역(k) : <A>(t) = X0 exp(-k t), Var = X0 p (1 - p), p = exp(-k t)
+    - A = B 가역(kf, kr) : <A>(t) = A* + (X0 - A*) exp(-(kf + kr) t), A* = X0 kr / (kf + kr)
+    - tau-leaping도 같은 평균을 주는지, 스레드 수와 관계없이 같은 결과를 주는지
+평균의 허용 오차는 표준 오차의 5배로 둠. tau-leaping의 평균은 선형계에서 전진 Euler를 따르므로,
+O(tau)의 편향을 작게 하도록 허용 오차(epsilon)를 줄이고 과도 구간의 편향(2%)을 허용 오차에 더함.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+int main()
+{
+    ChemBase A("A"), B("B");
+    const std::vector<double> timeVec = {0.5, 1.0, 2.0, 4.0};
+    const int trajNum = 400;
+
+    // 비가역 1차 반응
+    {
+        const double k = 0.5, x0 = 1000;
+        SpeedRxnBase rxn(std::vector<std::string>{"A = B"});
+        rxn.setMassAction({float(k)}, {0.0f});
+
+        for (auto method : {SSAEngine::Direct, SSAEngine::CompositionRejection})
+        {
+            const auto name = std::string((method == SSAEngine::Direct) ? "Direct" : "CompositionRejection");
+            SSAEngine engine(&rxn, 100.0, method);
+            engine.setInitCount({std::int64_t(x0), 0});
+
+            auto res = engine.simulateEnsemble(timeVec, trajNum, 4);
+            for (auto n = 0; n < timeVec.size(); ++n)
+            {
+                const double p = std::exp(-k * timeVec[n]);
+                const double var = x0 * p * (1 - p);
+                const auto tag = " at t = " + std::to_string(timeVec[n]);
+
+                checkNear(res.MeanMat(0, n), x0 * p, 5 * std::sqrt(var / trajNum), 0, name + " mean of A follows the ODE" + tag);
+                checkNear(res.MeanMat(0, n) + res.MeanMat(1, n), x0, 1e-9, 0, name + " conserves molecules" + tag);
+                checkNear(res.VarMat(0, n), var, 0, 0.25, name + " variance of A is binomial" + tag);
+            }
+
+            auto serial = engine.simulateEnsemble(timeVec, trajNum, 1);
+            check((serial.MeanMat - res.MeanMat).cwiseAbs().maxCoeff() == 0, name + " ensemble doesn't depend on the thread count");
+        }
+    }
+
+    // 가역 1차 반응 : 정확한 SSA와 tau-leaping
+    {
+        const double kf = 1.0, kr = 0.5, x0 = 20000;
+        SpeedRxnBase rxn(std::vector<std::string>{"A = B"});
+        rxn.setMassAction({float(kf)}, {float(kr)});
+
+        SSAEngine engine(&rxn, 1000.0);
+        engine.setInitCount({std::int64_t(x0), 0});
+
+        const double eq = x0 * kr / (kf + kr);
+        auto exact = engine.simulateEnsemble(timeVec, 100);
+
+        engine.setTauLeap(true, 0.005);
+        auto leap = engine.simulateEnsemble(timeVec, 100);
+        check(engine.simulate(timeVec).LeapNum > 0, "tau-leaping takes leaps for large counts");
+
+        for (auto n = 0; n < timeVec.size(); ++n)
+        {
+            const double ref = eq + (x0 - eq) * std::exp(-(kf + kr) * timeVec[n]);
+            const double tol = 5 * std::sqrt(x0 / 4 / 100);
+            const auto tag = " at t = " + std::to_string(timeVec[n]);
+
+            checkNear(exact.MeanMat(0, n), ref, tol, 0, "reversible SSA mean follows the ODE" + tag);
+            checkNear(leap.MeanMat(0, n), ref, tol + 0.02 * (ref - eq), 0, "tau-leaping mean follows the ODE" + tag);
+        }
+    }
+
+    return testhelper::report("SSAMeanTest");
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*
+tests/SparseBDFTest.cpp
+-----------------------
+SparseBDF의 해를 boost::odeint의 rosenbrock4(밀집 Jacobian)로 구한 기준 해와 비교함.
+    - Robertson 문제 : 일반 시스템 생성자(패턴 지정)
+    - stiff한 질량 작용 메커니즘 : SpeedRxnBase 생성자(반응식 계수와 getJacobPattern으로 패턴 구성)
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+using VecType = boost::numeric::ublas::vector<double>;
+using MatType = boost::numeric::ublas::matrix<double>;
+
+// rosenbrock4로 TimeVec의 각 시간까지 적분한 상태를 반환함.
+template <typename SystemType, typename JacobiType>
+std::vector<std::vector<double>> solveRosenbrock(SystemType System, JacobiType Jacobi, const std::vector<double>& y0,
+    const std::vector<double>& TimeVec)
+{
+    namespace odeint = boost::numeric::odeint;
+
+    VecType y(y0.size());
+    for (auto i = 0; i < y0.size(); ++i) y[i] = y0[i];
+
+    std::vector<std::vector<double>> stateVec;
+    double t = 0;
+    for (auto tEnd : TimeVec)
+    {
+        odeint::integrate_adaptive(odeint::make_controlled<odeint::rosenbrock4<double>>(1e-14, 1e-10),
+            std::make_pair(System, Jacobi), y, t, tEnd, (tEnd - t) * 1e-6);
+        t = tEnd;
+        stateVec.emplace_back(y.begin(), y.end());
+    }
+    return stateVec;
+}
+
+// 성분별 상대 오차 RelTol(절대 오차 AbsTol 포함) 안에서 두 해가 같은지 검사함.
+void compareStates(const BDFResult& Res, const std::vector<std::vector<double>>& RefVec, const double& AbsTol,
+    const double& RelTol, const std::string& Name)
+{
+    check(Res.StateVec.size() == RefVec.size(), Name + " records every output time");
+    for (auto n = 0; n < RefVec.size(); ++n)
+    {
+        for (auto i = 0; i < RefVec[n].size(); ++i)
+        {
+            checkNear(Res.StateVec[n][i], RefVec[n][i], AbsTol, RelTol,
+                Name + " component " + std::to_string(i) + " at t = " + std::to_string(Res.TimeVec[n]));
+        }
+    }
+}
+
+int main()
+{
+    // Robertson 문제
+    {
+        auto func = [](const double* y, double* f)
+        {
+            f[0] = -0.04 * y[0] + 1e4 * y[1] * y[2];
+            f[2] = 3e7 * y[1] * y[1];
+            f[1] = -f[0] - f[2];
+        };
+
+        SparseBDF bdf(3, [func](const double& /* t */, const double* y, double* f) {func(y, f);},
+            [](const double& /* t */, const double* y, double* v)
+            {
+                v[0] = -0.04; v[1] = 1e4 * y[2]; v[2] = 1e4 * y[1];
+                v[3] = 0.04; v[4] = -1e4 * y[2] - 6e7 * y[1]; v[5] = -1e4 * y[1];
+                v[6] = 6e7 * y[1];
+            },
+            {0, 0, 0, 1, 1, 1, 2}, {0, 1, 2, 0, 1, 2, 1});
+        bdf.setTolerance(1e-12, 1e-7);
+
+        const std::vector<double> timeVec = {0.4, 40, 4e3, 4e5};
+        std::vector<double> y = {1, 0, 0};
+        auto res = bdf.solve(y, 0, timeVec);
+
+        auto ref = solveRosenbrock(
+            [func](const VecType& x, VecType& dxdt, const double& /* t */) {func(&x[0], &dxdt[0]);},
+            [](const VecType& x, MatType& J, const double& /* t */, VecType& dfdt)
+            {
+                J(0, 0) = -0.04; J(0, 1) = 1e4 * x[2]; J(0, 2) = 1e4 * x[1];
+                J(1, 0) = 0.04; J(1, 1) = -1e4 * x[2] - 6e7 * x[1]; J(1, 2) = -1e4 * x[1];
+                J(2, 0) = 0; J(2, 1) = 6e7 * x[1]; J(2, 2) = 0;
+                for (auto i = 0; i < 3; ++i) dfdt[i] = 0;
+            },
+            {1, 0, 0}, timeVec);
+
+        compareStates(res, ref, 1e-10, 1e-4, "Robertson");
+        checkNear(y[0] + y[1] + y[2], 1, 1e-8, 0, "Robertson conserves mass");
+        check(res.LUNum < res.StepNum, "Robertson reuses the LU factorization across steps");
+    }
+
+    // stiff한 질량 작용 메커니즘 (P = Q가 다른 반응보다 10^4배 빠름)
+    {
+        ChemBase A("A"), B("B"), P("P"), Q("Q");
+        SpeedRxnBase rxn(std::vector<std::string>{"A + B = P", "P = Q", "2A = Q"});
+        rxn.setMassAction({2.0f, 2e4f, 0.5f}, {0.3f, 1e3f, 0.0f});
+
+        const int chemNum = rxn.getChemNum();
+        const int rxnNum = rxn.getRxnNum();
+        const Eigen::MatrixXd stoiMat = rxn.getEffiMat().block(0, 0, chemNum, rxnNum).cast<double>();
+
+        std::vector<double> y0(chemNum, 0);
+        const auto chemIdx = rxn.getChemIdx();
+        for (auto i = 0; i < chemNum; ++i) y0[i] = (chemIdx[i] == &A) ? 1.0 : ((chemIdx[i] == &B) ? 0.8 : 0.0);
+
+        SparseBDF bdf(&rxn);
+        bdf.setTolerance(1e-12, 1e-8);
+
+        const std::vector<double> timeVec = {1e-3, 0.1, 1, 10};
+        std::vector<double> y = y0;
+        auto res = bdf.solve(y, 0, timeVec);
+
+        auto ref = solveRosenbrock(
+            [&](const VecType& x, VecType& dxdt, const double& /* t */)
+            {
+                std::vector<double> rate(rxnNum);
+                rxn.calcRate(&x[0], rate.data());
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    dxdt[i] = 0;
+                    for (auto j = 0; j < rxnNum; ++j) dxdt[i] += stoiMat(i, j) * rate[j];
+                }
+            },
+            [&](const VecType& x, MatType& J, const double& /* t */, VecType& dfdt)
+            {
+                std::vector<double> rate(rxnNum), jac(chemNum * rxnNum);
+                rxn.calcRateJacobian(&x[0], rate.data(), jac.data());
+                for (auto i = 0; i < chemNum; ++i)
+                {
+                    dfdt[i] = 0;
+                    for (auto k = 0; k < chemNum; ++k)
+                    {
+                        J(i, k) = 0;
+                        for (auto j = 0; j < rxnNum; ++j) J(i, k) += stoiMat(i, j) * jac[k * rxnNum + j];
+                    }
+                }
+            },
+            y0, timeVec);
+
+        compareStates(res, ref, 1e-9, 1e-5, "mass-action mechanism");
+    }
+
+    return testhelper::report("SparseBDFTest");
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+tests/SplitterSpecTest.cpp
+--------------------------
+SplitterBase, SeparatorBase의 역산(입력 스트림을 모르는 경우)을 검사함.
+    - 알려진 출력 스트림 하나로 입력과 나머지 출력을 계산함.
+    - 알려진 출력 스트림이 여러 개이면 서로 맞을 때만 풀고, 맞지 않으면 스트림을 바꾸지 않고 runtime error 발생.
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// Func가 runtime error를 던지면 true를 반환함.
+template <typename FuncType>
+bool throws(FuncType Func)
+{
+    try
+    {
+        Func();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    ChemBase A("A"), B("B");
+
+    // 분배기 : 출력 하나만 알려진 경우
+    {
+        StreamBase in(std::vector<ChemBase*>{&A, &B});
+        StreamBase out1(std::vector<ChemBase*>{&A, &B}, std::vector<float>{3, 6});
+        StreamBase out2(std::vector<ChemBase*>{&A, &B});
+        SplitterBase splitter(&in, {&out1, &out2}, std::vector<float>{0.3f, 0.7f});
+
+        splitter.solveSteadyState();
+        checkNear(in.getChemMol(&A), 10, 1e-5, 1e-5, "splitter back-calculates inlet A");
+        checkNear(in.getChemMol(&B), 20, 1e-5, 1e-5, "splitter back-calculates inlet B");
+        checkNear(out2.getChemMol(&A), 7, 1e-5, 1e-5, "splitter computes the other outlet");
+    }
+
+    // 분배기 : 두 출력이 모두 알려지고 서로 맞는 경우와 맞지 않는 경우
+    {
+        StreamBase in(std::vector<ChemBase*>{&A, &B});
+        StreamBase out1(std::vector<ChemBase*>{&A, &B}, std::vector<float>{3, 6});
+        StreamBase out2(std::vector<ChemBase*>{&A, &B}, std::vector<float>{7, 14});
+        SplitterBase splitter(&in, {&out1, &out2}, std::vector<float>{0.3f, 0.7f});
+
+        check(!throws([&]() {splitter.solveSteadyState();}), "consistent known outlets are accepted");
+        checkNear(in.getChemMol(&A), 10, 1e-5, 1e-5, "consistent outlets give the inlet");
+
+        StreamBase in2(std::vector<ChemBase*>{&A, &B});
+        StreamBase bad(std::vector<ChemBase*>{&A, &B}, std::vector<float>{5, 14});
+        SplitterBase overSpec(&in2, {&out1, &bad}, std::vector<float>{0.3f, 0.7f});
+
+        check(throws([&]() {overSpec.solveSteadyState();}), "inconsistent known outlets throw");
+        check(!in2.chemMolIsAllKnown(), "inlet stays unknown after the error");
+        checkNear(bad.getChemMol(&A), 5, 0, 0, "specified outlet isn't overwritten");
+    }
+
+    // 성분 분리기 : 회수율이 0인 출력에 0이 아닌 값이 지정된 경우
+    {
+        StreamBase in(std::vector<ChemBase*>{&A, &B});
+        StreamBase top(std::vector<ChemBase*>{&A, &B}, std::vector<float>{9, 1});
+        StreamBase bottom(std::vector<ChemBase*>{&A, &B}, std::vector<float>{1, 0});
+        SeparatorBase separator(&in, {&top, &bottom});
+        separator.setRecovery(&A, {0.9f, 0.1f});
+        separator.setRecovery(&B, {1.0f, 0.0f});
+
+        check(!throws([&]() {separator.solveSteadyState();}), "separator accepts consistent outlets");
+
+        StreamBase in2(std::vector<ChemBase*>{&A, &B});
+        StreamBase bottom2(std::vector<ChemBase*>{&A, &B}, std::vector<float>{1, 2});
+        SeparatorBase overSpec(&in2, {&top, &bottom2});
+        overSpec.setRecovery(&A, {0.9f, 0.1f});
+        overSpec.setRecovery(&B, {1.0f, 0.0f});
+
+        check(throws([&]() {overSpec.solveSteadyState();}), "separator throws on a non-zero outlet with zero recovery");
+    }
+
+    return testhelper::report("SplitterSpecTest");
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*
+tests/TearMethodTest.cpp
+------------------------
+두 개의 순환 루프가 한 Mixer를 공유하는 공정도에서 TearConverger의 네 가지 방법을 비교함.
+    feed + rec1 + rec2 -> Mixer -> PFR(A -> B -> C) -> Separator1 -> [top1, bot1]
+    top1 -> Splitter(0.995, 0.005) -> [rec1, purge1]
+    bot1 -> PFR -> Separator2 -> [top2, prod]
+    top2 -> Splitter(0.99, 0.01) -> [rec2, purge2]
+순환 비율이 커서 축차 대입(Direct)은 느리게 수렴함.
+    - 모든 방법이 같은 절단 스트림 값과 제품으로 수렴하는지
+    - Wegstein, Broyden, Anderson의 반복 횟수가 Direct보다 여러 배 적은지
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+int main()
+{
+    ChemBase A("A"), B("B"), C("C");
+    const std::vector<ChemBase*> chemVec = {&A, &B, &C};
+
+    SpeedRxnBase rxn(std::vector<std::string>{"A = B", "B = C"});
+    rxn.setMassAction({0.5f, 0.05f}, {0.0f, 0.0f});
+
+    StreamBase feed(chemVec, std::vector<float>{10, 0, 0});
+    std::deque<StreamBase> streamVec;
+    for (auto i = 0; i < 11; ++i) streamVec.emplace_back(chemVec);
+    auto& mixOut = streamVec[0];
+    auto& pfrOut = streamVec[1];
+    auto& top1 = streamVec[2];
+    auto& bot1 = streamVec[3];
+    auto& rec1 = streamVec[4];
+    auto& purge1 = streamVec[5];
+    auto& pfr2Out = streamVec[6];
+    auto& top2 = streamVec[7];
+    auto& prod = streamVec[8];
+    auto& rec2 = streamVec[9];
+    auto& purge2 = streamVec[10];
+
+    MixerBase mixer({&feed, &rec1, &rec2}, &mixOut);
+    PFR pfr(&mixOut, &pfrOut, &rxn, 1.0f, 1.0f);
+    SeparatorBase sep1(&pfrOut, {&top1, &bot1});
+    sep1.setRecovery(&A, {0.98f, 0.02f});
+    sep1.setRecovery(&B, {0.1f, 0.9f});
+    sep1.setRecovery(&C, {0.02f, 0.98f});
+    SplitterBase split1(&top1, {&rec1, &purge1}, std::vector<float>{0.995f, 0.005f});
+    PFR pfr2(&bot1, &pfr2Out, &rxn, 1.0f, 1.0f);
+    SeparatorBase sep2(&pfr2Out, {&top2, &prod});
+    sep2.setRecovery(&A, {0.9f, 0.1f});
+    sep2.setRecovery(&B, {0.8f, 0.2f});
+    sep2.setRecovery(&C, {0.05f, 0.95f});
+    SplitterBase split2(&top2, {&rec2, &purge2}, std::vector<float>{0.99f, 0.01f});
+
+    const std::vector<std::string> nameVec = {"Direct", "Wegstein", "Broyden", "Anderson"};
+    std::vector<int> iterVec;
+    std::vector<std::vector<float>> tearVec, prodVec;
+
+    for (auto m = 0; m < nameVec.size(); ++m)
+    {
+        for (auto& stream : streamVec) stream.setAllUnknown();
+
+        Flowsheet flowsheet({&split2, &sep2, &pfr2, &split1, &sep1, &pfr, &mixer});
+        flowsheet.setTearMethod(static_cast<TearConverger::MethodType>(m));
+        flowsheet.setTolerance(1e-6);
+        flowsheet.setMaxIter(1000);
+        auto resVec = flowsheet.solve();
+
+        check(resVec.size() == 1 && resVec[0].Converged, nameVec[m] + " converges");
+        if (resVec.size() != 1) continue;
+        iterVec.push_back(resVec[0].IterNum);
+
+        std::vector<float> tear, out;
+        for (auto ptr : resVec[0].TearIdx)
+        {
+            for (auto chem : chemVec) tear.push_back(ptr->getChemMol(chem));
+        }
+        for (auto chem : chemVec) out.push_back(prod.getChemMol(chem));
+        tearVec.push_back(tear);
+        prodVec.push_back(out);
+
+        std::cout << nameVec[m] << " : " << resVec[0].IterNum << " iterations" << std::endl;
+    }
+
+    if (iterVec.size() != nameVec.size()) return testhelper::report("TearMethodTest");
+
+    for (auto m = 1; m < nameVec.size(); ++m)
+    {
+        check(tearVec[m].size() == tearVec[0].size(), nameVec[m] + " tears the same streams as Direct");
+        for (auto i = 0; i < std::min(tearVec[m].size(), tearVec[0].size()); ++i)
+        {
+            checkNear(tearVec[m][i], tearVec[0][i], 1e-4, 1e-4, nameVec[m] + " tear value " + std::to_string(i) + " matches Direct");
+        }
+        for (auto i = 0; i < 3; ++i)
+        {
+            checkNear(prodVec[m][i], prodVec[0][i], 1e-4, 1e-4, nameVec[m] + " product " + chemVec[i]->getAbb() + " matches Direct");
+        }
+        check(3 * iterVec[m] <= iterVec[0], nameVec[m] + " needs several times fewer passes than Direct");
+    }
+
+    // 제품과 퍼지의 합은 원료와 같음.
+    double total = 0;
+    for (auto chem : chemVec) total += prod.getChemMol(chem) + purge1.getChemMol(chem) + purge2.getChemMol(chem);
+    checkNear(total, 10, 1e-3, 1e-3, "outlets conserve moles");
+
+    return testhelper::report("TearMethodTest");
+}
\ No newline at end of file
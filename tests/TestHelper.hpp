@@ -0,0 +1,54 @@
+/*
+tests/TestHelper.hpp
+--------------------
+tests의 검사 프로그램들이 함께 사용하는 검사 함수를 정의함.
+검사 프로그램은 각각 main을 가지며, 저장소 최상위 경로에서 다음과 같이 빌드하고 실행함.
+    g++ -std=c++17 -O2 -pthread -I<Eigen 경로> -I. tests/XXXTest.cpp -o XXXTest && ./XXXTest
+실패한 검사가 하나라도 있으면 0이 아닌 값을 반환함.
+*/
+#ifndef _CHEMPROCHELPER_TESTHELPER
+#define _CHEMPROCHELPER_TESTHELPER
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <sstream>
+
+namespace testhelper
+{
+    // 실패한 검사의 수를 저장함.
+    inline int& failCount()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    // Cond가 거짓이면 실패로 기록하고 Msg를 출력함.
+    inline void check(const bool& Cond, const std::string& Msg)
+    {
+        if (Cond) return;
+        ++failCount();
+        std::cerr << "[FAIL] " << Msg << std::endl;
+    }
+
+    // |Val - Ref| <= AbsTol + RelTol * |Ref| 인지 검사함.
+    inline void checkNear(const double& Val, const double& Ref, const double& AbsTol, const double& RelTol,
+        const std::string& Msg)
+    {
+        const bool cond = std::isfinite(Val) && std::abs(Val - Ref) <= AbsTol + RelTol * std::abs(Ref);
+        std::ostringstream oss;
+        oss.precision(10);
+        oss << Msg << " (value " << Val << ", expected " << Ref << ")";
+        check(cond, oss.str());
+    }
+
+    // 검사 결과를 출력하고 main의 반환값을 돌려줌.
+    inline int report(const std::string& Name)
+    {
+        if (failCount() == 0) std::cout << "[PASS] " << Name << std::endl;
+        else std::cout << "[FAIL] " << Name << " : " << failCount() << " check(s) failed" << std::endl;
+        return failCount() == 0 ? 0 : 1;
+    }
+} // namespace testhelper
+
+#endif
\ No newline at end of file
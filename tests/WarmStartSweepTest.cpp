@@ -0,0 +1,107 @@
+/*
+tests/WarmStartSweepTest.cpp
+----------------------------
+RxtorBase::solveConvRateFromKValue의 warm start와 sweepConvRateFromKValue(continuation)를 검사함.
+    - 경로의 모든 지점에서 ln Q = ln K 를 만족하는지
+    - 각 지점을 cold start로 따로 푼 결과와 같은지
+    - warm start와 1차 예측이 cold start보다 반복 횟수를 줄이는지
+    - 실행 불가능한 초기값을 주면 cold start로 돌아가는지
+*/
+#define _INCLUDE_CHEMPROCHELPER_SOLVER
+#include "ChemProcHelper.hpp"
+#include "tests/TestHelper.hpp"
+
+using namespace chemprochelper;
+using testhelper::check;
+using testhelper::checkNear;
+
+// 입구 몰수 feedVec(반응 화학종 순서)과 전화율 convVec에서 반응별 ln Q - ln K 의 최대 절댓값을 계산함.
+double maxLnQResidual(RxtorBase& Rxtor, const std::vector<float>& feedVec, const std::vector<float>& convVec,
+    const std::vector<float>& K)
+{
+    const auto& stoiMat = Rxtor.getStoiMat();
+    double res = 0;
+    for (auto j = 0; j < stoiMat.cols(); ++j)
+    {
+        double lnQ = 0;
+        for (auto i = 0; i < stoiMat.rows(); ++i)
+        {
+            double mol = feedVec[i];
+            for (auto k = 0; k < stoiMat.cols(); ++k) mol += stoiMat(i, k) * convVec[k];
+            lnQ += stoiMat(i, j) * std::log(mol);
+        }
+        res = std::max(res, std::abs(lnQ - std::log(K[j])));
+    }
+    return res;
+}
+
+int main()
+{
+    ChemBase NH3("NH3"), MeOH("CH3OH"), H2O("H2O"), MMA("CH3NH2"), DMA("(CH3)2NH");
+    RxnBase rxn(std::vector<std::string>{"NH3 + CH3OH = CH3NH2 + H2O", "CH3NH2 + CH3OH = (CH3)2NH + H2O"});
+
+    // 반응 화학종 순서(RxnBase::getChemIdx())의 입구 몰수
+    std::vector<float> feedVec;
+    for (auto ptr : rxn.getChemIdx()) feedVec.push_back((ptr == &NH3 || ptr == &MeOH) ? 100.0f : 0.0f);
+
+    StreamBase inStream(std::vector<ChemBase*>{&NH3, &MeOH}, std::vector<float>{100, 100});
+    StreamBase outStream(std::vector<ChemBase*>{&NH3, &MeOH, &H2O, &MMA, &DMA}, std::vector<float>{0, 0, 0, 0, 0});
+    RxtorBase rxtor(&inStream, &outStream, &rxn);
+
+    // K1을 2에서 8까지, K2를 1.5에서 0.5까지 바꾸는 경로
+    std::vector<std::vector<float>> KPath;
+    for (auto k = 0; k <= 12; ++k) KPath.push_back({2.0f + 0.5f * k, 1.5f - k / 12.0f});
+
+    auto warmRes = rxtor.sweepConvRateFromKValue(KPath, false);
+    auto predRes = rxtor.sweepConvRateFromKValue(KPath, true);
+
+    check(warmRes.ConvRateVec.size() == KPath.size(), "sweep returns one result per path point");
+    check(predRes.ConvRateVec.size() == KPath.size(), "predictor sweep returns one result per path point");
+
+    int coldIterSum = 0, warmIterSum = 0, predIterSum = 0;
+    for (auto k = 0; k < KPath.size(); ++k)
+    {
+        const auto tag = " at point " + std::to_string(k);
+
+        check(maxLnQResidual(rxtor, feedVec, warmRes.ConvRateVec[k], KPath[k]) < 1e-3, "warm sweep satisfies ln Q = ln K" + tag);
+        check(maxLnQResidual(rxtor, feedVec, predRes.ConvRateVec[k], KPath[k]) < 1e-3, "predictor sweep satisfies ln Q = ln K" + tag);
+
+        // 같은 지점을 cold start로 따로 풂.
+        coldIterSum += rxtor.solveConvRateFromKValue(KPath[k]);
+        const auto coldConv = rxtor.getScalarVec();
+        for (auto j = 0; j < coldConv.size(); ++j)
+        {
+            checkNear(warmRes.ConvRateVec[k][j], coldConv[j], 1e-3, 1e-3, "warm extent matches cold solve" + tag);
+            checkNear(predRes.ConvRateVec[k][j], coldConv[j], 1e-3, 1e-3, "predictor extent matches cold solve" + tag);
+        }
+
+        warmIterSum += warmRes.IterVec[k];
+        predIterSum += predRes.IterVec[k];
+    }
+
+    check(warmIterSum < coldIterSum, "warm start uses fewer iterations than cold start");
+    check(predIterSum <= warmIterSum, "first-order predictor doesn't use more iterations than plain warm start");
+    check(warmRes.SavedIter > 0, "SavedIter reports saved iterations");
+
+    int savedSum = 0;
+    for (auto k = 1; k < KPath.size(); ++k) savedSum += warmRes.ColdIter - warmRes.IterVec[k];
+    check(warmRes.SavedIter == savedSum, "SavedIter is the sum of saved iterations over the warm points");
+
+    // 이미 수렴한 전화율에서 시작하면 반복 없이 끝남.
+    rxtor.solveConvRateFromKValue(KPath.back());
+    const auto convVec = rxtor.getScalarVec();
+    check(rxtor.solveConvRateFromKValue(KPath.back(), convVec) <= 1, "warm start at the solution converges immediately");
+
+    // 몰수가 음수가 되는 초기값은 Newton이 실패하므로 cold start로 돌아가야 함.
+    const int fallbackIter = rxtor.solveConvRateFromKValue(KPath.back(), std::vector<float>{500.0f, 500.0f});
+    const auto fallbackConv = rxtor.getScalarVec();
+    check(maxLnQResidual(rxtor, feedVec, fallbackConv, KPath.back()) < 1e-3, "infeasible warm start falls back to a converged cold solve");
+    check(fallbackIter >= rxtor.solveConvRateFromKValue(KPath.back()), "fallback counts at least the cold-start iterations");
+
+    // 출력 스트림은 마지막 풀이의 전화율로 물질 수지를 만족해야 함.
+    float nitrogen = 0;
+    for (auto ptr : std::vector<ChemBase*>{&NH3, &MMA, &DMA}) nitrogen += outStream.getChemMol(ptr);
+    checkNear(nitrogen, 100.0, 1e-2, 0, "outlet conserves nitrogen");
+
+    return testhelper::report("WarmStartSweepTest");
+}
\ No newline at end of file